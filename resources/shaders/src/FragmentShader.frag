@@ -4,6 +4,10 @@
 
 #define MAX_MODEL_COUNT 256
 
+#define TILE_TEXEL_LENGTH 16
+
+#define DESCRIPTOR_HANDLE_INVALID 0xFFFFFFFF
+
 struct DrawInfo {
 	// Indirect draw info
 	uint indexCount;
@@ -14,6 +18,12 @@ struct DrawInfo {
 	// Additional draw data
 	int modelIndex;
 	uint imageIndex;
+	// Tilemap draw data; tilesetImageIndex is 0xFFFFFFFF if the model is not a tilemap
+	uint tilesetImageIndex;
+	uint tileDataBufferIndex;
+	uint tileDataOffset;
+	uint tilemapWidth;
+	uint tilemapLength;
 };
 
 layout(set = 0, binding = 0) uniform sampler samplers[];
@@ -31,23 +41,57 @@ layout(set = 0, binding = 4, scalar) buffer MatrixBuffers {
 	mat4 modelMatrices[MAX_MODEL_COUNT];
 } matrixBuffers[];
 
+layout(set = 0, binding = 4, scalar) readonly buffer TileDataBuffers {
+	uint tileIndices[];
+} tileDataBuffers[];
+
 layout(push_constant) uniform PushConstants {
 	uint samplerIndex;
 	uint sampledImageIndex;
 	uint storageImageIndex;
 	uint uniformBufferIndex;
 	uint storageBufferIndex;
+	uint animationBufferIndex;
+	uint animationTime;	// Milliseconds
 } pushConstants;
 
 layout(location = 0) in vec2 inTextureCoordinates;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in flat uint inDrawIndex;
+layout(location = 3) in flat uint inImageIndex;
 
 layout(location = 0) out vec4 outColor;
 
+// Converts an sRGB-encoded color to linear, as sampling an sRGB image does.
+vec3 srgbToLinear(const vec3 color) {
+	return mix(color / 12.92, pow((color + 0.055) / 1.055, vec3(2.4)), greaterThan(color, vec3(0.04045)));
+}
+
+// Reads the texel of a tilemap directly from the tileset, using the tile index of the tile under the texture coordinates.
+// Tile indices are stored row by row, starting from the top row.
+vec4 readTilemap(const DrawInfo drawInfo) {
+	const vec2 tilemapCoordinates = inTextureCoordinates * vec2(drawInfo.tilemapWidth, drawInfo.tilemapLength);
+	const uvec2 tile = min(uvec2(tilemapCoordinates), uvec2(drawInfo.tilemapWidth - 1, drawInfo.tilemapLength - 1));
+	const uint tileIndex = tileDataBuffers[drawInfo.tileDataBufferIndex].tileIndices[drawInfo.tileDataOffset + tile.y * drawInfo.tilemapWidth + tile.x];
+	
+	const int tilesetWidth = imageSize(storageImages[drawInfo.tilesetImageIndex]).x / TILE_TEXEL_LENGTH;
+	const ivec2 tilesetTile = ivec2(int(tileIndex) % tilesetWidth, int(tileIndex) / tilesetWidth);
+	const ivec2 tileTexel = min(ivec2(fract(tilemapCoordinates) * TILE_TEXEL_LENGTH), ivec2(TILE_TEXEL_LENGTH - 1));
+	const uvec4 texel = imageLoad(storageImages[drawInfo.tilesetImageIndex], ivec3(tilesetTile * TILE_TEXEL_LENGTH + tileTexel, 0));
+	
+	// The tileset stores raw sRGB-encoded bytes, so decode them as an sRGB texture would be.
+	const vec4 color = vec4(texel) / 255.0;
+	return vec4(srgbToLinear(color.rgb), color.a);
+}
+
 void main() {
 	const DrawInfo drawInfo = drawInfoBuffers[pushConstants.uniformBufferIndex].drawInfos[inDrawIndex];
+	if (drawInfo.tilesetImageIndex != DESCRIPTOR_HANDLE_INVALID) {
+		outColor = readTilemap(drawInfo) * vec4(inColor, 1.0);
+		return;
+	}
+	
 	const uint sampledImageIndex = pushConstants.sampledImageIndex + drawInfo.modelIndex;
-	const vec3 textureCoordinates = vec3(inTextureCoordinates, float(drawInfo.imageIndex));
+	const vec3 textureCoordinates = vec3(inTextureCoordinates, float(inImageIndex));
 	outColor = texture(sampler2DArray(sampledImages[sampledImageIndex], samplers[0]), textureCoordinates) * vec4(inColor, 1.0);
 }
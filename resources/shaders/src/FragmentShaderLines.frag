@@ -14,6 +14,12 @@ struct DrawInfo {
 	// Additional draw data
 	int modelIndex;
 	uint imageIndex;
+	// Tilemap draw data; tilesetImageIndex is 0xFFFFFFFF if the model is not a tilemap
+	uint tilesetImageIndex;
+	uint tileDataBufferIndex;
+	uint tileDataOffset;
+	uint tilemapWidth;
+	uint tilemapLength;
 };
 
 layout(set = 0, binding = 0) uniform sampler samplers[];
@@ -0,0 +1,24 @@
+#version 460
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 0, binding = 0) uniform sampler samplers[];
+layout(set = 0, binding = 1) uniform texture2DArray sampledImages[];
+layout(set = 0, binding = 2, rgba8ui) uniform uimage2DArray storageImages[];
+
+layout(push_constant) uniform PushConstants {
+	uint fontImageIndex;
+	uint glyphBufferIndex;
+	uint matrixBufferIndex;
+} pushConstants;
+
+layout(location = 0) in vec2 inTextureCoordinates;
+layout(location = 1) in vec4 inColor;
+layout(location = 2) in flat uint inGlyphIndex;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+	const vec3 textureCoordinates = vec3(inTextureCoordinates, float(inGlyphIndex));
+	outColor = texture(sampler2DArray(sampledImages[pushConstants.fontImageIndex], samplers[0]), textureCoordinates) * inColor;
+}
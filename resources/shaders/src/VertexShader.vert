@@ -16,6 +16,20 @@ struct DrawInfo {
 	// Additional draw info
 	int modelIndex;
 	uint imageIndex;
+	// Tilemap draw data; tilesetImageIndex is 0xFFFFFFFF if the model is not a tilemap
+	uint tilesetImageIndex;
+	uint tileDataBufferIndex;
+	uint tileDataOffset;
+	uint tilemapWidth;
+	uint tilemapLength;
+};
+
+struct ModelAnimation {
+	uint startCell;
+	uint frameCount;	// Models with less than two frames are not animated.
+	float frameDuration;	// Milliseconds
+	uint startTime;	// Milliseconds
+	uint loop;
 };
 
 // Shader layout defintions
@@ -37,12 +51,18 @@ layout(set = 0, binding = 4, scalar) buffer MatrixBuffers {
 	mat4 modelMatrices[MAX_MODEL_COUNT];
 } matrixBuffers[];
 
+layout(set = 0, binding = 4, scalar) readonly buffer AnimationBuffers {
+	ModelAnimation animations[MAX_MODEL_COUNT];
+} animationBuffers[];
+
 layout(push_constant) uniform PushConstants {
 	uint samplerIndex;
 	uint sampledImageIndex;
 	uint storageImageIndex;
 	uint uniformBufferIndex;
 	uint storageBufferIndex;
+	uint animationBufferIndex;
+	uint animationTime;	// Milliseconds
 } pushConstants;
 
 layout(location = 0) in vec3 inPosition;
@@ -52,11 +72,29 @@ layout(location = 2) in vec3 inColor;
 layout(location = 0) out vec2 outTextureCoordinates;
 layout(location = 1) out vec3 outColor;
 layout(location = 2) out uint outDrawIndex;
+layout(location = 3) out flat uint outImageIndex;
 
 // Function definitions
 
+// Selects the current image of the model from the animation clock, or the draw info's image if the model is not animated.
+uint selectImageIndex(const DrawInfo drawInfo) {
+	const ModelAnimation animation = animationBuffers[pushConstants.animationBufferIndex].animations[drawInfo.modelIndex];
+	if (animation.frameCount < 2 || animation.frameDuration <= 0.0) {
+		return drawInfo.imageIndex;
+	}
+	
+	// Unsigned subtraction keeps the elapsed time correct when the clock wraps around.
+	const uint elapsedTime = pushConstants.animationTime - animation.startTime;
+	const uint frame = uint(float(elapsedTime) / animation.frameDuration);
+	if (animation.loop != 0) {
+		return animation.startCell + frame % animation.frameCount;
+	}
+	return animation.startCell + min(frame, animation.frameCount - 1);
+}
+
 void main() {
-	DrawInfo drawInfo = drawInfoBuffers[pushConstants.uniformBufferIndex].drawInfos[gl_DrawID];
+	// The culling pass passes the index of each visible draw's draw info through its first instance.
+	DrawInfo drawInfo = drawInfoBuffers[pushConstants.uniformBufferIndex].drawInfos[gl_InstanceIndex];
 	
 	mat4 modelMatrix = matrixBuffers[pushConstants.storageBufferIndex].modelMatrices[drawInfo.modelIndex];
 	vec4 homogenousCoordinates = vec4(inPosition, 1.0);
@@ -64,5 +102,6 @@ void main() {
 
 	outTextureCoordinates = inTextureCoordinates;
 	outColor = inColor;
-	outDrawIndex = gl_DrawID;
+	outDrawIndex = gl_InstanceIndex;
+	outImageIndex = selectImageIndex(drawInfo);
 }
@@ -14,6 +14,12 @@ struct DrawInfo {
 	// Additional draw info
 	int modelIndex;
 	uint imageIndex;
+	// Tilemap draw data; tilesetImageIndex is 0xFFFFFFFF if the model is not a tilemap
+	uint tilesetImageIndex;
+	uint tileDataBufferIndex;
+	uint tileDataOffset;
+	uint tilemapWidth;
+	uint tilemapLength;
 };
 
 layout(set = 0, binding = 0) uniform sampler samplers[];
@@ -47,7 +53,8 @@ layout(location = 1) in vec3 inColor;
 layout(location = 0) out vec3 outColor;
 
 void main() {
-	DrawInfo drawInfo = drawInfoBuffers[pushConstants.uniformBufferIndex].drawInfos[gl_DrawID];
+	// The culling pass passes the index of each visible draw's draw info through its first instance.
+	DrawInfo drawInfo = drawInfoBuffers[pushConstants.uniformBufferIndex].drawInfos[gl_InstanceIndex];
 	
 	mat4 modelMatrix = matrixBuffers[pushConstants.storageBufferIndex].modelMatrices[drawInfo.modelIndex];
 	vec4 homogenousCoordinates = vec4(inPosition, 1.0);
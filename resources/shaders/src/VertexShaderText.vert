@@ -0,0 +1,78 @@
+#version 460
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Draws text as instanced glyph quads.
+// Each instance is one glyph; the quad's corners are generated from the vertex index, so no vertex buffer is needed.
+
+#define MAX_MODEL_COUNT 256
+
+// Half the length of each side of a glyph quad.
+#define GLYPH_HALF_EXTENT 0.25
+
+// Type/struct definitions
+
+struct GlyphInstance {
+	vec3 position;
+	uint glyphIndex;
+	vec4 color;
+};
+
+// Shader layout defintions
+
+layout(set = 0, binding = 0) uniform sampler samplers[];
+layout(set = 0, binding = 1) uniform texture2DArray sampledImages[];
+layout(set = 0, binding = 2, rgba8ui) uniform uimage2DArray storageImages[];
+
+layout(set = 0, binding = 4, scalar) readonly buffer GlyphBuffers {
+	GlyphInstance glyphs[];
+} glyphBuffers[];
+
+layout(set = 0, binding = 4, scalar) readonly buffer MatrixBuffers {
+	mat4 projectionMatrix;
+	mat4 viewMatrices[MAX_MODEL_COUNT];
+	mat4 modelMatrices[MAX_MODEL_COUNT];
+} matrixBuffers[];
+
+layout(push_constant) uniform PushConstants {
+	uint fontImageIndex;
+	uint glyphBufferIndex;
+	uint matrixBufferIndex;
+} pushConstants;
+
+layout(location = 0) out vec2 outTextureCoordinates;
+layout(location = 1) out vec4 outColor;
+layout(location = 2) out flat uint outGlyphIndex;
+
+// Corners of the glyph quad, in the same order as the quad index buffer (0, 1, 2, 2, 3, 0).
+const vec2 corners[6] = vec2[6](
+	vec2(-1.0, -1.0),
+	vec2(-1.0,  1.0),
+	vec2( 1.0,  1.0),
+	vec2( 1.0,  1.0),
+	vec2( 1.0, -1.0),
+	vec2(-1.0, -1.0)
+);
+
+const vec2 textureCoordinates[6] = vec2[6](
+	vec2(0.0, 1.0),
+	vec2(0.0, 0.0),
+	vec2(1.0, 0.0),
+	vec2(1.0, 0.0),
+	vec2(1.0, 1.0),
+	vec2(0.0, 1.0)
+);
+
+// Function definitions
+
+void main() {
+	const GlyphInstance glyph = glyphBuffers[pushConstants.glyphBufferIndex].glyphs[gl_InstanceIndex];
+	
+	// Text is drawn in screen space, so only the projection matrix is applied.
+	const vec3 position = glyph.position + vec3(GLYPH_HALF_EXTENT * corners[gl_VertexIndex], 0.0);
+	gl_Position = matrixBuffers[pushConstants.matrixBufferIndex].projectionMatrix * vec4(position, 1.0);
+	
+	outTextureCoordinates = textureCoordinates[gl_VertexIndex];
+	outColor = glyph.color;
+	outGlyphIndex = glyph.glyphIndex;
+}
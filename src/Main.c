@@ -1,80 +1,260 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include "config.h"
 #include "debug.h"
+#include "audio/audio_backend.h"
+#include "audio/audio_config.h"
 #include "audio/audio_mixer.h"
-#include "audio/portaudio/portaudio_manager.h"
 #include "game/Game.h"
+#include "game/HotReload.h"
+#include "game/entity/Collision.h"
 #include "game/entity/entity_manager.h"
 #include "game/entity/EntityRegistry.h"
 #include "glfw/GLFWManager.h"
+#include "glfw/InputManager.h"
 #include "log/Logger.h"
 #include "render/RenderManager.h"
+#include "render/render_config.h"
+#include "util/GameClock.h"
 #include "util/Random.h"
+#include "util/StringTable.h"
 #include "util/Time.h"
+#include "util/VirtualFileSystem.h"
 
 static const char appVersion[] = "Alpha 0.2";
-static bool appRunning = false;
+static atomic_bool appRunning = false;
+
+// Files to record input to, and to replay input from; null if not set.
+static const char *pInputRecordingPath = nullptr;
+static const char *pInputReplayPath = nullptr;
+
+// Whether changed resource files are reloaded while the game runs.
+static bool hotReloadEnabled = false;
+
+static void parseArguments(const int argc, char *argv[]);
 
 static void runApp(void);
 
-int main(void) {
+static void runReplay(void);
+
+int main(int argc, char *argv[]) {
 	logMsg(loggerSystem, LOG_LEVEL_INFO, "Running Pink Pearl version %s.", appVersion);
 	if (debug_enabled) {
 		logMsg(loggerSystem, LOG_LEVEL_WARNING, "Debug mode is enabled.");
 		logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Process ID is %i.", getpid());
 	}
+	
+	// Archives given on the command line are mounted while parsing, after the default archive, so that their files take precedence.
+	vfsMountDefaultArchive();
+	parseArguments(argc, argv);
+	
+	// The replay must be opened first, since it sets the random seed, and a replay runs without a window or a GPU.
+	uint64_t randomSeed = 0;
+	if (pInputReplayPath && startInputReplay(pInputReplayPath, &randomSeed)) {
+		initRandomSeed(randomSeed);
+		setRenderHeadless(true);
+	} else {
+		initRandom();
+	}
 
-	initGLFW();
+	initStringTable();
+	if (!isRenderHeadless()) {
+		initGLFW();
+	}
 	initRenderManager();
+	init_audio_backend();
 	init_audio_mixer();
-	init_portaudio();
+	start_audio_backend();
 	initEntityRegistry();
 	init_entity_manager();
-	initRandom();
 	start_game();
+	
+	if (pInputRecordingPath && !isInputReplaying()) {
+		startInputRecording(pInputRecordingPath, getRandomSeed());
+	}
+	if (hotReloadEnabled && !isInputReplaying()) {
+		initHotReload();
+	}
 
 	logMsg(loggerSystem, LOG_LEVEL_INFO, "Ready to play Pink Pearl!");
-	runApp();
+	if (isInputReplaying()) {
+		runReplay();
+	} else {
+		runApp();
+	}
+	
+	stopInputRecording(gameClockGetTickCount());
+	stopInputReplay();
 
+	terminateHotReload();
 	endGame();
+	terminate_entity_manager();
 	terminate_entity_registry();
-	terminate_portaudio();
+	terminate_audio_backend();
 	terminate_audio_mixer();
 	terminateRenderManager();
-	terminateGLFW();
+	if (!isRenderHeadless()) {
+		terminateGLFW();
+	}
+	terminateStringTable();
+	vfsUnmountArchives();
 
 	logMsg(loggerSystem, LOG_LEVEL_INFO, "Stopping Pink Pearl. Goodbye!");
 	return 0;
 }
 
-static void runApp(void) {
-	appRunning = true;
-	
-	static const double tickPerSecond = 20.0;	// ticks / s
-	static const double msPerTick = 1000.0 / tickPerSecond; // ms
-
-	uint64_t previousTime = getMilliseconds();	// ms
-	float tickDelta = 0.0F; // Unitless interpolation value
-
-	while (appRunning && !shouldAppWindowClose()) {
+// Reads runtime settings from the command line:
+// 	--archive <path>
+// 	--frames-in-flight <1-3>
+// 	--present-mode <fifo|fifo_relaxed|mailbox|immediate>
+// 	--room-render <stitched|tilemap>
+// 	--audio-latency <milliseconds>
+// 	--audio-backend <portaudio|null|wav>
+// 	--audio-output <path to WAV file>
+// 	--audio-rate <hertz>
+// 	--audio-resampler <linear|sinc>
+// 	--time-scale <factor>
+// 	--record-input <path>
+// 	--replay-input <path>
+// 	--validate-collision
+// 	--hot-reload
+static void parseArguments(const int argc, char *argv[]) {
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--archive") == 0 && i + 1 < argc) {
+			vfsMountArchive(argv[++i]);
+		} else if (strcmp(argv[i], "--frames-in-flight") == 0 && i + 1 < argc) {
+			const unsigned long int numFramesInFlight = strtoul(argv[++i], nullptr, 10);
+			setNumFramesInFlight((uint32_t)numFramesInFlight);
+		} else if (strcmp(argv[i], "--present-mode") == 0 && i + 1 < argc) {
+			PresentMode presentMode = PRESENT_MODE_FIFO;
+			if (parsePresentMode(argv[++i], &presentMode)) {
+				setPresentMode(presentMode);
+			} else {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Parsing arguments: unknown present mode \"%s\".", argv[i]);
+			}
+		} else if (strcmp(argv[i], "--room-render") == 0 && i + 1 < argc) {
+			RoomRenderMode roomRenderMode = ROOM_RENDER_MODE_STITCHED;
+			if (parseRoomRenderMode(argv[++i], &roomRenderMode)) {
+				setRoomRenderMode(roomRenderMode);
+			} else {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Parsing arguments: unknown room render mode \"%s\".", argv[i]);
+			}
+		} else if (strcmp(argv[i], "--audio-latency") == 0 && i + 1 < argc) {
+			const unsigned long int audioLatency = strtoul(argv[++i], nullptr, 10);
+			set_audio_target_latency((unsigned int)audioLatency);
+		} else if (strcmp(argv[i], "--audio-backend") == 0 && i + 1 < argc) {
+			AudioBackendType audioBackend = AUDIO_BACKEND_PORTAUDIO;
+			if (parse_audio_backend(argv[++i], &audioBackend)) {
+				set_audio_backend(audioBackend);
+			} else {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Parsing arguments: unknown audio backend \"%s\".", argv[i]);
+			}
+		} else if (strcmp(argv[i], "--audio-output") == 0 && i + 1 < argc) {
+			set_audio_output_path(argv[++i]);
+		} else if (strcmp(argv[i], "--audio-rate") == 0 && i + 1 < argc) {
+			const unsigned long int audioSampleRate = strtoul(argv[++i], nullptr, 10);
+			set_audio_sample_rate((unsigned int)audioSampleRate);
+		} else if (strcmp(argv[i], "--audio-resampler") == 0 && i + 1 < argc) {
+			AudioResampleQuality audioResampleQuality = AUDIO_RESAMPLE_SINC;
+			if (parse_audio_resample_quality(argv[++i], &audioResampleQuality)) {
+				set_audio_resample_quality(audioResampleQuality);
+			} else {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Parsing arguments: unknown audio resampler \"%s\".", argv[i]);
+			}
+		} else if (strcmp(argv[i], "--time-scale") == 0 && i + 1 < argc) {
+			const double timeScale = strtod(argv[++i], nullptr);
+			gameClockSetTimeScale(timeScale);
+		} else if (strcmp(argv[i], "--record-input") == 0 && i + 1 < argc) {
+			pInputRecordingPath = argv[++i];
+		} else if (strcmp(argv[i], "--replay-input") == 0 && i + 1 < argc) {
+			pInputReplayPath = argv[++i];
+		} else if (strcmp(argv[i], "--validate-collision") == 0) {
+			setCollisionValidation(true);
+		} else if (strcmp(argv[i], "--hot-reload") == 0) {
+			hotReloadEnabled = true;
+		} else {
+			logMsg(loggerSystem, LOG_LEVEL_WARNING, "Parsing arguments: ignoring unrecognized argument \"%s\".", argv[i]);
+		}
+	}
+}
 
-		const uint64_t currentTime = getMilliseconds();	// ms
-		const uint64_t deltaTime = currentTime - previousTime;	// ms
-		previousTime = currentTime;
-		tickDelta += (float)(deltaTime / msPerTick);
+// Applies the tick's changes to render objects, and publishes the state the render thread needs to draw the game as of the current tick.
+static void publishGameRenderState(void) {
+	flushRenderCommands();
+	const GameState gameState = getGameState();
+	publishRenderState(areaGetCameraPosition(&currentArea), areaGetProjectionBounds(currentArea), !gameState.paused && !gameState.scrolling);
+}
 
-		while (tickDelta >= 1.0F) {
+// Runs game ticks on the simulation thread until the app stops, sleeping between ticks.
+// Ticks only change CPU-side render state; GPU work they need is queued and handed to the render thread with the published snapshot.
+static void *runSimulation(void *pArg) {
+	(void)pArg;
+	
+	while (atomic_load(&appRunning)) {
+		gameClockBeginFrame();
+		
+		while (gameClockNextTick()) {
+			inputManagerBeginTick(gameClockGetTickCount());
 			tick_game();
-			tickDelta -= 1.0F;
+			publishGameRenderState();
 		}
+		
+		// Resources are only swapped between ticks, so that no tick sees a half-reloaded resource.
+		serviceHotReload();
+		
+		sleepNanoseconds(gameClockGetTimeUntilNextTickNS());
+	}
+	return nullptr;
+}
 
-		if (appRunning && !shouldAppWindowClose()) {
-			const GameState gameState = getGameState();
-			renderFrame(tickDelta, areaGetCameraPosition(&currentArea), areaGetProjectionBounds(currentArea), !gameState.paused && !gameState.scrolling);
-		} else {
-			break;
+// Runs the simulation on its own thread, and draws frames on the main thread, which also handles window events.
+// The threads share no lock: each tick only hands off a snapshot and the render tasks it queued, and all GPU work runs on the render thread,
+// 	so a slow frame does not delay ticks, and a slow tick does not stall frames, which keep drawing the latest published snapshot.
+static void runApp(void) {
+	initGameClock();
+	publishGameRenderState();
+	
+	atomic_store(&appRunning, true);
+	pthread_t simulationThread;
+	const int threadCreateResult = pthread_create(&simulationThread, nullptr, runSimulation, nullptr);
+	if (threadCreateResult != 0) {
+		logMsg(loggerSystem, LOG_LEVEL_FATAL, "Running app: failed to create simulation thread (error code: %i).", threadCreateResult);
+		atomic_store(&appRunning, false);
+		return;
+	}
+
+	while (atomic_load(&appRunning) && !shouldAppWindowClose()) {
+		inputManagerPollEvents();
+		renderFrame();
+	}
+	
+	atomic_store(&appRunning, false);
+	const int threadJoinResult = pthread_join(simulationThread, nullptr);
+	if (threadJoinResult != 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Running app: failed to join simulation thread (error code: %i).", threadJoinResult);
+	}
+}
+
+// Runs the ticks of a recorded session back to back with the recorded input, and reports how long the simulation took.
+// The renderer is headless, so the render commands of each tick are dropped instead of being applied to models that are never drawn.
+static void runReplay(void) {
+	initGameClock();
+	const uint64_t startTimeNS = getNanoseconds();
+	
+	while (!isInputReplayFinished()) {
+		gameClockStep();
+		while (gameClockNextTick()) {
+			inputManagerBeginTick(gameClockGetTickCount());
+			tick_game();
+			dropRenderCommands();
 		}
 	}
 	
-	appRunning = false;
-}
\ No newline at end of file
+	const uint64_t elapsedTimeNS = getNanoseconds() - startTimeNS;
+	const uint64_t tickCount = gameClockGetTickCount();
+	logMsg(loggerSystem, LOG_LEVEL_INFO, "Replayed %llu ticks in %.3f ms (%.3f ms per tick).", 
+			(unsigned long long)tickCount, (double)elapsedTimeNS / 1.0e6, tickCount > 0 ? (double)elapsedTimeNS / 1.0e6 / (double)tickCount : 0.0);
+}
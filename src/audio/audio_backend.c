@@ -0,0 +1,73 @@
+#include "audio_backend.h"
+
+#include "log/Logger.h"
+#include "null/null_audio_output.h"
+#include "portaudio/portaudio_manager.h"
+#include "wav/wav_audio_output.h"
+
+static bool audio_backend_running = false;
+static AudioBackendType running_audio_backend = AUDIO_BACKEND_NULL;
+
+static bool open_audio_backend(const AudioBackendType backend_type) {
+	switch (backend_type) {
+		case AUDIO_BACKEND_PORTAUDIO: return init_portaudio();
+		case AUDIO_BACKEND_NULL: return init_null_audio_output();
+		case AUDIO_BACKEND_WAV_FILE: return init_wav_audio_output(get_audio_output_path());
+	}
+	return false;
+}
+
+bool init_audio_backend(void) {
+	AudioBackendType backend_type = get_audio_backend();
+	bool opened = open_audio_backend(backend_type);
+	if (!opened && backend_type == AUDIO_BACKEND_PORTAUDIO) {
+		logMsg(loggerAudio, LOG_LEVEL_WARNING, "Initializing audio backend: PortAudio could not be opened; falling back to null audio output.");
+		backend_type = AUDIO_BACKEND_NULL;
+		opened = open_audio_backend(backend_type);
+	}
+	
+	if (!opened) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error initializing audio backend: no audio backend could be opened.");
+		return false;
+	}
+	
+	audio_backend_running = true;
+	running_audio_backend = backend_type;
+	return true;
+}
+
+bool start_audio_backend(void) {
+	if (!audio_backend_running) {
+		return false;
+	}
+	
+	switch (running_audio_backend) {
+		case AUDIO_BACKEND_PORTAUDIO: return start_portaudio();
+		case AUDIO_BACKEND_NULL: return start_null_audio_output();
+		case AUDIO_BACKEND_WAV_FILE: return start_wav_audio_output();
+	}
+	return false;
+}
+
+void terminate_audio_backend(void) {
+	if (!audio_backend_running) {
+		return;
+	}
+	
+	switch (running_audio_backend) {
+		case AUDIO_BACKEND_PORTAUDIO: 
+			terminate_portaudio();
+			break;
+		case AUDIO_BACKEND_NULL: 
+			terminate_null_audio_output();
+			break;
+		case AUDIO_BACKEND_WAV_FILE: 
+			terminate_wav_audio_output();
+			break;
+	}
+	audio_backend_running = false;
+}
+
+AudioBackendType get_running_audio_backend(void) {
+	return running_audio_backend;
+}
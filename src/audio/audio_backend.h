@@ -0,0 +1,24 @@
+#ifndef AUDIO_BACKEND_H
+#define AUDIO_BACKEND_H
+
+#include <stdbool.h>
+
+#include "audio_config.h"
+
+// Opens the audio backend chosen in the audio config, which reads mixed buffers from the audio mixer once started.
+// If PortAudio cannot be opened, falls back to the null backend so that the game still runs at the right pace.
+// The backend may change the audio sample rate setting, so call before the audio mixer is initialized.
+// Returns true if a backend was opened, false otherwise.
+bool init_audio_backend(void);
+
+// Starts reading from the audio mixer; call after the audio mixer is initialized.
+// Returns true if the backend was started, false otherwise.
+bool start_audio_backend(void);
+
+// Stops the running audio backend. Call before the audio mixer is terminated.
+void terminate_audio_backend(void);
+
+// Returns the type of the running audio backend.
+AudioBackendType get_running_audio_backend(void);
+
+#endif	// AUDIO_BACKEND_H
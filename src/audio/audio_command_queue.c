@@ -0,0 +1,42 @@
+#include "audio_command_queue.h"
+
+#include <assert.h>
+
+void init_audio_command_queue(AudioCommandQueue *const pQueue) {
+	assert(pQueue);
+	atomic_init(&pQueue->head, 0);
+	atomic_init(&pQueue->tail, 0);
+}
+
+bool audio_command_queue_push(AudioCommandQueue *const pQueue, const AudioCommand command) {
+	assert(pQueue);
+	
+	const size_t tail = atomic_load_explicit(&pQueue->tail, memory_order_relaxed);
+	const size_t head = atomic_load_explicit(&pQueue->head, memory_order_acquire);
+	if (tail - head >= AUDIO_COMMAND_QUEUE_CAPACITY) {
+		return false;
+	}
+	
+	pQueue->commands[tail % AUDIO_COMMAND_QUEUE_CAPACITY] = command;
+	
+	// Publish the command only after it has been written.
+	atomic_store_explicit(&pQueue->tail, tail + 1, memory_order_release);
+	return true;
+}
+
+bool audio_command_queue_pop(AudioCommandQueue *const pQueue, AudioCommand *const pOutCommand) {
+	assert(pQueue);
+	assert(pOutCommand);
+	
+	const size_t head = atomic_load_explicit(&pQueue->head, memory_order_relaxed);
+	const size_t tail = atomic_load_explicit(&pQueue->tail, memory_order_acquire);
+	if (head == tail) {
+		return false;
+	}
+	
+	*pOutCommand = pQueue->commands[head % AUDIO_COMMAND_QUEUE_CAPACITY];
+	
+	// Free the command's slot only after it has been read.
+	atomic_store_explicit(&pQueue->head, head + 1, memory_order_release);
+	return true;
+}
@@ -0,0 +1,55 @@
+#ifndef AUDIO_COMMAND_QUEUE_H
+#define AUDIO_COMMAND_QUEUE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "audio_voice.h"
+
+#define AUDIO_COMMAND_QUEUE_CAPACITY 256
+
+typedef enum AudioCommandType {
+	AUDIO_COMMAND_PLAY,
+	AUDIO_COMMAND_STOP,
+	AUDIO_COMMAND_SET_GAIN,
+	AUDIO_COMMAND_SET_PAN
+} AudioCommandType;
+
+typedef struct AudioCommand {
+	
+	AudioCommandType type;
+	
+	// The voice to start or change.
+	uint32_t voice_id;
+	
+	// The sound to play; only used by play commands.
+	int32_t sound_handle;
+	
+	// The parameters of a new voice, or the new gain or pan of an existing voice.
+	AudioVoiceParams params;
+	
+} AudioCommand;
+
+// Lock-free queue of commands from a single producer thread (the game thread) to a single consumer thread (the mixer thread).
+typedef struct AudioCommandQueue {
+	
+	AudioCommand commands[AUDIO_COMMAND_QUEUE_CAPACITY];
+	
+	// Position of the next command to pop; only written by the consumer.
+	atomic_size_t head;
+	
+	// Position of the next command to push; only written by the producer.
+	atomic_size_t tail;
+	
+} AudioCommandQueue;
+
+void init_audio_command_queue(AudioCommandQueue *const pQueue);
+
+// Call on producer thread. Returns false if the queue is full.
+bool audio_command_queue_push(AudioCommandQueue *const pQueue, const AudioCommand command);
+
+// Call on consumer thread. Returns false if the queue is empty.
+bool audio_command_queue_pop(AudioCommandQueue *const pQueue, AudioCommand *const pOutCommand);
+
+#endif	// AUDIO_COMMAND_QUEUE_H
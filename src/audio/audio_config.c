@@ -1,5 +1,113 @@
 #include "audio_config.h"
 
+#include <string.h>
+
+#include "log/Logger.h"
+
 const unsigned int num_audio_channels = NUM_AUDIO_CHANNELS;
 const size_t num_audio_frames_per_buffer = NUM_AUDIO_FRAMES_PER_BUFFER;
-const size_t audio_buffer_length = AUDIO_BUFFER_LENGTH;
\ No newline at end of file
+const size_t audio_buffer_length = AUDIO_BUFFER_LENGTH;
+const unsigned int audio_sample_rate = AUDIO_SAMPLE_RATE;
+
+static unsigned int audio_target_latency_setting = DEFAULT_AUDIO_TARGET_LATENCY_MS;
+static unsigned int audio_sample_rate_setting = AUDIO_SAMPLE_RATE;
+static AudioResampleQuality audio_resample_quality_setting = AUDIO_RESAMPLE_SINC;
+static AudioBackendType audio_backend_setting = AUDIO_BACKEND_PORTAUDIO;
+static char audio_output_path_setting[256] = DEFAULT_AUDIO_OUTPUT_PATH;
+
+bool set_audio_target_latency(const unsigned int latency_ms) {
+	if (latency_ms < 1 || latency_ms > MAX_AUDIO_TARGET_LATENCY_MS) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Setting audio target latency: %u ms is out of range (must be between 1 and %u).", latency_ms, MAX_AUDIO_TARGET_LATENCY_MS);
+		return false;
+	}
+	audio_target_latency_setting = latency_ms;
+	return true;
+}
+
+unsigned int get_audio_target_latency(void) {
+	return audio_target_latency_setting;
+}
+
+unsigned int get_audio_target_buffer_count(void) {
+	const size_t latency_frames = (size_t)audio_target_latency_setting * audio_sample_rate_setting / 1000;
+	const size_t buffer_count = (latency_frames + NUM_AUDIO_FRAMES_PER_BUFFER - 1) / NUM_AUDIO_FRAMES_PER_BUFFER;
+	return buffer_count > 0 ? (unsigned int)buffer_count : 1;
+}
+
+bool set_audio_sample_rate(const unsigned int sample_rate) {
+	if (sample_rate < MIN_AUDIO_SAMPLE_RATE || sample_rate > MAX_AUDIO_SAMPLE_RATE) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Setting audio sample rate: %u Hz is out of range (must be between %u and %u).", sample_rate, MIN_AUDIO_SAMPLE_RATE, MAX_AUDIO_SAMPLE_RATE);
+		return false;
+	}
+	audio_sample_rate_setting = sample_rate;
+	return true;
+}
+
+unsigned int get_audio_sample_rate(void) {
+	return audio_sample_rate_setting;
+}
+
+void set_audio_resample_quality(const AudioResampleQuality quality) {
+	audio_resample_quality_setting = quality;
+}
+
+AudioResampleQuality get_audio_resample_quality(void) {
+	return audio_resample_quality_setting;
+}
+
+bool parse_audio_resample_quality(const char *const name, AudioResampleQuality *const pQuality) {
+	if (!name || !pQuality) {
+		return false;
+	}
+	
+	if (strcmp(name, "linear") == 0) {
+		*pQuality = AUDIO_RESAMPLE_LINEAR;
+		return true;
+	} else if (strcmp(name, "sinc") == 0) {
+		*pQuality = AUDIO_RESAMPLE_SINC;
+		return true;
+	}
+	return false;
+}
+
+void set_audio_backend(const AudioBackendType backend_type) {
+	audio_backend_setting = backend_type;
+}
+
+AudioBackendType get_audio_backend(void) {
+	return audio_backend_setting;
+}
+
+bool parse_audio_backend(const char *const name, AudioBackendType *const pBackendType) {
+	if (!name || !pBackendType) {
+		return false;
+	}
+	
+	if (strcmp(name, "portaudio") == 0) {
+		*pBackendType = AUDIO_BACKEND_PORTAUDIO;
+		return true;
+	} else if (strcmp(name, "null") == 0) {
+		*pBackendType = AUDIO_BACKEND_NULL;
+		return true;
+	} else if (strcmp(name, "wav") == 0) {
+		*pBackendType = AUDIO_BACKEND_WAV_FILE;
+		return true;
+	}
+	return false;
+}
+
+bool set_audio_output_path(const char *const path) {
+	if (!path || path[0] == '\0') {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Setting audio output path: path is null or empty.");
+		return false;
+	} else if (strlen(path) >= sizeof(audio_output_path_setting)) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Setting audio output path: path is longer than %zu characters.", sizeof(audio_output_path_setting) - 1);
+		return false;
+	}
+	strcpy(audio_output_path_setting, path);
+	return true;
+}
+
+const char *get_audio_output_path(void) {
+	return audio_output_path_setting;
+}
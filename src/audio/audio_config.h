@@ -12,4 +12,86 @@ extern const size_t num_audio_frames_per_buffer;
 #define AUDIO_BUFFER_LENGTH (NUM_AUDIO_CHANNELS * NUM_AUDIO_FRAMES_PER_BUFFER)
 extern const size_t audio_buffer_length;
 
-#endif	// AUDIO_CONFIG_H
\ No newline at end of file
+// The sample rate at which the mixer runs unless another is set, or the output device refuses it.
+#define AUDIO_SAMPLE_RATE 44100
+extern const unsigned int audio_sample_rate;
+
+#define MIN_AUDIO_SAMPLE_RATE 8000
+#define MAX_AUDIO_SAMPLE_RATE 192000
+
+// The default amount of mixed audio, in milliseconds, kept queued ahead of the output device.
+#define DEFAULT_AUDIO_TARGET_LATENCY_MS 200
+
+#define MAX_AUDIO_TARGET_LATENCY_MS 2000
+
+// The file to which the WAV file backend writes if no other file is set.
+#define DEFAULT_AUDIO_OUTPUT_PATH "audio_output.wav"
+
+// Where mixed audio is sent once it leaves the mixer's queue.
+typedef enum AudioBackendType {
+	
+	// Plays audio on the default output device.
+	AUDIO_BACKEND_PORTAUDIO,
+	
+	// Discards audio at the rate a device would play it, for running without an audio device.
+	AUDIO_BACKEND_NULL,
+	
+	// Writes every mixed buffer to a WAV file, as fast as the mixer produces them.
+	AUDIO_BACKEND_WAV_FILE
+	
+} AudioBackendType;
+
+// How sounds whose sample rate differs from the output sample rate are converted.
+typedef enum AudioResampleQuality {
+	
+	// Interpolates linearly between neighbouring frames; cheap, but dulls high frequencies and lets some aliasing through.
+	AUDIO_RESAMPLE_LINEAR,
+	
+	// Filters with a windowed-sinc kernel read from a precomputed polyphase table.
+	AUDIO_RESAMPLE_SINC
+	
+} AudioResampleQuality;
+
+/* -- Runtime Audio Settings -- */
+
+// Sets the amount of mixed audio, in milliseconds, that the mixer keeps queued ahead of the output device.
+// Lower latencies make sounds respond sooner, but leave less room for the mixer to fall behind.
+// Returns true if the setting was accepted, false otherwise.
+bool set_audio_target_latency(const unsigned int latency_ms);
+
+unsigned int get_audio_target_latency(void);
+
+// Returns the number of mixed buffers needed to cover the target latency, which is at least one.
+// The mixer wakes up to refill the queue whenever fewer buffers than this are queued.
+unsigned int get_audio_target_buffer_count(void);
+
+// Sets the sample rate of the mixed output. Sounds at other sample rates are resampled while they are mixed.
+// Audio backends may replace this setting with a rate that the output device supports.
+// Returns true if the setting was accepted, false otherwise.
+bool set_audio_sample_rate(const unsigned int sample_rate);
+
+unsigned int get_audio_sample_rate(void);
+
+void set_audio_resample_quality(const AudioResampleQuality quality);
+
+AudioResampleQuality get_audio_resample_quality(void);
+
+// Converts the name of a resample quality (e.g. "sinc") into its value.
+// Returns true if the name was recognized, false otherwise.
+bool parse_audio_resample_quality(const char *const name, AudioResampleQuality *const pQuality);
+
+void set_audio_backend(const AudioBackendType backend_type);
+
+AudioBackendType get_audio_backend(void);
+
+// Converts the name of an audio backend (e.g. "null") into its type.
+// Returns true if the name was recognized, false otherwise.
+bool parse_audio_backend(const char *const name, AudioBackendType *const pBackendType);
+
+// Sets the file to which the WAV file backend writes; the string is copied.
+// Returns true if the setting was accepted, false otherwise.
+bool set_audio_output_path(const char *const path);
+
+const char *get_audio_output_path(void);
+
+#endif	// AUDIO_CONFIG_H
@@ -1,13 +1,67 @@
 #include "audio_loader.h"
 
 #include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
 #define DR_WAV_IMPLEMENTATION
 #include <dr_audio/dr_wav.h>
-#include "config.h"
+
 #include "log/Logger.h"
 #include "util/Allocation.h"
+#include "util/VirtualFileSystem.h"
+
+#define AUDIO_DIRECTORY "assets/audio/"
 
-#define AUDIO_PATH (RESOURCE_PATH "assets/audio/music/demo_dungeon.wav")
+#define AUDIO_PATH_MAX_LENGTH 256
+
+struct AudioStream_T {
+	
+	// The encoded file, which the decoder reads from piece by piece as it decodes.
+	VFSStream file;
+	drwav decoder;
+	
+	unsigned int num_channels;
+	unsigned int sample_rate;
+	
+	// Total number of frames in the file.
+	size_t num_frames;
+	
+	bool loop;
+	size_t loop_frame;
+	
+	// Set when the decoder reaches the end of a non-looping file.
+	bool end_of_file;
+	
+	// Ring buffer of decoded frames, holding up to AUDIO_STREAM_DECODE_AHEAD_FRAMES frames.
+	AudioSample *pDecodedSamples;
+	size_t read_frame;
+	size_t num_decoded_frames;
+	
+};
+
+// Writes the full path of an audio file into pPath; returns false if the path is too long.
+static bool make_audio_path(const char *const filename, char pPath[static AUDIO_PATH_MAX_LENGTH]) {
+	const int path_length = snprintf(pPath, AUDIO_PATH_MAX_LENGTH, "%s%s", AUDIO_DIRECTORY, filename);
+	return path_length > 0 && path_length < AUDIO_PATH_MAX_LENGTH;
+}
+
+static size_t read_audio_file(void *pUserData, void *pBufferOut, size_t bytesToRead) {
+	return vfsStreamRead(pUserData, pBufferOut, bytesToRead);
+}
+
+static drwav_bool32 seek_audio_file(void *pUserData, int offset, drwav_seek_origin origin) {
+	VFSStream *const pFile = pUserData;
+	if (origin == drwav_seek_origin_start) {
+		return offset >= 0 && vfsStreamSeek(pFile, (size_t)offset);
+	} else if (origin == drwav_seek_origin_current) {
+		if (offset < 0 && (size_t)-(int64_t)offset > pFile->position) {
+			return false;
+		}
+		return vfsStreamSeek(pFile, offset < 0 ? pFile->position - (size_t)-(int64_t)offset : pFile->position + (size_t)offset);
+	}
+	return false;
+}
 
 AudioData load_audio_file(const char *const filename) {
 	
@@ -17,7 +71,19 @@ AudioData load_audio_file(const char *const filename) {
 		return audio_data;
 	}
 	
-	audio_data.samples = drwav_open_file_and_read_pcm_frames_f32(AUDIO_PATH, &audio_data.num_channels, &audio_data.sample_rate, (drwav_uint64 *)&audio_data.num_samples, nullptr);
+	char path[AUDIO_PATH_MAX_LENGTH];
+	if (!make_audio_path(filename, path)) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error loading audio file \"%s\": path is too long.", filename);
+		return audio_data;
+	}
+	
+	VFSFile file = { };
+	if (!vfsReadFile(path, &file)) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error loading audio file \"%s\": failed to read file.", filename);
+		return audio_data;
+	}
+	audio_data.samples = drwav_open_memory_and_read_pcm_frames_f32(file.pData, file.size, &audio_data.num_channels, &audio_data.sample_rate, (drwav_uint64 *)&audio_data.num_samples, nullptr);
+	vfsCloseFile(&file);
 	
 	if (!audio_data.samples) {
 		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error loading audio file \"%s\": samples is null.", filename);
@@ -36,3 +102,167 @@ void unload_audio_file(AudioData *const pAudioData) {
 	pAudioData->num_samples = 0;
 	pAudioData->samples = nullptr;
 }
+
+AudioStream open_audio_stream(const char *const filename, const bool loop) {
+	if (!filename) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error opening audio stream: filename is null.");
+		return nullptr;
+	}
+	
+	char path[AUDIO_PATH_MAX_LENGTH];
+	if (!make_audio_path(filename, path)) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error opening audio stream \"%s\": path is too long.", filename);
+		return nullptr;
+	}
+	
+	AudioStream audio_stream = heapAlloc(1, sizeof(struct AudioStream_T));
+	if (!audio_stream) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error opening audio stream \"%s\": failed to allocate stream object.", filename);
+		return nullptr;
+	}
+	
+	// The file is read from disk as it is decoded, so only the decode-ahead window is kept in memory.
+	if (!vfsOpenStream(path, &audio_stream->file)) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error opening audio stream \"%s\": failed to open file.", filename);
+		heapFree(audio_stream);
+		return nullptr;
+	}
+	
+	if (!drwav_init(&audio_stream->decoder, read_audio_file, seek_audio_file, &audio_stream->file, nullptr)) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error opening audio stream \"%s\": failed to open decoder.", filename);
+		vfsCloseStream(&audio_stream->file);
+		heapFree(audio_stream);
+		return nullptr;
+	}
+	
+	audio_stream->num_channels = audio_stream->decoder.channels;
+	audio_stream->sample_rate = audio_stream->decoder.sampleRate;
+	audio_stream->num_frames = (size_t)audio_stream->decoder.totalPCMFrameCount;
+	if (audio_stream->num_channels == 0 || audio_stream->num_frames == 0) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error opening audio stream \"%s\": file has no audio.", filename);
+		drwav_uninit(&audio_stream->decoder);
+		vfsCloseStream(&audio_stream->file);
+		heapFree(audio_stream);
+		return nullptr;
+	}
+	
+	audio_stream->loop = loop;
+	audio_stream->loop_frame = 0;
+	audio_stream->end_of_file = false;
+	audio_stream->read_frame = 0;
+	audio_stream->num_decoded_frames = 0;
+	
+	audio_stream->pDecodedSamples = heapAlloc(AUDIO_STREAM_DECODE_AHEAD_FRAMES * audio_stream->num_channels, sizeof(AudioSample));
+	if (!audio_stream->pDecodedSamples) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error opening audio stream \"%s\": failed to allocate decode buffer.", filename);
+		drwav_uninit(&audio_stream->decoder);
+		vfsCloseStream(&audio_stream->file);
+		heapFree(audio_stream);
+		return nullptr;
+	}
+	
+	// Decode the first window up front so that playback can start immediately.
+	audio_stream_decode_ahead(audio_stream);
+	
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Opened audio stream \"%s\" (%u channel(s), %u Hz, %zu frames).", filename, audio_stream->num_channels, audio_stream->sample_rate, audio_stream->num_frames);
+	return audio_stream;
+}
+
+void close_audio_stream(AudioStream *const pAudioStream) {
+	if (!pAudioStream || !*pAudioStream) {
+		return;
+	}
+	
+	drwav_uninit(&(*pAudioStream)->decoder);
+	vfsCloseStream(&(*pAudioStream)->file);
+	heapFree((*pAudioStream)->pDecodedSamples);
+	heapFree(*pAudioStream);
+	*pAudioStream = nullptr;
+}
+
+unsigned int audio_stream_num_channels(const AudioStream audio_stream) {
+	return audio_stream ? audio_stream->num_channels : 0;
+}
+
+unsigned int audio_stream_sample_rate(const AudioStream audio_stream) {
+	return audio_stream ? audio_stream->sample_rate : 0;
+}
+
+void audio_stream_set_loop_point(AudioStream audio_stream, const size_t loop_frame) {
+	if (!audio_stream) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error setting audio stream loop point: stream is null.");
+		return;
+	} else if (loop_frame >= audio_stream->num_frames) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error setting audio stream loop point: frame %zu is past the end of the stream (%zu frames).", loop_frame, audio_stream->num_frames);
+		return;
+	}
+	audio_stream->loop_frame = loop_frame;
+}
+
+size_t audio_stream_decode_ahead(AudioStream audio_stream) {
+	if (!audio_stream) {
+		return 0;
+	}
+	
+	size_t num_frames_decoded = 0;
+	bool seeked_without_progress = false;
+	while (audio_stream->num_decoded_frames < AUDIO_STREAM_DECODE_AHEAD_FRAMES && !audio_stream->end_of_file) {
+		
+		// Decode into the contiguous free space after the last decoded frame.
+		const size_t write_frame = (audio_stream->read_frame + audio_stream->num_decoded_frames) % AUDIO_STREAM_DECODE_AHEAD_FRAMES;
+		const size_t num_free_frames = AUDIO_STREAM_DECODE_AHEAD_FRAMES - audio_stream->num_decoded_frames;
+		const size_t num_contiguous_frames = AUDIO_STREAM_DECODE_AHEAD_FRAMES - write_frame;
+		const size_t num_frames_to_decode = num_free_frames < num_contiguous_frames ? num_free_frames : num_contiguous_frames;
+		
+		AudioSample *const pWrite = &audio_stream->pDecodedSamples[write_frame * audio_stream->num_channels];
+		const size_t num_frames_read = (size_t)drwav_read_pcm_frames_f32(&audio_stream->decoder, num_frames_to_decode, pWrite);
+		audio_stream->num_decoded_frames += num_frames_read;
+		num_frames_decoded += num_frames_read;
+		
+		if (num_frames_read > 0) {
+			seeked_without_progress = false;
+		}
+		
+		if (num_frames_read < num_frames_to_decode) {
+			if (seeked_without_progress) {
+				// Nothing could be decoded even after seeking, so stop instead of seeking forever.
+				logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error decoding audio stream: no frames could be read after seeking to the loop point.");
+				audio_stream->end_of_file = true;
+			} else if (!audio_stream->loop || !drwav_seek_to_pcm_frame(&audio_stream->decoder, audio_stream->loop_frame)) {
+				audio_stream->end_of_file = true;
+			} else {
+				// Reached the end of the file and seeked back to the loop point, so the next frames continue seamlessly.
+				seeked_without_progress = true;
+			}
+		}
+	}
+	
+	return num_frames_decoded;
+}
+
+size_t audio_stream_read(AudioStream audio_stream, AudioSample *const pOut, const size_t num_frames) {
+	assert(pOut);
+	if (!audio_stream) {
+		memset(pOut, 0, num_frames * num_audio_channels * sizeof(AudioSample));
+		return 0;
+	}
+	
+	if (audio_stream->num_decoded_frames < num_frames) {
+		audio_stream_decode_ahead(audio_stream);
+	}
+	
+	const size_t num_channels = audio_stream->num_channels;
+	const size_t num_frames_read = audio_stream->num_decoded_frames < num_frames ? audio_stream->num_decoded_frames : num_frames;
+	
+	// Copy out of the ring buffer in at most two contiguous pieces.
+	const size_t num_contiguous_frames = AUDIO_STREAM_DECODE_AHEAD_FRAMES - audio_stream->read_frame;
+	const size_t num_first_frames = num_frames_read < num_contiguous_frames ? num_frames_read : num_contiguous_frames;
+	memcpy(pOut, &audio_stream->pDecodedSamples[audio_stream->read_frame * num_channels], num_first_frames * num_channels * sizeof(AudioSample));
+	memcpy(&pOut[num_first_frames * num_channels], audio_stream->pDecodedSamples, (num_frames_read - num_first_frames) * num_channels * sizeof(AudioSample));
+	memset(&pOut[num_frames_read * num_channels], 0, (num_frames - num_frames_read) * num_channels * sizeof(AudioSample));
+	
+	audio_stream->read_frame = (audio_stream->read_frame + num_frames_read) % AUDIO_STREAM_DECODE_AHEAD_FRAMES;
+	audio_stream->num_decoded_frames -= num_frames_read;
+	
+	return num_frames_read;
+}
@@ -3,12 +3,14 @@
 
 #include <stddef.h>
 
+#include "audio_config.h"
+
 typedef float AudioSample;
 
 typedef struct AudioData {
 	unsigned int num_channels;
 	unsigned int sample_rate;
-	size_t num_samples;
+	size_t num_samples;	// Number of frames, i.e. samples per channel.
 	AudioSample *samples;
 } AudioData;
 
@@ -18,8 +20,39 @@ typedef struct AudioTrack {
 	AudioData data;
 } AudioTrack;
 
+// Decodes an entire audio file into memory; the filename is relative to the audio asset directory.
 AudioData load_audio_file(const char *const filename);
 
 void unload_audio_file(AudioData *const pAudioData);
 
+// Number of frames an audio stream keeps decoded ahead of playback.
+#define AUDIO_STREAM_DECODE_AHEAD_FRAMES (4 * NUM_AUDIO_FRAMES_PER_BUFFER)
+
+// Handle to an audio file that is decoded incrementally during playback, instead of all at once.
+typedef struct AudioStream_T *AudioStream;
+
+// Opens an audio file for streaming; the filename is relative to the audio asset directory.
+// The encoded file is read whole through the virtual file system and kept in memory while the stream is open.
+// If loop is true, playback seeks back to the loop point (initially the first frame) when the end of the file is reached.
+// Returns null if the file could not be opened.
+AudioStream open_audio_stream(const char *const filename, const bool loop);
+
+void close_audio_stream(AudioStream *const pAudioStream);
+
+unsigned int audio_stream_num_channels(const AudioStream audio_stream);
+
+unsigned int audio_stream_sample_rate(const AudioStream audio_stream);
+
+// Sets the frame from which a looping stream restarts when it reaches the end of the file.
+void audio_stream_set_loop_point(AudioStream audio_stream, const size_t loop_frame);
+
+// Decodes frames until the stream's decode-ahead window is full or the end of a non-looping file is reached.
+// Returns the number of frames decoded.
+size_t audio_stream_decode_ahead(AudioStream audio_stream);
+
+// Reads decoded frames into pOut, decoding more frames first if the window holds too few.
+// Frames past the end of a non-looping file are filled with silence.
+// Returns the number of frames of audio read, not counting silence.
+size_t audio_stream_read(AudioStream audio_stream, AudioSample *const pOut, const size_t num_frames);
+
 #endif	// AUDIO_LOADER_H
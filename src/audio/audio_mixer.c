@@ -4,25 +4,74 @@
 #include <stddef.h>
 #include <string.h>
 #include <pthread.h>
+#include <time.h>
 #include "log/Logger.h"
+#include "audio_command_queue.h"
 
 static pthread_t audio_mixer_thread;
 static atomic_bool audio_mixer_running = false;
 
-// TODO - use mutexes.
-static AudioTrack background_music_track;
+// The mixer thread sleeps on this condition while enough mixed audio is queued,
+// 	and is woken by the audio output when the queue drops below the low-water mark.
+// The condition waits against the monotonic clock, so that changes to the wall clock do not stall or spin the mixer.
+static pthread_mutex_t audio_mixer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t audio_mixer_condition;
+
+// The number of queued buffers below which the mixer refills the queue; read from the audio config when the mixer starts.
+static unsigned int audio_mixer_low_water_mark = 1;
+
+// Decoded incrementally by the mixer thread, a window ahead of the mixed audio.
+static AudioStream music_stream = nullptr;
+
+// Music that is not at the output sample rate, or is not stereo, is mixed through a resampler.
+static bool music_resample = false;
+static AudioResampler music_resampler;
+static AudioSample music_source_frames[AUDIO_MAX_SOURCE_CHANNELS * AUDIO_RESAMPLER_MAX_INPUT_FRAMES];
 
 AudioQueue audio_mixer_queue;
 
+// The number of buffers the audio output asked for while the queue was empty.
+static atomic_uint audio_mixer_underrun_count = 0;
+
+// Sound effects are decoded fully into memory, since they are short and may be played many times at once.
+// Only written on the main thread; the mixer thread only reads sounds named by commands, which are published after loading.
+static AudioData sounds[AUDIO_MIXER_SOUND_COUNT];
+static int32_t sound_count = 0;
+
+// Commands from the game thread to start, stop or change voices.
+static AudioCommandQueue voice_command_queue;
+
+// The last voice ID given out by the game thread; zero is never used as an ID.
+static uint32_t last_voice_id = 0;
+
+// Only accessed on the mixer thread.
+static AudioVoice voices[AUDIO_MIXER_VOICE_COUNT];
+static uint64_t voice_start_count = 0;
+
 static void *audio_mixer_main(void *arg);
 static void audio_mixer_mix(void);
+static void audio_mixer_free_played_nodes(void);
 
 // Call on main thread.
 void init_audio_mixer(void) {
 	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Initializing audio mixer...");
 	
+	pthread_condattr_t condition_attributes;
+	pthread_condattr_init(&condition_attributes);
+	pthread_condattr_setclock(&condition_attributes, CLOCK_MONOTONIC);
+	pthread_cond_init(&audio_mixer_condition, &condition_attributes);
+	pthread_condattr_destroy(&condition_attributes);
+	
 	audio_mixer_queue = make_audio_queue();
-	audio_mixer_set_music_track(load_audio_file("demo_dungeon.wav"));
+	init_audio_command_queue(&voice_command_queue);
+	for (uint32_t i = 0; i < AUDIO_MIXER_VOICE_COUNT; ++i) {
+		voices[i] = (AudioVoice){ .id = 0 };
+	}
+	audio_mixer_set_music_stream(open_audio_stream("music/demo_dungeon.wav", true));
+	
+	audio_mixer_low_water_mark = get_audio_target_buffer_count();
+	atomic_store(&audio_mixer_running, true);
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Audio mixer target latency is %u ms (%u buffer(s)).", get_audio_target_latency(), audio_mixer_low_water_mark);
 	
 	const int thread_create_result = pthread_create(&audio_mixer_thread, nullptr, audio_mixer_main, nullptr);
 	if (thread_create_result != 0) {
@@ -37,66 +86,310 @@ void terminate_audio_mixer(void) {
 	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Terminating audio mixer...");
 	
 	atomic_store(&audio_mixer_running, false);
+	pthread_mutex_lock(&audio_mixer_mutex);
+	pthread_cond_signal(&audio_mixer_condition);
+	pthread_mutex_unlock(&audio_mixer_mutex);
 	const int thread_join_result = pthread_join(audio_mixer_thread, nullptr);
 	if (thread_join_result != 0) {
 		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error terminating audio mixer: thread joining returned with code %i.", thread_join_result);
 	}
+	pthread_cond_destroy(&audio_mixer_condition);
 	
 	destroy_audio_queue(&audio_mixer_queue);
-	unload_audio_file(&background_music_track.data);
+	close_audio_stream(&music_stream);
+	for (int32_t i = 0; i < sound_count; ++i) {
+		unload_audio_file(&sounds[i]);
+	}
+	sound_count = 0;
 	
 	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Done terminating audio mixer.");
 }
 
-void audio_mixer_set_music_track(const AudioData audio_data) {
-	background_music_track.data = audio_data;
-	background_music_track.loop = true;
-	background_music_track.current_position = 0;
+void audio_mixer_set_music_stream(AudioStream audio_stream) {
+	if (audio_stream) {
+		const unsigned int num_channels = audio_stream_num_channels(audio_stream);
+		const unsigned int sample_rate = audio_stream_sample_rate(audio_stream);
+		const unsigned int output_rate = get_audio_sample_rate();
+		if (num_channels > AUDIO_MAX_SOURCE_CHANNELS) {
+			logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error setting music stream: stream has %u channels, but at most %u are supported.", num_channels, AUDIO_MAX_SOURCE_CHANNELS);
+			close_audio_stream(&audio_stream);
+			return;
+		}
+		
+		music_resample = sample_rate != output_rate || num_channels != num_audio_channels;
+		if (music_resample && !audio_resampler_reset(&music_resampler, get_audio_resample_quality(), sample_rate, output_rate)) {
+			close_audio_stream(&audio_stream);
+			return;
+		}
+	}
+	close_audio_stream(&music_stream);
+	music_stream = audio_stream;
 }
 
-static void *audio_mixer_main(void *arg) {
-	(void)arg;
-	atomic_store(&audio_mixer_running, true);
-	while (atomic_load(&audio_mixer_running)) {
-		audio_mixer_mix();
+int32_t audio_mixer_load_sound(const char *const filename) {
+	if (sound_count >= AUDIO_MIXER_SOUND_COUNT) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error loading sound \"%s\": no more than %i sounds can be loaded.", filename, AUDIO_MIXER_SOUND_COUNT);
+		return -1;
+	}
+	
+	AudioData sound = load_audio_file(filename);
+	if (!sound.samples || sound.num_samples == 0) {
+		unload_audio_file(&sound);
+		return -1;
+	} else if (sound.num_channels > AUDIO_MAX_SOURCE_CHANNELS) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error loading sound \"%s\": sound has %u channels, but at most %u are supported.", filename, sound.num_channels, AUDIO_MAX_SOURCE_CHANNELS);
+		unload_audio_file(&sound);
+		return -1;
+	} else if (sound.sample_rate > AUDIO_RESAMPLER_MAX_RATIO * get_audio_sample_rate()) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error loading sound \"%s\": sample rate of %u Hz is too high to resample to %u Hz.", filename, sound.sample_rate, get_audio_sample_rate());
+		unload_audio_file(&sound);
+		return -1;
+	}
+	
+	const int32_t sound_handle = sound_count;
+	sounds[sound_handle] = sound;
+	sound_count += 1;
+	return sound_handle;
+}
+
+uint32_t audio_mixer_play_sound(const int32_t sound_handle, const AudioVoiceParams params) {
+	if (sound_handle < 0 || sound_handle >= sound_count) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error playing sound: sound handle %i is invalid.", sound_handle);
+		return 0;
+	}
+	
+	last_voice_id += 1;
+	if (last_voice_id == 0) {
+		last_voice_id = 1;
+	}
+	
+	const AudioCommand command = {
+		.type = AUDIO_COMMAND_PLAY,
+		.voice_id = last_voice_id,
+		.sound_handle = sound_handle,
+		.params = params
+	};
+	if (!audio_command_queue_push(&voice_command_queue, command)) {
+		logMsg(loggerAudio, LOG_LEVEL_WARNING, "Warning playing sound: voice command queue is full.");
+		return 0;
+	}
+	return last_voice_id;
+}
+
+void audio_mixer_stop_voice(const uint32_t voice_id) {
+	const AudioCommand command = {
+		.type = AUDIO_COMMAND_STOP,
+		.voice_id = voice_id
+	};
+	if (!audio_command_queue_push(&voice_command_queue, command)) {
+		logMsg(loggerAudio, LOG_LEVEL_WARNING, "Warning stopping voice: voice command queue is full.");
+	}
+}
+
+void audio_mixer_set_voice_gain(const uint32_t voice_id, const float gain) {
+	const AudioCommand command = {
+		.type = AUDIO_COMMAND_SET_GAIN,
+		.voice_id = voice_id,
+		.params.gain = gain
+	};
+	if (!audio_command_queue_push(&voice_command_queue, command)) {
+		logMsg(loggerAudio, LOG_LEVEL_WARNING, "Warning setting voice gain: voice command queue is full.");
+	}
+}
+
+void audio_mixer_set_voice_pan(const uint32_t voice_id, const float pan) {
+	const AudioCommand command = {
+		.type = AUDIO_COMMAND_SET_PAN,
+		.voice_id = voice_id,
+		.params.pan = pan
+	};
+	if (!audio_command_queue_push(&voice_command_queue, command)) {
+		logMsg(loggerAudio, LOG_LEVEL_WARNING, "Warning setting voice pan: voice command queue is full.");
+	}
+}
+
+// Returns the active voice with the given ID, or null if the voice has finished or was stolen.
+static AudioVoice *find_voice(const uint32_t voice_id) {
+	if (voice_id == 0) {
+		return nullptr;
+	}
+	for (uint32_t i = 0; i < AUDIO_MIXER_VOICE_COUNT; ++i) {
+		if (voices[i].id == voice_id) {
+			return &voices[i];
+		}
 	}
 	return nullptr;
 }
 
-static void audio_mixer_mix(void) {
+// Returns a free voice, or steals the lowest-priority voice (the oldest among equals) if it does not outrank the new sound.
+// Returns null if every voice outranks the new sound.
+static AudioVoice *allocate_voice(const int32_t priority) {
+	AudioVoice *pStealVoice = nullptr;
+	for (uint32_t i = 0; i < AUDIO_MIXER_VOICE_COUNT; ++i) {
+		if (voices[i].id == 0) {
+			return &voices[i];
+		}
+		if (!pStealVoice || voices[i].params.priority < pStealVoice->params.priority
+				|| (voices[i].params.priority == pStealVoice->params.priority && voices[i].start_order < pStealVoice->start_order)) {
+			pStealVoice = &voices[i];
+		}
+	}
 	
-	static const unsigned int excess_node_limit = 8;	// TODO - move to audio config
-	if (atomic_load(&audio_mixer_queue.num_excess_nodes) < excess_node_limit) {
+	if (pStealVoice && pStealVoice->params.priority <= priority) {
+		return pStealVoice;
+	}
+	return nullptr;
+}
+
+static void process_voice_commands(void) {
+	AudioCommand command = { };
+	while (audio_command_queue_pop(&voice_command_queue, &command)) {
+		switch (command.type) {
+			case AUDIO_COMMAND_PLAY: {
+				// A sound that cannot be played is rejected before a voice is chosen, so that it never steals a playing voice.
+				const AudioData *const pSound = &sounds[command.sound_handle];
+				if (!audio_voice_can_play(pSound)) {
+					logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error playing sound %i: its sample rate (%u Hz) cannot be converted to the output rate.", command.sound_handle, pSound->sample_rate);
+					break;
+				}
+				AudioVoice *const pVoice = allocate_voice(command.params.priority);
+				if (pVoice && !audio_voice_start(pVoice, command.voice_id, pSound, command.params, voice_start_count++)) {
+					logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error playing sound %i: failed to start voice.", command.sound_handle);
+				}
+			} break;
+			case AUDIO_COMMAND_STOP: {
+				AudioVoice *const pVoice = find_voice(command.voice_id);
+				if (pVoice) {
+					pVoice->id = 0;
+				}
+			} break;
+			case AUDIO_COMMAND_SET_GAIN: {
+				AudioVoice *const pVoice = find_voice(command.voice_id);
+				if (pVoice) {
+					pVoice->params.gain = command.params.gain;
+				}
+			} break;
+			case AUDIO_COMMAND_SET_PAN: {
+				AudioVoice *const pVoice = find_voice(command.voice_id);
+				if (pVoice) {
+					pVoice->params.pan = command.params.pan;
+				}
+			} break;
+		}
+	}
+}
+
+bool audio_mixer_read_buffer(AudioSample *const pOut) {
+	AudioQueueNode *pNeckNode = (AudioQueueNode *)atomic_load(&audio_mixer_queue.pNeckNode);
+	const AudioQueueNode *const pTailNode = (AudioQueueNode *)atomic_load(&audio_mixer_queue.pTailNode);
+	
+	const bool buffer_available = pNeckNode != pTailNode;
+	if (buffer_available) {
+		memcpy(pOut, pNeckNode->pNextNode->samples, audio_buffer_length * sizeof(AudioSample));
+		atomic_store(&audio_mixer_queue.pNeckNode, pNeckNode->pNextNode);
+		atomic_fetch_sub(&audio_mixer_queue.num_excess_nodes, 1);
+	} else {
+		memset(pOut, 0, audio_buffer_length * sizeof(AudioSample));
+		atomic_fetch_add(&audio_mixer_underrun_count, 1);
+	}
+	
+	// Wake the mixer if this left too little audio queued.
+	// Signalled without taking the mutex so that the audio output never blocks;
+	// 	a wakeup missed this way is covered by the mixer's timed wait.
+	if (atomic_load(&audio_mixer_queue.num_excess_nodes) < audio_mixer_low_water_mark) {
+		pthread_cond_signal(&audio_mixer_condition);
+	}
+	
+	return buffer_available;
+}
+
+unsigned int audio_mixer_queued_buffer_count(void) {
+	return atomic_load(&audio_mixer_queue.num_excess_nodes);
+}
+
+unsigned int audio_mixer_get_underrun_count(void) {
+	return atomic_load(&audio_mixer_underrun_count);
+}
+
+static void *audio_mixer_main(void *arg) {
+	(void)arg;
+	
+	// Wait at most one buffer's duration, so a missed wakeup costs at most one buffer of latency.
+	const long int buffer_duration_ns = (long int)(1000000000LL * NUM_AUDIO_FRAMES_PER_BUFFER / get_audio_sample_rate());
 	
-		// Create the next node.
-		atomic_store(&audio_mixer_queue.pTailNode->pNextNode, (_Atomic AudioQueueNode *)new_audio_queue_node());
-		_Atomic AudioQueueNode *pNextNode = atomic_load(&audio_mixer_queue.pTailNode->pNextNode);
+	while (atomic_load(&audio_mixer_running)) {
 		
-		// Mix audio data into new node.
-		if (background_music_track.current_position + audio_buffer_length >= background_music_track.data.num_samples) {
-			size_t mix_index = background_music_track.current_position;
-			for (size_t i = 0; i < audio_buffer_length; ++i) {
-				pNextNode->samples[i] = background_music_track.data.samples[mix_index];
-				if (++mix_index >= background_music_track.data.num_samples) {
-					mix_index -= background_music_track.data.num_samples;
-				}
-			}
-			background_music_track.current_position = mix_index;
+		// Fill the queue up to the target latency.
+		while (atomic_load(&audio_mixer_running) && atomic_load(&audio_mixer_queue.num_excess_nodes) < audio_mixer_low_water_mark) {
+			audio_mixer_mix();
 		}
-		else {
-			//memcpy_s(pNextNode->samples, audio_buffer_length * sizeof(AudioSample), &background_music_track.data.samples[background_music_track.current_position], audio_buffer_length * sizeof(AudioSample));
-			for (size_t i = 0; i < audio_buffer_length; i++) {
-				pNextNode->samples[i] = background_music_track.data.samples[background_music_track.current_position + i];
+		audio_mixer_free_played_nodes();
+		
+		pthread_mutex_lock(&audio_mixer_mutex);
+		while (atomic_load(&audio_mixer_running) && atomic_load(&audio_mixer_queue.num_excess_nodes) >= audio_mixer_low_water_mark) {
+			struct timespec wake_time = { };
+			clock_gettime(CLOCK_MONOTONIC, &wake_time);
+			wake_time.tv_nsec += buffer_duration_ns;
+			if (wake_time.tv_nsec >= 1000000000L) {
+				wake_time.tv_sec += 1;
+				wake_time.tv_nsec -= 1000000000L;
+			}
+			if (pthread_cond_timedwait(&audio_mixer_condition, &audio_mixer_mutex, &wake_time) != 0) {
+				break;
 			}
-			background_music_track.current_position += audio_buffer_length;
 		}
-		
-		// Publish the new node.
-		atomic_store(&audio_mixer_queue.pTailNode, audio_mixer_queue.pTailNode->pNextNode);
-		atomic_fetch_add(&audio_mixer_queue.num_excess_nodes, 1);
+		pthread_mutex_unlock(&audio_mixer_mutex);
+	}
+	return nullptr;
+}
+
+// Writes the next frames of the music, resampled to the output format if needed, into the mix buffer.
+static void audio_mixer_read_music(AudioSample *const pMix, const size_t num_frames) {
+	if (!music_stream || !music_resample) {
+		audio_stream_read(music_stream, pMix, num_frames);
+		return;
+	}
+	
+	const unsigned int num_channels = audio_stream_num_channels(music_stream);
+	size_t num_frames_read = 0;
+	while (num_frames_read < num_frames) {
+		const size_t num_chunk_frames = num_frames - num_frames_read < AUDIO_RESAMPLER_CHUNK_FRAMES ? num_frames - num_frames_read : AUDIO_RESAMPLER_CHUNK_FRAMES;
+		size_t num_input_frames = 0;
+		AudioSample *const pInput = audio_resampler_prepare_input(&music_resampler, num_chunk_frames, &num_input_frames);
+		audio_stream_read(music_stream, music_source_frames, num_input_frames);
+		audio_channels_to_stereo(pInput, music_source_frames, num_input_frames, num_channels);
+		audio_resampler_process(&music_resampler, &pMix[2 * num_frames_read], num_chunk_frames);
+		num_frames_read += num_chunk_frames;
+	}
+}
+
+// Mixes one buffer of audio and appends it to the queue.
+static void audio_mixer_mix(void) {
+	// Create the next node.
+	atomic_store(&audio_mixer_queue.pTailNode->pNextNode, (_Atomic AudioQueueNode *)new_audio_queue_node());
+	_Atomic AudioQueueNode *pNextNode = atomic_load(&audio_mixer_queue.pTailNode->pNextNode);
+	
+	// Mix audio data into new node, starting with the music and adding each active voice on top.
+	AudioSample *const pMix = (AudioSample *)pNextNode->samples;
+	audio_mixer_read_music(pMix, num_audio_frames_per_buffer);
+	process_voice_commands();
+	for (uint32_t i = 0; i < AUDIO_MIXER_VOICE_COUNT; ++i) {
+		if (voices[i].id != 0 && !audio_voice_mix(&voices[i], pMix, num_audio_frames_per_buffer)) {
+			voices[i].id = 0;
+		}
 	}
+	audio_mix_clamp(pMix, audio_buffer_length);
 	
-	// Remove already-processed nodes.
+	// Publish the new node.
+	atomic_store(&audio_mixer_queue.pTailNode, audio_mixer_queue.pTailNode->pNextNode);
+	atomic_fetch_add(&audio_mixer_queue.num_excess_nodes, 1);
+	
+	// Refill the decode-ahead window now that the node is published, so decoding stays off the path of the next node.
+	audio_stream_decode_ahead(music_stream);
+}
+
+// Removes nodes that the audio output has already played.
+static void audio_mixer_free_played_nodes(void) {
 	while (audio_mixer_queue.pHeadNode != audio_mixer_queue.pNeckNode) {
 		AudioQueueNode *const temp_node_ptr = audio_mixer_queue.pHeadNode;
 		audio_mixer_queue.pHeadNode = (AudioQueueNode *)audio_mixer_queue.pHeadNode->pNextNode;
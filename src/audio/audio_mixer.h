@@ -1,13 +1,52 @@
 #ifndef AUDIO_MIXER_H
 #define AUDIO_MIXER_H
 
+#include <stdint.h>
+
 #include "audio_loader.h"
 #include "audio_queue.h"
+#include "audio_voice.h"
+
+// The maximum number of sounds that can play at once.
+#define AUDIO_MIXER_VOICE_COUNT 32
+
+// The maximum number of sound effects that can be loaded.
+#define AUDIO_MIXER_SOUND_COUNT 64
 
 extern AudioQueue audio_mixer_queue;
 
 void init_audio_mixer(void);
 void terminate_audio_mixer(void);
-void audio_mixer_set_music_track(const AudioData audio_data);
+
+// Replaces the music stream, closing the previous one; the mixer takes ownership of the stream.
+// Call on main thread before the mixer starts.
+void audio_mixer_set_music_stream(AudioStream audio_stream);
+
+// Loads a sound effect into memory; the filename is relative to the audio asset directory.
+// Returns a handle to the sound, or -1 if it could not be loaded. Call on main thread.
+int32_t audio_mixer_load_sound(const char *const filename);
+
+// Starts playing a sound on a new voice. Call on game thread.
+// Returns the ID of the voice, or zero if the voice could not be started.
+// The voice may not play if every voice is busy with higher-priority sounds.
+uint32_t audio_mixer_play_sound(const int32_t sound_handle, const AudioVoiceParams params);
+
+// Call on game thread; does nothing if the voice has already finished.
+void audio_mixer_stop_voice(const uint32_t voice_id);
+
+void audio_mixer_set_voice_gain(const uint32_t voice_id, const float gain);
+
+void audio_mixer_set_voice_pan(const uint32_t voice_id, const float pan);
+
+// Call on audio output thread; copies the oldest mixed buffer (audio_buffer_length samples) into pOut,
+// 	and wakes the mixer if the queue is running low.
+// Returns true if a mixed buffer was read, or false if the queue was empty and pOut was filled with silence.
+bool audio_mixer_read_buffer(AudioSample *const pOut);
+
+// Returns the number of mixed buffers waiting to be read.
+unsigned int audio_mixer_queued_buffer_count(void);
+
+// Returns the number of times the audio output read from an empty queue.
+unsigned int audio_mixer_get_underrun_count(void);
 
 #endif	// AUDIO_MIXER_H
@@ -0,0 +1,275 @@
+#include "audio_resampler.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#include "log/Logger.h"
+
+// Each output frame is filtered from the source frames centered on its position:
+// 	HALF_TAP_COUNT - 1 frames before the current source frame, the current frame, and HALF_TAP_COUNT frames after it.
+#define HALF_TAP_COUNT (AUDIO_RESAMPLER_TAP_COUNT / 2)
+
+// The fractional position between two source frames selects one of 2^PHASE_BITS rows of filter taps.
+#define PHASE_BITS 9
+#define PHASE_COUNT (1 << PHASE_BITS)
+
+// The most pairs of sample rates that sinc filter tables are kept for.
+#define FILTER_TABLE_COUNT 4
+
+#define PHASE_MASK 0xFFFFFFFFULL
+
+// The passband of the filter as a fraction of the lower of the two Nyquist frequencies, leaving room for the transition band.
+static const double filter_cutoff = 0.9;
+
+// Shape parameter of the Kaiser window; higher values trade a wider transition band for more stopband attenuation.
+static const double kaiser_beta = 8.0;
+
+typedef struct FilterTable {
+	unsigned int source_rate;
+	unsigned int output_rate;
+	float taps[PHASE_COUNT * AUDIO_RESAMPLER_TAP_COUNT];
+} FilterTable;
+
+// Only accessed on the mixer thread, or before it starts.
+static FilterTable filter_tables[FILTER_TABLE_COUNT];
+static uint32_t filter_table_count = 0;
+
+// Zeroth-order modified Bessel function of the first kind, used by the Kaiser window.
+static double bessel_i0(const double x) {
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		const double half_x_over_k = x / (2.0 * k);
+		term *= half_x_over_k * half_x_over_k;
+		sum += term;
+	}
+	return sum;
+}
+
+static void build_filter_table(FilterTable *const pTable, const unsigned int source_rate, const unsigned int output_rate) {
+	const double pi = 3.14159265358979323846;
+	
+	// When downsampling, the cutoff is lowered to the output's Nyquist frequency so that higher frequencies do not alias.
+	const double rate_ratio = output_rate < source_rate ? (double)output_rate / source_rate : 1.0;
+	const double cutoff = filter_cutoff * rate_ratio;
+	const double window_scale = 1.0 / bessel_i0(kaiser_beta);
+	
+	pTable->source_rate = source_rate;
+	pTable->output_rate = output_rate;
+	for (uint32_t phase = 0; phase < PHASE_COUNT; ++phase) {
+		float *const pRow = &pTable->taps[phase * AUDIO_RESAMPLER_TAP_COUNT];
+		const double fraction = (double)phase / PHASE_COUNT;
+		
+		double row_sum = 0.0;
+		double row[AUDIO_RESAMPLER_TAP_COUNT];
+		for (int tap = 0; tap < AUDIO_RESAMPLER_TAP_COUNT; ++tap) {
+			const double x = (double)(tap - (HALF_TAP_COUNT - 1)) - fraction;
+			const double sinc = x == 0.0 ? 1.0 : sin(pi * cutoff * x) / (pi * cutoff * x);
+			const double window_position = x / HALF_TAP_COUNT;
+			const double window = window_position * window_position < 1.0
+				? bessel_i0(kaiser_beta * sqrt(1.0 - window_position * window_position)) * window_scale 
+				: 0.0;
+			row[tap] = sinc * window;
+			row_sum += row[tap];
+		}
+		
+		// Normalize each row so that every phase passes a constant signal at unity gain.
+		for (int tap = 0; tap < AUDIO_RESAMPLER_TAP_COUNT; ++tap) {
+			pRow[tap] = (float)(row[tap] / row_sum);
+		}
+	}
+}
+
+static const float *get_filter_table(const unsigned int source_rate, const unsigned int output_rate) {
+	for (uint32_t i = 0; i < filter_table_count; ++i) {
+		if (filter_tables[i].source_rate == source_rate && filter_tables[i].output_rate == output_rate) {
+			return filter_tables[i].taps;
+		}
+	}
+	
+	if (filter_table_count >= FILTER_TABLE_COUNT) {
+		return nullptr;
+	}
+	
+	FilterTable *const pTable = &filter_tables[filter_table_count];
+	build_filter_table(pTable, source_rate, output_rate);
+	filter_table_count += 1;
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Built resampling filter table for %u Hz to %u Hz.", source_rate, output_rate);
+	return pTable->taps;
+}
+
+bool audio_resampler_supports_rates(const unsigned int source_rate, const unsigned int output_rate) {
+	return source_rate > 0 && output_rate > 0 && source_rate <= AUDIO_RESAMPLER_MAX_RATIO * output_rate;
+}
+
+bool audio_resampler_reset(AudioResampler *const pResampler, const AudioResampleQuality quality, const unsigned int source_rate, const unsigned int output_rate) {
+	assert(pResampler);
+	
+	if (!audio_resampler_supports_rates(source_rate, output_rate)) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error resetting resampler: cannot resample from %u Hz to %u Hz (at most %u times the output rate).", source_rate, output_rate, AUDIO_RESAMPLER_MAX_RATIO);
+		return false;
+	}
+	
+	// At equal rates every output frame lands exactly on a source frame, which the linear resampler copies unchanged.
+	pResampler->quality = source_rate == output_rate ? AUDIO_RESAMPLE_LINEAR : quality;
+	pResampler->pFilterTable = nullptr;
+	if (pResampler->quality == AUDIO_RESAMPLE_SINC) {
+		pResampler->pFilterTable = get_filter_table(source_rate, output_rate);
+		if (!pResampler->pFilterTable) {
+			logMsg(loggerAudio, LOG_LEVEL_WARNING, "Resetting resampler: no filter table left for %u Hz to %u Hz; resampling linearly instead.", source_rate, output_rate);
+			pResampler->quality = AUDIO_RESAMPLE_LINEAR;
+		}
+	}
+	
+	pResampler->step = ((uint64_t)source_rate << 32) / output_rate;
+	pResampler->phase = 0;
+	pResampler->source_position = 0;
+	
+	// Start with silence before the first source frame, so the filter has a full history from the start.
+	pResampler->index = HALF_TAP_COUNT - 1;
+	pResampler->num_frames = HALF_TAP_COUNT - 1;
+	memset(pResampler->frames, 0, 2 * pResampler->num_frames * sizeof(AudioSample));
+	return true;
+}
+
+AudioSample *audio_resampler_prepare_input(AudioResampler *const pResampler, const size_t num_output_frames, size_t *const pNumInputFrames) {
+	assert(pResampler);
+	assert(pNumInputFrames);
+	assert(num_output_frames > 0 && num_output_frames <= AUDIO_RESAMPLER_CHUNK_FRAMES);
+	
+	// The last output frame filters up to HALF_TAP_COUNT frames past its own source frame.
+	const size_t last_index = pResampler->index + (size_t)((pResampler->phase + pResampler->step * (num_output_frames - 1)) >> 32);
+	const size_t num_frames_needed = last_index + HALF_TAP_COUNT + 1;
+	assert(num_frames_needed <= AUDIO_RESAMPLER_MAX_INPUT_FRAMES);
+	
+	AudioSample *const pInput = &pResampler->frames[2 * pResampler->num_frames];
+	*pNumInputFrames = num_frames_needed > pResampler->num_frames ? num_frames_needed - pResampler->num_frames : 0;
+	pResampler->num_frames += *pNumInputFrames;
+	return pInput;
+}
+
+// Interpolates one stereo frame between the source frame at pIn and the next one.
+static inline void resample_linear_frame(const AudioSample *restrict pIn, const float fraction, AudioSample *restrict pOut) {
+#if defined(__SSE__)
+	const float weight = 1.0F - fraction;
+	const __m128 products = _mm_mul_ps(_mm_loadu_ps(pIn), _mm_setr_ps(weight, weight, fraction, fraction));
+	const __m128 sums = _mm_add_ps(products, _mm_movehl_ps(products, products));
+	pOut[0] = _mm_cvtss_f32(sums);
+	pOut[1] = _mm_cvtss_f32(_mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 1, 1, 1)));
+#else
+	pOut[0] = pIn[0] + (pIn[2] - pIn[0]) * fraction;
+	pOut[1] = pIn[1] + (pIn[3] - pIn[1]) * fraction;
+#endif
+}
+
+// Filters one stereo frame from the AUDIO_RESAMPLER_TAP_COUNT source frames starting at pIn.
+static inline void resample_sinc_frame(const AudioSample *restrict pIn, const float *restrict pTaps, AudioSample *restrict pOut) {
+#if defined(__SSE__)
+	// Accumulates left and right sums side by side; each group of four taps is spread over two registers of two frames each.
+	__m128 sums = _mm_setzero_ps();
+	for (size_t tap = 0; tap < AUDIO_RESAMPLER_TAP_COUNT; tap += 4) {
+		const __m128 taps = _mm_loadu_ps(&pTaps[tap]);
+		sums = _mm_add_ps(sums, _mm_mul_ps(_mm_loadu_ps(&pIn[2 * tap]), _mm_unpacklo_ps(taps, taps)));
+		sums = _mm_add_ps(sums, _mm_mul_ps(_mm_loadu_ps(&pIn[2 * tap + 4]), _mm_unpackhi_ps(taps, taps)));
+	}
+	sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+	pOut[0] = _mm_cvtss_f32(sums);
+	pOut[1] = _mm_cvtss_f32(_mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 1, 1, 1)));
+#else
+	float left = 0.0F;
+	float right = 0.0F;
+	for (size_t tap = 0; tap < AUDIO_RESAMPLER_TAP_COUNT; ++tap) {
+		left += pIn[2 * tap] * pTaps[tap];
+		right += pIn[2 * tap + 1] * pTaps[tap];
+	}
+	pOut[0] = left;
+	pOut[1] = right;
+#endif
+}
+
+void audio_resampler_process(AudioResampler *const pResampler, AudioSample *const pOut, const size_t num_output_frames) {
+	assert(pResampler);
+	assert(pOut);
+	
+	size_t index = pResampler->index;
+	uint64_t phase = pResampler->phase;
+	const uint64_t step = pResampler->step;
+	const AudioSample *const pFrames = pResampler->frames;
+	
+	if (pResampler->quality == AUDIO_RESAMPLE_SINC) {
+		for (size_t i = 0; i < num_output_frames; ++i) {
+			const float *const pTaps = &pResampler->pFilterTable[(phase >> (32 - PHASE_BITS)) * AUDIO_RESAMPLER_TAP_COUNT];
+			resample_sinc_frame(&pFrames[2 * (index - (HALF_TAP_COUNT - 1))], pTaps, &pOut[2 * i]);
+			phase += step;
+			index += (size_t)(phase >> 32);
+			phase &= PHASE_MASK;
+		}
+	} else {
+		for (size_t i = 0; i < num_output_frames; ++i) {
+			resample_linear_frame(&pFrames[2 * index], (float)phase * 0x1p-32F, &pOut[2 * i]);
+			phase += step;
+			index += (size_t)(phase >> 32);
+			phase &= PHASE_MASK;
+		}
+	}
+	
+	pResampler->source_position += index - pResampler->index;
+	pResampler->phase = phase;
+	
+	// Drop the source frames that no later output frame filters over.
+	const size_t first_kept_frame = index - (HALF_TAP_COUNT - 1);
+	memmove(pResampler->frames, &pResampler->frames[2 * first_kept_frame], 2 * (pResampler->num_frames - first_kept_frame) * sizeof(AudioSample));
+	pResampler->num_frames -= first_kept_frame;
+	pResampler->index = HALF_TAP_COUNT - 1;
+}
+
+#define HALF_GAIN 0.70710678F
+
+// Left and right gains of each source channel, indexed by the number of channels, in the standard WAVE channel order.
+static const float downmix_gains[AUDIO_MAX_SOURCE_CHANNELS + 1][AUDIO_MAX_SOURCE_CHANNELS][2] = {
+	// Front left, front right, front center.
+	[3] = { { 1.0F, 0.0F }, { 0.0F, 1.0F }, { HALF_GAIN, HALF_GAIN } },
+	// Front left, front right, back left, back right.
+	[4] = { { 1.0F, 0.0F }, { 0.0F, 1.0F }, { HALF_GAIN, 0.0F }, { 0.0F, HALF_GAIN } },
+	// Front left, front right, front center, back left, back right.
+	[5] = { { 1.0F, 0.0F }, { 0.0F, 1.0F }, { HALF_GAIN, HALF_GAIN }, { HALF_GAIN, 0.0F }, { 0.0F, HALF_GAIN } },
+	// 5.1: front left, front right, front center, LFE, back left, back right.
+	[6] = { { 1.0F, 0.0F }, { 0.0F, 1.0F }, { HALF_GAIN, HALF_GAIN }, { 0.0F, 0.0F }, { HALF_GAIN, 0.0F }, { 0.0F, HALF_GAIN } },
+	// 6.1: front left, front right, front center, LFE, back center, side left, side right.
+	[7] = { { 1.0F, 0.0F }, { 0.0F, 1.0F }, { HALF_GAIN, HALF_GAIN }, { 0.0F, 0.0F }, { 0.5F, 0.5F }, { HALF_GAIN, 0.0F }, { 0.0F, HALF_GAIN } },
+	// 7.1: front left, front right, front center, LFE, back left, back right, side left, side right.
+	[8] = { { 1.0F, 0.0F }, { 0.0F, 1.0F }, { HALF_GAIN, HALF_GAIN }, { 0.0F, 0.0F }, { HALF_GAIN, 0.0F }, { 0.0F, HALF_GAIN }, { HALF_GAIN, 0.0F }, { 0.0F, HALF_GAIN } }
+};
+
+void audio_channels_to_stereo(AudioSample *restrict pOut, const AudioSample *restrict pIn, const size_t num_frames, const unsigned int num_channels) {
+	assert(num_channels >= 1 && num_channels <= AUDIO_MAX_SOURCE_CHANNELS);
+	
+	if (num_channels == 2) {
+		memcpy(pOut, pIn, 2 * num_frames * sizeof(AudioSample));
+		return;
+	} else if (num_channels == 1) {
+		for (size_t i = 0; i < num_frames; ++i) {
+			pOut[2 * i] = pIn[i];
+			pOut[2 * i + 1] = pIn[i];
+		}
+		return;
+	}
+	
+	const float (*const pGains)[2] = downmix_gains[num_channels];
+	for (size_t i = 0; i < num_frames; ++i) {
+		const AudioSample *const pFrame = &pIn[i * num_channels];
+		float left = 0.0F;
+		float right = 0.0F;
+		for (unsigned int channel = 0; channel < num_channels; ++channel) {
+			left += pFrame[channel] * pGains[channel][0];
+			right += pFrame[channel] * pGains[channel][1];
+		}
+		pOut[2 * i] = left;
+		pOut[2 * i + 1] = right;
+	}
+}
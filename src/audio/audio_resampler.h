@@ -0,0 +1,72 @@
+#ifndef AUDIO_RESAMPLER_H
+#define AUDIO_RESAMPLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "audio_config.h"
+#include "audio_loader.h"
+
+// The number of source frames that each output frame is filtered from by the sinc resampler.
+#define AUDIO_RESAMPLER_TAP_COUNT 16
+
+// The highest ratio of source sample rate to output sample rate that can be resampled (e.g. 176.4 kHz to 44.1 kHz).
+#define AUDIO_RESAMPLER_MAX_RATIO 4
+
+// The most output frames that can be resampled in one call.
+#define AUDIO_RESAMPLER_CHUNK_FRAMES 256
+
+// The most stereo frames that a resampler holds: the chunk's source frames, plus the filter's history and look-ahead.
+#define AUDIO_RESAMPLER_MAX_INPUT_FRAMES (AUDIO_RESAMPLER_MAX_RATIO * AUDIO_RESAMPLER_CHUNK_FRAMES + AUDIO_RESAMPLER_TAP_COUNT + 1)
+
+// The most channels a sound can have; sounds with more than two are mixed down to stereo.
+#define AUDIO_MAX_SOURCE_CHANNELS 8
+
+// Converts stereo audio from one sample rate to another, a chunk at a time.
+// The resampler keeps the source frames that later chunks still filter over, so a sound can be fed to it piece by piece.
+typedef struct AudioResampler {
+	
+	AudioResampleQuality quality;
+	
+	// The polyphase filter table used by the sinc resampler; null for the linear resampler.
+	const float *pFilterTable;
+	
+	// Source frames advanced per output frame, in 32.32 fixed point.
+	uint64_t step;
+	
+	// Fractional position between the current source frame and the next, in 0.32 fixed point.
+	uint64_t phase;
+	
+	// The buffered source frame at the current position, and the number of buffered source frames.
+	size_t index;
+	size_t num_frames;
+	
+	// The number of source frames that the current position has passed since the resampler was reset.
+	uint64_t source_position;
+	
+	AudioSample frames[2 * AUDIO_RESAMPLER_MAX_INPUT_FRAMES];
+	
+} AudioResampler;
+
+// Returns true if a resampler can convert from source_rate to output_rate, false otherwise.
+bool audio_resampler_supports_rates(const unsigned int source_rate, const unsigned int output_rate);
+
+// Prepares a resampler to convert a new sound from source_rate to output_rate.
+// Sinc filter tables are built the first time each pair of rates is seen; call on the mixer thread, or before it starts.
+// If both rates are equal, the resampler copies frames through unchanged.
+// Returns false if the ratio of the rates is not supported, true otherwise.
+bool audio_resampler_reset(AudioResampler *const pResampler, const AudioResampleQuality quality, const unsigned int source_rate, const unsigned int output_rate);
+
+// Returns where to write the stereo source frames needed to produce the next num_output_frames frames,
+// 	and the number of frames to write through pNumInputFrames. The frames must be written before the next call to audio_resampler_process.
+// num_output_frames must not be greater than AUDIO_RESAMPLER_CHUNK_FRAMES.
+AudioSample *audio_resampler_prepare_input(AudioResampler *const pResampler, const size_t num_output_frames, size_t *const pNumInputFrames);
+
+// Writes num_output_frames resampled stereo frames to pOut; the frames must have been prepared first.
+void audio_resampler_process(AudioResampler *const pResampler, AudioSample *const pOut, const size_t num_output_frames);
+
+// Converts interleaved frames with any number of channels up to AUDIO_MAX_SOURCE_CHANNELS into interleaved stereo.
+// Mono is copied into both channels; more than two channels are mixed down, assuming the standard WAVE channel order.
+void audio_channels_to_stereo(AudioSample *restrict pOut, const AudioSample *restrict pIn, const size_t num_frames, const unsigned int num_channels);
+
+#endif	// AUDIO_RESAMPLER_H
@@ -0,0 +1,186 @@
+#include "audio_voice.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// Voices are always mixed into interleaved stereo.
+static_assert(NUM_AUDIO_CHANNELS == 2, "Audio voices can only be mixed into stereo output.");
+
+static const float pi = 3.14159265358979F;
+
+// Adds a stereo source to a stereo mix, scaling the left and right channels separately.
+static void mix_stereo(AudioSample *restrict pMix, const AudioSample *restrict pSource, const size_t num_frames, const float left_gain, const float right_gain) {
+	const size_t num_samples = 2 * num_frames;
+	size_t i = 0;
+#if defined(__SSE__)
+	const __m128 gains = _mm_setr_ps(left_gain, right_gain, left_gain, right_gain);
+	for (; i + 4 <= num_samples; i += 4) {
+		const __m128 source = _mm_mul_ps(_mm_loadu_ps(&pSource[i]), gains);
+		_mm_storeu_ps(&pMix[i], _mm_add_ps(_mm_loadu_ps(&pMix[i]), source));
+	}
+#endif
+	for (; i < num_samples; i += 2) {
+		pMix[i] += pSource[i] * left_gain;
+		pMix[i + 1] += pSource[i + 1] * right_gain;
+	}
+}
+
+// Adds a mono source to both channels of a stereo mix.
+static void mix_mono(AudioSample *restrict pMix, const AudioSample *restrict pSource, const size_t num_frames, const float left_gain, const float right_gain) {
+	size_t i = 0;
+#if defined(__SSE__)
+	const __m128 gains = _mm_setr_ps(left_gain, right_gain, left_gain, right_gain);
+	for (; i + 4 <= num_frames; i += 4) {
+		// Duplicate each mono sample into a left and right sample.
+		const __m128 source = _mm_loadu_ps(&pSource[i]);
+		const __m128 low = _mm_mul_ps(_mm_unpacklo_ps(source, source), gains);
+		const __m128 high = _mm_mul_ps(_mm_unpackhi_ps(source, source), gains);
+		_mm_storeu_ps(&pMix[2 * i], _mm_add_ps(_mm_loadu_ps(&pMix[2 * i]), low));
+		_mm_storeu_ps(&pMix[2 * i + 4], _mm_add_ps(_mm_loadu_ps(&pMix[2 * i + 4]), high));
+	}
+#endif
+	for (; i < num_frames; ++i) {
+		pMix[2 * i] += pSource[i] * left_gain;
+		pMix[2 * i + 1] += pSource[i] * right_gain;
+	}
+}
+
+// Voices whose sounds are not at the output sample rate, or have more than two channels, are mixed through a resampler.
+static bool sound_needs_resampling(const AudioData *const pSound, const unsigned int output_rate) {
+	return pSound->sample_rate != output_rate || pSound->num_channels > 2;
+}
+
+bool audio_voice_can_play(const AudioData *const pSound) {
+	assert(pSound);
+	const unsigned int output_rate = get_audio_sample_rate();
+	return !sound_needs_resampling(pSound, output_rate) || audio_resampler_supports_rates(pSound->sample_rate, output_rate);
+}
+
+bool audio_voice_start(AudioVoice *const pVoice, const uint32_t id, const AudioData *const pSound, const AudioVoiceParams params, const uint64_t start_order) {
+	assert(pVoice);
+	assert(pSound);
+	
+	pVoice->id = 0;
+	const unsigned int output_rate = get_audio_sample_rate();
+	pVoice->resample = sound_needs_resampling(pSound, output_rate);
+	if (pVoice->resample && !audio_resampler_reset(&pVoice->resampler, get_audio_resample_quality(), pSound->sample_rate, output_rate)) {
+		return false;
+	}
+	
+	pVoice->id = id;
+	pVoice->pSound = pSound;
+	pVoice->position = 0;
+	pVoice->params = params;
+	pVoice->start_order = start_order;
+	return true;
+}
+
+// Copies the next frames of a voice's sound, converted to stereo, looping or padding with silence at the end of the sound.
+static void read_voice_frames(AudioVoice *const pVoice, AudioSample *const pOut, const size_t num_frames) {
+	const AudioData *const pSound = pVoice->pSound;
+	size_t num_frames_read = 0;
+	while (num_frames_read < num_frames) {
+		if (pVoice->position >= pSound->num_samples) {
+			if (!pVoice->params.loop) {
+				memset(&pOut[2 * num_frames_read], 0, 2 * (num_frames - num_frames_read) * sizeof(AudioSample));
+				return;
+			}
+			pVoice->position = 0;
+		}
+		
+		const size_t num_frames_left = pSound->num_samples - pVoice->position;
+		const size_t num_frames_to_read = num_frames - num_frames_read < num_frames_left ? num_frames - num_frames_read : num_frames_left;
+		audio_channels_to_stereo(&pOut[2 * num_frames_read], &pSound->samples[pVoice->position * pSound->num_channels], num_frames_to_read, pSound->num_channels);
+		pVoice->position += num_frames_to_read;
+		num_frames_read += num_frames_to_read;
+	}
+}
+
+// Mixes a voice through its resampler, a chunk at a time.
+static bool mix_resampled(AudioVoice *const pVoice, AudioSample *const pMix, const size_t num_frames, const float left_gain, const float right_gain) {
+	const AudioData *const pSound = pVoice->pSound;
+	AudioSample chunk[2 * AUDIO_RESAMPLER_CHUNK_FRAMES];
+	
+	size_t num_frames_mixed = 0;
+	while (num_frames_mixed < num_frames) {
+		if (!pVoice->params.loop && pVoice->resampler.source_position >= pSound->num_samples) {
+			return false;
+		}
+		
+		const size_t num_chunk_frames = num_frames - num_frames_mixed < AUDIO_RESAMPLER_CHUNK_FRAMES ? num_frames - num_frames_mixed : AUDIO_RESAMPLER_CHUNK_FRAMES;
+		size_t num_input_frames = 0;
+		AudioSample *const pInput = audio_resampler_prepare_input(&pVoice->resampler, num_chunk_frames, &num_input_frames);
+		read_voice_frames(pVoice, pInput, num_input_frames);
+		audio_resampler_process(&pVoice->resampler, chunk, num_chunk_frames);
+		mix_stereo(&pMix[2 * num_frames_mixed], chunk, num_chunk_frames, left_gain, right_gain);
+		num_frames_mixed += num_chunk_frames;
+	}
+	
+	return pVoice->params.loop || pVoice->resampler.source_position < pSound->num_samples;
+}
+
+bool audio_voice_mix(AudioVoice *const pVoice, AudioSample *const pMix, const size_t num_frames) {
+	assert(pVoice);
+	assert(pMix);
+	
+	const AudioData *const pSound = pVoice->pSound;
+	if (!pSound || !pSound->samples || pSound->num_samples == 0) {
+		return false;
+	}
+	
+	// Constant-power panning keeps the loudness of a sound steady as it moves between channels.
+	const float pan = fminf(fmaxf(pVoice->params.pan, -1.0F), 1.0F);
+	const float pan_angle = (pan + 1.0F) * 0.25F * pi;
+	const float left_gain = pVoice->params.gain * cosf(pan_angle);
+	const float right_gain = pVoice->params.gain * sinf(pan_angle);
+	
+	if (pVoice->resample) {
+		return mix_resampled(pVoice, pMix, num_frames, left_gain, right_gain);
+	}
+	
+	size_t num_frames_mixed = 0;
+	while (num_frames_mixed < num_frames) {
+		if (pVoice->position >= pSound->num_samples) {
+			if (!pVoice->params.loop) {
+				return false;
+			}
+			pVoice->position = 0;
+		}
+		
+		// Mix up to the end of the sound or the end of the buffer, whichever comes first.
+		const size_t num_frames_left = pSound->num_samples - pVoice->position;
+		const size_t num_frames_to_mix = num_frames - num_frames_mixed < num_frames_left ? num_frames - num_frames_mixed : num_frames_left;
+		const AudioSample *const pSource = &pSound->samples[pVoice->position * pSound->num_channels];
+		AudioSample *const pMixStart = &pMix[num_frames_mixed * 2];
+		if (pSound->num_channels == 1) {
+			mix_mono(pMixStart, pSource, num_frames_to_mix, left_gain, right_gain);
+		} else {
+			mix_stereo(pMixStart, pSource, num_frames_to_mix, left_gain, right_gain);
+		}
+		
+		pVoice->position += num_frames_to_mix;
+		num_frames_mixed += num_frames_to_mix;
+	}
+	
+	return pVoice->params.loop || pVoice->position < pSound->num_samples;
+}
+
+void audio_mix_clamp(AudioSample *const pMix, const size_t num_samples) {
+	assert(pMix);
+	size_t i = 0;
+#if defined(__SSE__)
+	const __m128 lower_bound = _mm_set1_ps(-1.0F);
+	const __m128 upper_bound = _mm_set1_ps(1.0F);
+	for (; i + 4 <= num_samples; i += 4) {
+		_mm_storeu_ps(&pMix[i], _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&pMix[i]), lower_bound), upper_bound));
+	}
+#endif
+	for (; i < num_samples; ++i) {
+		pMix[i] = fminf(fmaxf(pMix[i], -1.0F), 1.0F);
+	}
+}
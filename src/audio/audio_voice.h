@@ -0,0 +1,64 @@
+#ifndef AUDIO_VOICE_H
+#define AUDIO_VOICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "audio_loader.h"
+#include "audio_resampler.h"
+
+// Playback parameters of a voice, set when the voice is started.
+typedef struct AudioVoiceParams {
+	
+	// Linear gain applied to the sound; 1.0 plays the sound at its original volume.
+	float gain;
+	
+	// Stereo position from -1.0 (fully left) through 0.0 (center) to 1.0 (fully right).
+	float pan;
+	
+	// If true, the sound restarts from its first frame when it ends, until the voice is stopped.
+	bool loop;
+	
+	// When every voice is in use, a new sound steals the voice with the lowest priority,
+	// 	as long as that priority is not higher than its own.
+	int32_t priority;
+	
+} AudioVoiceParams;
+
+// One sound playing in the mixer.
+typedef struct AudioVoice {
+	
+	// Identifies the voice to commands from the game thread; zero if the voice is free.
+	uint32_t id;
+	
+	const AudioData *pSound;
+	
+	// The next frame of the sound to mix, or to feed to the resampler if the voice resamples.
+	size_t position;
+	
+	AudioVoiceParams params;
+	
+	// Order in which voices were started, used to steal the oldest of equal-priority voices.
+	uint64_t start_order;
+	
+	// Voices whose sounds are not at the output sample rate, or have more than two channels, are mixed through a resampler.
+	bool resample;
+	AudioResampler resampler;
+	
+} AudioVoice;
+
+// Returns true if the sound can be converted to the output format, so that starting it on a voice cannot fail, false otherwise.
+bool audio_voice_can_play(const AudioData *const pSound);
+
+// Starts a sound on a voice, replacing whatever the voice was playing. Call on the mixer thread.
+// Returns false if the sound cannot be converted to the output format, true otherwise.
+bool audio_voice_start(AudioVoice *const pVoice, const uint32_t id, const AudioData *const pSound, const AudioVoiceParams params, const uint64_t start_order);
+
+// Mixes the next frames of a voice into an interleaved stereo mix buffer.
+// Returns false if the voice has finished playing, true otherwise.
+bool audio_voice_mix(AudioVoice *const pVoice, AudioSample *const pMix, const size_t num_frames);
+
+// Clamps every sample of a mix buffer into [-1.0, 1.0].
+void audio_mix_clamp(AudioSample *const pMix, const size_t num_samples);
+
+#endif	// AUDIO_VOICE_H
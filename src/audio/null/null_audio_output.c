@@ -0,0 +1,81 @@
+#include "null_audio_output.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "audio/audio_config.h"
+#include "audio/audio_mixer.h"
+#include "log/Logger.h"
+
+static pthread_t null_audio_output_thread;
+static atomic_bool null_audio_output_running = false;
+
+// Only accessed on the output thread until it is joined.
+static AudioSample discard_buffer[AUDIO_BUFFER_LENGTH];
+static uint64_t num_buffers_read = 0;
+
+static void *null_audio_output_main(void *arg);
+
+bool init_null_audio_output(void) {
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Initializing null audio output at %u Hz.", get_audio_sample_rate());
+	num_buffers_read = 0;
+	return true;
+}
+
+bool start_null_audio_output(void) {
+	atomic_store(&null_audio_output_running, true);
+	const int thread_create_result = pthread_create(&null_audio_output_thread, nullptr, null_audio_output_main, nullptr);
+	if (thread_create_result != 0) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error starting null audio output: thread creation returned with code %i.", thread_create_result);
+		atomic_store(&null_audio_output_running, false);
+		return false;
+	}
+	return true;
+}
+
+void terminate_null_audio_output(void) {
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Terminating null audio output...");
+	
+	if (!atomic_exchange(&null_audio_output_running, false)) {
+		return;
+	}
+	
+	const int thread_join_result = pthread_join(null_audio_output_thread, nullptr);
+	if (thread_join_result != 0) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error terminating null audio output: thread joining returned with code %i.", thread_join_result);
+	}
+	
+	logMsg(loggerAudio, LOG_LEVEL_INFO, "Null audio output read %llu buffers with %u underruns.", (unsigned long long)num_buffers_read, audio_mixer_get_underrun_count());
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Done terminating null audio output.");
+}
+
+static void *null_audio_output_main(void *arg) {
+	(void)arg;
+	
+	const uint64_t sample_rate = get_audio_sample_rate();
+	struct timespec start_time = { };
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	
+	while (atomic_load(&null_audio_output_running)) {
+		
+		// Each deadline is computed from the total number of frames played so far, 
+		// 	so that rounding does not accumulate into drift away from the sample rate.
+		const uint64_t num_frames_played = (num_buffers_read + 1) * NUM_AUDIO_FRAMES_PER_BUFFER;
+		const uint64_t elapsed_ns = num_frames_played * 1000000000ULL / sample_rate;
+		const uint64_t deadline_ns = (uint64_t)start_time.tv_nsec + elapsed_ns;
+		const struct timespec deadline = {
+			.tv_sec = start_time.tv_sec + (time_t)(deadline_ns / 1000000000ULL),
+			.tv_nsec = (long)(deadline_ns % 1000000000ULL)
+		};
+		
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR);
+		
+		audio_mixer_read_buffer(discard_buffer);
+		num_buffers_read += 1;
+	}
+	
+	return nullptr;
+}
@@ -0,0 +1,16 @@
+#ifndef NULL_AUDIO_OUTPUT_H
+#define NULL_AUDIO_OUTPUT_H
+
+#include <stdbool.h>
+
+// The null audio output reads and discards buffers from the audio mixer at the audio sample rate,
+// 	standing in for an output device when there is none (e.g. when benchmarking on a headless machine).
+bool init_null_audio_output(void);
+
+// Starts the thread that reads from the audio mixer; call after the audio mixer is initialized.
+// Returns true if the thread was started, false otherwise.
+bool start_null_audio_output(void);
+
+void terminate_null_audio_output(void);
+
+#endif	// NULL_AUDIO_OUTPUT_H
@@ -1,6 +1,5 @@
 #include "portaudio_manager.h"
 
-#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -11,15 +10,11 @@
 #include "audio/audio_mixer.h"
 #include "log/Logger.h"
 
-#define INPUT_CHANNEL_COUNT 0
-#define OUTPUT_CHANNEL_COUNT 2
-#define AUDIO_SAMPLE_RATE 44100
-
 static const int num_input_channels = 0;
 static const int num_output_channels = NUM_AUDIO_CHANNELS;
-static const int audio_sample_rate = 44100;
 
 static PaStream *pAudioStream = nullptr;
+static bool stream_started = false;
 
 static int audioStreamCallback(const void *pInputBuffer, void *pOutputBuffer, unsigned long int frameCount, const PaStreamCallbackTimeInfo *pTimeInfo, PaStreamCallbackFlags statusFlags, void *pUserData) {
 	(void)pInputBuffer;
@@ -27,61 +22,79 @@ static int audioStreamCallback(const void *pInputBuffer, void *pOutputBuffer, un
 	(void)statusFlags;
 	(void)pUserData;
 
-	AudioSample *const pOut = (AudioSample *)pOutputBuffer;
-	AudioQueueNode *pNeckNode = (AudioQueueNode *)atomic_load(&audio_mixer_queue.pNeckNode);
-	const AudioQueueNode *const pTailNode = (AudioQueueNode *)atomic_load(&audio_mixer_queue.pTailNode);
-	
-	if (pNeckNode != pTailNode) {
-		for (unsigned long int i = 0; i < frameCount * num_output_channels; ++i) {
-			pOut[i] = pNeckNode->pNextNode->samples[i];
-		}
-		atomic_store(&audio_mixer_queue.pNeckNode, pNeckNode->pNextNode);
-		atomic_fetch_sub(&audio_mixer_queue.num_excess_nodes, 1);
-	} else {
-		memset(pOut, 0, frameCount * sizeof(AudioSample));
+	// The stream is opened with a fixed buffer size, so each callback asks for exactly one mixed buffer.
+	if (frameCount != num_audio_frames_per_buffer) {
+		memset(pOutputBuffer, 0, frameCount * num_output_channels * sizeof(AudioSample));
+		return paContinue;
 	}
+	
+	audio_mixer_read_buffer((AudioSample *)pOutputBuffer);
 	return paContinue;
 }
 
-void init_portaudio(void) {
+bool init_portaudio(void) {
 	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Initializing PortAudio...");
 	
 	const int init_result = Pa_Initialize();
 	if (init_result != paNoError) {
 		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error initializing PortAudio: initialization failed (result code: \"%s\").", Pa_GetErrorText(init_result));
-		return;
+		return false;
+	}
+	
+	int stream_open_result = Pa_OpenDefaultStream(&pAudioStream, num_input_channels, num_output_channels, paFloat32, get_audio_sample_rate(), num_audio_frames_per_buffer, audioStreamCallback, nullptr);
+	
+	// If the device refuses the configured rate, run the mixer at the device's own rate instead; sounds are resampled to it as they are mixed.
+	const PaDeviceInfo *const pDeviceInfo = Pa_GetDeviceInfo(Pa_GetDefaultOutputDevice());
+	if (stream_open_result == paInvalidSampleRate && pDeviceInfo && set_audio_sample_rate((unsigned int)pDeviceInfo->defaultSampleRate)) {
+		logMsg(loggerAudio, LOG_LEVEL_WARNING, "Initializing PortAudio: output device does not support the configured sample rate; using %u Hz instead.", get_audio_sample_rate());
+		stream_open_result = Pa_OpenDefaultStream(&pAudioStream, num_input_channels, num_output_channels, paFloat32, get_audio_sample_rate(), num_audio_frames_per_buffer, audioStreamCallback, nullptr);
 	}
 	
-	const int stream_open_result = Pa_OpenDefaultStream(&pAudioStream, num_input_channels, num_output_channels, paFloat32, audio_sample_rate, num_audio_frames_per_buffer, audioStreamCallback, nullptr);
 	if (stream_open_result != paNoError) {
 		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error initializing PortAudio: failed to open audio stream (result code: \"%s\").", Pa_GetErrorText(stream_open_result));
-		return;
+		pAudioStream = nullptr;
+		Pa_Terminate();
+		return false;
 	}
 
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Done initializing PortAudio.");
+	return true;
+}
+
+bool start_portaudio(void) {
 	const int stream_start_result = Pa_StartStream(pAudioStream);
 	if (stream_start_result != paNoError) {
-		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error initializing PortAudio: failed to start audio stream (result code: \"%s\").", Pa_GetErrorText(stream_start_result));
-		return;
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error starting PortAudio: failed to start audio stream (result code: \"%s\").", Pa_GetErrorText(stream_start_result));
+		return false;
 	}
-
-	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Done initializing PortAudio.");
+	stream_started = true;
+	return true;
 }
 
 void terminate_portaudio(void) {
 	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Terminating PortAudio...");
 	
-	const PaError stopStreamResult = Pa_StopStream(pAudioStream);
-	if (stopStreamResult != paNoError) {
-		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error terminating PortAudio: failed to stop audio stream (result code: \"%s\").", Pa_GetErrorText(stopStreamResult));
+	if (!pAudioStream) {
 		return;
 	}
 	
+	if (stream_started) {
+		const PaError stopStreamResult = Pa_StopStream(pAudioStream);
+		if (stopStreamResult != paNoError) {
+			logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error terminating PortAudio: failed to stop audio stream (result code: \"%s\").", Pa_GetErrorText(stopStreamResult));
+			return;
+		}
+		stream_started = false;
+	}
+	
 	const PaError closeStreamResult = Pa_CloseStream(pAudioStream);
 	if (closeStreamResult != paNoError) {
 		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error terminating PortAudio: failed to close audio stream (result code: \"%s\").", Pa_GetErrorText(closeStreamResult));
 		return;
 	}
 
+	pAudioStream = nullptr;
+
 	const PaError terminatePortAudioResult = Pa_Terminate();
 	if (terminatePortAudioResult != paNoError) {
 		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error terminating PortAudio: termination failed (result code: \"%s\").", Pa_GetErrorText(terminatePortAudioResult));
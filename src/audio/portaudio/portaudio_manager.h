@@ -1,7 +1,16 @@
 #ifndef PORTAUDIO_MANAGER_H
 #define PORTAUDIO_MANAGER_H
 
-void init_portaudio(void);
+#include <stdbool.h>
+
+// Opens a stream on the default output device, which plays buffers from the audio mixer once started.
+// If the device does not support the configured sample rate, the setting is changed to the device's default rate.
+// Returns true if the stream was opened, false otherwise.
+bool init_portaudio(void);
+
+// Starts the stream; call after the audio mixer is initialized.
+// Returns true if the stream was started, false otherwise.
+bool start_portaudio(void);
 void terminate_portaudio(void);
 
 #endif	// PORTAUDIO_MANAGER_H
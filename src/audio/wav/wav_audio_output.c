@@ -0,0 +1,112 @@
+#include "wav_audio_output.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <dr_audio/dr_wav.h>
+
+#include "audio/audio_config.h"
+#include "audio/audio_mixer.h"
+#include "log/Logger.h"
+
+// How long the output thread sleeps when the mixer has no buffer ready.
+#define WAV_AUDIO_OUTPUT_POLL_INTERVAL_NS 1000000L
+
+static pthread_t wav_audio_output_thread;
+static atomic_bool wav_audio_output_running = false;
+
+// Only accessed on the output thread until it is joined.
+static drwav wav_writer;
+static bool wav_file_open = false;
+static AudioSample write_buffer[AUDIO_BUFFER_LENGTH];
+static uint64_t num_frames_written = 0;
+
+static void *wav_audio_output_main(void *arg);
+
+bool init_wav_audio_output(const char *const path) {
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Initializing WAV audio output...");
+	
+	if (!path) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error initializing WAV audio output: path is null.");
+		return false;
+	}
+	
+	const drwav_data_format data_format = {
+		.container = drwav_container_riff,
+		.format = DR_WAVE_FORMAT_IEEE_FLOAT,
+		.channels = NUM_AUDIO_CHANNELS,
+		.sampleRate = get_audio_sample_rate(),
+		.bitsPerSample = 8 * sizeof(AudioSample)
+	};
+	
+	if (!drwav_init_file_write(&wav_writer, path, &data_format, nullptr)) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error initializing WAV audio output: failed to open file \"%s\" for writing.", path);
+		return false;
+	}
+	
+	wav_file_open = true;
+	num_frames_written = 0;
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Done initializing WAV audio output to \"%s\" at %u Hz.", path, get_audio_sample_rate());
+	return true;
+}
+
+bool start_wav_audio_output(void) {
+	atomic_store(&wav_audio_output_running, true);
+	const int thread_create_result = pthread_create(&wav_audio_output_thread, nullptr, wav_audio_output_main, nullptr);
+	if (thread_create_result != 0) {
+		logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error starting WAV audio output: thread creation returned with code %i.", thread_create_result);
+		atomic_store(&wav_audio_output_running, false);
+		return false;
+	}
+	return true;
+}
+
+void terminate_wav_audio_output(void) {
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Terminating WAV audio output...");
+	
+	if (atomic_exchange(&wav_audio_output_running, false)) {
+		const int thread_join_result = pthread_join(wav_audio_output_thread, nullptr);
+		if (thread_join_result != 0) {
+			logMsg(loggerAudio, LOG_LEVEL_ERROR, "Error terminating WAV audio output: thread joining returned with code %i.", thread_join_result);
+		}
+	}
+	
+	if (!wav_file_open) {
+		return;
+	}
+	
+	// Finishing the writer fills in the sizes in the file's header.
+	drwav_uninit(&wav_writer);
+	wav_file_open = false;
+	
+	logMsg(loggerAudio, LOG_LEVEL_INFO, "WAV audio output wrote %llu frames.", (unsigned long long)num_frames_written);
+	logMsg(loggerAudio, LOG_LEVEL_VERBOSE, "Done terminating WAV audio output.");
+}
+
+static void *wav_audio_output_main(void *arg) {
+	(void)arg;
+	
+	static const struct timespec poll_interval = { .tv_sec = 0, .tv_nsec = WAV_AUDIO_OUTPUT_POLL_INTERVAL_NS };
+	
+	while (atomic_load(&wav_audio_output_running)) {
+		
+		// Only buffers that the mixer actually produced are written, so that the file
+		// 	does not depend on how fast the mixer ran compared to this thread.
+		if (audio_mixer_queued_buffer_count() == 0) {
+			nanosleep(&poll_interval, nullptr);
+			continue;
+		}
+		
+		audio_mixer_read_buffer(write_buffer);
+		const drwav_uint64 num_frames = drwav_write_pcm_frames(&wav_writer, NUM_AUDIO_FRAMES_PER_BUFFER, write_buffer);
+		num_frames_written += num_frames;
+		if (num_frames != NUM_AUDIO_FRAMES_PER_BUFFER) {
+			logMsg(loggerAudio, LOG_LEVEL_ERROR, "WAV audio output: wrote only %llu of %u frames; stopping output.", (unsigned long long)num_frames, NUM_AUDIO_FRAMES_PER_BUFFER);
+			break;
+		}
+	}
+	
+	return nullptr;
+}
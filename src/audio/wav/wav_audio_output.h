@@ -0,0 +1,19 @@
+#ifndef WAV_AUDIO_OUTPUT_H
+#define WAV_AUDIO_OUTPUT_H
+
+#include <stdbool.h>
+
+// The WAV audio output writes every buffer from the audio mixer to a 32-bit float WAV file,
+// 	as fast as the mixer produces them. Buffers are written exactly as mixed, so the file can
+// 	be compared bit for bit against a reference to check the mixer's output.
+// Returns true if the file was opened, false otherwise.
+bool init_wav_audio_output(const char *const path);
+
+// Starts the thread that reads from the audio mixer; call after the audio mixer is initialized.
+// Returns true if the thread was started, false otherwise.
+bool start_wav_audio_output(void);
+
+// Stops the thread and finishes the file; buffers still queued in the mixer are not written.
+void terminate_wav_audio_output(void);
+
+#endif	// WAV_AUDIO_OUTPUT_H
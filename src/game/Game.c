@@ -9,7 +9,7 @@
 #include "log/Logger.h"
 #include "render/RenderManager.h"
 #include "render/vulkan/TextureState.h"
-#include "util/Time.h"
+#include "util/GameClock.h"
 #include "area/fgm_file_parse.h"
 #include "entity/entity_manager.h"
 #include "entity/EntityRegistry.h"
@@ -62,6 +62,10 @@ Area currentArea = { };
 // The handle to the player entity.
 static int playerEntityHandle = -1;
 
+// Entity IDs are interned once, so that spawning an entity does not look up its ID by string.
+static StringID entityIDPearl = 0;
+static StringID entityIDSpear = 0;
+
 static void pauseGame(GameState *const pGameState, GameRenderState *const pGameRenderState);
 
 static void toggleDebugMenu(GameRenderState *const pGameRenderState);
@@ -72,11 +76,13 @@ void start_game(void) {
 	
 	currentArea = readAreaData("test");
 	areaRenderStateReset(&currentArea, currentArea.pRooms[currentArea.currentRoomIndex]);
-	playerEntityHandle = loadEntity(makeStaticString("pearl"), makeVec3D(0.0, 0.0, 1.0), zeroVec3D);
+	entityIDPearl = internString(makeStaticString("pearl"));
+	entityIDSpear = internString(makeStaticString("spear"));
+	playerEntityHandle = loadEntity(entityIDPearl, makeVec3D(0.0, 0.0, 1.0), zeroVec3D);
 	
 	// Test entity spawner.
 	EntitySpawner testEntitySpawner = {
-		.entityID = makeStaticString("slime"),
+		.entityID = internString(makeStaticString("slime")),
 		.reloadMode = RELOAD_AFTER_REFRESH,
 		.spawnCounter = 0,
 		.minSpawnCount = 1,
@@ -87,7 +93,7 @@ void start_game(void) {
 	entitySpawnerSpawnEntities(&testEntitySpawner);
 	
 	const RenderObjectLoadInfo loadInfoHearts = {
-		.textureID = makeStaticString("gui/heart3"),
+		.textureID = internString(makeStaticString("gui/heart3")),
 		.quadCount = 3,
 		.pQuadLoadInfos = (QuadLoadInfo[3]){
 			{
@@ -117,7 +123,7 @@ void start_game(void) {
 	renderState.heartsHandle = loadRenderObject(loadInfoHearts);
 	
 	const RenderObjectLoadInfo loadInfoSlots = {
-		.textureID = makeStaticString("gui/slots"),
+		.textureID = internString(makeStaticString("gui/slots")),
 		.quadCount = 1,
 		.pQuadLoadInfos = (QuadLoadInfo[1]){
 			{
@@ -137,6 +143,19 @@ void endGame(void) {
 	deleteArea(&currentArea);
 }
 
+void gameReloadArea(void) {
+	Area area = readAreaData("test");
+	if (!area.pRooms) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error reloading area: failed to read area data.");
+		return;
+	}
+	
+	if (areaReplaceRooms(&currentArea, &area) && renderState.debugMenuEnabled) {
+		areaUnloadWireframes(&currentArea);
+		areaLoadWireframes(&currentArea);
+	}
+}
+
 void tick_game(void) {
 
 	tickRenderManager();
@@ -154,6 +173,7 @@ void tick_game(void) {
 	}
 
 	if (gameState.scrolling) {
+		areaTickScroll(&currentArea);
 		if (areaIsScrolling(currentArea)) {
 			return;
 		}
@@ -177,7 +197,7 @@ void tick_game(void) {
 		const ProjectionBounds projection = areaGetProjectionBounds(currentArea);
 		
 		Vector3D click = { };
-		getCursorPosition(&click.x, &click.y);
+		getInputCursorPosition(&click.x, &click.y);
 		click.x *= projection.right; // Scale to projection
 		click.y *= projection.bottom;
 		click.x += camera.x;
@@ -186,7 +206,7 @@ void tick_game(void) {
 		Vector3D position = pPlayerEntity->physics.position;
 		position.z = 2.0;
 		const Vector3D velocity = mulVec3D(normVec3D(subVec3D(click, position)), 0.5);
-		loadEntity(makeStaticString("spear"), position, velocity);
+		loadEntity(entityIDSpear, position, velocity);
 	}
 	
 	static const double accelerationMagnitude = 0.24;
@@ -257,10 +277,11 @@ GameState getGameState(void) {
 static void pauseGame(GameState *const pGameState, GameRenderState *const pGameRenderState) {
 	assert(pGameState);
 	pGameState->paused = !pGameState->paused;
+	gameClockSetPaused(pGameState->paused);
 	if (pGameState->paused) {
 		pGameRenderState->pauseTextHandle = loadRenderText(makeStaticString("Paused"), makeVec3D(-1.5, 0.25, 3.0), COLOR_WHITE);
 	} else {
-		unloadRenderObject(&pGameRenderState->pauseTextHandle);
+		unloadRenderText(&pGameRenderState->pauseTextHandle);
 	}
 }
 
@@ -274,9 +295,9 @@ static void toggleDebugMenu(GameRenderState *const pGameRenderState) {
 		drawEntityHitboxes();
 		areaLoadWireframes(&currentArea);
 	} else {
-		unloadRenderObject(&pGameRenderState->debugTextHandles[0]);
-		unloadRenderObject(&pGameRenderState->debugTextHandles[1]);
-		unloadRenderObject(&pGameRenderState->debugTextHandles[2]);
+		unloadRenderText(&pGameRenderState->debugTextHandles[0]);
+		unloadRenderText(&pGameRenderState->debugTextHandles[1]);
+		unloadRenderText(&pGameRenderState->debugTextHandles[2]);
 		undrawEntityHitboxes();
 		areaUnloadWireframes(&currentArea);
 	}
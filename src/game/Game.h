@@ -16,6 +16,9 @@ void start_game(void);
 
 void endGame(void);
 
+// Reads the current area again and replaces the contents of its rooms in place, keeping the player and the camera where they are.
+void gameReloadArea(void);
+
 void tick_game(void);
 
 GameState getGameState(void);
@@ -0,0 +1,99 @@
+#include "HotReload.h"
+
+#include <string.h>
+#include "log/Logger.h"
+#include "render/vulkan/texture_manager.h"
+#include "render/vulkan/VulkanManager.h"
+#include "util/FileWatcher.h"
+#include "util/String.h"
+#include "util/VirtualFileSystem.h"
+#include "Game.h"
+
+#define AREA_PATH "data/DemoDungeon.fga"
+#define SHADER_PREFIX "shaders/"
+#define SHADER_SUFFIX ".spv"
+#define TEXTURE_PREFIX "assets/textures/"
+#define TEXTURE_SUFFIX ".png"
+
+static const char *const watchedDirectories[3] = {
+	"data",
+	"shaders",
+	"assets/textures"
+};
+
+static bool hotReloadInitialized = false;
+
+static bool stringStartsWith(const char *const pString, const char *const pPrefix) {
+	return strncmp(pString, pPrefix, strlen(pPrefix)) == 0;
+}
+
+static bool stringEndsWith(const char *const pString, const char *const pSuffix) {
+	const size_t length = strlen(pString);
+	const size_t suffixLength = strlen(pSuffix);
+	return length >= suffixLength && strcmp(&pString[length - suffixLength], pSuffix) == 0;
+}
+
+static void reloadTextureFile(const char *const pPath) {
+	// The texture ID is the path of the image inside the texture directory, without the extension.
+	const char *const pTexturePath = &pPath[strlen(TEXTURE_PREFIX)];
+	String textureID = newString(strlen(pTexturePath) + 1, pTexturePath);
+	stringRemoveTrailingChars(&textureID, strlen(TEXTURE_SUFFIX));
+
+	int textureHandle = textureHandleMissing;
+	if (!textureManagerReloadTexture(textureID, &textureHandle)) {
+		logMsg(loggerGame, LOG_LEVEL_WARNING, "Hot reload: \"%s\" was not reloaded; it is not a loaded texture, or the reload could not be queued.", pPath);
+		deleteString(&textureID);
+		return;
+	}
+	logMsg(loggerGame, LOG_LEVEL_INFO, "Hot reload: reloading texture \"%s\".", textureID.pBuffer);
+	deleteString(&textureID);
+
+	// Room layers stitched from the area's tileset are copies of it, so they are stitched again, after the reload on the render thread.
+	if (textureHandle == currentArea.renderState.tilemapTextureState.textureHandle) {
+		for (int32_t i = 0; i < currentArea.roomCount; ++i) {
+			areaReloadRoomLayers(&currentArea, i);
+		}
+	}
+}
+
+static void reloadChangedFile(const char *const pPath) {
+	if (vfsIsArchived(pPath)) {
+		logMsg(loggerGame, LOG_LEVEL_WARNING, "Hot reload: \"%s\" changed, but a mounted archive has the file, so the change is not used.", pPath);
+		return;
+	}
+
+	if (strcmp(pPath, AREA_PATH) == 0) {
+		logMsg(loggerGame, LOG_LEVEL_INFO, "Hot reload: reloading area \"%s\"...", pPath);
+		gameReloadArea();
+	} else if (stringStartsWith(pPath, SHADER_PREFIX) && stringEndsWith(pPath, SHADER_SUFFIX)) {
+		reloadShader(&pPath[strlen(SHADER_PREFIX)]);
+	} else if (stringStartsWith(pPath, TEXTURE_PREFIX) && stringEndsWith(pPath, TEXTURE_SUFFIX)) {
+		reloadTextureFile(pPath);
+	} else if (stringStartsWith(pPath, "data/")) {
+		logMsg(loggerGame, LOG_LEVEL_WARNING, "Hot reload: \"%s\" changed, but it cannot be reloaded; restart to load it.", pPath);
+	}
+}
+
+bool initHotReload(void) {
+	logMsg(loggerGame, LOG_LEVEL_VERBOSE, "Initializing hot reload...");
+	hotReloadInitialized = initFileWatcher(sizeof(watchedDirectories) / sizeof(watchedDirectories[0]), watchedDirectories);
+	if (!hotReloadInitialized) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error initializing hot reload: failed to start watching resource files.");
+		return false;
+	}
+	logMsg(loggerGame, LOG_LEVEL_INFO, "Hot reload is enabled.");
+	return true;
+}
+
+void terminateHotReload(void) {
+	if (hotReloadInitialized) {
+		terminateFileWatcher();
+		hotReloadInitialized = false;
+	}
+}
+
+void serviceHotReload(void) {
+	if (hotReloadInitialized) {
+		pollFileWatcher(reloadChangedFile);
+	}
+}
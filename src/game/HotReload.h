@@ -0,0 +1,19 @@
+#ifndef HOT_RELOAD_H
+#define HOT_RELOAD_H
+
+#include <stdbool.h>
+
+// Reloads resources while the game runs when their files change, so that content can be edited without restarting:
+// 	area files replace the contents of the area's rooms, texture images are uploaded into their existing textures,
+// 	and shaders recreate only the pipelines built from them.
+
+// Starts watching the resource directories for changed files.
+// Returns true if successful, false otherwise.
+bool initHotReload(void);
+
+void terminateHotReload(void);
+
+// Reloads the resources whose files changed since the last call; call between ticks.
+void serviceHotReload(void);
+
+#endif	// HOT_RELOAD_H
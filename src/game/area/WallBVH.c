@@ -0,0 +1,244 @@
+#include "WallBVH.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include "log/Logger.h"
+#include "util/Allocation.h"
+
+static BoxD boxUnion(const BoxD a, const BoxD b) {
+	return (BoxD){
+		.x1 = fmin(a.x1, b.x1),
+		.y1 = fmin(a.y1, b.y1),
+		.x2 = fmax(a.x2, b.x2),
+		.y2 = fmax(a.y2, b.y2)
+	};
+}
+
+static bool boxesTouch(const BoxD a, const BoxD b) {
+	return a.x1 <= b.x2 && a.x2 >= b.x1 && a.y1 <= b.y2 && a.y2 >= b.y1;
+}
+
+static int compareWallCentersX(const void *pA, const void *pB) {
+	const BoxD *const a = pA;
+	const BoxD *const b = pB;
+	const double centerA = a->x1 + a->x2;
+	const double centerB = b->x1 + b->x2;
+	return (centerA > centerB) - (centerA < centerB);
+}
+
+static int compareWallCentersY(const void *pA, const void *pB) {
+	const BoxD *const a = pA;
+	const BoxD *const b = pB;
+	const double centerA = a->y1 + a->y2;
+	const double centerB = b->y1 + b->y2;
+	return (centerA > centerB) - (centerA < centerB);
+}
+
+// Builds the subtree over walls [first, first + count), splitting at the median wall center along the longer axis of the centers' bounds.
+static void buildNode(BoxD *const pWalls, const uint32_t first, const uint32_t count, const uint32_t depth, WallBVH *const pBVH) {
+	const uint32_t nodeIndex = pBVH->nodeCount++;
+	WallBVHNode *const pNode = &pBVH->pNodes[nodeIndex];
+
+	pNode->bounds = pWalls[first];
+	BoxD centerBounds = { pWalls[first].x1 + pWalls[first].x2, pWalls[first].y1 + pWalls[first].y2,
+			pWalls[first].x1 + pWalls[first].x2, pWalls[first].y1 + pWalls[first].y2 };
+	for (uint32_t i = first + 1; i < first + count; ++i) {
+		pNode->bounds = boxUnion(pNode->bounds, pWalls[i]);
+		const double centerX = pWalls[i].x1 + pWalls[i].x2;
+		const double centerY = pWalls[i].y1 + pWalls[i].y2;
+		centerBounds = boxUnion(centerBounds, (BoxD){ centerX, centerY, centerX, centerY });
+	}
+
+	if (count <= WALL_BVH_LEAF_SIZE || depth + 1 >= WALL_BVH_MAX_DEPTH) {
+		pNode->index = first;
+		pNode->wallCount = count;
+		return;
+	}
+
+	const bool splitX = boxWidthD(centerBounds) >= boxLengthD(centerBounds);
+	qsort(&pWalls[first], count, sizeof(BoxD), splitX ? compareWallCentersX : compareWallCentersY);
+
+	const uint32_t leftCount = count / 2;
+	pNode->wallCount = 0;
+	buildNode(pWalls, first, leftCount, depth + 1, pBVH);
+	// The node array is not reallocated during the build, so the node pointer is still valid.
+	pNode->index = pBVH->nodeCount;
+	buildNode(pWalls, first + leftCount, count - leftCount, depth + 1, pBVH);
+}
+
+bool createWallBVH(const uint32_t wallCount, BoxD *const pWalls, WallBVH *const pOutBVH) {
+	if (!pOutBVH) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Creating wall BVH: pointer to output BVH is null.");
+		return false;
+	}
+	*pOutBVH = (WallBVH){ };
+
+	if (wallCount == 0) {
+		return true;
+	} else if (!pWalls) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Creating wall BVH: pointer to wall array is null.");
+		return false;
+	}
+
+	// A binary tree with at least one wall per leaf has fewer than twice as many nodes as walls.
+	pOutBVH->pNodes = heapAlloc(2 * (size_t)wallCount, sizeof(WallBVHNode));
+	if (!pOutBVH->pNodes) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Creating wall BVH: failed to allocate node array.");
+		return false;
+	}
+
+	buildNode(pWalls, 0, wallCount, 0, pOutBVH);
+	return true;
+}
+
+void deleteWallBVH(WallBVH *const pBVH) {
+	if (!pBVH) {
+		return;
+	}
+	if (pBVH->pNodes) {
+		heapFree(pBVH->pNodes);
+	}
+	*pBVH = (WallBVH){ };
+}
+
+uint32_t wallBVHQueryBox(const WallBVH bvh, const BoxD *const pWalls, const BoxD bounds, const uint32_t maxWallCount, uint32_t *const pWallIndices) {
+	if (bvh.nodeCount == 0 || !pWalls) {
+		return 0;
+	}
+
+	// Depth-first traversal holds at most one pending sibling per level.
+	uint32_t foundCount = 0;
+	uint32_t stack[WALL_BVH_MAX_DEPTH + 1];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const uint32_t nodeIndex = stack[--stackSize];
+		const WallBVHNode node = bvh.pNodes[nodeIndex];
+		if (!boxesTouch(node.bounds, bounds)) {
+			continue;
+		}
+
+		if (node.wallCount == 0) {
+			stack[stackSize++] = node.index;
+			stack[stackSize++] = nodeIndex + 1;
+			continue;
+		}
+
+		for (uint32_t i = node.index; i < node.index + node.wallCount; ++i) {
+			if (boxesTouch(pWalls[i], bounds)) {
+				if (pWallIndices && foundCount < maxWallCount) {
+					pWallIndices[foundCount] = i;
+				}
+				foundCount += 1;
+			}
+		}
+	}
+
+	// Sort the written indices, so that callers can visit the walls in their stored order.
+	const uint32_t writtenCount = foundCount < maxWallCount ? foundCount : maxWallCount;
+	if (pWallIndices) {
+		for (uint32_t i = 1; i < writtenCount; ++i) {
+			const uint32_t wallIndex = pWallIndices[i];
+			uint32_t j = i;
+			for (; j > 0 && pWallIndices[j - 1] > wallIndex; --j) {
+				pWallIndices[j] = pWallIndices[j - 1];
+			}
+			pWallIndices[j] = wallIndex;
+		}
+	}
+
+	return foundCount;
+}
+
+// Intersects a ray with a box using the slab method.
+// Returns the distance to where the ray enters the box (zero if it starts inside), or INFINITY if it misses.
+static double raycastBox(const BoxD box, const double originX, const double originY, const double inverseDirectionX, const double inverseDirectionY, const double maxDistance) {
+	double entry = 0.0;
+	double exit = maxDistance;
+
+	if (isinf(inverseDirectionX)) {
+		if (originX < box.x1 || originX > box.x2) {
+			return INFINITY;
+		}
+	} else {
+		const double t1 = (box.x1 - originX) * inverseDirectionX;
+		const double t2 = (box.x2 - originX) * inverseDirectionX;
+		entry = fmax(entry, fmin(t1, t2));
+		exit = fmin(exit, fmax(t1, t2));
+	}
+
+	if (isinf(inverseDirectionY)) {
+		if (originY < box.y1 || originY > box.y2) {
+			return INFINITY;
+		}
+	} else {
+		const double t1 = (box.y1 - originY) * inverseDirectionY;
+		const double t2 = (box.y2 - originY) * inverseDirectionY;
+		entry = fmax(entry, fmin(t1, t2));
+		exit = fmin(exit, fmax(t1, t2));
+	}
+
+	return entry <= exit ? entry : INFINITY;
+}
+
+bool wallBVHRaycast(const WallBVH bvh, const BoxD *const pWalls, const Vector3D origin, const Vector3D direction, const double maxDistance, WallRaycastHit *const pHit) {
+	if (bvh.nodeCount == 0 || !pWalls) {
+		return false;
+	}
+
+	const double directionLength = sqrt(direction.x * direction.x + direction.y * direction.y);
+	if (directionLength == 0.0) {
+		logMsg(loggerGame, LOG_LEVEL_WARNING, "Raycasting walls: ray direction has no length in the xy-plane.");
+		return false;
+	}
+
+	// Distances are measured along the normalized direction, so that they are in world units.
+	const double inverseDirectionX = directionLength / direction.x;
+	const double inverseDirectionY = directionLength / direction.y;
+
+	double nearestDistance = INFINITY;
+	uint32_t nearestWallIndex = 0;
+
+	uint32_t stack[WALL_BVH_MAX_DEPTH + 1];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const uint32_t nodeIndex = stack[--stackSize];
+		const WallBVHNode node = bvh.pNodes[nodeIndex];
+		const double limit = fmin(maxDistance, nearestDistance);
+		if (raycastBox(node.bounds, origin.x, origin.y, inverseDirectionX, inverseDirectionY, limit) > limit) {
+			continue;
+		}
+
+		if (node.wallCount == 0) {
+			stack[stackSize++] = node.index;
+			stack[stackSize++] = nodeIndex + 1;
+			continue;
+		}
+
+		for (uint32_t i = node.index; i < node.index + node.wallCount; ++i) {
+			const double distance = raycastBox(pWalls[i], origin.x, origin.y, inverseDirectionX, inverseDirectionY, fmin(maxDistance, nearestDistance));
+			if (distance < nearestDistance) {
+				nearestDistance = distance;
+				nearestWallIndex = i;
+			}
+		}
+	}
+
+	if (isinf(nearestDistance)) {
+		return false;
+	}
+
+	if (pHit) {
+		*pHit = (WallRaycastHit){
+			.wallIndex = nearestWallIndex,
+			.distance = nearestDistance,
+			.position = (Vector3D){
+				.x = origin.x + direction.x / directionLength * nearestDistance,
+				.y = origin.y + direction.y / directionLength * nearestDistance,
+				.z = origin.z
+			}
+		};
+	}
+	return true;
+}
@@ -0,0 +1,62 @@
+#ifndef WALL_BVH_H
+#define WALL_BVH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "math/Box.h"
+#include "math/Vector.h"
+
+// The most walls held in one leaf of a wall BVH.
+#define WALL_BVH_LEAF_SIZE 4
+
+// The deepest a wall BVH can be; more than enough for any room, since leaves are split at the median.
+#define WALL_BVH_MAX_DEPTH 32
+
+// A node of a wall BVH. Nodes are stored depth-first, so an interior node's first child directly follows it.
+typedef struct WallBVHNode {
+
+	BoxD bounds;
+
+	// For a leaf, the index of the first of its walls; for an interior node, the index of its second child.
+	uint32_t index;
+
+	// The number of walls in a leaf, or zero for an interior node.
+	uint32_t wallCount;
+
+} WallBVHNode;
+
+// A bounding volume hierarchy over the walls of a room.
+// Each leaf covers a contiguous range of the walls it was built from.
+typedef struct WallBVH {
+	uint32_t nodeCount;
+	WallBVHNode *pNodes;
+} WallBVH;
+
+typedef struct WallRaycastHit {
+
+	// The index of the wall that was hit.
+	uint32_t wallIndex;
+
+	// The distance from the ray's origin to the hit.
+	double distance;
+
+	Vector3D position;
+
+} WallRaycastHit;
+
+// Builds a BVH over an array of walls, reordering the walls so that each leaf covers a contiguous range of them.
+// Returns true if successful, false otherwise.
+bool createWallBVH(const uint32_t wallCount, BoxD *const pWalls, WallBVH *const pOutBVH);
+
+void deleteWallBVH(WallBVH *const pBVH);
+
+// Finds the walls that overlap or touch a box.
+// Writes up to maxWallCount wall indices, in ascending order, and returns the total number of walls found.
+uint32_t wallBVHQueryBox(const WallBVH bvh, const BoxD *const pWalls, const BoxD bounds, const uint32_t maxWallCount, uint32_t *const pWallIndices);
+
+// Finds the nearest wall hit by a ray in the xy-plane within a maximum distance; the z components are ignored.
+// Returns true and fills in the hit if a wall was hit, false otherwise.
+bool wallBVHRaycast(const WallBVH bvh, const BoxD *const pWalls, const Vector3D origin, const Vector3D direction, const double maxDistance, WallRaycastHit *const pHit);
+
+#endif	// WALL_BVH_H
@@ -3,12 +3,14 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include "log/Logger.h"
 #include "render/render_config.h"
 #include "render/RenderManager.h"
+#include "render/vulkan/RoomTilemap.h"
 #include "render/vulkan/compute/ComputeStitchTexture.h"
 #include "util/Allocation.h"
-#include "util/Time.h"
+#include "util/GameClock.h"
 
 #define swap(x, y) {\
 		typeof(x) tmp = x; \
@@ -31,6 +33,29 @@ static String roomSizeToTextureID(const RoomSize roomSize) {
 	return roomMTextureID;
 }
 
+// Fills the layers of a room cache slot with a room, either by stitching the slot's part of the room texture,
+// 	or by uploading the room's tile indices and having the layer quads read the tileset directly.
+static void areaLoadRoomLayers(Area *const pArea, const uint32_t cacheSlot, const int32_t quadIndices[NUM_ROOM_LAYERS], const Room room) {
+	if (getRoomRenderMode() == ROOM_RENDER_MODE_TILEMAP) {
+		if (!roomTilemapUpload(cacheSlot, pArea->renderState.tilemapTextureState.textureHandle, pArea->room_extent, room.ppTileIndices)) {
+			logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading room layers: failed to upload tilemap of room %i.", room.id);
+			return;
+		}
+		for (uint32_t layer = 0; layer < numRoomLayers; ++layer) {
+			renderObjectSetQuadTilemap(pArea->renderState.renderObjectHandle, quadIndices[layer], cacheSlot, layer);
+		}
+		return;
+	}
+	
+	const int32_t textureHandle = renderObjectGetTextureHandle(pArea->renderState.renderObjectHandle, quadIndices[0]);
+	const ImageSubresourceRange imageSubresourceRange = {
+		.imageAspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+		.baseArrayLayer = cacheSlot * numRoomLayers,
+		.arrayLayerCount = numRoomLayers
+	};
+	computeStitchTexture(pArea->renderState.tilemapTextureState.textureHandle, textureHandle, imageSubresourceRange, pArea->room_extent, room.ppTileIndices);
+}
+
 void deleteArea(Area *const pArea) {
 	assert(pArea);
 	heapFree(pArea->pRooms);
@@ -170,19 +195,13 @@ bool areaSetNextRoom(Area *const pArea, const CardinalDirection direction) {
 		pArea->renderState.nextRoomQuadIndices[0] = renderObjectLoadQuad(pArea->renderState.renderObjectHandle, quadLoadInfos[0]);
 		pArea->renderState.nextRoomQuadIndices[1] = renderObjectLoadQuad(pArea->renderState.renderObjectHandle, quadLoadInfos[1]);
 		
-		const int32_t textureHandle = renderObjectGetTextureHandle(pArea->renderState.renderObjectHandle, 0);
-		const ImageSubresourceRange imageSubresourceRange = {
-			.imageAspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-			.baseArrayLayer = nextCacheSlot * numRoomLayers,
-			.arrayLayerCount = numRoomLayers
-		};
-		computeStitchTexture(pArea->renderState.tilemapTextureState.textureHandle, textureHandle, imageSubresourceRange, pArea->room_extent, pNextRoom->ppTileIndices);
+		areaLoadRoomLayers(pArea, nextCacheSlot, pArea->renderState.nextRoomQuadIndices, *pNextRoom);
 	} else {
 		//swap(pArea->renderState.currentRoomQuadIndices[0], pArea->renderState.nextRoomQuadIndices[0]);
 		//swap(pArea->renderState.currentRoomQuadIndices[1], pArea->renderState.nextRoomQuadIndices[1]);
 	}
 	pArea->renderState.nextCacheSlot = nextCacheSlot;
-	pArea->renderState.scrollStartTimeMS = getMilliseconds();
+	pArea->renderState.scrollStartTimeMS = gameClockGetTickTimeMS();
 	pArea->renderState.roomIDsToCacheSlots[pNextRoom->id] = pArea->renderState.nextCacheSlot;
 	pArea->renderState.cacheSlotsToRoomIDs[pArea->renderState.nextCacheSlot] = pNextRoom->id;
 	pArea->currentRoomIndex = pNextRoom->id;
@@ -297,6 +316,11 @@ void areaRenderStateReset(Area *const pArea, const Room initialRoom) {
 		pArea->renderState.cacheSlotsToRoomIDs[i] = UINT32_MAX;
 	}
 	
+	// Every room in the area has the same extent, so the tile data buffer only has to grow when a new area is loaded.
+	if (getRoomRenderMode() == ROOM_RENDER_MODE_TILEMAP && !roomTilemapReserve(pArea->room_extent)) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error resetting area render state: failed to reserve room tilemaps for room extent (%u, %u).", pArea->room_extent.width, pArea->room_extent.length);
+	}
+	
 	pArea->renderState.currentCacheSlot = 0;
 	pArea->renderState.nextCacheSlot = 0;
 	pArea->renderState.roomIDsToCacheSlots[initialRoom.id] = pArea->renderState.currentCacheSlot;
@@ -321,7 +345,8 @@ void areaRenderStateReset(Area *const pArea, const Room initialRoom) {
 		}
 	};
 	const RenderObjectLoadInfo renderObjectLoadInfo = {
-		.textureID = roomSizeToTextureID(initialRoom.size),
+		// Tilemap rooms use no room texture, so their quads get the missing texture until their tilemaps are set.
+		.textureID = getRoomRenderMode() == ROOM_RENDER_MODE_STITCHED ? internString(roomSizeToTextureID(initialRoom.size)) : stringIDNull,
 		.quadCount = NUM_ROOM_LAYERS,
 		.pQuadLoadInfos = (QuadLoadInfo[NUM_ROOM_LAYERS]){
 			{
@@ -347,17 +372,91 @@ void areaRenderStateReset(Area *const pArea, const Room initialRoom) {
 	pArea->renderState.nextRoomQuadIndices[0] = -1;
 	pArea->renderState.nextRoomQuadIndices[1] = -1;
 	
-	const int32_t textureHandle = renderObjectGetTextureHandle(pArea->renderState.renderObjectHandle, 0);
-	const ImageSubresourceRange imageSubresourceRange = {
-		.imageAspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-		.baseArrayLayer = pArea->renderState.currentCacheSlot * numRoomLayers,
-		.arrayLayerCount = numRoomLayers
-	};
-	computeStitchTexture(pArea->renderState.tilemapTextureState.textureHandle, textureHandle, imageSubresourceRange, pArea->room_extent, initialRoom.ppTileIndices);
+	areaLoadRoomLayers(pArea, pArea->renderState.currentCacheSlot, pArea->renderState.currentRoomQuadIndices, initialRoom);
 	
 	logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Reset area render state.");
 }
 
+void areaReloadRoomLayers(Area *const pArea, const int32_t roomIndex) {
+	assert(pArea);
+	if (roomIndex < 0 || roomIndex >= pArea->roomCount) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error reloading room layers: room index %i is invalid.", roomIndex);
+		return;
+	}
+	
+	// The current cache slot is drawn with the current room quads, and the other slot with the next room quads.
+	for (uint32_t cacheSlot = 0; cacheSlot < numRoomTextureCacheSlots; ++cacheSlot) {
+		if (pArea->renderState.cacheSlotsToRoomIDs[cacheSlot] != (uint32_t)roomIndex) {
+			continue;
+		}
+		const int32_t *const quadIndices = cacheSlot == pArea->renderState.currentCacheSlot 
+				? pArea->renderState.currentRoomQuadIndices : pArea->renderState.nextRoomQuadIndices;
+		if (quadIndices[0] >= 0) {
+			areaLoadRoomLayers(pArea, cacheSlot, quadIndices, pArea->pRooms[roomIndex]);
+		}
+	}
+}
+
+// Returns true if the tiles or the walls of two rooms of the same extent differ.
+static bool roomsDiffer(const Room roomA, const Room roomB) {
+	const size_t tileDataSize = extentArea(roomA.extent) * sizeof(uint32_t);
+	for (uint32_t layer = 0; layer < numRoomLayers; ++layer) {
+		if (memcmp(roomA.ppTileIndices[layer], roomB.ppTileIndices[layer], tileDataSize) != 0) {
+			return true;
+		}
+	}
+	return roomA.wallCount != roomB.wallCount 
+		|| (roomA.wallCount > 0 && memcmp(roomA.pWalls, roomB.pWalls, roomA.wallCount * sizeof(BoxD)) != 0);
+}
+
+bool areaReplaceRooms(Area *const pArea, Area *const pNewArea) {
+	assert(pArea);
+	assert(pNewArea);
+	
+	if (!pNewArea->pRooms) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error replacing area rooms: new area has no rooms.");
+		return false;
+	}
+	
+	// The render state and entities refer to rooms by index and position, so only the contents of the rooms may change.
+	bool sameLayout = pNewArea->extent.x1 == pArea->extent.x1 && pNewArea->extent.y1 == pArea->extent.y1
+			&& pNewArea->extent.x2 == pArea->extent.x2 && pNewArea->extent.y2 == pArea->extent.y2
+			&& pNewArea->room_size == pArea->room_size
+			&& pNewArea->roomCount == pArea->roomCount;
+	for (int32_t i = 0; i < pArea->roomCount && sameLayout; ++i) {
+		sameLayout = pNewArea->pRooms[i].position.x == pArea->pRooms[i].position.x 
+				&& pNewArea->pRooms[i].position.y == pArea->pRooms[i].position.y;
+	}
+	if (!sameLayout) {
+		logMsg(loggerGame, LOG_LEVEL_WARNING, "Replacing area rooms: the layout of the area changed; restart to load it.");
+		for (int32_t i = 0; i < pNewArea->roomCount; ++i) {
+			deleteRoom(pNewArea->pRooms[i]);
+		}
+		deleteArea(pNewArea);
+		return false;
+	}
+	
+	uint32_t changedRoomCount = 0;
+	for (int32_t i = 0; i < pArea->roomCount; ++i) {
+		if (!roomsDiffer(pArea->pRooms[i], pNewArea->pRooms[i])) {
+			deleteRoom(pNewArea->pRooms[i]);
+			continue;
+		}
+		deleteRoom(pArea->pRooms[i]);
+		pArea->pRooms[i] = pNewArea->pRooms[i];
+		areaReloadRoomLayers(pArea, i);
+		changedRoomCount += 1;
+	}
+	
+	// Every room of the copy was either moved into the area or deleted.
+	deleteArea(pNewArea);
+	logMsg(loggerGame, LOG_LEVEL_INFO, "Replaced %u changed rooms of area.", changedRoomCount);
+	return true;
+}
+
+// How long it takes to scroll from one room to the next.
+static const uint64_t scrollTimeLimitMS = 1024;
+
 bool areaIsScrolling(const Area area) {
 	return area.renderState.currentCacheSlot != area.renderState.nextCacheSlot;
 }
@@ -388,19 +487,29 @@ Vector4F areaGetCameraPosition(Area *const pArea) {
 		.w = 1.0F
 	};
 	
-	static const uint64_t timeLimitMS = 1024;
-	const uint64_t currentTimeMS = getMilliseconds();
+	// The camera moves smoothly with frame time; the scroll itself ends on a tick, in areaTickScroll.
+	const uint64_t currentTimeMS = gameClockGetFrameTimeMS();
+	const uint64_t scrollTimeMS = currentTimeMS > pArea->renderState.scrollStartTimeMS ? currentTimeMS - pArea->renderState.scrollStartTimeMS : 0;
+	if (scrollTimeMS >= scrollTimeLimitMS) {
+		return end;
+	}
+	
+	const double deltaTime = (double)scrollTimeMS / (double)(scrollTimeLimitMS);
+	return lerpVec4F(start, end, deltaTime);
+}
+
+void areaTickScroll(Area *const pArea) {
+	assert(pArea);
+	if (!areaIsScrolling(*pArea)) {
+		return;
+	}
 	
 	// If the scrolling time limit is reached, update the current room slot to equal the next room cache slot.
-	if (currentTimeMS - pArea->renderState.scrollStartTimeMS >= timeLimitMS) {
+	if (gameClockGetTickTimeMS() - pArea->renderState.scrollStartTimeMS >= scrollTimeLimitMS) {
 		pArea->renderState.currentCacheSlot = pArea->renderState.nextCacheSlot;
 		swap(pArea->renderState.currentRoomQuadIndices[0], pArea->renderState.nextRoomQuadIndices[0]);
 		swap(pArea->renderState.currentRoomQuadIndices[1], pArea->renderState.nextRoomQuadIndices[1]);
-		return end;
 	}
-	
-	const double deltaTime = (double)(currentTimeMS - pArea->renderState.scrollStartTimeMS) / (double)(timeLimitMS);
-	return lerpVec4F(start, end, deltaTime);
 }
 
 ProjectionBounds areaGetProjectionBounds(const Area area) {
@@ -111,10 +111,23 @@ Offset direction_offset(const CardinalDirection direction);
 void areaRenderStateReset(Area *const pArea, const Room initialRoom);
 
 // Returns true if the current cache slot and the next cache slot are not equal, false otherwise.
+// Fills the room texture cache slots that hold a room with the room again, e.g. after its tiles or tileset changed.
+void areaReloadRoomLayers(Area *const pArea, const int32_t roomIndex);
+
+// Moves the rooms of a newly read copy of an area into the area in place, keeping its render state, 
+// 	and reloads the layers of the rooms that changed.
+// Fails without changing the area if the copy does not have the same extent, room size and room positions.
+// The copy is deleted either way.
+// Returns true if successful, false otherwise.
+bool areaReplaceRooms(Area *const pArea, Area *const pNewArea);
+
 bool areaIsScrolling(const Area area);
 
 Vector4F areaGetCameraPosition(Area *const pArea);
 
+// Ends the scroll between rooms once it has run its full length in tick time. Call once per game tick.
+void areaTickScroll(Area *const pArea);
+
 ProjectionBounds areaGetProjectionBounds(const Area area);
 
 void areaLoadWireframes(Area *const pArea);
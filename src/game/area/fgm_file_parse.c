@@ -2,27 +2,31 @@
 
 #include <stdio.h>
 #include <string.h>
-#include "config.h"
 #include "log/Logger.h"
 #include "render/render_config.h"
 #include "util/Allocation.h"
-#include "util/FileIO.h"
+#include "util/BinaryReader.h"
+#include "util/VirtualFileSystem.h"
 
-#define FGA_FILE_DIRECTORY (RESOURCE_PATH "data/DemoDungeon.fga")
+#define FGA_FILE_DIRECTORY "data/DemoDungeon.fga"
 
-static int readRoomData(const File file, Room *const pRoom);
+static int readRoomData(BinaryReader *const pReader, Room *const pRoom);
 
 Area readAreaData(const char *const pFilename) {
 	
 	Area area = { };
-	File file = openFile(FGA_FILE_DIRECTORY, FMODE_READ, FMODE_NO_UPDATE, FMODE_BINARY);
+	BinaryReader reader = { };
+	if (!vfsOpenBinaryReader(FGA_FILE_DIRECTORY, &reader)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading area file: failed to open file.");
+		return (Area){ };
+	}
 
 	// Check file label.
-	char label[4];
-	fread(label, 1, 4, file.pStream);
-	if (strcmp(label, "FGA") != 0) {
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading area file: invalid file format; found label \"%s\".", label);
-		closeFile(&file);
+	char label[4] = { };
+	binaryReadBytes(&reader, sizeof(label), label);
+	if (memcmp(label, "FGA", sizeof(label)) != 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading area file: invalid file format; found label \"%.4s\".", label);
+		closeBinaryReader(&reader);
 		return (Area){ };
 	}
 	
@@ -35,19 +39,21 @@ Area readAreaData(const char *const pFilename) {
 	 * Room data
 	*/
 	
-	fileReadData(file, 1, sizeof(area.extent), &area.extent);
+	area.extent.x1 = binaryReadI32(&reader);
+	area.extent.y1 = binaryReadI32(&reader);
+	area.extent.x2 = binaryReadI32(&reader);
+	area.extent.y2 = binaryReadI32(&reader);
 	const int areaWidth = boxWidth(area.extent);
 	const int areaLength = boxLength(area.extent);
 	const long int extentArea = areaWidth * areaLength;
 	
 	// Read room size type.
-	uint32_t roomSizeType = 0;
-	fileReadData(file, 1, sizeof(roomSizeType), &roomSizeType);
+	const uint32_t roomSizeType = binaryReadU32(&reader);
 
 	// Validate room size type, must be between 0 and 3, inclusive.
 	if (roomSizeType >= num_room_sizes) {
 		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error creating area: room size type is invalid (%u).", roomSizeType);
-		closeFile(&file);
+		closeBinaryReader(&reader);
 		return (Area){ };
 	}
 
@@ -55,13 +61,18 @@ Area readAreaData(const char *const pFilename) {
 	area.room_extent = room_size_to_extent(area.room_size);
 	
 	// Read room count.
-	fileReadData(file, 1, sizeof(area.roomCount), &area.roomCount);
+	area.roomCount = binaryReadI32(&reader);
+	if (reader.failed || area.roomCount <= 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error creating area: failed to read area header, or room count is invalid (%i).", area.roomCount);
+		closeBinaryReader(&reader);
+		return (Area){ };
+	}
 	
 	// Allocate array of rooms.
 	area.pRooms = heapAlloc(area.roomCount, sizeof(Room));
 	if (!area.pRooms) {
 		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error creating area: allocation of area.pRooms failed.");
-		closeFile(&file);
+		closeBinaryReader(&reader);
 		return (Area){ };
 	}
 
@@ -70,7 +81,7 @@ Area readAreaData(const char *const pFilename) {
 	if (!area.pPositionsToRooms) {
 		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error creating area: allocation of area.pPositionsToRooms failed.");
 		heapFree(area.pRooms);
-		closeFile(&file);
+		closeBinaryReader(&reader);
 		return (Area){ };
 	}
 
@@ -90,12 +101,12 @@ Area readAreaData(const char *const pFilename) {
 		area.pRooms[i].entity_spawners = nullptr;	// Feature not yet implemented.
 		
 		// Read room data.
-		const int result = readRoomData(file, &area.pRooms[i]);
+		const int result = readRoomData(&reader, &area.pRooms[i]);
 		if (result != 0) {
 			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error creating area: error encountered while reading data for room %u (error code = %i).", i, result);
 			heapFree(area.pRooms);
 			heapFree(area.pPositionsToRooms);
-			closeFile(&file);
+			closeBinaryReader(&reader);
 			return (Area){ };
 		}
 
@@ -104,11 +115,11 @@ Area readAreaData(const char *const pFilename) {
 		area.pPositionsToRooms[roomPosition] = i;
 	}
 	
-	closeFile(&file);
+	closeBinaryReader(&reader);
 	return area;
 }
 
-static int readRoomData(const File file, Room *const pRoom) {
+static int readRoomData(BinaryReader *const pReader, Room *const pRoom) {
 	
 	/* Order of data reading:
 	 * Room Position (2 * i32)
@@ -133,15 +144,20 @@ static int readRoomData(const File file, Room *const pRoom) {
 	}
 	
 	// Read room position from file.
-	fileReadData(file, 1, sizeof(Offset), &pRoom->position);
+	pRoom->position.x = binaryReadI32(pReader);
+	pRoom->position.y = binaryReadI32(pReader);
 	
 	// Read tile data for each layer from file.
 	for (uint32_t i = 0; i < numRoomLayers; ++i) {
-		fileReadData(file, numTiles, sizeof(uint32_t), pRoom->ppTileIndices[i]);
+		binaryReadU32Array(pReader, numTiles, pRoom->ppTileIndices[i]);
 	}
 	
 	// Read wall count from the file.
-	fileReadData(file, 1, sizeof(uint32_t), &pRoom->wallCount);
+	pRoom->wallCount = binaryReadU32(pReader);
+	if (pReader->failed) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading area file: failed to read room tile data.");
+		return -2;
+	}
 	
 	if (pRoom->wallCount > 0) {
 		// Allocate array for the walls.
@@ -152,7 +168,21 @@ static int readRoomData(const File file, Room *const pRoom) {
 		}
 		
 		// Read wall data from the file.
-		fileReadData(file, pRoom->wallCount, sizeof(BoxD), pRoom->pWalls);
+		for (uint32_t i = 0; i < pRoom->wallCount; ++i) {
+			pRoom->pWalls[i].x1 = binaryReadF64(pReader);
+			pRoom->pWalls[i].y1 = binaryReadF64(pReader);
+			pRoom->pWalls[i].x2 = binaryReadF64(pReader);
+			pRoom->pWalls[i].y2 = binaryReadF64(pReader);
+		}
+		if (pReader->failed) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading area file: failed to read room wall data.");
+			return -2;
+		}
+		
+		if (!roomPrepareWalls(pRoom)) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading area file: failed to prepare room walls.");
+			return -1;
+		}
 	}
 	
 	return 0;
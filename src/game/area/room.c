@@ -1,5 +1,6 @@
 #include "room.h"
 
+#include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include "log/Logger.h"
@@ -25,4 +26,154 @@ void deleteRoom(Room room) {
 	}
 	heapFree(room.ppTileIndices);
 	heapFree(room.pWalls);
+	deleteCollisionWalls(&room.collisionWalls);
+	deleteWallBVH(&room.wallBVH);
+}
+
+// The most walls gathered from the BVH for a single collision test; if more are near, every wall is tested instead.
+#define MAX_NEARBY_WALL_COUNT 64
+
+static int compareWallRows(const void *pA, const void *pB) {
+	const BoxD *const a = pA;
+	const BoxD *const b = pB;
+	if (a->y1 != b->y1) {
+		return a->y1 < b->y1 ? -1 : 1;
+	} else if (a->y2 != b->y2) {
+		return a->y2 < b->y2 ? -1 : 1;
+	}
+	return (a->x1 > b->x1) - (a->x1 < b->x1);
+}
+
+static int compareWallColumns(const void *pA, const void *pB) {
+	const BoxD *const a = pA;
+	const BoxD *const b = pB;
+	if (a->x1 != b->x1) {
+		return a->x1 < b->x1 ? -1 : 1;
+	} else if (a->x2 != b->x2) {
+		return a->x2 < b->x2 ? -1 : 1;
+	}
+	return (a->y1 > b->y1) - (a->y1 < b->y1);
+}
+
+// Merges each run of walls that span the same rows and touch or overlap side by side (or the same columns, end to end) into one wall.
+// Returns the number of walls left at the front of the array.
+static uint32_t mergeWallRuns(const uint32_t wallCount, BoxD *const pWalls, const bool rows) {
+	qsort(pWalls, wallCount, sizeof(BoxD), rows ? compareWallRows : compareWallColumns);
+	
+	uint32_t mergedCount = 0;
+	for (uint32_t i = 0; i < wallCount; ++i) {
+		BoxD *const pLast = mergedCount > 0 ? &pWalls[mergedCount - 1] : nullptr;
+		const BoxD wall = pWalls[i];
+		if (pLast && rows && pLast->y1 == wall.y1 && pLast->y2 == wall.y2 && wall.x1 <= pLast->x2) {
+			pLast->x2 = fmax(pLast->x2, wall.x2);
+		} else if (pLast && !rows && pLast->x1 == wall.x1 && pLast->x2 == wall.x2 && wall.y1 <= pLast->y2) {
+			pLast->y2 = fmax(pLast->y2, wall.y2);
+		} else {
+			pWalls[mergedCount++] = wall;
+		}
+	}
+	return mergedCount;
+}
+
+bool roomPrepareWalls(Room *const pRoom) {
+	if (!pRoom) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Preparing room walls: pointer to room is null.");
+		return false;
+	}
+	
+	// Merge rows and columns alternately until no more walls merge.
+	// Walls built from tiles become horizontal strips first, and strips of the same width then stack into rectangles.
+	const uint32_t originalWallCount = pRoom->wallCount;
+	uint32_t wallCount = originalWallCount;
+	bool rows = true;
+	for (uint32_t unchangedPasses = 0; unchangedPasses < 2 && wallCount > 1; rows = !rows) {
+		const uint32_t mergedCount = mergeWallRuns(wallCount, pRoom->pWalls, rows);
+		unchangedPasses = mergedCount == wallCount ? unchangedPasses + 1 : 0;
+		wallCount = mergedCount;
+	}
+	pRoom->wallCount = wallCount;
+	
+	if (!createWallBVH(pRoom->wallCount, pRoom->pWalls, &pRoom->wallBVH)) {
+		return false;
+	}
+	
+	if (!createCollisionWalls(pRoom->wallCount, pRoom->pWalls, &pRoom->collisionWalls)) {
+		deleteWallBVH(&pRoom->wallBVH);
+		return false;
+	}
+	
+	logMsg(loggerGame, LOG_LEVEL_VERBOSE, "Prepared room %i walls: merged %u walls into %u, with %u BVH nodes.", 
+			pRoom->id, originalWallCount, pRoom->wallCount, pRoom->wallBVH.nodeCount);
+	return true;
+}
+
+uint32_t roomQueryWalls(const Room *const pRoom, const BoxD bounds, const uint32_t maxWallCount, uint32_t *const pWallIndices) {
+	if (!pRoom) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Querying room walls: pointer to room is null.");
+		return 0;
+	}
+	return wallBVHQueryBox(pRoom->wallBVH, pRoom->pWalls, bounds, maxWallCount, pWallIndices);
+}
+
+bool roomRaycastWalls(const Room *const pRoom, const Vector3D origin, const Vector3D direction, const double maxDistance, WallRaycastHit *const pHit) {
+	if (!pRoom) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Raycasting room walls: pointer to room is null.");
+		return false;
+	}
+	return wallBVHRaycast(pRoom->wallBVH, pRoom->pWalls, origin, direction, maxDistance, pHit);
+}
+
+Vector3D roomResolveWallCollisions(const Room *const pRoom, const BoxD hitbox, const Vector3D previousPosition, const Vector3D positionStep) {
+	if (!pRoom) {
+		return addVec(previousPosition, positionStep);
+	}
+	
+	// A wall can only change the step if it touches the hitbox somewhere within the step's length of the previous position,
+	// 	since any step it resolves to is shorter than the original step. The margin covers rounding in resolveCollision.
+	const double reach = sqrt(positionStep.x * positionStep.x + positionStep.y * positionStep.y + positionStep.z * positionStep.z) + 1.0e-6;
+	const BoxD bounds = {
+		.x1 = previousPosition.x + hitbox.x1 - reach,
+		.y1 = previousPosition.y + hitbox.y1 - reach,
+		.x2 = previousPosition.x + hitbox.x2 + reach,
+		.y2 = previousPosition.y + hitbox.y2 + reach
+	};
+	
+	// Gather the nearby walls in their stored order, so that they resolve the same as if every wall were tested.
+	uint32_t wallIndices[MAX_NEARBY_WALL_COUNT];
+	const uint32_t nearbyWallCount = roomQueryWalls(pRoom, bounds, MAX_NEARBY_WALL_COUNT, wallIndices);
+	
+	Vector3D resolvedPosition;
+	if (nearbyWallCount > MAX_NEARBY_WALL_COUNT) {
+		resolvedPosition = resolveWallCollisions(pRoom->collisionWalls, hitbox, previousPosition, positionStep);
+	} else {
+		double x1[MAX_NEARBY_WALL_COUNT], y1[MAX_NEARBY_WALL_COUNT], x2[MAX_NEARBY_WALL_COUNT], y2[MAX_NEARBY_WALL_COUNT];
+		for (uint32_t i = 0; i < nearbyWallCount; ++i) {
+			const BoxD wall = pRoom->pWalls[wallIndices[i]];
+			x1[i] = wall.x1;
+			y1[i] = wall.y1;
+			x2[i] = wall.x2;
+			y2[i] = wall.y2;
+		}
+		const CollisionWalls nearbyWalls = {
+			.count = nearbyWallCount,
+			.pX1 = x1,
+			.pY1 = y1,
+			.pX2 = x2,
+			.pY2 = y2
+		};
+		resolvedPosition = resolveWallCollisions(nearbyWalls, hitbox, previousPosition, positionStep);
+	}
+	
+	if (getCollisionValidation()) {
+		const Vector3D referencePosition = resolveWallCollisionsReference(pRoom->collisionWalls, hitbox, previousPosition, positionStep);
+		if (resolvedPosition.x != referencePosition.x || resolvedPosition.y != referencePosition.y || resolvedPosition.z != referencePosition.z) {
+			logMsg(loggerGame, LOG_LEVEL_ERROR, "Resolving room wall collisions: result (%.17g, %.17g, %.17g) differs from reference result (%.17g, %.17g, %.17g); previous position (%.17g, %.17g, %.17g), step (%.17g, %.17g, %.17g).",
+					resolvedPosition.x, resolvedPosition.y, resolvedPosition.z,
+					referencePosition.x, referencePosition.y, referencePosition.z,
+					previousPosition.x, previousPosition.y, previousPosition.z,
+					positionStep.x, positionStep.y, positionStep.z);
+		}
+	}
+	
+	return resolvedPosition;
 }
\ No newline at end of file
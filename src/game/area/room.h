@@ -1,12 +1,17 @@
 #ifndef ROOM_H
 #define ROOM_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "game/entity/Collision.h"
 #include "game/entity/EntitySpawner.h"
 #include "math/Box.h"
 #include "math/extent.h"
 #include "math/offset.h"
+#include "math/Vector.h"
+
+#include "WallBVH.h"
 
 #define NUM_ROOM_SIZES 4
 
@@ -34,6 +39,12 @@ typedef struct Room {
 	unsigned int wallCount;
 	BoxD *pWalls;
 	
+	// The same walls, laid out for testing entities against them in batches.
+	CollisionWalls collisionWalls;
+	
+	// Bounding volume hierarchy over the walls, for finding the walls in an area or along a ray.
+	WallBVH wallBVH;
+	
 	unsigned int num_entity_spawners;
 	EntitySpawner *entity_spawners;
 
@@ -43,4 +54,21 @@ Extent room_size_to_extent(const RoomSize room_size);
 
 void deleteRoom(Room room);
 
+// Merges adjacent walls of the room into larger walls, and builds the structures used to test entities against them.
+// Call once after the room's walls are loaded; this reorders the walls.
+// Returns true if successful, false otherwise.
+bool roomPrepareWalls(Room *const pRoom);
+
+// Finds the walls of the room that overlap or touch a box.
+// Writes up to maxWallCount indices into the room's wall array, in ascending order, and returns the total number of walls found.
+uint32_t roomQueryWalls(const Room *const pRoom, const BoxD bounds, const uint32_t maxWallCount, uint32_t *const pWallIndices);
+
+// Finds the nearest wall of the room hit by a ray in the xy-plane, within a maximum distance.
+// Returns true and fills in the hit if a wall was hit, false otherwise.
+bool roomRaycastWalls(const Room *const pRoom, const Vector3D origin, const Vector3D direction, const double maxDistance, WallRaycastHit *const pHit);
+
+// Moves an entity's hitbox from its previous position by a step, stopping or sliding it against the walls of the room.
+// Only the walls near the step are tested. Returns the resolved position of the entity.
+Vector3D roomResolveWallCollisions(const Room *const pRoom, const BoxD hitbox, const Vector3D previousPosition, const Vector3D positionStep);
+
 #endif	// ROOM_H
@@ -0,0 +1,489 @@
+#include "Collision.h"
+
+#include <stdint.h>
+#include "log/Logger.h"
+#include "util/Allocation.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define SQUARE(x) ((x) * (x))
+
+// How much an entity is slowed down when sliding against a wall; must match resolveCollision.
+static const double frictionFactor = 0.75;
+
+static bool collisionValidationEnabled = false;
+
+bool createCollisionWalls(const unsigned int wallCount, const BoxD *const pWalls, CollisionWalls *const pOutWalls) {
+	if (!pOutWalls) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Creating collision walls: pointer to output walls is null.");
+		return false;
+	}
+	*pOutWalls = (CollisionWalls){ };
+
+	if (wallCount == 0) {
+		return true;
+	} else if (!pWalls) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Creating collision walls: pointer to wall array is null.");
+		return false;
+	}
+
+	double *const pData = heapAlloc(4 * (size_t)wallCount, sizeof(double));
+	if (!pData) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Creating collision walls: failed to allocate wall arrays.");
+		return false;
+	}
+
+	pOutWalls->count = wallCount;
+	pOutWalls->pX1 = pData;
+	pOutWalls->pY1 = pData + wallCount;
+	pOutWalls->pX2 = pData + 2 * (size_t)wallCount;
+	pOutWalls->pY2 = pData + 3 * (size_t)wallCount;
+	for (unsigned int i = 0; i < wallCount; ++i) {
+		pOutWalls->pX1[i] = pWalls[i].x1;
+		pOutWalls->pY1[i] = pWalls[i].y1;
+		pOutWalls->pX2[i] = pWalls[i].x2;
+		pOutWalls->pY2[i] = pWalls[i].y2;
+	}
+	return true;
+}
+
+void deleteCollisionWalls(CollisionWalls *const pWalls) {
+	if (!pWalls) {
+		return;
+	}
+	if (pWalls->pX1) {
+		heapFree(pWalls->pX1);
+	}
+	*pWalls = (CollisionWalls){ };
+}
+
+void setCollisionValidation(const bool enabled) {
+	collisionValidationEnabled = enabled;
+}
+
+bool getCollisionValidation(void) {
+	return collisionValidationEnabled;
+}
+
+Vector3D resolveCollision(const Vector3D old_position, const Vector3D new_position, const BoxD hitbox, const BoxD wall) {
+	/*
+	Collision detection and correction works by transforming 
+	the entity's velocity vector into a linear function:
+	
+	y = mx + b, { s < x < e }, where
+	
+	x is the independent variable and represents the entity's position in the x-axis,
+	y is the dependent variable and represents the entity's position in the y-axis,
+	m is the slope of the function and the ratio of y component of the velocity to the x component,
+	b is the y-intercept of the function,
+	s is the lower bound of the domain of the function and represents 
+		the starting point of the entity's travel along the x-axis, and
+	e is the upper bound of the domain of the function and represents
+		the ending point of the entity's travel along the x-axis.
+	
+	Four such functions can be generated, one for each corner of the hitbox, 
+	using x as the independent variable and y as the dependent variable. 
+	Four more can be generated swapping the axes,
+	which effectively checks for collision in the y-direction instead of the x-direction.
+	One function is generated for each corner of the entity's hitbox, for these are the
+	extremities of the entity's body. With the extremities, collision can be checked
+	with the following independently sufficient conditions:
+	
+	1. Any extremity is both above the lower bound and below the upper bound of the wall, OR
+	2. The lower extremity is above the lower bound of the wall, and the upper extremity
+		is below the upper bound of the wall.
+	
+	Any of these conditions being fulfilled means that collision has happened.
+	
+	There are two extremities when checking collision on a particular axis. 
+	Though there are four corners, only two are at the fore of the entity's movement
+	and can collide with a wall that the entity may move into.
+	Because of this, two linear functions are generated, one for each of those
+	two corners--one upper function and one lower function.
+	In order to generate these functions, first the base linear function
+	must be transposed such that the origin is at the old position of the entity:
+	
+	y - old_position.y = m(x - old_position.x).
+	
+	This is also known as 'point-slope form' of a linear function.
+	The function then can be rearranged back into 'slope-intercept form':
+	
+	y = m(x - old_position.x) + old_position.y.
+	
+	Keep in mind that the domain of the function is also transposed:
+	
+	y - old_position.y = m(x - old_position.x) { s < x - old_position.x < e }; 
+	y = m(x - old_position.x) + old_position.y { s + old_position.x < x < e + old_position.x }.
+	
+	The function now maps to the travel of the entity when graphed:
+	
+	+y |
+	   |
+	 6 |      B
+	   |     /
+	 4 |    /
+	   |   /
+	 2 |  A
+	   |
+	   O---------------------------
+	   	2 4 6 8 |    |    |    | +x
+	   		   10   15   20   25
+	
+	The capital A represents the old position of the entity, and
+	the capital B represents the projected new position of the entity.
+	
+	This process can be repeated for each of the two extremities to produce
+	the lower and upper functions. When moving right, which is the +x direction,
+	the +x side of the hitbox will be the outward extremity, and is represented with hitbox.x2.
+	When moving left, which is the -x direction, the -x side of 
+	the hitbox will be the outward extremity, and is represented with hitbox.x1.
+	The lower extremity will always use the lower side of the hitbox, which is
+	represented with hitbox.y1. The upper extremity will always use the upper side
+	of the hitbox, which is represented with hitbox.y2.
+	
+	Assuming moving right for convenience, the lower function is created like this:
+	
+	y - hitbox.y1 = m((x - hitbox.x2) - old_position.x) + old_position.y 
+		{ s + old_position.x < x - hitbox.x2 < e + old_position.x };
+	y = m(x - hitbox.x2 - old_position.x) + old_position.y + hitbox.y1 
+		{ s + old_position.x + hitbox.x2 < x < e + old_position.x + hitbox.x2 }.
+	
+	Similarly, the upper function is created like this:
+	
+	y - hitbox.y2 = m((x - hitbox.x2) - old_position.x) + old_position.y 
+		{ s + old_position.x < x - hitbox.x2 < e + old_position.x };
+	y = m(x - hitbox.x2 - old_position.x) + old_position.y + hitbox.y2 
+		{ s + old_position.x + hitbox.x2 < x < e + old_position.x + hitbox.x2 }.
+	
+	When x is set to an x-position, then y equals the y-position along the line of travel.
+	Theoretically, this extends out to infinity, but we are only concerned with the entity's
+	movement in a single step, which is not infinite; thus, we restrict the function to a domain
+	representing the start and end point of the entity's travel.
+	Now it is possible to check for collision, by finding the exact y-position of each of 
+	the extremities in the entity's travel, and then comparing these y-positions to the
+	upper and lower y-positions of the wall, using the above conditions:
+	
+	if wall.y1 < y_lower < wall.y2 OR wall.y1 < y_upper < wall.y2 
+		OR (y_lower < wall.y1 AND y_upper > wall.y2), then
+	
+		the entity collides.
+	*/
+
+	// This parameter determines how much the entity is slowed down when sliding against a wall.
+	static const double friction_factor = 0.75;
+
+	const Vector3D position_step = subVec(new_position, old_position);
+	Vector3D resolved_position = new_position; 
+
+	if (position_step.x > 0.0) {
+		// If the wall is entirely behind or ahead of the entity as it moves right, then skip collision resolution.
+		if (old_position.x + hitbox.x1 >= wall.x2 || new_position.x + hitbox.x2 <= wall.x1) {
+			goto skip;
+		}
+
+		const double slope_y = position_step.y / position_step.x;
+		const double x_boundary = wall.x1 - old_position.x - hitbox.x2;
+		const double lower_intersection = slope_y * x_boundary + old_position.y + hitbox.y1;
+		const double upper_intersection = slope_y * x_boundary + old_position.y + hitbox.y2;
+		
+		const bool lower_collision = lower_intersection > wall.y1 && lower_intersection < wall.y2;
+		const bool upper_collision = upper_intersection > wall.y1 && upper_intersection < wall.y2;
+		const bool surround_collision = lower_intersection < wall.y1 && upper_intersection > wall.y2;
+
+		// Test for lower and upper collision in the +x direction.
+		if (lower_collision || upper_collision || surround_collision) {
+			// If the entity is flush against the wall, then strip the x-component from the entity's velocity.
+			if (old_position.x + hitbox.x2 == wall.x1) {
+				Vector3D resolved_step = position_step;
+				resolved_step.x = 0.0;
+				resolved_step.y *= friction_factor;
+				resolved_position = addVec(old_position, resolved_step);
+			} else {
+				resolved_position = new_position;
+				resolved_position.x = wall.x1 - hitbox.x2;
+				resolved_position.y = slope_y * (resolved_position.x - old_position.x) + old_position.y;
+			}
+			goto correct;
+		}
+	} else if (position_step.x < 0.0) {
+		// If the wall is entirely behind or ahead of the entity as it moves left, then skip collision resolution.
+		if (old_position.x + hitbox.x2 <= wall.x1 || new_position.x + hitbox.x1 >= wall.x2) {
+			goto skip;
+		}
+
+		const double slope_y = position_step.y / position_step.x;
+		const double x_boundary = wall.x2 - old_position.x - hitbox.x1;
+		const double lower_intersection = slope_y * x_boundary + old_position.y + hitbox.y1;
+		const double upper_intersection = slope_y * x_boundary + old_position.y + hitbox.y2;
+		
+		const bool lower_collision = lower_intersection > wall.y1 && lower_intersection < wall.y2;
+		const bool upper_collision = upper_intersection > wall.y1 && upper_intersection < wall.y2;
+		const bool surround_collision = lower_intersection < wall.y1 && upper_intersection > wall.y2;
+
+		// Test for lower and upper collision in the -x direction.
+		if (lower_collision || upper_collision || surround_collision) {
+			// If the entity is flush against the wall, then strip the x-component from the entity's velocity.
+			if (old_position.x + hitbox.x1 == wall.x2) {
+				Vector3D resolved_step = position_step;
+				resolved_step.x = 0.0;
+				resolved_step.y *= friction_factor;
+				resolved_position = addVec(old_position, resolved_step);
+			} else {
+				resolved_position = new_position;
+				resolved_position.x = wall.x2 - hitbox.x1;
+				resolved_position.y = slope_y * (resolved_position.x - old_position.x) + old_position.y;
+			}
+			goto correct;
+		}
+	}
+
+	if (position_step.y > 0.0) {
+		// If the wall is entirely below or above the entity as it moves up, then skip collision resolution.
+		if (old_position.y + hitbox.y1 >= wall.y2 || new_position.y + hitbox.y2 <= wall.y1) {
+			goto skip;
+		}
+
+		const double slope_x = position_step.x / position_step.y;
+		const double y_boundary = wall.y1 - old_position.y - hitbox.y2;
+		const double left_intersection = slope_x * y_boundary + old_position.x + hitbox.x1;
+		const double right_intersection = slope_x * y_boundary + old_position.x + hitbox.x2;
+		
+		const bool left_collision = left_intersection > wall.x1 && left_intersection < wall.x2;
+		const bool right_collision = right_intersection > wall.x1 && right_intersection < wall.x2;
+		const bool surround_collision = left_intersection < wall.x1 && right_intersection > wall.x2;
+
+		// Test for left and right collision in the +y direction.
+		if (left_collision || right_collision || surround_collision) {
+			// If the entity is flush against the wall, then strip the y-component from the entity's velocity.
+			if (old_position.y + hitbox.y2 == wall.y1) {
+				Vector3D resolved_step = position_step;
+				resolved_step.y = 0.0;
+				resolved_step.x *= friction_factor;
+				resolved_position = addVec(old_position, resolved_step);
+			} else {
+				resolved_position = new_position;
+				resolved_position.y = wall.y1 - hitbox.y2;
+				resolved_position.x = slope_x * (resolved_position.y - old_position.y) + old_position.x;
+			}
+			goto correct;
+		}
+	} else if (position_step.y < 0.0) {
+		// If the wall is entirely below or above the entity as it moves down, then skip collision resolution.
+		if (old_position.y + hitbox.y2 <= wall.y1 || new_position.y + hitbox.y1 >= wall.y2) {
+			goto skip;
+		}
+
+		const double slope_x = position_step.x / position_step.y;
+		const double y_boundary = wall.y2 - old_position.y - hitbox.y1;
+		const double left_intersection = slope_x * y_boundary + old_position.x + hitbox.x1;
+		const double right_intersection = slope_x * y_boundary + old_position.x + hitbox.x2;
+		
+		const bool left_collision = left_intersection > wall.x1 && left_intersection < wall.x2;
+		const bool right_collision = right_intersection > wall.x1 && right_intersection < wall.x2;
+		const bool surround_collision = left_intersection < wall.x1 && right_intersection > wall.x2;
+
+		// Test for left and right collision in the -y direction.
+		if (left_collision || right_collision || surround_collision) {
+			// If the entity is flush against the wall, then strip the y-component from the entity's velocity.
+			if (old_position.y + hitbox.y1 == wall.y2) {
+				Vector3D resolved_step = position_step;
+				resolved_step.y = 0.0;
+				resolved_step.x *= friction_factor;
+				resolved_position = addVec(old_position, resolved_step);
+			} else {
+				resolved_position = new_position;
+				resolved_position.y = wall.y2 - hitbox.y1;
+				resolved_position.x = slope_x * (resolved_position.y - old_position.y) + old_position.x;
+			}
+			goto correct;
+		}
+	}
+
+skip: // Jump to this label if the movement step does not need to be corrected, i.e. there is no collision.
+	return new_position;
+
+correct: // Jump to this label if the movement step needs to be corrected, i.e. there is collision.
+	return resolved_position;
+}
+
+// Resolves the step against a single wall, keeping the result if it is shorter than the current step.
+static inline void resolveWallScalar(const CollisionWalls walls, const unsigned int index, const BoxD hitbox, const Vector3D previousPosition,
+		Vector3D *const pNextPosition, double *const pStepLengthSquared) {
+
+	const BoxD wall = { walls.pX1[index], walls.pY1[index], walls.pX2[index], walls.pY2[index] };
+	const Vector3D resolvedPosition = resolveCollision(previousPosition, *pNextPosition, hitbox, wall);
+	const Vector3D resolvedStep = subVec(resolvedPosition, previousPosition);
+	const double resolvedStepLengthSquared = SQUARE(resolvedStep.x) + SQUARE(resolvedStep.y) + SQUARE(resolvedStep.z);
+
+	if (resolvedStepLengthSquared < *pStepLengthSquared) {
+		*pNextPosition = resolvedPosition;
+		*pStepLengthSquared = resolvedStepLengthSquared;
+	}
+}
+
+Vector3D resolveWallCollisionsReference(const CollisionWalls walls, const BoxD hitbox, const Vector3D previousPosition, const Vector3D positionStep) {
+	Vector3D nextPosition = addVec(previousPosition, positionStep);
+	double stepLengthSquared = SQUARE(positionStep.x) + SQUARE(positionStep.y) + SQUARE(positionStep.z);
+	for (unsigned int i = 0; i < walls.count; ++i) {
+		resolveWallScalar(walls, i, hitbox, previousPosition, &nextPosition, &stepLengthSquared);
+	}
+	return nextPosition;
+}
+
+#if defined(__SSE2__)
+
+static inline __m128d selectPD(const __m128d mask, const __m128d a, const __m128d b) {
+	return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+// The collision conditions of resolveCollision: either extremity of the hitbox is within the wall, or the hitbox surrounds the wall.
+static inline __m128d extremitiesOverlapPD(const __m128d lower, const __m128d upper, const __m128d wallLower, const __m128d wallUpper) {
+	const __m128d lowerCollision = _mm_and_pd(_mm_cmpgt_pd(lower, wallLower), _mm_cmplt_pd(lower, wallUpper));
+	const __m128d upperCollision = _mm_and_pd(_mm_cmpgt_pd(upper, wallLower), _mm_cmplt_pd(upper, wallUpper));
+	const __m128d surroundCollision = _mm_and_pd(_mm_cmplt_pd(lower, wallLower), _mm_cmpgt_pd(upper, wallUpper));
+	return _mm_or_pd(_mm_or_pd(lowerCollision, upperCollision), surroundCollision);
+}
+
+// Resolves the step against two consecutive walls at once, computing exactly what resolveCollision computes for each of them.
+// Returns a bit mask of the walls whose resolved step is shorter than stepLengthSquared, with bit 0 for the first wall.
+// The direction of the step is the same for both walls, so only the walls' bounds vary between the two lanes.
+static int resolveWallPair(const CollisionWalls walls, const unsigned int first, const BoxD hitbox, const Vector3D previousPosition,
+		const Vector3D nextPosition, const double stepLengthSquared, Vector3D resolvedPositions[2], double resolvedStepLengthsSquared[2]) {
+
+	const Vector3D positionStep = subVec(nextPosition, previousPosition);
+
+	const __m128d wallX1 = _mm_loadu_pd(&walls.pX1[first]);
+	const __m128d wallY1 = _mm_loadu_pd(&walls.pY1[first]);
+	const __m128d wallX2 = _mm_loadu_pd(&walls.pX2[first]);
+	const __m128d wallY2 = _mm_loadu_pd(&walls.pY2[first]);
+
+	const __m128d nextX = _mm_set1_pd(nextPosition.x);
+	const __m128d nextY = _mm_set1_pd(nextPosition.y);
+	const __m128d nextZ = _mm_set1_pd(nextPosition.z);
+	const __m128d slideZ = _mm_set1_pd(previousPosition.z + positionStep.z);
+
+	// Collision in the x-direction.
+	__m128d skipX = _mm_setzero_pd();
+	__m128d hitX = _mm_setzero_pd();
+	__m128d resolvedXX = nextX;
+	__m128d resolvedXY = nextY;
+	__m128d resolvedXZ = nextZ;
+	if (positionStep.x > 0.0 || positionStep.x < 0.0) {
+		const bool positive = positionStep.x > 0.0;
+
+		// The side of the wall that the entity moves into, and the side of the hitbox that leads the movement.
+		const __m128d nearWall = positive ? wallX1 : wallX2;
+		const __m128d farWall = positive ? wallX2 : wallX1;
+		const double headEdge = positive ? hitbox.x2 : hitbox.x1;
+		const double tailEdge = positive ? hitbox.x1 : hitbox.x2;
+
+		// The wall is entirely behind or ahead of the entity.
+		const __m128d tail = _mm_set1_pd(previousPosition.x + tailEdge);
+		const __m128d head = _mm_set1_pd(nextPosition.x + headEdge);
+		skipX = positive ? _mm_or_pd(_mm_cmpge_pd(tail, farWall), _mm_cmple_pd(head, nearWall))
+				: _mm_or_pd(_mm_cmple_pd(tail, farWall), _mm_cmpge_pd(head, nearWall));
+
+		const __m128d slopeY = _mm_set1_pd(positionStep.y / positionStep.x);
+		const __m128d boundary = _mm_sub_pd(_mm_sub_pd(nearWall, _mm_set1_pd(previousPosition.x)), _mm_set1_pd(headEdge));
+		const __m128d intersection = _mm_add_pd(_mm_mul_pd(slopeY, boundary), _mm_set1_pd(previousPosition.y));
+		const __m128d lowerIntersection = _mm_add_pd(intersection, _mm_set1_pd(hitbox.y1));
+		const __m128d upperIntersection = _mm_add_pd(intersection, _mm_set1_pd(hitbox.y2));
+		hitX = _mm_andnot_pd(skipX, extremitiesOverlapPD(lowerIntersection, upperIntersection, wallY1, wallY2));
+
+		// If the entity is flush against the wall, it slides along the wall; otherwise it stops at the wall.
+		const __m128d flush = _mm_cmpeq_pd(_mm_set1_pd(previousPosition.x + headEdge), nearWall);
+		const __m128d stopX = _mm_sub_pd(nearWall, _mm_set1_pd(headEdge));
+		const __m128d stopY = _mm_add_pd(_mm_mul_pd(slopeY, _mm_sub_pd(stopX, _mm_set1_pd(previousPosition.x))), _mm_set1_pd(previousPosition.y));
+		resolvedXX = selectPD(flush, _mm_set1_pd(previousPosition.x + 0.0), stopX);
+		resolvedXY = selectPD(flush, _mm_set1_pd(previousPosition.y + positionStep.y * frictionFactor), stopY);
+		resolvedXZ = selectPD(flush, slideZ, nextZ);
+	}
+
+	// Collision in the y-direction, for walls that are neither skipped nor collided with in the x-direction.
+	__m128d hitY = _mm_setzero_pd();
+	__m128d resolvedYX = nextX;
+	__m128d resolvedYY = nextY;
+	__m128d resolvedYZ = nextZ;
+	if (positionStep.y > 0.0 || positionStep.y < 0.0) {
+		const bool positive = positionStep.y > 0.0;
+
+		const __m128d nearWall = positive ? wallY1 : wallY2;
+		const __m128d farWall = positive ? wallY2 : wallY1;
+		const double headEdge = positive ? hitbox.y2 : hitbox.y1;
+		const double tailEdge = positive ? hitbox.y1 : hitbox.y2;
+
+		const __m128d tail = _mm_set1_pd(previousPosition.y + tailEdge);
+		const __m128d head = _mm_set1_pd(nextPosition.y + headEdge);
+		const __m128d skipY = positive ? _mm_or_pd(_mm_cmpge_pd(tail, farWall), _mm_cmple_pd(head, nearWall))
+				: _mm_or_pd(_mm_cmple_pd(tail, farWall), _mm_cmpge_pd(head, nearWall));
+
+		const __m128d slopeX = _mm_set1_pd(positionStep.x / positionStep.y);
+		const __m128d boundary = _mm_sub_pd(_mm_sub_pd(nearWall, _mm_set1_pd(previousPosition.y)), _mm_set1_pd(headEdge));
+		const __m128d intersection = _mm_add_pd(_mm_mul_pd(slopeX, boundary), _mm_set1_pd(previousPosition.x));
+		const __m128d leftIntersection = _mm_add_pd(intersection, _mm_set1_pd(hitbox.x1));
+		const __m128d rightIntersection = _mm_add_pd(intersection, _mm_set1_pd(hitbox.x2));
+		hitY = _mm_andnot_pd(skipY, extremitiesOverlapPD(leftIntersection, rightIntersection, wallX1, wallX2));
+
+		const __m128d flush = _mm_cmpeq_pd(_mm_set1_pd(previousPosition.y + headEdge), nearWall);
+		const __m128d stopY = _mm_sub_pd(nearWall, _mm_set1_pd(headEdge));
+		const __m128d stopX = _mm_add_pd(_mm_mul_pd(slopeX, _mm_sub_pd(stopY, _mm_set1_pd(previousPosition.y))), _mm_set1_pd(previousPosition.x));
+		resolvedYX = selectPD(flush, _mm_set1_pd(previousPosition.x + positionStep.x * frictionFactor), stopX);
+		resolvedYY = selectPD(flush, _mm_set1_pd(previousPosition.y + 0.0), stopY);
+		resolvedYZ = selectPD(flush, slideZ, nextZ);
+	}
+
+	const __m128d useY = _mm_andnot_pd(skipX, _mm_andnot_pd(hitX, hitY));
+	const __m128d resolvedX = selectPD(hitX, resolvedXX, selectPD(useY, resolvedYX, nextX));
+	const __m128d resolvedY = selectPD(hitX, resolvedXY, selectPD(useY, resolvedYY, nextY));
+	const __m128d resolvedZ = selectPD(hitX, resolvedXZ, selectPD(useY, resolvedYZ, nextZ));
+
+	const __m128d stepX = _mm_sub_pd(resolvedX, _mm_set1_pd(previousPosition.x));
+	const __m128d stepY = _mm_sub_pd(resolvedY, _mm_set1_pd(previousPosition.y));
+	const __m128d stepZ = _mm_sub_pd(resolvedZ, _mm_set1_pd(previousPosition.z));
+	const __m128d lengthsSquared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(stepX, stepX), _mm_mul_pd(stepY, stepY)), _mm_mul_pd(stepZ, stepZ));
+
+	double x[2], y[2], z[2];
+	_mm_storeu_pd(x, resolvedX);
+	_mm_storeu_pd(y, resolvedY);
+	_mm_storeu_pd(z, resolvedZ);
+	_mm_storeu_pd(resolvedStepLengthsSquared, lengthsSquared);
+	resolvedPositions[0] = (Vector3D){ x[0], y[0], z[0] };
+	resolvedPositions[1] = (Vector3D){ x[1], y[1], z[1] };
+
+	return _mm_movemask_pd(_mm_cmplt_pd(lengthsSquared, _mm_set1_pd(stepLengthSquared)));
+}
+
+#endif	// __SSE2__
+
+Vector3D resolveWallCollisions(const CollisionWalls walls, const BoxD hitbox, const Vector3D previousPosition, const Vector3D positionStep) {
+	Vector3D nextPosition = addVec(previousPosition, positionStep);
+	double stepLengthSquared = SQUARE(positionStep.x) + SQUARE(positionStep.y) + SQUARE(positionStep.z);
+	unsigned int i = 0;
+
+#if defined(__SSE2__)
+	// Walls are tested two at a time against the current step.
+	// Most pairs shorten nothing and are passed over; when one does, the first such wall is taken,
+	// 	and testing resumes after it with the shortened step, just as the reference does.
+	while (i + 1 < walls.count) {
+		Vector3D resolvedPositions[2];
+		double resolvedStepLengthsSquared[2];
+		const int shorterMask = resolveWallPair(walls, i, hitbox, previousPosition, nextPosition, stepLengthSquared, resolvedPositions, resolvedStepLengthsSquared);
+		if (shorterMask == 0) {
+			i += 2;
+			continue;
+		}
+
+		const unsigned int lane = (shorterMask & 1) ? 0 : 1;
+		nextPosition = resolvedPositions[lane];
+		stepLengthSquared = resolvedStepLengthsSquared[lane];
+		i += lane + 1;
+	}
+#endif	// __SSE2__
+
+	for (; i < walls.count; ++i) {
+		resolveWallScalar(walls, i, hitbox, previousPosition, &nextPosition, &stepLengthSquared);
+	}
+	return nextPosition;
+}
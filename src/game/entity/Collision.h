@@ -0,0 +1,48 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <stdbool.h>
+
+#include "math/Box.h"
+#include "math/Vector.h"
+
+// The walls of a room in structure-of-arrays layout, so that several walls can be tested against an entity at once.
+typedef struct CollisionWalls {
+
+	unsigned int count;
+
+	// All four arrays are parts of one allocation, owned by pX1.
+	double *pX1;
+	double *pY1;
+	double *pX2;
+	double *pY2;
+
+} CollisionWalls;
+
+// Copies an array of walls into structure-of-arrays layout.
+// Returns true if successful, false otherwise.
+bool createCollisionWalls(const unsigned int wallCount, const BoxD *const pWalls, CollisionWalls *const pOutWalls);
+
+void deleteCollisionWalls(CollisionWalls *const pWalls);
+
+// Moves an entity's hitbox from its old position to its new position, stopping or sliding it against a single wall.
+// Returns the resolved position of the entity.
+Vector3D resolveCollision(const Vector3D old_position, const Vector3D new_position, const BoxD hitbox, const BoxD wall);
+
+// Moves an entity's hitbox from its previous position by a step, stopping or sliding it against any walls in its way.
+// Returns the resolved position of the entity.
+// The walls are resolved in order; each wall is tested against the step left over by the walls before it,
+// 	and the shortest resolved step is kept.
+Vector3D resolveWallCollisions(const CollisionWalls walls, const BoxD hitbox, const Vector3D previousPosition, const Vector3D positionStep);
+
+// Does the same as resolveWallCollisions, one wall at a time with resolveCollision.
+// This is the reference that resolveWallCollisions must always agree with.
+Vector3D resolveWallCollisionsReference(const CollisionWalls walls, const BoxD hitbox, const Vector3D previousPosition, const Vector3D positionStep);
+
+// If enabled, wall collisions resolved for entities are checked against resolveWallCollisionsReference,
+// 	and any difference is logged as an error. Disabled by default.
+void setCollisionValidation(const bool enabled);
+
+bool getCollisionValidation(void);
+
+#endif	// COLLISION_H
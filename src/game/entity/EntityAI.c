@@ -4,7 +4,7 @@
 #include "math/Vector.h"
 #include "render/RenderManager.h"
 #include "util/Random.h"
-#include "util/Time.h"
+#include "util/GameClock.h"
 
 static void entityAIRegularTickNone(Entity *const pEntity) {
 	(void)pEntity;
@@ -19,11 +19,11 @@ static void entityAIRegularTickSlime(Entity *const pEntity) {
 	
 	static const double accelerationMagnitude = 0.24;
 	
-	const uint64_t currentTimeMS = getMilliseconds();
+	const uint64_t currentTimeMS = gameClockGetTickTimeMS();
 	if (currentTimeMS - pEntity->ai.lastActionTimeMS >= pEntity->ai.timeTillNextAction) {
 		pEntity->ai.lastActionTimeMS = currentTimeMS;
-		pEntity->ai.timeTillNextAction = (random(0ULL, 3ULL) + random(1ULL, 4ULL)) * 1000ULL;
-		pEntity->ai.direction = random(0, 4);
+		pEntity->ai.timeTillNextAction = (random(RANDOM_STREAM_AI, 0ULL, 3ULL) + random(RANDOM_STREAM_AI, 1ULL, 4ULL)) * 1000ULL;
+		pEntity->ai.direction = random(RANDOM_STREAM_AI, 0, 4);
 	}
 	
 	const unsigned int currentAnimation = renderObjectGetAnimation(pEntity->renderHandle, 0);
@@ -5,6 +5,7 @@
 #include "math/Box.h"
 #include "math/Vector.h"
 #include "util/String.h"
+#include "util/StringTable.h"
 #include "EntityAI.h"
 
 typedef struct EntityComponentSystem_T *EntityComponentSystem;
@@ -65,7 +66,7 @@ typedef struct EntityCreateInfo {
 	EntityPhysics physics;
 	BoxD hitbox;
 	EntityHealth health; // If currentHP is zero, then it is initialized to maxHP. Fields invincible and iFrameTimer are ignored.
-	String textureID;
+	StringID textureID;
 	BoxF textureDimensions;
 } EntityCreateInfo;
 
@@ -82,7 +83,7 @@ typedef struct InitEntityHealth {
 } InitEntityHealth;
 
 typedef struct EntityLoadInfo {
-	String entityID;
+	StringID entityID;
 	InitEntityPhysics physics;
 	InitEntityHealth health;
 } EntityLoadInfo;
@@ -2,17 +2,18 @@
 
 #include <stddef.h>
 #include <stdint.h>
-#include "config.h"
 #include "log/Logger.h"
-#include "util/FileIO.h"
+#include "util/BinaryReader.h"
+#include "util/HashMap.h"
 #include "util/String.h"
+#include "util/StringTable.h"
+#include "util/VirtualFileSystem.h"
 
-#define FGE_PATH (RESOURCE_PATH "data/EntityRecordData.fge")
-#define ENTITY_RECORD_COUNT 3
+#define FGE_PATH "data/EntityRecordData.fge"
 #define ENTITY_AI_COUNT 2
 
-static const size_t entityRecordCount = ENTITY_RECORD_COUNT;
-static EntityRecord entityRecords[ENTITY_RECORD_COUNT];
+// Maps interned entity IDs to entity records.
+static HashMap entityRecords = { };
 
 static const size_t entityAICount = ENTITY_AI_COUNT;
 static EntityAI entityAIs[ENTITY_AI_COUNT];
@@ -27,95 +28,95 @@ void initEntityRegistry(void) {
 	entityAIs[0] = entityAINone;
 	entityAIs[1] = entityAISlime;
 	
-	for (size_t i = 0; i < entityRecordCount; ++i) {
-		entityRecords[i] = (EntityRecord){
-			.entityID = (String){ },
-			.entityHitbox = (BoxD){ },
-			.entityAI = entityAINone,
-			.textureID = (String){ },
-			.textureDimensions = (BoxF){ }
-		};
-	}
+	entityRecords = newHashMap(sizeof(EntityRecord), getStringIDHash);
 	
-	File file = openFile(FGE_PATH, FMODE_READ, FMODE_NO_UPDATE, FMODE_BINARY);
+	BinaryReader reader = { };
+	if (!vfsOpenBinaryReader(FGE_PATH, &reader)) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Initializing entity registry: failed to open entity record file.");
+		return;
+	}
 	
-	for (size_t i = 0; i < entityRecordCount; ++i) {
+	// The file holds one record after another, so records are read until it runs out.
+	for (size_t i = 0; binaryReaderRemaining(&reader) > 0; ++i) {
 		
 		EntityRecord entityRecord = { };
 		
 		// Read entity ID.
-		entityRecord.entityID = fileReadString(file, 32);
+		String entityID = binaryReadString(&reader, 32);
 		
 		/* -- Entity Properties -- */
 		
-		String entityAIID = fileReadString(file, 32);	// Read entity AI ID.
+		String entityAIID = binaryReadString(&reader, 32);	// Read entity AI ID.
 		entityRecord.entityAI = findEntityAI(entityAIID);	// Find entity AI.
 		deleteString(&entityAIID);
-		fileReadData(file, 1, sizeof(entityRecord.entityHitbox), &entityRecord.entityHitbox); // Read entity hitbox.
-		fileReadData(file, 1, 4, &entityRecord.entityIsPersistent); // Read entity persistency flag.
+		entityRecord.entityHitbox.x1 = binaryReadF64(&reader); // Read entity hitbox.
+		entityRecord.entityHitbox.y1 = binaryReadF64(&reader);
+		entityRecord.entityHitbox.x2 = binaryReadF64(&reader);
+		entityRecord.entityHitbox.y2 = binaryReadF64(&reader);
+		entityRecord.entityIsPersistent = binaryReadU32(&reader) != 0; // Read entity persistency flag.
 		
 		/* -- Entity Statistics -- */
 		
-		fileReadData(file, 1, sizeof(entityRecord.entityHP), &entityRecord.entityHP);	// Read maximum entity hitpoints.
-		fileReadData(file, 1, sizeof(entityRecord.entitySpeed), &entityRecord.entitySpeed);	// Read maximum entity speed.
+		entityRecord.entityHP = binaryReadI32(&reader);	// Read maximum entity hitpoints.
+		entityRecord.entitySpeed = binaryReadF64(&reader);	// Read maximum entity speed.
 		
 		/* -- Texture Properties -- */
 		
-		entityRecord.textureID = fileReadString(file, 32);	// Read entity texture ID.
-		fileReadData(file, 1, sizeof(entityRecord.textureDimensions), &entityRecord.textureDimensions); // Read entity texture dimensions.
+		String textureID = binaryReadString(&reader, 32);	// Read entity texture ID.
+		entityRecord.textureDimensions.x1 = binaryReadF32(&reader); // Read entity texture dimensions.
+		entityRecord.textureDimensions.y1 = binaryReadF32(&reader);
+		entityRecord.textureDimensions.x2 = binaryReadF32(&reader);
+		entityRecord.textureDimensions.y2 = binaryReadF32(&reader);
+		
+		if (reader.failed) {
+			logMsg(loggerGame, LOG_LEVEL_ERROR, "Initializing entity registry: failed to read entity record %zu.", i);
+			deleteString(&entityID);
+			deleteString(&textureID);
+			break;
+		}
+		
+		// Both IDs are interned here, so that spawning and loading the entity's texture do not compare strings.
+		entityRecord.entityID = internString(entityID);
+		entityRecord.textureID = internString(textureID);
+		deleteString(&entityID);
+		deleteString(&textureID);
 		
 		registerEntityRecord(entityRecord);
 	}
 	
-	closeFile(&file);
-	logMsg(loggerGame, LOG_LEVEL_VERBOSE, "Done initializing entity registry.");
+	closeBinaryReader(&reader);
+	logMsg(loggerGame, LOG_LEVEL_VERBOSE, "Done initializing entity registry, registered %u entity records.", entityRecords.count);
 }
 
 void terminate_entity_registry(void) {
 	logMsg(loggerGame, LOG_LEVEL_VERBOSE, "Terminating entity registry...");
 	
-	for (size_t i = 0; i < entityRecordCount; ++i) {
-		deleteString(&entityRecords[i].entityID);
-		deleteString(&entityRecords[i].textureID);
-	}
+	deleteHashMap(&entityRecords);
 	
 	logMsg(loggerGame, LOG_LEVEL_VERBOSE, "Done terminating entity registry.");
 }
 
 static bool registerEntityRecord(const EntityRecord entityRecord) {
-	logMsg(loggerGame, LOG_LEVEL_VERBOSE, "Registering entity record with ID \"%s\"...", entityRecord.entityID.pBuffer);
+	logMsg(loggerGame, LOG_LEVEL_VERBOSE, "Registering entity record with ID \"%s\"...", getInternedString(entityRecord.entityID).pBuffer);
 	
-	size_t hash_index = stringHash(entityRecord.entityID, entityRecordCount);
-	for (size_t i = 0; i < entityRecordCount; ++i) {
-		if (stringIsNull(entityRecords[hash_index].entityID)) {
-			entityRecords[hash_index] = entityRecord;
-			return true;
-		}
-		else {
-			hash_index += 1;
-			hash_index %= entityRecordCount;
-		}
+	if (entityRecord.entityID == stringIDNull) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error registering entity record: entity ID is null.");
+		return false;
 	}
-	return false;
+	return hashMapInsert(&entityRecords, entityRecord.entityID, &entityRecord);
 }
 
-bool find_entity_record(const String entityID, EntityRecord *const pEntityRecord) {
-	if (!pEntityRecord) {
+bool find_entity_record(const StringID entityID, EntityRecord *const pEntityRecord) {
+	if (!pEntityRecord || entityID == stringIDNull) {
 		return false;
 	}
 	
-	size_t hash_index = stringHash(entityID, entityRecordCount);
-	for (size_t i = 0; i < entityRecordCount; ++i) {
-		if (stringCompare(entityID, entityRecords[i].entityID)) {
-			*pEntityRecord = entityRecords[i];
-			return true;
-		}
-		else {
-			hash_index++;
-			hash_index %= entityRecordCount;
-		}
+	const EntityRecord *const pFoundRecord = hashMapFind(&entityRecords, entityID);
+	if (!pFoundRecord) {
+		return false;
 	}
-	return false;
+	*pEntityRecord = *pFoundRecord;
+	return true;
 }
 
 static EntityAI findEntityAI(const String string) {
@@ -5,10 +5,11 @@
 #include "EntityAI.h"
 #include "math/Box.h"
 #include "util/String.h"
+#include "util/StringTable.h"
 
 typedef struct EntityRecord {
 	
-	String entityID;
+	StringID entityID;
 	
 	/* -- Entity Properties -- */
 	
@@ -26,7 +27,7 @@ typedef struct EntityRecord {
 	
 	/* -- Texture Properties -- */
 	
-	String textureID;
+	StringID textureID;
 	
 	BoxF textureDimensions;
 	
@@ -39,6 +40,6 @@ void terminate_entity_registry(void);
 // Searches for an existing entity record using its entity ID.
 // Returns true if the entity record was found, which is stored in the pointer.
 // Returns false if the entity record was not found, or if an error occurred.
-bool find_entity_record(const String entityID, EntityRecord *const pEntityRecord);
+bool find_entity_record(const StringID entityID, EntityRecord *const pEntityRecord);
 
 #endif	// ENTITY_REGISTRY_H
\ No newline at end of file
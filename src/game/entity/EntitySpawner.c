@@ -8,7 +8,7 @@ void entitySpawnerReload(EntitySpawner *const pEntitySpawner) {
 	if (!pEntitySpawner) {
 		return;
 	}
-	pEntitySpawner->spawnCounter = random(pEntitySpawner->minSpawnCount, pEntitySpawner->maxSpawnCount);
+	pEntitySpawner->spawnCounter = random(RANDOM_STREAM_SPAWNING, pEntitySpawner->minSpawnCount, pEntitySpawner->maxSpawnCount);
 }
 
 void entitySpawnerSpawnEntities(EntitySpawner *const pEntitySpawner) {
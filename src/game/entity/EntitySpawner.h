@@ -1,7 +1,7 @@
 #ifndef ENTITY_SPAWNER_H
 #define ENTITY_SPAWNER_H
 
-#include "util/String.h"
+#include "util/StringTable.h"
 
 // Controls how often an object (e.g. entity spawner) in a room reloads.
 typedef enum ReloadMode {
@@ -14,8 +14,8 @@ typedef enum ReloadMode {
 // Controls the spawning of a single entity/enemy in a room.
 typedef struct EntitySpawner {
 	
-	// String ID of the entity type to spawn.
-	String entityID;
+	// Interned ID of the entity type to spawn.
+	StringID entityID;
 	
 	// Indicates when/how often the spawner is reloaded.
 	ReloadMode reloadMode;
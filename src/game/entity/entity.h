@@ -5,6 +5,7 @@
 #include "EntityAI.h"
 #include "math/Box.h"
 #include "math/Vector.h"
+#include "util/StringTable.h"
 
 typedef struct EntityPhysics {
 	Vector3D rotation;		
@@ -23,6 +24,9 @@ typedef struct EntityHitbox {
 // Represents a single "being" with the game (e.g. the player, NPCs, enemies, interactable objects).
 typedef struct Entity {
 	
+	// The ID of the entity record that the entity was loaded from.
+	StringID entityID;
+	
 	// The current position and velocity of the entity.
 	EntityPhysics physics;
 	
@@ -63,6 +67,5 @@ void tick_entity(Entity *const pEntity);
 void entityTriggerInvincibility(Entity *const pEntity);
 
 bool entityCollision(const Entity e1, const Entity e2);
-Vector3D resolveCollision(const Vector3D old_position, const Vector3D new_position, const BoxD hitbox, const BoxD wall);
 
 #endif	// ENTITY_H
@@ -4,80 +4,188 @@
 #include "EntityRegistry.h"
 #include "log/Logger.h"
 #include "render/RenderManager.h"
+#include "render/vulkan/texture_manager.h"
+#include "util/HashMap.h"
+
+// The most render objects each prefab keeps loaded for entities not yet spawned.
+#define ENTITY_PREFAB_MAX_WARM_RENDER_OBJECTS 8
+
+// The most render objects all prefabs together keep loaded for entities not yet spawned.
+// Warm render objects keep their models, so this bounds how many of the main model pool's slots they hold for many kinds of entities.
+#define MAX_WARM_RENDER_OBJECTS 32
+
+// The animation that entity sprites start in, if their texture has it.
+#define ENTITY_INIT_ANIMATION 2
+
+// Everything needed to spawn an entity of one kind, built from its entity record the first time one is spawned,
+// 	so that later spawns do not look up the record or its texture again.
+typedef struct EntityPrefab {
+	
+	int32_t textureHandle;
+	BoxF textureDimensions;
+	uint32_t initAnimation;
+	
+	BoxD hitbox;
+	EntityAI ai;
+	bool persistent;
+	int32_t hp;
+	double speed;
+	
+	// Hidden render objects of unloaded entities of this kind, shown again for the next entities of this kind instead of loading new ones.
+	uint32_t warmRenderObjectCount;
+	int32_t warmRenderObjects[ENTITY_PREFAB_MAX_WARM_RENDER_OBJECTS];
+	
+} EntityPrefab;
 
 const int maxNumEntities = MAX_NUM_ENTITIES;
 
 static Entity entities[MAX_NUM_ENTITIES];
 static bool entitySlotEnabledFlags[MAX_NUM_ENTITIES];
 
+// Handles of the unused entity slots, taken from the end, so that loading an entity does not search for a slot.
+static int freeEntityHandles[MAX_NUM_ENTITIES];
+static int freeEntityHandleCount = 0;
+
+// Maps interned entity IDs to entity prefabs.
+static HashMap entityPrefabs = { };
+
+// The number of warm render objects across all prefabs.
+static uint32_t warmRenderObjectCount = 0;
+
 const int entityHandleInvalid = -1;
 
 void init_entity_manager(void) {
 	for (int i = 0; i < maxNumEntities; ++i) {
 		entities[i] = new_entity();
 		entitySlotEnabledFlags[i] = false;
+		
+		// The lowest handles are used first.
+		freeEntityHandles[i] = maxNumEntities - 1 - i;
 	}
+	freeEntityHandleCount = maxNumEntities;
+	entityPrefabs = newHashMap(sizeof(EntityPrefab), getStringIDHash);
+	warmRenderObjectCount = 0;
 }
 
-int loadEntity(const String entityID, const Vector3D initPosition, const Vector3D initVelocity) {
-	if (stringIsNull(entityID)) {
-		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error loading entity: string entityID is null.");
+void terminate_entity_manager(void) {
+	
+	// Warm render objects are unloaded along with every other render object when the render manager is terminated.
+	deleteHashMap(&entityPrefabs);
+}
+
+// Returns the prefab of the entity record with the given ID, building it if no entity of this kind was spawned yet.
+// Returns null if there is no such entity record. The pointer is invalidated when the next prefab is built.
+static EntityPrefab *getEntityPrefab(const StringID entityID) {
+	EntityPrefab *const pFoundPrefab = hashMapFind(&entityPrefabs, entityID);
+	if (pFoundPrefab) {
+		return pFoundPrefab;
 	}
 	
-	int entityHandle = entityHandleInvalid;
-	for (int i = 0; validateEntityHandle(i); ++i) {
-		if (!entitySlotEnabledFlags[i]) {
-			entityHandle = i;
-			break;
+	EntityRecord entityRecord = { };
+	if (!find_entity_record(entityID, &entityRecord)) {
+		return nullptr;
+	}
+	
+	const int32_t textureHandle = findTextureByID(entityRecord.textureID);
+	const EntityPrefab prefab = {
+		.textureHandle = textureHandle,
+		.textureDimensions = entityRecord.textureDimensions,
+		.initAnimation = ENTITY_INIT_ANIMATION < getTexture(textureHandle).numAnimations ? ENTITY_INIT_ANIMATION : 0,
+		.hitbox = entityRecord.entityHitbox,
+		.ai = entityRecord.entityAI,
+		.persistent = entityRecord.entityIsPersistent,
+		.hp = entityRecord.entityHP,
+		.speed = entityRecord.entitySpeed,
+		.warmRenderObjectCount = 0
+	};
+	if (!hashMapInsert(&entityPrefabs, entityID, &prefab)) {
+		return nullptr;
+	}
+	return hashMapFind(&entityPrefabs, entityID);
+}
+
+// Shows a warm render object of the prefab at the position if it has one, or loads a new render object otherwise.
+static int32_t instantiateRenderObject(EntityPrefab *const pPrefab, const Vector3D position) {
+	while (pPrefab->warmRenderObjectCount > 0) {
+		pPrefab->warmRenderObjectCount -= 1;
+		warmRenderObjectCount -= 1;
+		const int32_t renderHandle = pPrefab->warmRenderObjects[pPrefab->warmRenderObjectCount];
+		if (renderObjectExists(renderHandle)) {
+			renderObjectSetPosition(renderHandle, 0, position);
+			renderObjectSetAnimation(renderHandle, 0, pPrefab->initAnimation);
+			renderObjectSetVisible(renderHandle, true);
+			return renderHandle;
 		}
 	}
-	if (!validateEntityHandle(entityHandle)) {
+	
+	const RenderObjectLoadInfo renderObjectLoadInfo = {
+		.textureID = stringIDNull,
+		.textureHandle = pPrefab->textureHandle,
+		.quadCount = 1,
+		.pQuadLoadInfos = &(QuadLoadInfo){
+			.quadType = QUAD_TYPE_MAIN,
+			.initPosition = position,
+			.quadDimensions = pPrefab->textureDimensions,
+			.initAnimation = (int32_t)pPrefab->initAnimation,
+			.color = COLOR_WHITE
+		}
+	};
+	return loadRenderObject(renderObjectLoadInfo);
+}
+
+// Hides the render object of an unloaded entity and keeps it warm in the entity's prefab,
+// 	or unloads it if the prefab, or all prefabs together, keep enough already.
+static void releaseRenderObject(const StringID entityID, int32_t *const pRenderHandle) {
+	EntityPrefab *const pPrefab = hashMapFind(&entityPrefabs, entityID);
+	if (pPrefab && pPrefab->warmRenderObjectCount < ENTITY_PREFAB_MAX_WARM_RENDER_OBJECTS && warmRenderObjectCount < MAX_WARM_RENDER_OBJECTS
+			&& renderObjectExists(*pRenderHandle)) {
+		renderObjectSetVisible(*pRenderHandle, false);
+		pPrefab->warmRenderObjects[pPrefab->warmRenderObjectCount] = *pRenderHandle;
+		pPrefab->warmRenderObjectCount += 1;
+		warmRenderObjectCount += 1;
+		*pRenderHandle = -1;
+		return;
+	}
+	unloadRenderObject(pRenderHandle);
+}
+
+int loadEntity(const StringID entityID, const Vector3D initPosition, const Vector3D initVelocity) {
+	if (entityID == stringIDNull) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error loading entity: entity ID is null.");
+		return entityHandleInvalid;
+	} else if (freeEntityHandleCount <= 0) {
 		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error loading entity: failed to find available entity handle.");
 		return entityHandleInvalid;
 	}
 	
-	EntityRecord entityRecord = { };
-	if (!find_entity_record(entityID, &entityRecord)) {
-		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error loading entity: failed to find entity record with ID \"%s\".", entityID.pBuffer);
+	EntityPrefab *const pPrefab = getEntityPrefab(entityID);
+	if (!pPrefab) {
+		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error loading entity: failed to find entity record with ID \"%s\".", getInternedString(entityID).pBuffer);
 		return entityHandleInvalid;
 	}
 	
-	const RenderObjectLoadInfo renderObjectLoadInfo = {
-		.textureID = entityRecord.textureID,
-		.quadCount = 1, // TODO: load wireframe if debug menu is enabled.
-		.pQuadLoadInfos = (QuadLoadInfo[2]){
-			{
-				.quadType = QUAD_TYPE_MAIN,
-				.initPosition = initPosition,
-				.quadDimensions = entityRecord.textureDimensions,
-				.initAnimation = 2,
-				.color = COLOR_WHITE
-			}, {
-				.quadType = QUAD_TYPE_WIREFRAME,
-				.initPosition = initPosition,
-				.quadDimensions = boxD2F(entityRecord.entityHitbox),
-				.initAnimation = 0,
-				.color = COLOR_RED // TODO: select color green if entity is the player.
-			}
-		}
-	};
-	const int32_t renderHandle = loadRenderObject(renderObjectLoadInfo);
+	const int32_t renderHandle = instantiateRenderObject(pPrefab, initPosition);
 	if (!renderObjectExists(renderHandle)) {
 		logMsg(loggerGame, LOG_LEVEL_ERROR, "Error loading entity: failed to load render object.");
 		return entityHandleInvalid;
 	}
 	
+	freeEntityHandleCount -= 1;
+	const int entityHandle = freeEntityHandles[freeEntityHandleCount];
+	
+	entities[entityHandle] = new_entity();
+	entities[entityHandle].entityID = entityID;
 	entities[entityHandle].physics = (EntityPhysics){
 		.position = initPosition,
 		.velocity = initVelocity
 	};
-	entities[entityHandle].hitbox = entityRecord.entityHitbox;
-	entities[entityHandle].ai = entityRecord.entityAI;
-	entities[entityHandle].persistent = entityRecord.entityIsPersistent;
+	entities[entityHandle].hitbox = pPrefab->hitbox;
+	entities[entityHandle].ai = pPrefab->ai;
+	entities[entityHandle].persistent = pPrefab->persistent;
 	entities[entityHandle].invincible = false;
-	entities[entityHandle].currentHP = entityRecord.entityHP;
-	entities[entityHandle].maxHP = entityRecord.entityHP;
-	entities[entityHandle].speed = entityRecord.entitySpeed;
+	entities[entityHandle].currentHP = pPrefab->hp;
+	entities[entityHandle].maxHP = pPrefab->hp;
+	entities[entityHandle].speed = pPrefab->speed;
 	entities[entityHandle].renderHandle = renderHandle;
 	entities[entityHandle].wireframe = -1;
 	entitySlotEnabledFlags[entityHandle] = true;
@@ -92,8 +200,15 @@ void unloadEntity(const int entityHandle) {
 		logMsg(loggerGame, LOG_LEVEL_WARNING, "Unloading already unused entity slot (%i).", entityHandle);
 		return;
 	}
-	unloadRenderObject(&entities[entityHandle].renderHandle);
+	
+	// The wireframe is not kept, since hitboxes may not be drawn when the render object is used again.
+	if (renderObjectQuadExists(entities[entityHandle].renderHandle, entities[entityHandle].wireframe)) {
+		renderObjectUnloadQuad(entities[entityHandle].renderHandle, &entities[entityHandle].wireframe);
+	}
+	releaseRenderObject(entities[entityHandle].entityID, &entities[entityHandle].renderHandle);
 	entitySlotEnabledFlags[entityHandle] = false;
+	freeEntityHandles[freeEntityHandleCount] = entityHandle;
+	freeEntityHandleCount += 1;
 }
 
 void drawEntityHitboxes(void) {
@@ -6,7 +6,7 @@
 
 #include "entity.h"
 
-#include "util/String.h"
+#include "util/StringTable.h"
 
 #define MAX_NUM_ENTITIES 64
 
@@ -17,11 +17,14 @@ extern const int entityHandleInvalid;
 // Initializes the entity manager by setting all entity slots to default values using `new_entity`.
 void init_entity_manager(void);
 
+void terminate_entity_manager(void);
+
 // Loads an entity into the game world at the specified initial position and velocity.
+// The entity is made from the prefab of its entity record, reusing a render object kept from an unloaded entity of the same kind if there is one.
 // Returns a handle to the entity if entity loading succeeding, or an invalid handle if it failed.
-int loadEntity(const String entityID, const Vector3D initPosition, const Vector3D initVelocity);
+int loadEntity(const StringID entityID, const Vector3D initPosition, const Vector3D initVelocity);
 
-// Frees the entity slot at the specified handle.
+// Frees the entity slot at the specified handle; the entity's render object is hidden and kept for the next entity of the same kind.
 void unloadEntity(const int entityHandle);
 
 // Loads a wireframe for each active entity's hitbox.
@@ -42,8 +42,8 @@ void initGLFW(void) {
 	
 	char appName[64];
 	snprintf(appName, 64, "%s %i.%i", APP_NAME, PinkPearl_VERSION_MAJOR, PinkPearl_VERSION_MINOR);
-	ImageData icon = loadImageData(RESOURCE_PATH "assets/textures/icon.png", COLOR_TRANSPARENT);
-	ImageData cursorImage = loadImageData(RESOURCE_PATH "assets/textures/gui/crosshairs.png", COLOR_TRANSPARENT);
+	ImageData icon = loadImageData("assets/textures/icon.png", COLOR_TRANSPARENT);
+	ImageData cursorImage = loadImageData("assets/textures/gui/crosshairs.png", COLOR_TRANSPARENT);
 	appWindow = createWindow(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT, appName, icon, cursorImage, !debug_enabled);
 	if (!appWindow.pHandle) {
 		logMsg(loggerSystem, LOG_LEVEL_FATAL, "Initializing GLFW: window creation failed.");
@@ -1,11 +1,43 @@
 #include "InputManager.h"
 
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "log/Logger.h"
+#include "GLFWManager.h"
+
 typedef enum InputState {
 	INPUT_STATE_PRESSED = 0,
 	INPUT_STATE_HELD = 1,
 	INPUT_STATE_RELEASED = 2
 } InputState;
 
+typedef enum InputEventType {
+	INPUT_EVENT_PRESS = 0,
+	INPUT_EVENT_RELEASE = 1,
+	INPUT_EVENT_CURSOR = 2,
+	
+	// Marks the last tick of a recording; only found in recording files.
+	INPUT_EVENT_END = 3
+} InputEventType;
+
+// A change in input, applied at the start of a game tick.
+typedef struct InputEvent {
+	uint32_t tick;
+	uint16_t input;
+	uint8_t type;
+	
+	// Only used by cursor events.
+	float cursorX;
+	float cursorY;
+} InputEvent;
+
+// Recording files start with a header (magic number, version, random seed),
+// 	followed by events in tick order; each event is its tick, input, and type,
+// 	plus the cursor position for cursor events. Values are stored in host byte order.
+static const char inputRecordingMagic[4] = { 'P', 'P', 'I', 'R' };
+static const uint32_t inputRecordingVersion = 1;
+
 static void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods);
 static void mouseButtonCallback(GLFWwindow *window, int button, int action, int mods);
 
@@ -14,14 +46,219 @@ static const int keyInputCount = GLFW_KEY_LAST;
 static const int maxInputCount = MAX_INPUT_COUNT;
 static InputState inputStates[MAX_INPUT_COUNT] = { };
 
-void initInputManager(GLFWwindow *window) {
+// Events from the window since the last tick; events past the capacity are dropped.
+// Window events arrive on the main thread and are applied on the simulation thread, so the queue is guarded by a mutex.
+#define INPUT_EVENT_QUEUE_CAPACITY 256
+static pthread_mutex_t pendingEventMutex = PTHREAD_MUTEX_INITIALIZER;
+static InputEvent pendingEvents[INPUT_EVENT_QUEUE_CAPACITY];
+static uint32_t pendingEventCount = 0;
+
+// The cursor position last sampled from the window, guarded by the same mutex as the event queue.
+static double sampledCursorX = 0.0;
+static double sampledCursorY = 0.0;
+
+static float cursorPosX = 0.0F;
+static float cursorPosY = 0.0F;
+
+static FILE *pRecordingFile = nullptr;
+
+static FILE *pReplayFile = nullptr;
+static InputEvent nextReplayEvent = { };
+static bool replayHasNextEvent = false;
+static bool replayFinished = false;
+
+static void resetInputStates(void) {
 	for (int i = 0; i < maxInputCount; ++i) {
 		inputStates[i] = INPUT_STATE_RELEASED;
 	}
+	pendingEventCount = 0;
+}
+
+void initInputManager(GLFWwindow *window) {
+	resetInputStates();
 	glfwSetKeyCallback(window, keyCallback);
 	glfwSetMouseButtonCallback(window, mouseButtonCallback);
 }
 
+static void applyInputEvent(const InputEvent event) {
+	switch ((InputEventType)event.type) {
+		case INPUT_EVENT_PRESS:
+			inputStates[event.input] = INPUT_STATE_PRESSED;
+			break;
+		case INPUT_EVENT_RELEASE:
+			inputStates[event.input] = INPUT_STATE_RELEASED;
+			break;
+		case INPUT_EVENT_CURSOR:
+			cursorPosX = event.cursorX;
+			cursorPosY = event.cursorY;
+			break;
+		case INPUT_EVENT_END:
+			break;
+	}
+}
+
+static void writeInputEvent(const InputEvent event) {
+	fwrite(&event.tick, sizeof event.tick, 1, pRecordingFile);
+	fwrite(&event.input, sizeof event.input, 1, pRecordingFile);
+	fwrite(&event.type, sizeof event.type, 1, pRecordingFile);
+	if (event.type == INPUT_EVENT_CURSOR) {
+		fwrite(&event.cursorX, sizeof event.cursorX, 1, pRecordingFile);
+		fwrite(&event.cursorY, sizeof event.cursorY, 1, pRecordingFile);
+	}
+}
+
+static bool readInputEvent(InputEvent *const pEvent) {
+	*pEvent = (InputEvent){ };
+	if (fread(&pEvent->tick, sizeof pEvent->tick, 1, pReplayFile) != 1
+			|| fread(&pEvent->input, sizeof pEvent->input, 1, pReplayFile) != 1
+			|| fread(&pEvent->type, sizeof pEvent->type, 1, pReplayFile) != 1) {
+		return false;
+	}
+	if (pEvent->type == INPUT_EVENT_CURSOR) {
+		return fread(&pEvent->cursorX, sizeof pEvent->cursorX, 1, pReplayFile) == 1
+			&& fread(&pEvent->cursorY, sizeof pEvent->cursorY, 1, pReplayFile) == 1;
+	} else if (pEvent->type == INPUT_EVENT_END) {
+		return true;
+	}
+	return pEvent->type <= INPUT_EVENT_RELEASE && pEvent->input < MAX_INPUT_COUNT;
+}
+
+// Must be called with the pending event mutex held.
+static void pushInputEvent(const InputEvent event) {
+	if (pendingEventCount < INPUT_EVENT_QUEUE_CAPACITY) {
+		pendingEvents[pendingEventCount] = event;
+		pendingEventCount += 1;
+	}
+}
+
+void inputManagerPollEvents(void) {
+	glfwPollEvents();
+	
+	double cursorX = 0.0, cursorY = 0.0;
+	getCursorPosition(&cursorX, &cursorY);
+	pthread_mutex_lock(&pendingEventMutex);
+	sampledCursorX = cursorX;
+	sampledCursorY = cursorY;
+	pthread_mutex_unlock(&pendingEventMutex);
+}
+
+void inputManagerBeginTick(const uint64_t tick) {
+	if (pReplayFile) {
+		// Input from the window is ignored while replaying.
+		pthread_mutex_lock(&pendingEventMutex);
+		pendingEventCount = 0;
+		pthread_mutex_unlock(&pendingEventMutex);
+		while (replayHasNextEvent && nextReplayEvent.tick <= tick) {
+			if (nextReplayEvent.type == INPUT_EVENT_END) {
+				replayFinished = true;
+				replayHasNextEvent = false;
+				break;
+			}
+			applyInputEvent(nextReplayEvent);
+			replayHasNextEvent = readInputEvent(&nextReplayEvent);
+		}
+		if (!replayHasNextEvent) {
+			replayFinished = true;
+		}
+		return;
+	}
+	
+	// The events are taken out of the queue first, so that the window is not held up while they are applied and recorded.
+	static InputEvent tickEvents[INPUT_EVENT_QUEUE_CAPACITY];
+	pthread_mutex_lock(&pendingEventMutex);
+	
+	// The cursor is sampled once per tick, and only recorded when it moves.
+	if ((float)sampledCursorX != cursorPosX || (float)sampledCursorY != cursorPosY) {
+		pushInputEvent((InputEvent){ .type = INPUT_EVENT_CURSOR, .cursorX = (float)sampledCursorX, .cursorY = (float)sampledCursorY });
+	}
+	
+	const uint32_t tickEventCount = pendingEventCount;
+	memcpy(tickEvents, pendingEvents, tickEventCount * sizeof(InputEvent));
+	pendingEventCount = 0;
+	pthread_mutex_unlock(&pendingEventMutex);
+	
+	for (uint32_t i = 0; i < tickEventCount; ++i) {
+		tickEvents[i].tick = (uint32_t)tick;
+		applyInputEvent(tickEvents[i]);
+		if (pRecordingFile) {
+			writeInputEvent(tickEvents[i]);
+		}
+	}
+}
+
+void getInputCursorPosition(double *const pPosX, double *const pPosY) {
+	*pPosX = cursorPosX;
+	*pPosY = cursorPosY;
+}
+
+bool startInputRecording(const char *const pPath, const uint64_t randomSeed) {
+	pRecordingFile = fopen(pPath, "wb");
+	if (!pRecordingFile) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Starting input recording: failed to open file \"%s\".", pPath);
+		return false;
+	}
+	
+	fwrite(inputRecordingMagic, sizeof inputRecordingMagic, 1, pRecordingFile);
+	fwrite(&inputRecordingVersion, sizeof inputRecordingVersion, 1, pRecordingFile);
+	fwrite(&randomSeed, sizeof randomSeed, 1, pRecordingFile);
+	logMsg(loggerSystem, LOG_LEVEL_INFO, "Recording input to \"%s\".", pPath);
+	return true;
+}
+
+void stopInputRecording(const uint64_t lastTick) {
+	if (!pRecordingFile) {
+		return;
+	}
+	writeInputEvent((InputEvent){ .tick = (uint32_t)lastTick, .type = INPUT_EVENT_END });
+	fclose(pRecordingFile);
+	pRecordingFile = nullptr;
+	logMsg(loggerSystem, LOG_LEVEL_INFO, "Finished input recording after %llu ticks.", (unsigned long long)lastTick);
+}
+
+bool startInputReplay(const char *const pPath, uint64_t *const pRandomSeed) {
+	pReplayFile = fopen(pPath, "rb");
+	if (!pReplayFile) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Starting input replay: failed to open file \"%s\".", pPath);
+		return false;
+	}
+	
+	char magic[4] = { };
+	uint32_t version = 0;
+	uint64_t randomSeed = 0;
+	if (fread(magic, sizeof magic, 1, pReplayFile) != 1 || memcmp(magic, inputRecordingMagic, sizeof magic) != 0
+			|| fread(&version, sizeof version, 1, pReplayFile) != 1 || version != inputRecordingVersion
+			|| fread(&randomSeed, sizeof randomSeed, 1, pReplayFile) != 1) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Starting input replay: \"%s\" is not a version %u input recording.", pPath, inputRecordingVersion);
+		fclose(pReplayFile);
+		pReplayFile = nullptr;
+		return false;
+	}
+	
+	// A replay runs without a window, so the input manager is never initialized with one.
+	resetInputStates();
+	*pRandomSeed = randomSeed;
+	replayHasNextEvent = readInputEvent(&nextReplayEvent);
+	replayFinished = false;
+	logMsg(loggerSystem, LOG_LEVEL_INFO, "Replaying input from \"%s\".", pPath);
+	return true;
+}
+
+void stopInputReplay(void) {
+	if (pReplayFile) {
+		fclose(pReplayFile);
+		pReplayFile = nullptr;
+	}
+	replayHasNextEvent = false;
+}
+
+bool isInputReplayFinished(void) {
+	return pReplayFile && replayFinished;
+}
+
+bool isInputReplaying(void) {
+	return pReplayFile != nullptr;
+}
+
 bool isInputPressed(const int input) {
 	if (inputStates[input] == INPUT_STATE_PRESSED) {
 		inputStates[input] = INPUT_STATE_HELD;
@@ -38,12 +275,14 @@ bool isInputPressedOrHeld(const int input) {
 	return pressedOrHeld;
 }
 
-static void updateInputState(const int input, const int action) {
+static void queueInputAction(const int input, const int action) {
+	pthread_mutex_lock(&pendingEventMutex);
 	if (action == GLFW_RELEASE) {
-		inputStates[input] = INPUT_STATE_RELEASED;
+		pushInputEvent((InputEvent){ .input = (uint16_t)input, .type = INPUT_EVENT_RELEASE });
 	} else if (action == GLFW_PRESS) {
-		inputStates[input] = INPUT_STATE_PRESSED;
+		pushInputEvent((InputEvent){ .input = (uint16_t)input, .type = INPUT_EVENT_PRESS });
 	}
+	pthread_mutex_unlock(&pendingEventMutex);
 }
 
 static void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods) {
@@ -53,13 +292,13 @@ static void keyCallback(GLFWwindow *window, int key, int scancode, int action, i
 	if (key == GLFW_KEY_UNKNOWN) {
 		return;
 	}
-	updateInputState(key, action);
+	queueInputAction(key, action);
 }
 
 static void mouseButtonCallback(GLFWwindow *window, int button, int action, int mods) {
 	(void)window;
 	(void)mods;
-	updateInputState(button + keyInputCount, action);
+	queueInputAction(button + keyInputCount, action);
 }
 
 char *getInputName(const int input) {
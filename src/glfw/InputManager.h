@@ -1,6 +1,8 @@
 #ifndef INPUT_MANAGER_H
 #define INPUT_MANAGER_H
 
+#include <stdint.h>
+
 #include <GLFW/glfw3.h>
 
 // These mouse button defines offset the GLFW mouse buttons by the number of keys, effectively differentiating mouse buttons from keys.
@@ -21,6 +23,37 @@
 // Do not call this until after GLFW is initialized.
 void initInputManager(GLFWwindow *window);
 
+// Polls the window for events and samples the cursor position, queueing input for the next tick.
+// GLFW only allows this on the main thread; call once per frame.
+void inputManagerPollEvents(void);
+
+// Applies the input events for a game tick, which are taken from the window, or from the replay file if one is open.
+// Call once at the start of each tick, before the game reads any input.
+void inputManagerBeginTick(const uint64_t tick);
+
+// Returns the cursor position as of the current tick, each coordinate in [-1, 1].
+void getInputCursorPosition(double *const pPosX, double *const pPosY);
+
+// Starts recording every input event, stamped with the tick it applies to, into a binary file.
+// The random seed is saved with the recording, so that a replay makes the same random choices.
+// Returns true if the recording file was opened, false otherwise.
+bool startInputRecording(const char *const pPath, const uint64_t randomSeed);
+
+// Finishes the recording file, marking the last tick of the recorded session.
+void stopInputRecording(const uint64_t lastTick);
+
+// Opens a recording to replay in place of input from the window; the random seed it was made with is returned through pRandomSeed.
+// Returns true if the replay file was opened, false otherwise.
+bool startInputReplay(const char *const pPath, uint64_t *const pRandomSeed);
+
+void stopInputReplay(void);
+
+// Returns true if a replay is open and its last recorded tick has been run.
+bool isInputReplayFinished(void);
+
+// Returns true if a replay is open.
+bool isInputReplaying(void);
+
 // Returns true if the specified input was just pressed, false otherwise.
 // If an input is pressed, getting the input state "consumes" it, setting the state to held.
 bool isInputPressed(const int input);
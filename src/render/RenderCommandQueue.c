@@ -0,0 +1,156 @@
+#include "RenderCommandQueue.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "log/Logger.h"
+#include "util/Allocation.h"
+
+#define RENDER_COMMAND_QUEUE_INITIAL_CAPACITY 64
+
+// Doubles the capacity of a command or load info array, freeing the old array.
+// Returns the new array, or null if it could not be allocated, in which case the old array is kept.
+static void *growArray(void *const pArray, uint32_t *const pCapacity, const uint32_t count, const size_t elementSize) {
+	const uint32_t newCapacity = *pCapacity > 0 ? 2 * *pCapacity : RENDER_COMMAND_QUEUE_INITIAL_CAPACITY;
+	void *const pNewArray = heapAlloc(newCapacity, elementSize);
+	if (!pNewArray) {
+		return nullptr;
+	}
+	if (pArray) {
+		memcpy(pNewArray, pArray, count * elementSize);
+		heapFree(pArray);
+	}
+	*pCapacity = newCapacity;
+	return pNewArray;
+}
+
+static bool isStructureCommand(const RenderCommandType type) {
+	return type == RENDER_COMMAND_LOAD_QUAD || type == RENDER_COMMAND_UNLOAD_QUAD;
+}
+
+// Update commands of the same kind replace each other.
+static uint32_t updateCommandKind(const RenderCommandType type) {
+	return type == RENDER_COMMAND_SET_IMAGE ? RENDER_COMMAND_SET_ANIMATION : type;
+}
+
+static int compareUpdateCommands(const void *pA, const void *pB) {
+	const RenderCommand *const pCommandA = pA;
+	const RenderCommand *const pCommandB = pB;
+	if (pCommandA->quadSlot != pCommandB->quadSlot) {
+		return pCommandA->quadSlot < pCommandB->quadSlot ? -1 : 1;
+	}
+	
+	const uint32_t kindA = updateCommandKind(pCommandA->type);
+	const uint32_t kindB = updateCommandKind(pCommandB->type);
+	if (kindA != kindB) {
+		return kindA < kindB ? -1 : 1;
+	} else if (pCommandA->sequence != pCommandB->sequence) {
+		return pCommandA->sequence < pCommandB->sequence ? -1 : 1;
+	}
+	return 0;
+}
+
+void deleteRenderCommandQueue(RenderCommandQueue *const pQueue) {
+	if (!pQueue) {
+		return;
+	}
+	if (pQueue->pStructureCommands) {
+		pQueue->pStructureCommands = heapFree(pQueue->pStructureCommands);
+	}
+	if (pQueue->pUpdateCommands) {
+		pQueue->pUpdateCommands = heapFree(pQueue->pUpdateCommands);
+	}
+	if (pQueue->pLoadInfos) {
+		pQueue->pLoadInfos = heapFree(pQueue->pLoadInfos);
+	}
+	*pQueue = (RenderCommandQueue){ };
+}
+
+bool renderCommandQueuePush(RenderCommandQueue *const pQueue, RenderCommand command) {
+	assert(pQueue);
+	
+	command.sequence = pQueue->nextSequence;
+	if (isStructureCommand((RenderCommandType)command.type)) {
+		if (pQueue->structureCommandCount >= pQueue->structureCommandCapacity) {
+			RenderCommand *const pNewCommands = growArray(pQueue->pStructureCommands, &pQueue->structureCommandCapacity, pQueue->structureCommandCount, sizeof(RenderCommand));
+			if (!pNewCommands) {
+				logMsg(loggerRender, LOG_LEVEL_ERROR, "Error queueing render command: failed to grow command queue.");
+				return false;
+			}
+			pQueue->pStructureCommands = pNewCommands;
+		}
+		pQueue->pStructureCommands[pQueue->structureCommandCount] = command;
+		pQueue->structureCommandCount += 1;
+	} else {
+		if (pQueue->updateCommandCount >= pQueue->updateCommandCapacity) {
+			RenderCommand *const pNewCommands = growArray(pQueue->pUpdateCommands, &pQueue->updateCommandCapacity, pQueue->updateCommandCount, sizeof(RenderCommand));
+			if (!pNewCommands) {
+				logMsg(loggerRender, LOG_LEVEL_ERROR, "Error queueing render command: failed to grow command queue.");
+				return false;
+			}
+			pQueue->pUpdateCommands = pNewCommands;
+		}
+		pQueue->pUpdateCommands[pQueue->updateCommandCount] = command;
+		pQueue->updateCommandCount += 1;
+	}
+	pQueue->nextSequence += 1;
+	return true;
+}
+
+bool renderCommandQueuePushLoad(RenderCommandQueue *const pQueue, const uint32_t quadSlot, const uint32_t generation, const QuadLoadInfo loadInfo) {
+	assert(pQueue);
+	
+	if (pQueue->loadInfoCount >= pQueue->loadInfoCapacity) {
+		QuadLoadInfo *const pNewLoadInfos = growArray(pQueue->pLoadInfos, &pQueue->loadInfoCapacity, pQueue->loadInfoCount, sizeof(QuadLoadInfo));
+		if (!pNewLoadInfos) {
+			logMsg(loggerRender, LOG_LEVEL_ERROR, "Error queueing render command: failed to grow quad load info array.");
+			return false;
+		}
+		pQueue->pLoadInfos = pNewLoadInfos;
+	}
+	
+	const RenderCommand command = {
+		.type = RENDER_COMMAND_LOAD_QUAD,
+		.quadSlot = quadSlot,
+		.generation = generation,
+		.loadInfoIndex = pQueue->loadInfoCount
+	};
+	if (!renderCommandQueuePush(pQueue, command)) {
+		return false;
+	}
+	pQueue->pLoadInfos[pQueue->loadInfoCount] = loadInfo;
+	pQueue->loadInfoCount += 1;
+	return true;
+}
+
+void renderCommandQueueCoalesceUpdates(RenderCommandQueue *const pQueue) {
+	assert(pQueue);
+	if (pQueue->updateCommandCount == 0) {
+		return;
+	}
+	
+	qsort(pQueue->pUpdateCommands, pQueue->updateCommandCount, sizeof(RenderCommand), compareUpdateCommands);
+	
+	// Commands of the same kind for the same quad are now adjacent, in the order they were queued, so only the last of each run is kept.
+	uint32_t keptCount = 0;
+	for (uint32_t i = 0; i < pQueue->updateCommandCount; ++i) {
+		const RenderCommand command = pQueue->pUpdateCommands[i];
+		if (i + 1 < pQueue->updateCommandCount) {
+			const RenderCommand nextCommand = pQueue->pUpdateCommands[i + 1];
+			if (nextCommand.quadSlot == command.quadSlot && updateCommandKind(nextCommand.type) == updateCommandKind(command.type)) {
+				continue;
+			}
+		}
+		pQueue->pUpdateCommands[keptCount] = command;
+		keptCount += 1;
+	}
+	pQueue->updateCommandCount = keptCount;
+}
+
+void renderCommandQueueClear(RenderCommandQueue *const pQueue) {
+	assert(pQueue);
+	pQueue->nextSequence = 0;
+	pQueue->structureCommandCount = 0;
+	pQueue->updateCommandCount = 0;
+	pQueue->loadInfoCount = 0;
+}
@@ -0,0 +1,101 @@
+#ifndef RENDER_COMMAND_QUEUE_H
+#define RENDER_COMMAND_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "math/Vector.h"
+#include "RenderManager.h"
+
+// Changes to render objects are queued as commands during a game tick, and applied together when the queue is flushed.
+// Structural commands (loading and unloading quads) are applied first, in the order they were queued.
+// Update commands are then sorted by quad, and only the last command of each kind queued for a quad is applied,
+// 	so e.g. an entity that moves several times in a tick only has its transform written once.
+
+typedef enum RenderCommandType {
+	RENDER_COMMAND_LOAD_QUAD = 0,
+	RENDER_COMMAND_UNLOAD_QUAD = 1,
+	
+	RENDER_COMMAND_SET_POSITION = 2,
+	RENDER_COMMAND_SET_ROTATION = 3,
+	
+	// Setting an animation and setting an image replace each other, so only the last of either is applied.
+	RENDER_COMMAND_SET_ANIMATION = 4,
+	RENDER_COMMAND_SET_IMAGE = 5,
+	
+	RENDER_COMMAND_SET_TILEMAP = 6,
+	
+	RENDER_COMMAND_SET_VISIBLE = 7
+} RenderCommandType;
+
+typedef struct RenderCommand {
+	
+	uint8_t type;
+	
+	// Index of the quad's slot in the render manager's quad pool.
+	uint32_t quadSlot;
+	
+	// The generation of the quad's slot when the command was queued; commands for an earlier use of the slot are discarded.
+	uint32_t generation;
+	
+	// The order in which the command was queued, set by the queue.
+	uint32_t sequence;
+	
+	union {
+		
+		// Index into the queue's quad load infos, for load commands.
+		uint32_t loadInfoIndex;
+		
+		// Position or rotation.
+		Vector4F vector;
+		
+		uint32_t animation;
+		
+		uint32_t imageIndex;
+		
+		bool visible;
+		
+		struct {
+			uint32_t slot;
+			uint32_t layer;
+		} tilemap;
+		
+	};
+	
+} RenderCommand;
+
+// Load infos are kept apart from the commands, so that the frequent update commands stay small.
+typedef struct RenderCommandQueue {
+	
+	uint32_t nextSequence;
+	
+	uint32_t structureCommandCount;
+	uint32_t structureCommandCapacity;
+	RenderCommand *pStructureCommands;
+	
+	uint32_t updateCommandCount;
+	uint32_t updateCommandCapacity;
+	RenderCommand *pUpdateCommands;
+	
+	uint32_t loadInfoCount;
+	uint32_t loadInfoCapacity;
+	QuadLoadInfo *pLoadInfos;
+	
+} RenderCommandQueue;
+
+void deleteRenderCommandQueue(RenderCommandQueue *const pQueue);
+
+// Queues a command; load commands must be queued with renderCommandQueuePushLoad instead.
+// Returns true if successful, false otherwise.
+bool renderCommandQueuePush(RenderCommandQueue *const pQueue, RenderCommand command);
+
+// Queues a command to load a quad.
+// Returns true if successful, false otherwise.
+bool renderCommandQueuePushLoad(RenderCommandQueue *const pQueue, const uint32_t quadSlot, const uint32_t generation, const QuadLoadInfo loadInfo);
+
+// Sorts the update commands by quad slot and kind, and removes every update command replaced by a later one.
+void renderCommandQueueCoalesceUpdates(RenderCommandQueue *const pQueue);
+
+// Removes every command from the queue, keeping its memory for the next tick.
+void renderCommandQueueClear(RenderCommandQueue *const pQueue);
+
+#endif	// RENDER_COMMAND_QUEUE_H
@@ -5,39 +5,75 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <GLFW/glfw3.h>
 #include "config.h"
 #include "log/Logger.h"
 #include "util/Allocation.h"
+#include "util/GameClock.h"
+#include "util/Pool.h"
+#include "util/Time.h"
+#include "RenderCommandQueue.h"
+#include "RenderSnapshot.h"
+#include "RenderTaskQueue.h"
 #include "vulkan/Draw.h"
+#include "vulkan/RoomTilemap.h"
+#include "vulkan/TextRenderer.h"
 #include "vulkan/VulkanManager.h"
 #include "vulkan/texture_manager.h"
 
 #define DATA_PATH (RESOURCE_PATH "data/")
-#define FGT_PATH (RESOURCE_PATH "data/textures.fgt")
+#define FGT_PATH "data/textures.fgt"
 
-#define RENDER_OBJECT_MAX_COUNT 64
-#define RENDER_OBJECT_QUAD_MAX_COUNT 64
+#define RENDER_OBJECT_POOL_INITIAL_CAPACITY 64
+#define RENDER_QUAD_POOL_INITIAL_CAPACITY 256
+
+// A render object handle holds the index of the object's slot in its low bits, and the slot's generation in the bits above,
+// 	so that a handle kept after its object is unloaded does not refer to a later object in the same slot.
+#define RENDER_OBJECT_INDEX_BITS 16
+#define RENDER_OBJECT_INDEX_MASK ((1U << RENDER_OBJECT_INDEX_BITS) - 1)
+#define RENDER_OBJECT_GENERATION_MASK 0x7FFFU
 
 typedef struct RenderObjectQuad {
-	int32_t handle;
+	
+	// Models are only loaded and unloaded once the render commands are flushed,
+	// 	so a quad's slot can be freed and allocated again while the model from its earlier use is still loaded.
+	bool modelLoaded;
+	int32_t modelHandle;
 	ModelPool modelPool;
+	
+	int32_t textureHandle;
+	
+	// The animation last set by the game, so that it can be read back before the commands setting it are flushed.
+	uint32_t animation;
+	
 } RenderObjectQuad;
 
 typedef struct RenderObject {
 	
-	// True if this render object is 'loaded' or in use.
-	bool active;
-	
 	int32_t textureHandle;
 	
-	// Array of handles to quads being rendered.
-	int32_t quadCount;
-	RenderObjectQuad *pQuads;
+	// Slots of the object's quads in the quad pool, by quad index; POOL_INDEX_NONE for quad indices not in use.
+	// The array is kept when the object is unloaded, and reused by the next object loaded into the same slot.
+	uint32_t quadCount;
+	uint32_t quadCapacity;
+	uint32_t *pQuadSlots;
 	
 } RenderObject;
 
-static RenderObject renderObjects[RENDER_OBJECT_MAX_COUNT];
+static Pool renderObjectPool = { };
+
+// The quads of every render object are kept together, so that they can be iterated without going through their objects.
+static Pool quadPool = { };
+
+// Changes to render objects made during a tick, applied together when the commands are flushed.
+static RenderCommandQueue renderCommandQueue = { };
+
+// The number of quads in the current flush that were not loaded because their model pool was full; such quads stay invisible.
+static uint32_t failedQuadLoadCount = 0;
+
+// The animation clock only advances while animation is enabled, so that animations pause with the game.
+// Only used by the render thread.
+static uint64_t lastFrameTimeMS = 0;
+static uint64_t animationTimeMS = 0;
 
 const Vector4F COLOR_WHITE 	= { 1.0F, 1.0F, 1.0F, 1.0F };
 const Vector4F COLOR_BLACK 	= { 0.0F, 0.0F, 0.0F, 1.0F };
@@ -52,16 +88,33 @@ const Vector4F COLOR_PINK	= { 1.0F, 0.6392156863F, 0.7568627451F, 1.0F };
 void initRenderManager(void) {
 	logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Initializing render manager...");
 	
-	initVulkanManager();
+	// Headless rooms are always stitched, since stitching only queues render tasks, whereas tilemaps need the tile data buffer.
+	if (isRenderHeadless()) {
+		logMsg(loggerRender, LOG_LEVEL_INFO, "Rendering headless: no window is created and nothing is drawn.");
+		setRoomRenderMode(ROOM_RENDER_MODE_STITCHED);
+	} else {
+		initVulkanManager();
+	}
 	initTextureManager();
 
 	TexturePack texturePack = readTexturePackFile(FGT_PATH);
 	textureManagerLoadTexturePack(texturePack);
 	deleteTexturePack(&texturePack);
 	
+	if (!isRenderHeadless()) {
+		textRendererSetFont(findTexture(makeStaticString("gui/fontFrogBlock")));
+	}
+	
+	renderObjectPool = newPool(sizeof(RenderObject));
+	quadPool = newPool(sizeof(RenderObjectQuad));
+	poolReserve(&renderObjectPool, RENDER_OBJECT_POOL_INITIAL_CAPACITY);
+	poolReserve(&quadPool, RENDER_QUAD_POOL_INITIAL_CAPACITY);
+	
 	// TEMPORARY
 	// Create room textures -- one for each room size.
-	for (int i = 0; i < (int)num_room_sizes; ++i) {
+	// Only stitched rooms are drawn from them; tilemap rooms read their tiles straight from the tileset.
+	const int roomTextureCount = getRoomRenderMode() == ROOM_RENDER_MODE_STITCHED ? (int)num_room_sizes : 0;
+	for (int i = 0; i < roomTextureCount; ++i) {
 		
 		// Give each room texture enough layers for each room layer (background, foreground) and each room cache slot.
 		TextureCreateInfo roomTextureCreateInfo = (TextureCreateInfo){
@@ -127,97 +180,239 @@ void initRenderManager(void) {
 
 void terminateRenderManager(void) {
 	logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Terminating render manager...");
-	terminateVulkanManager();
+	if (isRenderHeadless()) {
+		dropRenderCommands();
+	} else {
+		flushRenderCommands();
+	}
+	deleteRenderCommandQueue(&renderCommandQueue);
+	
+	// Freed slots keep their quad slot arrays, so every slot is checked.
+	for (uint32_t i = 0; i < renderObjectPool.capacity; ++i) {
+		RenderObject *const pRenderObject = poolGet(&renderObjectPool, i);
+		if (pRenderObject->pQuadSlots) {
+			pRenderObject->pQuadSlots = heapFree(pRenderObject->pQuadSlots);
+		}
+	}
+	deletePool(&renderObjectPool);
+	deletePool(&quadPool);
+	
+	// No more frames are drawn, so render tasks still queued are dropped.
+	terminateRenderTasks();
+	deleteRenderSnapshots();
+	if (isRenderHeadless()) {
+		terminateTextureManager();
+	} else {
+		terminateVulkanManager();
+	}
 	logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Terminated render manager.");
 }
 
 void tickRenderManager(void) {
-	for (int32_t handle = 0; handle < RENDER_OBJECT_MAX_COUNT; ++handle) {
-		if (!renderObjects[handle].active) {
-			continue;
-		}
-		for (int32_t quadIndex = 0; quadIndex < renderObjects[handle].quadCount; ++quadIndex) {
-			if (renderObjects[handle].pQuads[quadIndex].handle >= 0) {
-				modelSettleTransform(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle);
-			}
+	const RenderObjectQuad *const pQuads = quadPool.pValues;
+	for (uint32_t i = 0; i < quadPool.capacity; ++i) {
+		if (pQuads[i].modelLoaded) {
+			modelSettleTransform(pQuads[i].modelPool, pQuads[i].modelHandle);
 		}
 	}
 }
 
-void renderFrame(const float timeDelta, const Vector4F cameraPosition, const ProjectionBounds projectionBounds, const bool animate) {
-	glfwPollEvents();
+void dropRenderCommands(void) {
+	renderCommandQueueClear(&renderCommandQueue);
+	terminateRenderTasks();
+}
+
+void publishRenderState(const Vector4F cameraPosition, const ProjectionBounds projectionBounds, const bool animate) {
+	RenderSnapshot *const pSnapshot = beginRenderSnapshot();
+	pSnapshot->tick = gameClockGetTickCount();
+	pSnapshot->alpha = gameClockGetAlpha();
+	pSnapshot->timeScale = gameClockGetTimeScale();
+	pSnapshot->frameTimeMS = gameClockGetFrameTimeMS();
+	pSnapshot->animate = animate;
+	pSnapshot->cameraPosition = cameraPosition;
+	pSnapshot->projectionBounds = projectionBounds;
+	modelPoolTakeSnapshot(modelPoolMain, &pSnapshot->mainModels);
+	modelPoolTakeSnapshot(modelPoolDebug, &pSnapshot->debugModels);
+	pSnapshot->renderTaskBatch = sealRenderTasks();
+	pSnapshot->publishTimeNS = getNanoseconds();
+	publishRenderSnapshot();
+}
+
+void renderFrame(void) {
+	const RenderSnapshot *const pSnapshot = acquireRenderSnapshot();
+	if (!pSnapshot) {
+		return;
+	}
 	
-	if (animate) {
-		for (int32_t i = 0; i < RENDER_OBJECT_MAX_COUNT; ++i) {
-			renderObjectAnimate(i);
+	// GPU work queued by the ticks up to the snapshot's tick is done before the snapshot is drawn.
+	runRenderTasks(pSnapshot->renderTaskBatch);
+	
+	// Interpolate from the snapshot's previous tick towards its current tick by the game time that passed since the snapshot was taken.
+	// If the next snapshot is late, the frame holds at the snapshot's tick instead of extrapolating past it.
+	const uint64_t currentTimeNS = getNanoseconds();
+	const uint64_t elapsedTimeNS = currentTimeNS > pSnapshot->publishTimeNS ? currentTimeNS - pSnapshot->publishTimeNS : 0;
+	const double elapsedTicks = (double)elapsedTimeNS * pSnapshot->timeScale / ((double)gameTickDurationMS * 1.0e6);
+	float alpha = pSnapshot->alpha + (float)elapsedTicks;
+	if (alpha > 1.0F) {
+		alpha = 1.0F;
+	}
+	
+	uint32_t imageIndex = 0;
+	if (!acquireFrame(&imageIndex)) {
+		return;
+	}
+	
+	// Sprite animation frames are selected on the GPU, so only the animation clock is updated here.
+	// The clock never runs backwards, even when a new snapshot's frame time is behind the frame time drawn last.
+	const float elapsedFrameTimeMS = alpha > pSnapshot->alpha ? (alpha - pSnapshot->alpha) * (float)gameTickDurationMS : 0.0F;
+	const uint64_t currentFrameTimeMS = pSnapshot->frameTimeMS + (uint64_t)elapsedFrameTimeMS;
+	if (currentFrameTimeMS > lastFrameTimeMS) {
+		if (pSnapshot->animate && lastFrameTimeMS > 0) {
+			animationTimeMS += currentFrameTimeMS - lastFrameTimeMS;
+			setAnimationTime((uint32_t)animationTimeMS);
 		}
+		lastFrameTimeMS = currentFrameTimeMS;
+	}
+	
+	drawFrame(imageIndex, alpha, pSnapshot->cameraPosition, pSnapshot->projectionBounds, &pSnapshot->mainModels, &pSnapshot->debugModels);
+}
+
+// Returns the animation that a quad starts in, or 0 if the animation in its load info is not one of its texture's animations.
+static uint32_t getQuadInitAnimation(const int32_t textureHandle, const QuadLoadInfo loadInfo) {
+	const Texture texture = getTexture(textureHandle);
+	const bool animationValid = loadInfo.initAnimation >= 0 && loadInfo.initAnimation < (int32_t)texture.numAnimations;
+	return animationValid ? (uint32_t)loadInfo.initAnimation : 0;
+}
+
+static uint32_t renderObjectHandleIndex(const int32_t handle) {
+	return (uint32_t)handle & RENDER_OBJECT_INDEX_MASK;
+}
+
+static int32_t makeRenderObjectHandle(const uint32_t index) {
+	const uint32_t generation = poolGetGeneration(&renderObjectPool, index) & RENDER_OBJECT_GENERATION_MASK;
+	return (int32_t)((generation << RENDER_OBJECT_INDEX_BITS) | index);
+}
+
+// Returns the render object that the handle refers to, or null if it does not exist.
+// The pointer is invalidated when the next render object is loaded.
+static RenderObject *findRenderObject(const int32_t handle) {
+	if (!validateRenderObjectHandle(handle)) {
+		return nullptr;
+	}
+	const uint32_t index = renderObjectHandleIndex(handle);
+	if (!poolIsUsed(&renderObjectPool, index) || makeRenderObjectHandle(index) != handle) {
+		return nullptr;
+	}
+	return poolGet(&renderObjectPool, index);
+}
+
+// Returns the quad pool slot of a render object's quad, or POOL_INDEX_NONE if the quad does not exist.
+static uint32_t findRenderObjectQuadSlot(const int32_t handle, const int32_t quadIndex) {
+	const RenderObject *const pRenderObject = findRenderObject(handle);
+	if (!pRenderObject || !validateRenderObjectQuadIndex(quadIndex) || (uint32_t)quadIndex >= pRenderObject->quadCount) {
+		return POOL_INDEX_NONE;
+	}
+	return pRenderObject->pQuadSlots[quadIndex];
+}
+
+// Makes room for at least quadCapacity quads in a render object's quad slot array, marking the new entries as not in use.
+// Returns true if successful, false otherwise.
+static bool reserveRenderObjectQuadSlots(RenderObject *const pRenderObject, const uint32_t quadCapacity) {
+	if (quadCapacity <= pRenderObject->quadCapacity) {
+		return true;
+	}
+	
+	uint32_t newCapacity = pRenderObject->quadCapacity > 0 ? 2 * pRenderObject->quadCapacity : 1;
+	if (newCapacity < quadCapacity) {
+		newCapacity = quadCapacity;
+	}
+	uint32_t *const pNewQuadSlots = heapAlloc(newCapacity, sizeof(uint32_t));
+	if (!pNewQuadSlots) {
+		return false;
+	}
+	if (pRenderObject->pQuadSlots) {
+		memcpy(pNewQuadSlots, pRenderObject->pQuadSlots, pRenderObject->quadCount * sizeof(uint32_t));
+		pRenderObject->pQuadSlots = heapFree(pRenderObject->pQuadSlots);
+	}
+	for (uint32_t i = pRenderObject->quadCount; i < newCapacity; ++i) {
+		pNewQuadSlots[i] = POOL_INDEX_NONE;
+	}
+	pRenderObject->pQuadSlots = pNewQuadSlots;
+	pRenderObject->quadCapacity = newCapacity;
+	return true;
+}
+
+// Allocates a quad for the game, and queues its model to be loaded.
+// Returns true if successful, false otherwise.
+static bool reserveRenderObjectQuad(RenderObject *const pRenderObject, const uint32_t quadIndex, const QuadLoadInfo loadInfo) {
+	const uint32_t quadSlot = poolAlloc(&quadPool);
+	if (quadSlot == POOL_INDEX_NONE) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading render object quad: failed to allocate quad.");
+		return false;
 	}
 	
-	drawFrame(timeDelta, cameraPosition, projectionBounds);
+	RenderObjectQuad *const pQuad = poolGet(&quadPool, quadSlot);
+	pQuad->textureHandle = pRenderObject->textureHandle;
+	pQuad->animation = getQuadInitAnimation(pRenderObject->textureHandle, loadInfo);
+	pRenderObject->pQuadSlots[quadIndex] = quadSlot;
+	renderCommandQueuePushLoad(&renderCommandQueue, quadSlot, poolGetGeneration(&quadPool, quadSlot), loadInfo);
+	return true;
+}
+
+// Frees a quad from the game, and queues its model to be unloaded.
+// The quad's slot can be allocated again at once, since its model is unloaded before the next one is loaded.
+static void releaseRenderObjectQuad(RenderObject *const pRenderObject, const uint32_t quadIndex) {
+	const uint32_t quadSlot = pRenderObject->pQuadSlots[quadIndex];
+	renderCommandQueuePush(&renderCommandQueue, (RenderCommand){
+		.type = RENDER_COMMAND_UNLOAD_QUAD,
+		.quadSlot = quadSlot,
+		.generation = poolGetGeneration(&quadPool, quadSlot)
+	});
+	poolFree(&quadPool, quadSlot);
+	pRenderObject->pQuadSlots[quadIndex] = POOL_INDEX_NONE;
+}
+
+static void pushRenderObjectUpdate(const uint32_t quadSlot, RenderCommand command) {
+	command.quadSlot = quadSlot;
+	command.generation = poolGetGeneration(&quadPool, quadSlot);
+	renderCommandQueuePush(&renderCommandQueue, command);
 }
 
 int32_t loadRenderObject(const RenderObjectLoadInfo loadInfo) {
-	if (loadInfo.quadCount <= 0 || loadInfo.quadCount > RENDER_OBJECT_QUAD_MAX_COUNT) {
+	if (loadInfo.quadCount <= 0) {
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading render object: quad count (%i) is invalid.", loadInfo.quadCount);
 		return -1;
 	}
 	
-	int32_t handle = -1;
-	for (int32_t i = 0; i < RENDER_OBJECT_MAX_COUNT; ++i) {
-		if (!renderObjects[i].active) {
-			handle = i;
-			break;
-		}
-	}
-	if (!validateRenderObjectHandle(handle)) {
+	const uint32_t index = poolAlloc(&renderObjectPool);
+	if (index == POOL_INDEX_NONE || index > RENDER_OBJECT_INDEX_MASK) {
+		poolFree(&renderObjectPool, index);
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading render object: no render object slots available.");
 		return -1;
 	}
 	
-	renderObjects[handle].quadCount = loadInfo.quadCount;
-	renderObjects[handle].pQuads = heapAlloc(loadInfo.quadCount, sizeof(RenderObjectQuad));
-	if (!renderObjects[handle].pQuads) {
-		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading render object: failed to allocate quad array.");
+	RenderObject *const pRenderObject = poolGet(&renderObjectPool, index);
+	pRenderObject->quadCount = 0;
+	if (!reserveRenderObjectQuadSlots(pRenderObject, (uint32_t)loadInfo.quadCount)) {
+		poolFree(&renderObjectPool, index);
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading render object: failed to allocate quad slot array.");
 		return -1;
 	}
-	for (int32_t i = 0; i < loadInfo.quadCount; ++i) {
-		renderObjects[handle].pQuads[i] = (RenderObjectQuad){
-			.handle = -1,
-			.modelPool = nullptr
-		};
-	}
+	pRenderObject->quadCount = (uint32_t)loadInfo.quadCount;
 	
-	if (!stringIsNull(loadInfo.textureID)) {
-		renderObjects[handle].textureHandle = findTexture(loadInfo.textureID);
+	if (loadInfo.textureID != stringIDNull) {
+		pRenderObject->textureHandle = findTextureByID(loadInfo.textureID);
+	} else if (validateTextureHandle(loadInfo.textureHandle)) {
+		pRenderObject->textureHandle = loadInfo.textureHandle;
 	} else {
-		renderObjects[handle].textureHandle = textureHandleMissing;
+		pRenderObject->textureHandle = textureHandleMissing;
 	}
-	const Texture texture = getTexture(renderObjects[handle].textureHandle);
 	
-	for (int32_t quadIndex = 0; quadIndex < loadInfo.quadCount; ++quadIndex) {
-		
-		const QuadLoadInfo quadLoadInfo = loadInfo.pQuadLoadInfos[quadIndex];
-		
-		int32_t imageIndex = 0;
-		if (quadLoadInfo.initAnimation >= 0 && quadLoadInfo.initAnimation < (int32_t)texture.numAnimations) {
-			imageIndex = texture.animations[quadLoadInfo.initAnimation].startCell + quadLoadInfo.initCell;
-		}
-		
-		const ModelLoadInfo modelLoadInfo = {
-			.modelPool = quadLoadInfo.quadType == QUAD_TYPE_WIREFRAME ? modelPoolDebug : modelPoolMain,
-			.position = vec3DtoVec4F(quadLoadInfo.initPosition),
-			.dimensions = quadLoadInfo.quadDimensions,
-			.cameraFlag = quadLoadInfo.quadType == QUAD_TYPE_GUI ? 0 : 1,
-			.textureHandle = renderObjects[handle].textureHandle,
-			.color = quadLoadInfo.color,
-			.imageIndex = imageIndex
-		};
-		loadModel(modelLoadInfo, &renderObjects[handle].pQuads[quadIndex].handle);
-		renderObjects[handle].pQuads[quadIndex].modelPool = modelLoadInfo.modelPool;
-		logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Loaded quad %i in render object %i (model handle = %i).", quadIndex, handle, renderObjects[handle].pQuads[quadIndex].handle);
+	for (uint32_t quadIndex = 0; quadIndex < pRenderObject->quadCount; ++quadIndex) {
+		reserveRenderObjectQuad(pRenderObject, quadIndex, loadInfo.pQuadLoadInfos[quadIndex]);
 	}
 	
-	renderObjects[handle].active = true;
+	const int32_t handle = makeRenderObjectHandle(index);
 	logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Loaded render object %i.", handle);
 	return handle;
 }
@@ -226,131 +421,93 @@ void unloadRenderObject(int32_t *const pHandle) {
 	if (!pHandle) {
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error unloading render object: pointer to render object handle is null.");
 		return;
-	} else if (!renderObjectExists(*pHandle)) {
+	}
+	
+	RenderObject *const pRenderObject = findRenderObject(*pHandle);
+	if (!pRenderObject) {
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error unloading render object: render object %i does not exist.", *pHandle);
 		return;
 	}
 	
-	for (int32_t quadIndex = 0; quadIndex < renderObjects[*pHandle].quadCount; ++quadIndex) {
-		if (renderObjects[*pHandle].pQuads[quadIndex].handle >= 0) {
-			unloadModel(renderObjects[*pHandle].pQuads[quadIndex].modelPool, &renderObjects[*pHandle].pQuads[quadIndex].handle);
+	for (uint32_t quadIndex = 0; quadIndex < pRenderObject->quadCount; ++quadIndex) {
+		if (pRenderObject->pQuadSlots[quadIndex] != POOL_INDEX_NONE) {
+			releaseRenderObjectQuad(pRenderObject, quadIndex);
 		}
 	}
-	renderObjects[*pHandle].active = false;
-	renderObjects[*pHandle].quadCount = 0;
-	renderObjects[*pHandle].pQuads = heapFree(renderObjects[*pHandle].pQuads);
+	pRenderObject->quadCount = 0;
+	poolFree(&renderObjectPool, renderObjectHandleIndex(*pHandle));
 	
 	logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Unloaded render object %i.", *pHandle);
 	*pHandle = -1;
 }
 
 int32_t loadRenderText(const String text, const Vector3D position, const Vector4F color) {
-	
-	QuadLoadInfo quadLoadInfos[text.length] = { };
-	for (int32_t i = 0; i < (int32_t)text.length; ++i) {
-		quadLoadInfos[i] = (QuadLoadInfo){
-			.quadType = QUAD_TYPE_GUI,
-			.initPosition = addVec(position, mulVec3D(makeVec3D(0.5, 0.0, 0.0), (double)i)),
-			.quadDimensions = (BoxF){ .x1 = -0.25F, .y1 = -0.25F, .x2 = 0.25F, .y2 = 0.25F },
-			.initAnimation = 0,
-			.initCell = (int32_t)text.pBuffer[i],
-			.color = color
-		};
-	}
-	
-	const RenderObjectLoadInfo loadInfo = {
-		.textureID = makeStaticString("gui/fontFrogBlock"),
-		.quadCount = text.length,
-		.pQuadLoadInfos = quadLoadInfos
+	const TextLoadInfo loadInfo = {
+		.position = (Vector4F){ (float)position.x, (float)position.y, (float)position.z, 1.0F },
+		.color = color,
+		.length = (uint32_t)text.length,
+		.pText = text.pBuffer
 	};
-	
-	return loadRenderObject(loadInfo);
+	return loadText(loadInfo);
+}
+
+void unloadRenderText(int32_t *const pHandle) {
+	unloadText(pHandle);
 }
 
 void writeRenderText(const int32_t handle, const char *const pFormat, ...) {
-	if (!renderObjectExists(handle)) {
-		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error writing render text: render object %i does not exist.", handle);
+	if (!textExists(handle)) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error writing render text: text object %i does not exist.", handle);
+		return;
 	}
 	
-	#define BUFSIZE (RENDER_OBJECT_QUAD_MAX_COUNT + 1)
+	#define BUFSIZE 256
 	char buffer[BUFSIZE];
-	memset(buffer, 0, BUFSIZE);
 	va_list vlist;
 	va_start(vlist, pFormat);
-	vsnprintf_s(buffer, BUFSIZE, renderObjects[handle].quadCount, pFormat, vlist);
+	const int length = vsnprintf(buffer, BUFSIZE, pFormat, vlist);
 	va_end(vlist);
-	#undef BUFSIZE
 	
-	for (int32_t quadIndex = 0; quadIndex < renderObjects[handle].quadCount; ++quadIndex) {
-		TextureState *const pTextureState = modelGetTextureState(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle);
-		if (pTextureState) {
-			const unsigned int imageIndex = (unsigned int)buffer[quadIndex];
-			pTextureState->currentFrame = imageIndex;
-			updateDrawInfo(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle, imageIndex);
-		}
+	if (length < 0) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error writing render text: failed to format text.");
+		return;
 	}
+	textWrite(handle, length < BUFSIZE ? (uint32_t)length : BUFSIZE - 1, buffer);
+	#undef BUFSIZE
 }
 
 bool validateRenderObjectHandle(const int32_t handle) {
-	return handle >= 0 && handle < RENDER_OBJECT_MAX_COUNT;
+	return handle >= 0;
 }
 
 bool renderObjectExists(const int32_t handle) {
-	return validateRenderObjectHandle(handle) && renderObjects[handle].active;
+	return findRenderObject(handle) != nullptr;
 }
 
 int32_t renderObjectLoadQuad(const int32_t handle, const QuadLoadInfo loadInfo) {
-	if (!renderObjectExists(handle)) {
+	RenderObject *const pRenderObject = findRenderObject(handle);
+	if (!pRenderObject) {
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading render object quad: render object %i does not exist.", handle);
 		return -1;
 	}
 	
-	// Find the first appropriate slot to use.
-	bool enoughSpace = false; // Set to true if space for the new quad is found.
-	int32_t quadIndex = 0;
-	for (; quadIndex < renderObjects[handle].quadCount; ++quadIndex) {
-		if (renderObjects[handle].pQuads[quadIndex].handle < 0) {
-			enoughSpace = true;
-			break;
-		}
+	// Use the first quad index not in use, or add one at the end if every index is in use.
+	uint32_t quadIndex = 0;
+	while (quadIndex < pRenderObject->quadCount && pRenderObject->pQuadSlots[quadIndex] != POOL_INDEX_NONE) {
+		quadIndex += 1;
 	}
-	
-	// If there is not enough space for the new quad, double the amount of space.
-	if (!enoughSpace) {
-		const int32_t newCapacity = renderObjects[handle].quadCount > 0 ? 2 * renderObjects[handle].quadCount : 1;
-		RenderObjectQuad *const pRealloc = heapRealloc(renderObjects[handle].pQuads, newCapacity, sizeof(RenderObjectQuad));
-		if (!pRealloc) {
-			logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading render object quad: failed to reallocate quad array.");
+	if (quadIndex == pRenderObject->quadCount) {
+		if (!reserveRenderObjectQuadSlots(pRenderObject, quadIndex + 1)) {
+			logMsg(loggerRender, LOG_LEVEL_ERROR, "Error loading render object quad: failed to grow quad slot array.");
 			return -1;
 		}
-		renderObjects[handle].pQuads = pRealloc;
-		quadIndex = renderObjects[handle].quadCount;
-		renderObjects[handle].quadCount = newCapacity;
-		for (int32_t i = quadIndex; i < newCapacity; ++i) {
-			renderObjects[handle].pQuads[i].handle = -1;
-		}
+		pRenderObject->quadCount += 1;
 	}
 	
-	const Texture texture = getTexture(renderObjects[handle].textureHandle);
-	int32_t imageIndex = 0;
-	if (loadInfo.initAnimation >= 0 && loadInfo.initAnimation < (int32_t)texture.numAnimations) {
-		imageIndex = texture.animations[loadInfo.initAnimation].startCell + loadInfo.initCell;
+	if (!reserveRenderObjectQuad(pRenderObject, quadIndex, loadInfo)) {
+		return -1;
 	}
-	
-	const ModelLoadInfo modelLoadInfo = {
-		.modelPool = loadInfo.quadType == QUAD_TYPE_WIREFRAME ? modelPoolDebug : modelPoolMain,
-		.position = vec3DtoVec4F(loadInfo.initPosition),
-		.dimensions = loadInfo.quadDimensions,
-		.cameraFlag = loadInfo.quadType == QUAD_TYPE_GUI ? 0 : 1,
-		.textureHandle = renderObjects[handle].textureHandle,
-		.color = loadInfo.color,
-		.imageIndex = imageIndex
-	};
-	loadModel(modelLoadInfo, &renderObjects[handle].pQuads[quadIndex].handle);
-	renderObjects[handle].pQuads[quadIndex].modelPool = modelLoadInfo.modelPool;
-	
-	logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Loaded quad %i in render object %i (model handle = %i).", quadIndex, handle, renderObjects[handle].pQuads[quadIndex].handle);
-	return quadIndex;
+	return (int32_t)quadIndex;
 }
 
 void renderObjectUnloadQuad(const int32_t handle, int32_t *const pQuadIndex) {
@@ -361,17 +518,16 @@ void renderObjectUnloadQuad(const int32_t handle, int32_t *const pQuadIndex) {
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error unloading render object quad: quad %i of render object %i does not exist.", *pQuadIndex, handle);
 		return;
 	}
-	unloadModel(renderObjects[handle].pQuads[*pQuadIndex].modelPool, &renderObjects[handle].pQuads[*pQuadIndex].handle);
-	renderObjects[handle].pQuads[*pQuadIndex].modelPool = nullptr;
+	releaseRenderObjectQuad(findRenderObject(handle), (uint32_t)*pQuadIndex);
 	*pQuadIndex = -1;
 }
 
 bool validateRenderObjectQuadIndex(const int32_t quadIndex) {
-	return quadIndex >= 0 && quadIndex < RENDER_OBJECT_QUAD_MAX_COUNT;
+	return quadIndex >= 0;
 }
 
 bool renderObjectQuadExists(const int32_t handle, const int32_t quadIndex) {
-	return renderObjectExists(handle) && validateRenderObjectQuadIndex(quadIndex) && renderObjects[handle].pQuads[quadIndex].handle >= 0;
+	return findRenderObjectQuadSlot(handle, quadIndex) != POOL_INDEX_NONE;
 }
 
 void renderObjectSetPosition(const int32_t handle, const int32_t quadIndex, const Vector3D position) {
@@ -382,7 +538,10 @@ void renderObjectSetPosition(const int32_t handle, const int32_t quadIndex, cons
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error setting render object position: quad %i of render object %i does not exist.", quadIndex, handle);
 		return;
 	}
-	modelSetTranslation(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle, vec3DtoVec4F(position));
+	pushRenderObjectUpdate(findRenderObjectQuadSlot(handle, quadIndex), (RenderCommand){
+		.type = RENDER_COMMAND_SET_POSITION,
+		.vector = vec3DtoVec4F(position)
+	});
 }
 
 void renderObjectSetRotation(const int32_t handle, const int32_t quadIndex, const Vector3D rotation) {
@@ -393,7 +552,10 @@ void renderObjectSetRotation(const int32_t handle, const int32_t quadIndex, cons
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error setting render object position: quad %i of render object %i does not exist.", quadIndex, handle);
 		return;
 	}
-	modelSetRotation(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle, vec3DtoVec4F(rotation));
+	pushRenderObjectUpdate(findRenderObjectQuadSlot(handle, quadIndex), (RenderCommand){
+		.type = RENDER_COMMAND_SET_ROTATION,
+		.vector = vec3DtoVec4F(rotation)
+	});
 }
 
 int32_t renderObjectGetTextureHandle(const int32_t handle, const int32_t quadIndex) {
@@ -404,7 +566,7 @@ int32_t renderObjectGetTextureHandle(const int32_t handle, const int32_t quadInd
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error getting render object texture handle: quad %i of render object %i does not exist.", quadIndex, handle);
 		return -1;
 	}
-	return renderObjects[handle].textureHandle;
+	return findRenderObject(handle)->textureHandle;
 }
 
 void renderObjectSetQuadImage(const int32_t handle, const int32_t quadIndex, const int32_t imageIndex) {
@@ -415,28 +577,39 @@ void renderObjectSetQuadImage(const int32_t handle, const int32_t quadIndex, con
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Setting render object quad image: quad %i of render object %i does not exist.", quadIndex, handle);
 		return;
 	}
-	
-	TextureState *const pTextureState = modelGetTextureState(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle);
-	if (pTextureState) {
-		updateDrawInfo(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle, imageIndex);
-	}
+	pushRenderObjectUpdate(findRenderObjectQuadSlot(handle, quadIndex), (RenderCommand){
+		.type = RENDER_COMMAND_SET_IMAGE,
+		.imageIndex = (uint32_t)imageIndex
+	});
 }
 
-void renderObjectAnimate(const int32_t handle) {
+void renderObjectSetQuadTilemap(const int32_t handle, const int32_t quadIndex, const uint32_t tilemapSlot, const uint32_t layer) {
 	if (!renderObjectExists(handle)) {
-		//logMsg(loggerRender, LOG_LEVEL_ERROR, "Error animating render object: render object %i does not exist.", handle);
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Setting render object quad tilemap: render object %i does not exist.", handle);
+		return;
+	} else if (!renderObjectQuadExists(handle, quadIndex)) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Setting render object quad tilemap: quad %i of render object %i does not exist.", quadIndex, handle);
 		return;
 	}
-	
-	for (int32_t quadIndex = 0; quadIndex < renderObjects[handle].quadCount; ++quadIndex) {
-		if (renderObjects[handle].pQuads[quadIndex].handle < 0) {
-			continue;
-		}
-		
-		TextureState *const pTextureState = modelGetTextureState(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle);
-		if (textureStateAnimate(pTextureState) == 2) {
-			const uint32_t imageIndex = pTextureState->startCell + pTextureState->currentFrame;
-			updateDrawInfo(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle, imageIndex);
+	pushRenderObjectUpdate(findRenderObjectQuadSlot(handle, quadIndex), (RenderCommand){
+		.type = RENDER_COMMAND_SET_TILEMAP,
+		.tilemap.slot = tilemapSlot,
+		.tilemap.layer = layer
+	});
+}
+
+void renderObjectSetVisible(const int32_t handle, const bool visible) {
+	const RenderObject *const pRenderObject = findRenderObject(handle);
+	if (!pRenderObject) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error setting render object visibility: render object %i does not exist.", handle);
+		return;
+	}
+	for (uint32_t quadIndex = 0; quadIndex < pRenderObject->quadCount; ++quadIndex) {
+		if (pRenderObject->pQuadSlots[quadIndex] != POOL_INDEX_NONE) {
+			pushRenderObjectUpdate(pRenderObject->pQuadSlots[quadIndex], (RenderCommand){
+				.type = RENDER_COMMAND_SET_VISIBLE,
+				.visible = visible
+			});
 		}
 	}
 }
@@ -449,12 +622,8 @@ uint32_t renderObjectGetAnimation(const int32_t handle, const int32_t quadIndex)
 		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error getting render object animation: quad %i of render object %i does not exist.", quadIndex, handle);
 		return 0;
 	}
-	
-	const TextureState *const pTextureState = modelGetTextureState(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle);
-	if (pTextureState) {
-		return pTextureState->currentAnimation;
-	}
-	return 0;
+	const RenderObjectQuad *const pQuad = poolGet(&quadPool, findRenderObjectQuadSlot(handle, quadIndex));
+	return pQuad->animation;
 }
 
 bool renderObjectSetAnimation(const int32_t handle, const int32_t quadIndex, const uint32_t nextAnimation) {
@@ -466,14 +635,131 @@ bool renderObjectSetAnimation(const int32_t handle, const int32_t quadIndex, con
 		return false;
 	}
 	
-	TextureState *const pTextureState = modelGetTextureState(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle);
-	if (pTextureState) {
-		if (!textureStateSetAnimation(pTextureState, nextAnimation)) {
-			return false;
+	// The animation is checked now, since the command setting it is applied later.
+	const uint32_t quadSlot = findRenderObjectQuadSlot(handle, quadIndex);
+	RenderObjectQuad *const pQuad = poolGet(&quadPool, quadSlot);
+	const Texture texture = getTexture(pQuad->textureHandle);
+	if (nextAnimation >= texture.numAnimations) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error setting render object animation: animation %u is not less than the number of animations (%u).", nextAnimation, texture.numAnimations);
+		return false;
+	}
+	
+	pQuad->animation = nextAnimation;
+	pushRenderObjectUpdate(quadSlot, (RenderCommand){
+		.type = RENDER_COMMAND_SET_ANIMATION,
+		.animation = nextAnimation
+	});
+	return true;
+}
+
+static void applyLoadQuad(const RenderCommand command) {
+	
+	// A quad freed again later in the queue is never loaded.
+	if (!poolIsUsed(&quadPool, command.quadSlot) || poolGetGeneration(&quadPool, command.quadSlot) != command.generation) {
+		return;
+	}
+	
+	RenderObjectQuad *const pQuad = poolGet(&quadPool, command.quadSlot);
+	const QuadLoadInfo quadLoadInfo = renderCommandQueue.pLoadInfos[command.loadInfoIndex];
+	const Texture texture = getTexture(pQuad->textureHandle);
+	const bool animationValid = quadLoadInfo.initAnimation >= 0 && quadLoadInfo.initAnimation < (int32_t)texture.numAnimations;
+	
+	const ModelLoadInfo modelLoadInfo = {
+		.modelPool = quadLoadInfo.quadType == QUAD_TYPE_WIREFRAME ? modelPoolDebug : modelPoolMain,
+		.position = vec3DtoVec4F(quadLoadInfo.initPosition),
+		.dimensions = quadLoadInfo.quadDimensions,
+		.cameraFlag = quadLoadInfo.quadType == QUAD_TYPE_GUI ? 0 : 1,
+		.textureHandle = pQuad->textureHandle,
+		.color = quadLoadInfo.color,
+		.initAnimation = animationValid ? (uint32_t)quadLoadInfo.initAnimation : 0,
+		.initFrame = animationValid ? (uint32_t)quadLoadInfo.initCell : 0
+	};
+	pQuad->modelHandle = -1;
+	loadModel(modelLoadInfo, &pQuad->modelHandle);
+	pQuad->modelLoaded = pQuad->modelHandle >= 0;
+	pQuad->modelPool = modelLoadInfo.modelPool;
+	if (!pQuad->modelLoaded) {
+		failedQuadLoadCount += 1;
+		return;
+	}
+	logMsg(loggerRender, LOG_LEVEL_VERBOSE, "Loaded quad %u (model handle = %i).", command.quadSlot, pQuad->modelHandle);
+}
+
+// The quad's model is always one loaded for an earlier use of the quad's slot, since a slot is only allocated again after it is freed.
+static void applyUnloadQuad(const RenderCommand command) {
+	RenderObjectQuad *const pQuad = poolGet(&quadPool, command.quadSlot);
+	if (pQuad->modelLoaded) {
+		unloadModel(pQuad->modelPool, &pQuad->modelHandle);
+		pQuad->modelLoaded = false;
+		pQuad->modelPool = nullptr;
+	}
+}
+
+static void applyUpdate(const RenderCommand command) {
+	
+	// Updates queued for a quad that was since freed, or freed and allocated again, are discarded.
+	if (!poolIsUsed(&quadPool, command.quadSlot) || poolGetGeneration(&quadPool, command.quadSlot) != command.generation) {
+		return;
+	}
+	const RenderObjectQuad quad = *(const RenderObjectQuad *)poolGet(&quadPool, command.quadSlot);
+	if (!quad.modelLoaded) {
+		return;
+	}
+	
+	switch ((RenderCommandType)command.type) {
+		case RENDER_COMMAND_SET_POSITION:
+			modelSetTranslation(quad.modelPool, quad.modelHandle, command.vector);
+			break;
+		case RENDER_COMMAND_SET_ROTATION:
+			modelSetRotation(quad.modelPool, quad.modelHandle, command.vector);
+			break;
+		case RENDER_COMMAND_SET_ANIMATION:
+			modelSetAnimation(quad.modelPool, quad.modelHandle, command.animation, 0, true);
+			break;
+		case RENDER_COMMAND_SET_IMAGE:
+			modelSetImage(quad.modelPool, quad.modelHandle, command.imageIndex);
+			break;
+		case RENDER_COMMAND_SET_TILEMAP:
+			modelSetTilemap(quad.modelPool, quad.modelHandle, roomTilemapGetLayer(command.tilemap.slot, command.tilemap.layer));
+			break;
+		case RENDER_COMMAND_SET_VISIBLE:
+			modelSetVisible(quad.modelPool, quad.modelHandle, command.visible);
+			break;
+		default:
+			break;
+	}
+}
+
+void flushRenderCommands(void) {
+	if (renderCommandQueue.structureCommandCount == 0 && renderCommandQueue.updateCommandCount == 0) {
+		return;
+	}
+	
+	for (uint32_t i = 0; i < renderCommandQueue.structureCommandCount; ++i) {
+		const RenderCommand command = renderCommandQueue.pStructureCommands[i];
+		switch ((RenderCommandType)command.type) {
+			case RENDER_COMMAND_LOAD_QUAD:
+				applyLoadQuad(command);
+				break;
+			case RENDER_COMMAND_UNLOAD_QUAD:
+				applyUnloadQuad(command);
+				break;
+			default:
+				break;
 		}
-		const uint32_t imageIndex = pTextureState->startCell + pTextureState->currentFrame;
-		updateDrawInfo(renderObjects[handle].pQuads[quadIndex].modelPool, renderObjects[handle].pQuads[quadIndex].handle, imageIndex);
-		return true;
 	}
-	return false;
-}
\ No newline at end of file
+	
+	// Coalescing sorts the updates by quad slot, so they are applied in the order the quads are stored.
+	renderCommandQueueCoalesceUpdates(&renderCommandQueue);
+	for (uint32_t i = 0; i < renderCommandQueue.updateCommandCount; ++i) {
+		applyUpdate(renderCommandQueue.pUpdateCommands[i]);
+	}
+	
+	if (failedQuadLoadCount > 0) {
+		logMsg(loggerRender, LOG_LEVEL_WARNING, "Flushing render commands: %u quads are not drawn, since their model pools are full (%u models each).",
+				failedQuadLoadCount, modelPoolGetMaxModelCount(modelPoolMain));
+		failedQuadLoadCount = 0;
+	}
+	
+	renderCommandQueueClear(&renderCommandQueue);
+}
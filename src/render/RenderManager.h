@@ -5,6 +5,7 @@
 #include "math/Box.h"
 #include "math/Vector.h"
 #include "util/String.h"
+#include "util/StringTable.h"
 #include "vulkan/math/projection.h"
 
 // TYPE DEFINITIONS
@@ -36,7 +37,11 @@ typedef struct RenderObjectLoadInfo {
 	
 	// The texture that all quads controlled by the render object will use.
 	// Only used for regular (i.e. not debug) render objects.
-	String textureID;
+	StringID textureID;
+	
+	// Used instead of the texture ID if it is null, so that a texture found once can be used without finding it again.
+	// Zero is the handle of the missing texture.
+	int32_t textureHandle;
 	
 	// The load infos for each quad.
 	int32_t quadCount;
@@ -67,21 +72,46 @@ void terminateRenderManager(void);
 // Synchronizes the render manager with the game layer.
 void tickRenderManager(void);
 
-// Renders a single frame and polls GLFW for events.
-void renderFrame(const float timeDelta, const Vector4F cameraPosition, const ProjectionBounds projectionBounds, const bool animate);
+// The game runs on a simulation thread, and frames are drawn on the main thread; the two threads share no lock.
+// Only the simulation thread calls the other render manager functions, and publishes the render state at the end of each tick.
+// Changes to render objects are queued as render commands, and only reach the model pools when the commands are flushed.
+// The model pools are only read by the render thread through the published snapshots, and GPU work needed by a tick,
+// 	such as texture and tilemap uploads, is queued as render tasks that the render thread runs before drawing the tick's snapshot.
+
+// Applies every render command queued since the last flush in one batch. Call at the end of each tick.
+void flushRenderCommands(void);
+
+// Takes a snapshot of every model pool, along with the camera, and publishes it for the render thread with the render tasks queued so far.
+// Call at the end of each tick after flushing the render commands.
+void publishRenderState(const Vector4F cameraPosition, const ProjectionBounds projectionBounds, const bool animate);
+
+// Renders a single frame from the latest published render state, interpolated between its last two ticks.
+// Runs the render tasks published with the state first. Does nothing until the first render state is published.
+void renderFrame(void);
+
+// Discards every render command and render task queued since the last flush without applying or running them.
+// Call at the end of each tick instead of flushing when rendering headless, since there are no models to apply the commands to.
+void dropRenderCommands(void);
 
 // RENDER OBJECT INTERFACE
 
 // Loads a render object, AKA a collection of quads being rendered that can be managed through a single handle.
+// The handle can be used at once, but the quads are only drawn once the render commands are flushed.
+// There is no fixed limit on render objects or on quads per object; a handle kept after its object is unloaded never refers to a later object.
+// Each quad needs a model to be drawn, though, and the main and debug model pools hold a fixed 256 models each, the number of transforms the compute matrices pass reads.
+// Past that, quads are still loaded and can be changed as usual, but are never drawn; each flush that leaves quads without a model logs a warning with their count.
 int32_t loadRenderObject(const RenderObjectLoadInfo loadInfo);
 
 // Unloads a render object.
 void unloadRenderObject(int32_t *const pRenderObjectHandle);
 
-// Loads a render object displaying text.
+// Loads a text object, drawn in screen space with one instanced draw, and returns a handle to it.
 int32_t loadRenderText(const String text, const Vector3D position, const Vector4F color);
 
-// Writes formatted text to a render object.
+// Unloads a text object.
+void unloadRenderText(int32_t *const pHandle);
+
+// Writes formatted text to a text object.
 void writeRenderText(const int32_t handle, const char *const pFormat, ...);
 
 // Checks whether a render object handle is valid or not.
@@ -110,10 +140,14 @@ int renderObjectGetTextureHandle(const int renderHandle, const int quadIndex);
 
 void renderObjectSetQuadImage(const int32_t handle, const int32_t quadIndex, const int32_t imageIndex);
 
-// Animates each of the render object's quad's textures.
-void renderObjectAnimate(const int32_t handle);
+// Makes a quad draw one layer of the room tilemap in a slot, reading tiles directly from the room's tileset instead of from the quad's texture.
+void renderObjectSetQuadTilemap(const int32_t handle, const int32_t quadIndex, const uint32_t tilemapSlot, const uint32_t layer);
+
+// Hides or shows every quad of the render object, without unloading or reloading their models.
+// A shown quad appears at its current position, instead of moving there from where it was hidden.
+void renderObjectSetVisible(const int32_t handle, const bool visible);
 
-// Returns the current animation of the render object's texture state which is referenced by the render handle.
+// Returns the current animation of the render object's texture state which is referenced by the render handle, including changes not yet flushed.
 // Returns 0 if the render object could not be accessed.
 unsigned int renderObjectGetAnimation(const int renderHandle, const int quadIndex);
 
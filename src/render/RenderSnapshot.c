@@ -0,0 +1,49 @@
+#include "RenderSnapshot.h"
+
+#include <stdatomic.h>
+
+// Set in the shared index when the snapshot in it was published after the render thread last took one.
+#define SNAPSHOT_FRESH_BIT 0x4U
+#define SNAPSHOT_INDEX_MASK 0x3U
+
+static RenderSnapshot snapshots[3];
+
+// Each of the three buffers is owned by exactly one of these at a time.
+static uint32_t writeIndex = 0;
+static uint32_t readIndex = 1;
+static atomic_uint sharedIndex = 2;
+
+static atomic_bool snapshotPublished = false;
+
+RenderSnapshot *beginRenderSnapshot(void) {
+	return &snapshots[writeIndex];
+}
+
+void publishRenderSnapshot(void) {
+	
+	// Release the written buffer to the render thread, and take back whichever buffer it left.
+	const uint32_t previousIndex = atomic_exchange_explicit(&sharedIndex, writeIndex | SNAPSHOT_FRESH_BIT, memory_order_acq_rel);
+	writeIndex = previousIndex & SNAPSHOT_INDEX_MASK;
+	atomic_store_explicit(&snapshotPublished, true, memory_order_release);
+}
+
+const RenderSnapshot *acquireRenderSnapshot(void) {
+	if (!atomic_load_explicit(&snapshotPublished, memory_order_acquire)) {
+		return nullptr;
+	}
+	
+	// The last snapshot taken is kept if no newer one was published, e.g. when frames are drawn faster than ticks run.
+	if (atomic_load_explicit(&sharedIndex, memory_order_relaxed) & SNAPSHOT_FRESH_BIT) {
+		const uint32_t previousIndex = atomic_exchange_explicit(&sharedIndex, readIndex, memory_order_acq_rel);
+		readIndex = previousIndex & SNAPSHOT_INDEX_MASK;
+	}
+	return &snapshots[readIndex];
+}
+
+void deleteRenderSnapshots(void) {
+	for (uint32_t i = 0; i < sizeof(snapshots) / sizeof(snapshots[0]); ++i) {
+		deleteModelPoolSnapshot(&snapshots[i].mainModels);
+		deleteModelPoolSnapshot(&snapshots[i].debugModels);
+	}
+	atomic_store_explicit(&snapshotPublished, false, memory_order_release);
+}
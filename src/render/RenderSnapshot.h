@@ -0,0 +1,58 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "math/Vector.h"
+#include "vulkan/Draw.h"
+#include "vulkan/math/projection.h"
+
+// The state that the render thread needs to draw frames, published by the simulation thread at the end of each game tick.
+// Snapshots are triple-buffered: the simulation thread writes one buffer, the render thread reads another,
+// 	and the third holds the latest published snapshot, so neither thread ever waits for the other.
+// Each model transform holds both its state at the previous tick and at the snapshot's tick,
+// 	so the render thread interpolates between the last two ticks from a single snapshot.
+typedef struct RenderSnapshot {
+	
+	// The tick at the end of which the snapshot was taken.
+	uint64_t tick;
+	
+	// The monotonic clock reading when the snapshot was published.
+	uint64_t publishTimeNS;
+	
+	// How far game time already was past the tick when the snapshot was taken, in ticks, and how fast game time runs.
+	float alpha;
+	double timeScale;
+	
+	// The game time of the frame in which the tick ran, in milliseconds; drives the animation clock.
+	uint64_t frameTimeMS;
+	
+	// Whether sprite animations advance, i.e. whether the game is neither paused nor scrolling.
+	bool animate;
+	
+	Vector4F cameraPosition;
+	ProjectionBounds projectionBounds;
+	
+	ModelPoolSnapshot mainModels;
+	ModelPoolSnapshot debugModels;
+	
+	// The last batch of render tasks queued before the snapshot was taken, which must run before it is drawn.
+	uint64_t renderTaskBatch;
+	
+} RenderSnapshot;
+
+// Returns the buffer for the simulation thread to write the next snapshot into.
+// The buffer holds an older snapshot, so every field must be written before publishing it.
+RenderSnapshot *beginRenderSnapshot(void);
+
+// Makes the snapshot written since beginRenderSnapshot the latest one.
+void publishRenderSnapshot(void);
+
+// Returns the latest published snapshot for the render thread, which stays valid until the next call.
+// Returns null if no snapshot was published yet.
+const RenderSnapshot *acquireRenderSnapshot(void);
+
+// Frees the model arrays of every snapshot buffer; no thread may use a snapshot afterwards.
+void deleteRenderSnapshots(void);
+
+#endif	// RENDER_SNAPSHOT_H
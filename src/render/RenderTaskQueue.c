@@ -0,0 +1,117 @@
+#include "RenderTaskQueue.h"
+
+#include <pthread.h>
+#include "log/Logger.h"
+#include "util/Allocation.h"
+
+typedef struct RenderTask {
+
+	RenderTaskFunction function;
+	void *pData;
+
+	// The batch that the task belongs to.
+	uint64_t batchID;
+
+	struct RenderTask *pNext;
+
+} RenderTask;
+
+// Tasks are kept in a list in the order they were queued; only the hand-off of tasks between threads holds the lock.
+static pthread_mutex_t renderTaskMutex = PTHREAD_MUTEX_INITIALIZER;
+static RenderTask *pFirstTask = nullptr;
+static RenderTask *pLastTask = nullptr;
+
+// The batch that tasks queued now belong to.
+static uint64_t openBatchID = 1;
+
+bool pushRenderTask(const RenderTaskFunction function, void *const pData) {
+	if (!function) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error queueing render task: task function is null.");
+		if (pData) {
+			heapFree(pData);
+		}
+		return false;
+	}
+
+	RenderTask *const pTask = heapAlloc(1, sizeof(RenderTask));
+	if (!pTask) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Error queueing render task: failed to allocate task.");
+		if (pData) {
+			heapFree(pData);
+		}
+		return false;
+	}
+	pTask->function = function;
+	pTask->pData = pData;
+	pTask->pNext = nullptr;
+
+	pthread_mutex_lock(&renderTaskMutex);
+	pTask->batchID = openBatchID;
+	if (pLastTask) {
+		pLastTask->pNext = pTask;
+	} else {
+		pFirstTask = pTask;
+	}
+	pLastTask = pTask;
+	pthread_mutex_unlock(&renderTaskMutex);
+	return true;
+}
+
+uint64_t sealRenderTasks(void) {
+	pthread_mutex_lock(&renderTaskMutex);
+	const uint64_t batchID = openBatchID;
+	openBatchID += 1;
+	pthread_mutex_unlock(&renderTaskMutex);
+	return batchID;
+}
+
+void runRenderTasks(const uint64_t batchID) {
+
+	// The tasks are taken off the queue first, so that the simulation thread can keep queueing tasks while they run.
+	pthread_mutex_lock(&renderTaskMutex);
+	RenderTask *const pTasks = pFirstTask;
+	RenderTask *pLastTakenTask = nullptr;
+	for (RenderTask *pTask = pFirstTask; pTask && pTask->batchID <= batchID; pTask = pTask->pNext) {
+		pLastTakenTask = pTask;
+	}
+	if (pLastTakenTask) {
+		pFirstTask = pLastTakenTask->pNext;
+		if (!pFirstTask) {
+			pLastTask = nullptr;
+		}
+		pLastTakenTask->pNext = nullptr;
+	}
+	pthread_mutex_unlock(&renderTaskMutex);
+
+	if (!pLastTakenTask) {
+		return;
+	}
+
+	RenderTask *pTask = pTasks;
+	while (pTask) {
+		RenderTask *const pNextTask = pTask->pNext;
+		pTask->function(pTask->pData);
+		if (pTask->pData) {
+			heapFree(pTask->pData);
+		}
+		heapFree(pTask);
+		pTask = pNextTask;
+	}
+}
+
+void terminateRenderTasks(void) {
+	pthread_mutex_lock(&renderTaskMutex);
+	RenderTask *pTask = pFirstTask;
+	pFirstTask = nullptr;
+	pLastTask = nullptr;
+	pthread_mutex_unlock(&renderTaskMutex);
+
+	while (pTask) {
+		RenderTask *const pNextTask = pTask->pNext;
+		if (pTask->pData) {
+			heapFree(pTask->pData);
+		}
+		heapFree(pTask);
+		pTask = pNextTask;
+	}
+}
@@ -0,0 +1,28 @@
+#ifndef RENDER_TASK_QUEUE_H
+#define RENDER_TASK_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Work that must run on the render thread, such as writing GPU buffers, submitting GPU commands or recreating pipelines,
+// 	is queued by the simulation thread as render tasks instead of being done during the tick.
+// The tasks queued during a tick are sealed into a batch when the tick's render state is published,
+// 	and the render thread runs every batch up to the one of the snapshot it draws before drawing it.
+// Tasks run in the order they were queued, so e.g. a buffer is grown before the data written into it.
+
+typedef void (*RenderTaskFunction)(void *pData);
+
+// Queues a task; pData is passed to the function, and must be null or allocated with heapAlloc, since it is freed once the task has run.
+// Returns true if successful, false otherwise, in which case pData is freed without running the task.
+bool pushRenderTask(const RenderTaskFunction function, void *const pData);
+
+// Seals the tasks queued since the last call into a batch, and returns the batch's ID; batch IDs increase from one.
+uint64_t sealRenderTasks(void);
+
+// Runs the tasks of every batch up to and including the given batch, in the order they were queued.
+void runRenderTasks(const uint64_t batchID);
+
+// Frees the tasks still queued without running them.
+void terminateRenderTasks(void);
+
+#endif	// RENDER_TASK_QUEUE_H
@@ -1,8 +1,98 @@
 #include "render_config.h"
 
+#include <string.h>
+#include "log/Logger.h"
+
 const uint32_t num_frames_in_flight = NUM_FRAMES_IN_FLIGHT;
-const uint32_t numRenderObjectSlots = NUM_RENDER_OBJECT_SLOTS;
-const int maxNumRenderObjectQuads = MAX_NUM_RENDER_OBJECT_QUADS;
+const uint32_t maxNumFramesInFlight = MAX_NUM_FRAMES_IN_FLIGHT;
 const uint32_t numRoomTextureCacheSlots = NUM_ROOM_TEXTURE_CACHE_SLOTS;
 const uint32_t numRoomLayers = NUM_ROOM_LAYERS;
 const uint32_t tile_texel_length = TILE_TEXEL_LENGTH;
+
+static uint32_t numFramesInFlightSetting = NUM_FRAMES_IN_FLIGHT;
+
+static PresentMode presentModeSetting = PRESENT_MODE_MAILBOX;
+
+static RoomRenderMode roomRenderModeSetting = ROOM_RENDER_MODE_STITCHED;
+
+static bool renderHeadlessSetting = false;
+
+static const char *const presentModeNames[4] = {
+	[PRESENT_MODE_FIFO] = "fifo",
+	[PRESENT_MODE_FIFO_RELAXED] = "fifo_relaxed",
+	[PRESENT_MODE_MAILBOX] = "mailbox",
+	[PRESENT_MODE_IMMEDIATE] = "immediate"
+};
+
+bool setNumFramesInFlight(const uint32_t numFramesInFlight) {
+	if (numFramesInFlight < 1 || numFramesInFlight > MAX_NUM_FRAMES_IN_FLIGHT) {
+		logMsg(loggerRender, LOG_LEVEL_ERROR, "Setting number of frames in flight: %u is out of range (must be between 1 and %u).", numFramesInFlight, MAX_NUM_FRAMES_IN_FLIGHT);
+		return false;
+	}
+	numFramesInFlightSetting = numFramesInFlight;
+	return true;
+}
+
+uint32_t getNumFramesInFlight(void) {
+	return numFramesInFlightSetting;
+}
+
+void setPresentMode(const PresentMode presentMode) {
+	presentModeSetting = presentMode;
+}
+
+PresentMode getPresentMode(void) {
+	return presentModeSetting;
+}
+
+bool parsePresentMode(const char *const pName, PresentMode *const pPresentMode) {
+	if (!pName || !pPresentMode) {
+		return false;
+	}
+	
+	for (uint32_t i = 0; i < 4; ++i) {
+		if (strcmp(pName, presentModeNames[i]) == 0) {
+			*pPresentMode = (PresentMode)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+const char *presentModeName(const PresentMode presentMode) {
+	if ((uint32_t)presentMode >= 4) {
+		return "unknown";
+	}
+	return presentModeNames[presentMode];
+}
+
+void setRoomRenderMode(const RoomRenderMode roomRenderMode) {
+	roomRenderModeSetting = roomRenderMode;
+}
+
+RoomRenderMode getRoomRenderMode(void) {
+	return roomRenderModeSetting;
+}
+
+bool parseRoomRenderMode(const char *const pName, RoomRenderMode *const pRoomRenderMode) {
+	if (!pName || !pRoomRenderMode) {
+		return false;
+	}
+	
+	if (strcmp(pName, "stitched") == 0) {
+		*pRoomRenderMode = ROOM_RENDER_MODE_STITCHED;
+		return true;
+	} else if (strcmp(pName, "tilemap") == 0) {
+		*pRoomRenderMode = ROOM_RENDER_MODE_TILEMAP;
+		return true;
+	}
+	return false;
+}
+
+void setRenderHeadless(const bool headless) {
+	renderHeadlessSetting = headless;
+}
+
+bool isRenderHeadless(void) {
+	return renderHeadlessSetting;
+}
\ No newline at end of file
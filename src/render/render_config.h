@@ -5,9 +5,7 @@
 
 #define NUM_FRAMES_IN_FLIGHT 2
 
-#define NUM_RENDER_OBJECT_SLOTS 32
-
-#define MAX_NUM_RENDER_OBJECT_QUADS 8
+#define MAX_NUM_FRAMES_IN_FLIGHT 3
 
 #define NUM_ROOM_TEXTURE_CACHE_SLOTS 2
 
@@ -15,12 +13,11 @@
 
 #define TILE_TEXEL_LENGTH 16
 
+// The default number of frames in flight, used if no other number is requested.
 extern const uint32_t num_frames_in_flight;
 
-// The total number of render object slots available.
-extern const uint32_t numRenderObjectSlots;
-
-extern const int maxNumRenderObjectQuads;
+// The upper limit on the number of frames in flight; per-frame resource arrays are sized to this.
+extern const uint32_t maxNumFramesInFlight;
 
 // This config variable controls how many images for the room texture are loaded at a time.
 // Because multiple rooms are visible when scrolling between them, at least two images
@@ -37,6 +34,61 @@ extern const uint32_t numRoomLayers;
 // By default, this is 16, for a 16x16 texture.
 extern const uint32_t tile_texel_length;
 
+// Presentation modes that can be requested for the swapchain.
+// If the requested mode is not supported by the surface, FIFO is used instead, which is always supported.
+typedef enum PresentMode {
+	PRESENT_MODE_FIFO = 0,
+	PRESENT_MODE_FIFO_RELAXED = 1,
+	PRESENT_MODE_MAILBOX = 2,
+	PRESENT_MODE_IMMEDIATE = 3
+} PresentMode;
+
+// Ways in which rooms can be rendered.
+typedef enum RoomRenderMode {
+	
+	// Each room's tile layers are stitched into a room texture by a compute shader.
+	ROOM_RENDER_MODE_STITCHED = 0,
+	
+	// Each room's tile indices are uploaded to a buffer and its tiles are read directly from the tileset while drawing.
+	ROOM_RENDER_MODE_TILEMAP = 1
+	
+} RoomRenderMode;
+
+/* -- Runtime Render Settings -- */
+
+// These settings are read when the render manager is initialized;
+// changing them afterward has no effect until the renderer is reinitialized.
+
+// Sets the number of frames in flight, which must be between one and MAX_NUM_FRAMES_IN_FLIGHT, inclusive.
+// Returns true if the setting was accepted, false otherwise.
+bool setNumFramesInFlight(const uint32_t numFramesInFlight);
+
+uint32_t getNumFramesInFlight(void);
+
+void setPresentMode(const PresentMode presentMode);
+
+PresentMode getPresentMode(void);
+
+// Parses the name of a present mode (e.g. "fifo", "fifo_relaxed", "mailbox", "immediate").
+// Returns true if the name was recognized, false otherwise.
+bool parsePresentMode(const char *const pName, PresentMode *const pPresentMode);
+
+const char *presentModeName(const PresentMode presentMode);
+
+void setRoomRenderMode(const RoomRenderMode roomRenderMode);
+
+RoomRenderMode getRoomRenderMode(void);
+
+// Parses the name of a room render mode ("stitched" or "tilemap").
+// Returns true if the name was recognized, false otherwise.
+bool parseRoomRenderMode(const char *const pName, RoomRenderMode *const pRoomRenderMode);
+
+// Runs the render manager without a window or a GPU, e.g. to replay input as fast as possible.
+// Render objects and textures are only kept on the CPU, and render commands and render tasks are dropped instead of applied.
+void setRenderHeadless(const bool headless);
+
+bool isRenderHeadless(void);
+
 #define VERTEX_SHADER_NAME 				"VertexShader.spv"
 #define FRAGMENT_SHADER_NAME 			"FragmentShader.spv"
 #define COMPUTE_MATRICES_SHADER_NAME 	"compute_matrices.spv"
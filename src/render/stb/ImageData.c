@@ -1,20 +1,32 @@
 #include "ImageData.h"
 
+#include <limits.h>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 #include "log/Logger.h"
+#include "util/VirtualFileSystem.h"
 
 ImageData loadImageData(const char *const pPath, const size_t numChannels) {
 	
 	ImageData imageData = { };
 	
-	if  (numChannels == 0) {
-		imageData.pPixels = stbi_load(pPath, (int *)&imageData.width, (int *)&imageData.height, (int *)&imageData.numChannels, 0);
-	} else {
-		imageData.pPixels = stbi_load(pPath, (int *)&imageData.width, (int *)&imageData.height, nullptr, (int)numChannels);
-		imageData.numChannels = numChannels;
+	VFSFile file = { };
+	if (!vfsReadFile(pPath, &file) || file.size > INT_MAX) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Loading image: failed to read image file \"%s\".", pPath);
+		vfsCloseFile(&file);
+		return (ImageData){ };
 	}
 	
+	int width = 0;
+	int height = 0;
+	int fileChannels = 0;
+	imageData.pPixels = stbi_load_from_memory(file.pData, (int)file.size, &width, &height, &fileChannels, (int)numChannels);
+	vfsCloseFile(&file);
+	imageData.width = (size_t)width;
+	imageData.height = (size_t)height;
+	imageData.numChannels = numChannels == 0 ? (size_t)fileChannels : numChannels;
+	
 	if (!imageData.pPixels) {
 		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Loading image: failed to load image \"%s\".", pPath);
 		return (ImageData){ };
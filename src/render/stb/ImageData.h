@@ -28,7 +28,7 @@ typedef struct ImageData {
 
 } ImageData;
 
-// Loads an image at the given filepath.
+// Loads an image at the given path relative to the resource directory, through the virtual file system.
 ImageData loadImageData(const char *const pPath, const size_t numChannels);
 
 // Frees an image, destroying the data buffer.
@@ -6,7 +6,8 @@
 #include <string.h>
 #include "log/Logger.h"
 #include "util/Allocation.h"
-#include "util/FileIO.h"
+#include "util/BinaryReader.h"
+#include "util/VirtualFileSystem.h"
 
 void deleteTexturePack(TexturePack *const pTexturePack) {
 	assert(pTexturePack);
@@ -23,17 +24,21 @@ TexturePack readTexturePackFile(const char *pPath) {
 	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Loading texture pack from \"%s\"...", pPath);
 
 	TexturePack texturePack = { };
-	File file = openFile(pPath, FMODE_READ, FMODE_NO_UPDATE, FMODE_BINARY);
+	BinaryReader reader = { };
+	if (!vfsOpenBinaryReader(pPath, &reader)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading texture pack: failed to open file.");
+		return texturePack;
+	}
 
 	static const char fgt_label[4] = "FGT";
-	char label[4];
-	fread(label, 1, 4, file.pStream);
-	if (strcmp(label, fgt_label) != 0) {
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Invalid file format; found label \"%s\".", label);
+	char label[4] = { };
+	binaryReadBytes(&reader, sizeof(label), label);
+	if (memcmp(label, fgt_label, sizeof(label)) != 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Invalid file format; found label \"%.4s\".", label);
 		goto end_read;
 	}
 
-	fileReadData(file, 1, sizeof(texturePack.numTextures), &texturePack.numTextures);
+	texturePack.numTextures = binaryReadU32(&reader);
 
 	if (texturePack.numTextures == 0) {
 		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Number of textures specified as zero.");
@@ -50,25 +55,24 @@ TexturePack readTexturePackFile(const char *pPath) {
 		TextureCreateInfo *pTextureInfo = &texturePack.pTextureCreateInfos[i];
 
 		// Read texture ID.
-		pTextureInfo->textureID = fileReadString(file, 256);
+		pTextureInfo->textureID = binaryReadString(&reader, 256);
 		if (stringIsNull(pTextureInfo->textureID)) {
 			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading texture pack: failed to read texture ID.");
 			goto end_read;
 		}
 
 		// Read texture type.
-		uint32_t textureCreateInfoFlags = 0;
-		fileReadData(file, 1, sizeof(textureCreateInfoFlags), &textureCreateInfoFlags);
+		const uint32_t textureCreateInfoFlags = binaryReadU32(&reader);
 		if (textureCreateInfoFlags & 0x00000001U) pTextureInfo->isLoaded = true;
 		if (textureCreateInfoFlags & 0x00000002U) pTextureInfo->isTilemap = true;
 
 		// Read number of cells in texture atlas.
-		fileReadData(file, 1, sizeof(pTextureInfo->numCells.width), &pTextureInfo->numCells.width);
-		fileReadData(file, 1, sizeof(pTextureInfo->numCells.length), &pTextureInfo->numCells.length);
+		pTextureInfo->numCells.width = binaryReadU32(&reader);
+		pTextureInfo->numCells.length = binaryReadU32(&reader);
 
 		// Read texture cell extent.
-		fileReadData(file, 1, sizeof(pTextureInfo->cellExtent.width), &pTextureInfo->cellExtent.width);
-		fileReadData(file, 1, sizeof(pTextureInfo->cellExtent.length), &pTextureInfo->cellExtent.length);
+		pTextureInfo->cellExtent.width = binaryReadU32(&reader);
+		pTextureInfo->cellExtent.length = binaryReadU32(&reader);
 
 		// Check extents -- if any of them are zero, then there certainly was an error.
 		if (pTextureInfo->numCells.width == 0) {
@@ -85,7 +89,12 @@ TexturePack readTexturePackFile(const char *pPath) {
 		}
 
 		// Read animation create infos.
-		fileReadData(file, 1, sizeof(pTextureInfo->numAnimations), &pTextureInfo->numAnimations);
+		pTextureInfo->numAnimations = binaryReadU32(&reader);
+		if (reader.failed) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading texture pack: failed to read properties of texture %u.", i);
+			goto end_read;
+		}
+		
 		if (pTextureInfo->numAnimations > 0) {
 
 			pTextureInfo->animations = heapAlloc(pTextureInfo->numAnimations, sizeof(TextureAnimation));
@@ -95,9 +104,13 @@ TexturePack readTexturePackFile(const char *pPath) {
 			}
 
 			for (uint32_t j = 0; j < pTextureInfo->numAnimations; ++j) {
-				fileReadData(file, 1, sizeof(pTextureInfo->animations[j].startCell), &pTextureInfo->animations[j].startCell);
-				fileReadData(file, 1, sizeof(pTextureInfo->animations[j].numFrames), &pTextureInfo->animations[j].numFrames);
-				fileReadData(file, 1, sizeof(pTextureInfo->animations[j].framesPerSecond), &pTextureInfo->animations[j].framesPerSecond);
+				pTextureInfo->animations[j].startCell = binaryReadU32(&reader);
+				pTextureInfo->animations[j].numFrames = binaryReadU32(&reader);
+				pTextureInfo->animations[j].framesPerSecond = binaryReadU32(&reader);
+			}
+			if (reader.failed) {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reading texture pack: failed to read animations of texture %u.", i);
+				goto end_read;
 			}
 		} else {
 			// If there are no specified animations, then set the number of animations to one 
@@ -117,6 +130,6 @@ TexturePack readTexturePackFile(const char *pPath) {
 	}
 
 end_read:
-	closeFile(&file);
+	closeBinaryReader(&reader);
 	return texturePack;
 }
@@ -103,6 +103,12 @@ void createBuffer(const BufferCreateInfo bufferCreateInfo, Buffer *const pOutBuf
 		case BUFFER_TYPE_DRAW_DATA:
 			offsetAlignment = bufferCreateInfo.physicalDevice.properties.limits.minUniformBufferOffsetAlignment;
 			break;
+		case BUFFER_TYPE_STREAMING:
+			offsetAlignment = bufferCreateInfo.physicalDevice.properties.limits.minStorageBufferOffsetAlignment;
+			break;
+		case BUFFER_TYPE_INDIRECT:
+			offsetAlignment = bufferCreateInfo.physicalDevice.properties.limits.minStorageBufferOffsetAlignment;
+			break;
 	}
 
 	// Generate subranges
@@ -129,6 +135,12 @@ void createBuffer(const BufferCreateInfo bufferCreateInfo, Buffer *const pOutBuf
 		case BUFFER_TYPE_DRAW_DATA:
 			vkBufferUsageFlags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
 			break;
+		case BUFFER_TYPE_STREAMING:
+			vkBufferUsageFlags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+			break;
+		case BUFFER_TYPE_INDIRECT:
+			vkBufferUsageFlags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+			break;
 	}
 
 	VkBufferCreateInfo vkBufferCreateInfo = {
@@ -181,6 +193,13 @@ void createBuffer(const BufferCreateInfo bufferCreateInfo, Buffer *const pOutBuf
 			memoryTypeIndex = bufferCreateInfo.memoryTypeIndexSet.uniform_data;
 			isHostVisible = true;
 			break;
+		case BUFFER_TYPE_STREAMING:
+			memoryTypeIndex = bufferCreateInfo.memoryTypeIndexSet.uniform_data;
+			isHostVisible = true;
+			break;
+		case BUFFER_TYPE_INDIRECT:
+			memoryTypeIndex = bufferCreateInfo.memoryTypeIndexSet.graphics_resources;
+			break;
 	}
 
 	const VkMemoryAllocateInfo memory_allocate_info = {
@@ -318,7 +337,7 @@ void bufferHostTransfer(const BufferSubrange subrange, const VkDeviceSize dataOf
 		return;
 	}
 	
-	if (dataOffset + dataSize >= subrange.size) {
+	if (dataOffset + dataSize > subrange.size) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error copying data to buffer: data copy range cannot fit into buffer subrange.");
 		return;
 	}
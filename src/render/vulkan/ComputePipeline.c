@@ -12,6 +12,10 @@ Pipeline createComputePipeline(const ComputePipelineCreateInfo createInfo) {
 	Pipeline computePipeline = { .type = PIPELINE_TYPE_COMPUTE };
 	
 	ShaderModule shaderModule = createShaderModule(createInfo.vkDevice, SHADER_STAGE_COMPUTE, createInfo.shaderFilename.pBuffer);
+	if (shaderModule.vkShaderModule == VK_NULL_HANDLE) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Compute pipeline creation failed: could not create shader module.");
+		return computePipeline;
+	}
 	computePipeline.vkPipelineLayout = createPipelineLayout(createInfo.vkDevice, 1, &globalDescriptorSetLayout, createInfo.pushConstantRangeCount, createInfo.pPushConstantRanges);
 
 	const VkComputePipelineCreateInfo vkComputePipelineCreateInfo = {
@@ -28,6 +32,11 @@ Pipeline createComputePipeline(const ComputePipelineCreateInfo createInfo) {
 	const VkResult result = vkCreateComputePipelines(createInfo.vkDevice, VK_NULL_HANDLE, 1, &vkComputePipelineCreateInfo, nullptr, &computePipeline.vkPipeline);
 	if (result != VK_SUCCESS) {
 		logMsg(loggerVulkan, LOG_LEVEL_FATAL, "Compute pipeline creation failed (error code: %i).", result);
+		vkDestroyPipelineLayout(createInfo.vkDevice, computePipeline.vkPipelineLayout, nullptr);
+		computePipeline.vkPipelineLayout = VK_NULL_HANDLE;
+		computePipeline.vkPipeline = VK_NULL_HANDLE;
+		destroyShaderModule(&shaderModule);
+		return computePipeline;
 	}
 	computePipeline.vkDevice = createInfo.vkDevice;
 
@@ -1,5 +1,6 @@
 #include "Descriptor.h"
 
+#include <pthread.h>
 #include <stdlib.h>
 #include "log/Logger.h"
 
@@ -21,7 +22,7 @@ static const uint32_t maxDescriptorCounts[DESCRIPTOR_TYPE_COUNT] = {
 	4096,	// Sampled image descriptor count
 	256,	// Storage image descriptor count
 	16,		// Uniform buffer descriptor count
-	16		// Storage buffer descriptor count
+	32		// Storage buffer descriptor count
 };
 
 static uint32_t descriptorCounts[DESCRIPTOR_TYPE_COUNT] = {
@@ -46,6 +47,9 @@ VkDescriptorSetLayout globalDescriptorSetLayout = VK_NULL_HANDLE;
 VkDescriptorPool globalDescriptorPool = VK_NULL_HANDLE;
 VkDescriptorSet globalDescriptorSet = VK_NULL_HANDLE;
 
+// Descriptors are uploaded by both the simulation and the render thread, and writes to the descriptor set must not overlap.
+static pthread_mutex_t descriptorMutex = PTHREAD_MUTEX_INITIALIZER;
+
 void initDescriptorManager(const VkDevice vkDevice) {
 	
 	// Create global descriptor set layout.
@@ -133,8 +137,10 @@ uint32_t uploadSampler(const VkDevice vkDevice, const Sampler sampler) {
 	
 	static const uint32_t descriptorBinding = DESCRIPTOR_BINDING_SAMPLER;
 	
+	pthread_mutex_lock(&descriptorMutex);
 	const uint32_t handle = descriptorCounts[descriptorBinding];
 	if (handle >= maxDescriptorCounts[descriptorBinding]) {
+		pthread_mutex_unlock(&descriptorMutex);
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error uploading sampler descriptor: no sampler descriptors available.");
 		return descriptorHandleInvalid;
 	}
@@ -157,6 +163,7 @@ uint32_t uploadSampler(const VkDevice vkDevice, const Sampler sampler) {
 		.pTexelBufferView = nullptr
 	};
 	vkUpdateDescriptorSets(vkDevice, 1, &writeDescriptorSet, 0, nullptr);
+	pthread_mutex_unlock(&descriptorMutex);
 	
 	return handle;
 }
@@ -165,8 +172,10 @@ uint32_t uploadSampledImage(const VkDevice vkDevice, const Image image) {
 	
 	static const uint32_t descriptorBinding = DESCRIPTOR_BINDING_SAMPLED_IMAGE;
 	
+	pthread_mutex_lock(&descriptorMutex);
 	const uint32_t handle = descriptorCounts[descriptorBinding];
 	if (handle >= maxDescriptorCounts[descriptorBinding]) {
+		pthread_mutex_unlock(&descriptorMutex);
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error uploading sampled image descriptor: no sampled image descriptors available.");
 		return descriptorHandleInvalid;
 	}
@@ -189,6 +198,7 @@ uint32_t uploadSampledImage(const VkDevice vkDevice, const Image image) {
 		.pTexelBufferView = nullptr
 	};
 	vkUpdateDescriptorSets(vkDevice, 1, &writeDescriptorSet, 0, nullptr);
+	pthread_mutex_unlock(&descriptorMutex);
 	
 	return handle;
 }
@@ -197,8 +207,10 @@ uint32_t uploadStorageImage(const VkDevice vkDevice, const Image image) {
 	
 	static const uint32_t descriptorBinding = DESCRIPTOR_BINDING_STORAGE_IMAGE;
 	
+	pthread_mutex_lock(&descriptorMutex);
 	const uint32_t handle = descriptorCounts[descriptorBinding];
 	if (handle >= maxDescriptorCounts[descriptorBinding]) {
+		pthread_mutex_unlock(&descriptorMutex);
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error uploading storage image descriptor: no storage image descriptors available.");
 		return descriptorHandleInvalid;
 	}
@@ -221,6 +233,7 @@ uint32_t uploadStorageImage(const VkDevice vkDevice, const Image image) {
 		.pTexelBufferView = nullptr
 	};
 	vkUpdateDescriptorSets(vkDevice, 1, &writeDescriptorSet, 0, nullptr);
+	pthread_mutex_unlock(&descriptorMutex);
 	
 	return handle;
 }
@@ -229,8 +242,10 @@ uint32_t uploadUniformBuffer(const VkDevice vkDevice, const BufferPartition buff
 	
 	static const uint32_t descriptorBinding = DESCRIPTOR_BINDING_UNIFORM_BUFFER;
 	
+	pthread_mutex_lock(&descriptorMutex);
 	const uint32_t handle = descriptorCounts[descriptorBinding];
 	if (handle >= maxDescriptorCounts[descriptorBinding]) {
+		pthread_mutex_unlock(&descriptorMutex);
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error uploading uniform buffer descriptor: no uniform buffer descriptors available.");
 		return descriptorHandleInvalid;
 	}
@@ -249,6 +264,7 @@ uint32_t uploadUniformBuffer(const VkDevice vkDevice, const BufferPartition buff
 		.pTexelBufferView = nullptr
 	};
 	vkUpdateDescriptorSets(vkDevice, 1, &writeDescriptorSet, 0, nullptr);
+	pthread_mutex_unlock(&descriptorMutex);
 	
 	return handle;
 }
@@ -257,8 +273,10 @@ uint32_t uploadUniformBuffer2(const VkDevice vkDevice, const BufferSubrange buff
 	
 	static const uint32_t descriptorBinding = DESCRIPTOR_BINDING_UNIFORM_BUFFER;
 	
+	pthread_mutex_lock(&descriptorMutex);
 	const uint32_t handle = descriptorCounts[descriptorBinding];
 	if (handle >= maxDescriptorCounts[descriptorBinding]) {
+		pthread_mutex_unlock(&descriptorMutex);
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error uploading uniform buffer descriptor: no uniform buffer descriptors available.");
 		return descriptorHandleInvalid;
 	}
@@ -277,6 +295,7 @@ uint32_t uploadUniformBuffer2(const VkDevice vkDevice, const BufferSubrange buff
 		.pTexelBufferView = nullptr
 	};
 	vkUpdateDescriptorSets(vkDevice, 1, &writeDescriptorSet, 0, nullptr);
+	pthread_mutex_unlock(&descriptorMutex);
 	
 	return handle;
 }
@@ -285,8 +304,10 @@ uint32_t uploadStorageBuffer(const VkDevice vkDevice, const BufferPartition buff
 	
 	static const uint32_t descriptorBinding = DESCRIPTOR_BINDING_STORAGE_BUFFER;
 	
+	pthread_mutex_lock(&descriptorMutex);
 	const uint32_t handle = descriptorCounts[descriptorBinding];
 	if (handle >= maxDescriptorCounts[descriptorBinding]) {
+		pthread_mutex_unlock(&descriptorMutex);
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error uploading storage buffer descriptor: no storage buffer descriptors available.");
 		return descriptorHandleInvalid;
 	}
@@ -305,6 +326,7 @@ uint32_t uploadStorageBuffer(const VkDevice vkDevice, const BufferPartition buff
 		.pTexelBufferView = nullptr
 	};
 	vkUpdateDescriptorSets(vkDevice, 1, &writeDescriptorSet, 0, nullptr);
+	pthread_mutex_unlock(&descriptorMutex);
 	
 	return handle;
 }
@@ -313,8 +335,10 @@ uint32_t uploadStorageBuffer2(const VkDevice vkDevice, const BufferSubrange buff
 	
 	static const uint32_t descriptorBinding = DESCRIPTOR_BINDING_STORAGE_BUFFER;
 	
+	pthread_mutex_lock(&descriptorMutex);
 	const uint32_t handle = descriptorCounts[descriptorBinding];
 	if (handle >= maxDescriptorCounts[descriptorBinding]) {
+		pthread_mutex_unlock(&descriptorMutex);
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error uploading storage buffer descriptor: no storage buffer descriptors available.");
 		return descriptorHandleInvalid;
 	}
@@ -333,6 +357,33 @@ uint32_t uploadStorageBuffer2(const VkDevice vkDevice, const BufferSubrange buff
 		.pTexelBufferView = nullptr
 	};
 	vkUpdateDescriptorSets(vkDevice, 1, &writeDescriptorSet, 0, nullptr);
+	pthread_mutex_unlock(&descriptorMutex);
 	
 	return handle;
+}
+
+void updateStorageBuffer2(const VkDevice vkDevice, const uint32_t handle, const BufferSubrange bufferSubrange) {
+	
+	static const uint32_t descriptorBinding = DESCRIPTOR_BINDING_STORAGE_BUFFER;
+	
+	pthread_mutex_lock(&descriptorMutex);
+	if (handle >= descriptorCounts[descriptorBinding]) {
+		pthread_mutex_unlock(&descriptorMutex);
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error updating storage buffer descriptor: handle %u was not uploaded.", handle);
+		return;
+	}
+	
+	const VkDescriptorBufferInfo descriptorBufferInfo = makeDescriptorBufferInfo2(bufferSubrange);
+	const VkWriteDescriptorSet writeDescriptorSet = {
+		.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+		.dstSet = globalDescriptorSet,
+		.dstBinding = descriptorBinding,
+		.dstArrayElement = handle,
+		.descriptorType = descriptorTypes[descriptorBinding],
+		.descriptorCount = 1,
+		.pBufferInfo = &descriptorBufferInfo,
+		.pImageInfo = nullptr,
+		.pTexelBufferView = nullptr
+	};
+	vkUpdateDescriptorSets(vkDevice, 1, &writeDescriptorSet, 0, nullptr);	pthread_mutex_unlock(&descriptorMutex);
 }
\ No newline at end of file
@@ -34,6 +34,10 @@ uint32_t uploadUniformBuffer2(const VkDevice vkDevice, const BufferSubrange buff
 uint32_t uploadStorageBuffer(const VkDevice vkDevice, const BufferPartition bufferPartition, const uint32_t partitionIndex);
 uint32_t uploadStorageBuffer2(const VkDevice vkDevice, const BufferSubrange bufferSubrange);
 
+// Points an uploaded storage buffer descriptor at another buffer subrange, keeping its handle.
+// No frame in flight may still use the descriptor.
+void updateStorageBuffer2(const VkDevice vkDevice, const uint32_t handle, const BufferSubrange bufferSubrange);
+
 // The descriptor set layout for the bindless descriptor set.
 extern VkDescriptorSetLayout globalDescriptorSetLayout;
 
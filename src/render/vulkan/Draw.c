@@ -1,33 +1,18 @@
 #include "Draw.h"
 
+#include <assert.h>
+#include <stdatomic.h>
+#include <string.h>
 #include "log/Logger.h"
+#include "render/RenderTaskQueue.h"
 #include "util/Allocation.h"
 #include "Descriptor.h"
 #include "frame.h"
+#include "RoomTilemap.h"
 #include "texture_manager.h"
 #include "TextureState.h"
 #include "VulkanManager.h"
 
-typedef struct DrawInfo {
-	
-	/* Indirect draw command parameters */
-	
-	uint32_t indexCount;
-	uint32_t instanceCount;	// Unused
-	uint32_t firstIndex;
-	int32_t vertexOffset;
-	uint32_t firstInstance;	// Unused
-	
-	/* Additional draw parameters */
-	
-	// Indexes into a model pool's array of models.
-	int32_t modelIndex;
-	
-	// Indexes into a texture array.
-	uint32_t imageIndex;
-	
-} DrawInfo;
-
 // Holds data for a batch of models to be drawn with a single indirect draw call.
 // Controls how the parameters for the indirect draw call are generated.
 struct ModelPool_T {
@@ -36,8 +21,17 @@ struct ModelPool_T {
 	// As a result, the positions of the first vertex and first index for a particular model pool in the vertex/index buffer(s) is constant
 	// 	and the position of a particular mesh can be calculated by multiplying the mesh size by its relative position in the mesh array.
 	
-	// Some part of some buffer to which to upload draw command parameters.
-	BufferSubrange drawInfoBuffer;
+	// The number of frames in flight; each frame draws from its own part of each buffer, which only the render thread writes.
+	uint32_t frameCount;
+	
+	// Some part of some buffer to which to upload draw command parameters, for each frame.
+	BufferSubrange drawInfoBuffers[MAX_NUM_FRAMES_IN_FLIGHT];
+	
+	// Some part of some buffer to which to upload model animation parameters, indexed by model index, for each frame.
+	BufferSubrange animationBuffers[MAX_NUM_FRAMES_IN_FLIGHT];
+	
+	// Some part of some buffer to which to upload the bounds of each model's mesh, indexed by model index, for each frame.
+	BufferSubrange boundsBuffers[MAX_NUM_FRAMES_IN_FLIGHT];
 	
 	// The graphics pipeline with which the models will be drawn.
 	GraphicsPipeline graphicsPipeline;
@@ -57,9 +51,11 @@ struct ModelPool_T {
 	// The descriptor index of the first model in this pool. Offsets all descriptor/model indices.
 	uint32_t firstDescriptorIndex;
 	
-	uint32_t drawInfoBufferHandle;
+	uint32_t drawInfoBufferHandles[MAX_NUM_FRAMES_IN_FLIGHT];
 	
-	uint32_t matrixBufferHandle;
+	uint32_t animationBufferHandles[MAX_NUM_FRAMES_IN_FLIGHT];
+	
+	uint32_t boundsBufferHandles[MAX_NUM_FRAMES_IN_FLIGHT];
 	
 	// The maximum number of models.
 	uint32_t maxModelCount;
@@ -80,6 +76,18 @@ struct ModelPool_T {
 	
 	TextureState *pTextureStates;
 	
+	ModelAnimation *pAnimations;
+	
+	// The quadrangle-vertices and color of each model, from which the render thread builds its mesh.
+	BoxF *pBounds;
+	Vector4F *pColors;
+	
+	// Increased each time a model is loaded into the slot.
+	uint32_t *pMeshVersions;
+	
+	// The mesh version of each model in each frame's vertex buffer, only used on the render thread.
+	uint32_t *pFrameMeshVersions;
+	
 	/* DRAW INFO */
 	
 	// The number of draw infos, but not the space allocated.
@@ -89,15 +97,59 @@ struct ModelPool_T {
 	// All of the draw parameters for each of the models.
 	// DrawInfoIndex indexes into this array.
 	DrawInfo *pDrawInfos;
+	
+	// The draw infos of hidden models, by model index.
+	// A hidden model keeps its slot and mesh, but its draw info is left out of the array of draw infos until it is shown again.
+	DrawInfo *pHiddenDrawInfos;
 };
 
 const uint32_t drawCountSize = sizeof(uint32_t);
 
+// The draw info index of a hidden model.
+#define DRAW_INFO_INDEX_HIDDEN UINT32_MAX
+
 const uint32_t drawCommandStride = sizeof(DrawInfo);
 
+const uint32_t modelAnimationStride = sizeof(ModelAnimation);
+
+const uint32_t modelBoundsStride = sizeof(BoxF);
+
+// The animation clock shared by all model pools, in milliseconds.
+// Set by the render thread and read by the simulation thread when it starts animations.
+static atomic_uint animationTime = 0;
+
+// Frees the arrays of a model pool that were allocated, and the pool itself.
+static void freeModelPool(ModelPool modelPool) {
+	void *const pArrays[] = {
+		modelPool->pSlotFlags,
+		modelPool->pDrawInfoIndices,
+		modelPool->pCameraFlags,
+		modelPool->pModelTransforms,
+		modelPool->pTextureStates,
+		modelPool->pAnimations,
+		modelPool->pBounds,
+		modelPool->pColors,
+		modelPool->pMeshVersions,
+		modelPool->pFrameMeshVersions,
+		modelPool->pDrawInfos,
+		modelPool->pHiddenDrawInfos
+	};
+	for (size_t i = 0; i < sizeof(pArrays) / sizeof(pArrays[0]); ++i) {
+		if (pArrays[i]) {
+			heapFree(pArrays[i]);
+		}
+	}
+	heapFree(modelPool);
+}
+
 void createModelPool(const ModelPoolCreateInfo createInfo, ModelPool *const pOutModelPool) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Creating model pool...");
 	
+	if (createInfo.frameCount == 0 || createInfo.frameCount > MAX_NUM_FRAMES_IN_FLIGHT) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: frame count (%u) must be between 1 and %u.", createInfo.frameCount, MAX_NUM_FRAMES_IN_FLIGHT);
+		return;
+	}
+	
 	ModelPool modelPool = heapAlloc(1, sizeof(struct ModelPool_T));
 	if (!modelPool) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: failed to allocate model pool object.");
@@ -111,66 +163,44 @@ void createModelPool(const ModelPoolCreateInfo createInfo, ModelPool *const pOut
 	modelPool->indexCount = createInfo.indexCount;
 	modelPool->firstDescriptorIndex = createInfo.firstDescriptorIndex;
 	modelPool->maxModelCount = createInfo.maxModelCount;
+	modelPool->frameCount = createInfo.frameCount;
 	modelPool->drawInfoCount = 0;
 	
-	bufferBorrowSubrange(createInfo.buffer, createInfo.bufferSubrangeIndex, &modelPool->drawInfoBuffer);
-	modelPool->drawInfoBufferHandle = uploadUniformBuffer2(device, modelPool->drawInfoBuffer);
-	
 	modelPool->pSlotFlags = heapAlloc(createInfo.maxModelCount, sizeof(bool));
-	if (!modelPool->pSlotFlags) {
-		heapFree(modelPool);
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: failed to allocate slot flags.");
-		return;
-	}
-	
 	modelPool->pDrawInfoIndices = heapAlloc(createInfo.maxModelCount, sizeof(uint32_t));
-	if (!modelPool->pDrawInfoIndices) {
-		heapFree(modelPool->pSlotFlags);
-		heapFree(modelPool);
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: failed to allocate draw info indices.");
-		return;
-	}
-	
 	modelPool->pCameraFlags = heapAlloc(createInfo.maxModelCount, sizeof(uint32_t));
-	if (!modelPool->pCameraFlags) {
-		heapFree(modelPool->pSlotFlags);
-		heapFree(modelPool->pDrawInfoIndices);
-		heapFree(modelPool);
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: failed to allocate camera flags.");
-		return;
-	}
-	
 	modelPool->pModelTransforms = heapAlloc(createInfo.maxModelCount, sizeof(ModelTransform));
-	if (!modelPool->pModelTransforms) {
-		heapFree(modelPool->pSlotFlags);
-		heapFree(modelPool->pDrawInfoIndices);
-		heapFree(modelPool->pCameraFlags);
-		heapFree(modelPool);
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: failed to allocate model transforms.");
-		return;
-	}
-	
 	modelPool->pTextureStates = heapAlloc(createInfo.maxModelCount, sizeof(TextureState));
-	if (!modelPool->pTextureStates) {
-		heapFree(modelPool->pSlotFlags);
-		heapFree(modelPool->pDrawInfoIndices);
-		heapFree(modelPool->pCameraFlags);
-		heapFree(modelPool->pModelTransforms);
-		heapFree(modelPool);
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: failed to allocate texture states.");
+	modelPool->pAnimations = heapAlloc(createInfo.maxModelCount, sizeof(ModelAnimation));
+	modelPool->pBounds = heapAlloc(createInfo.maxModelCount, sizeof(BoxF));
+	modelPool->pColors = heapAlloc(createInfo.maxModelCount, sizeof(Vector4F));
+	modelPool->pMeshVersions = heapAlloc(createInfo.maxModelCount, sizeof(uint32_t));
+	modelPool->pFrameMeshVersions = heapAlloc((size_t)createInfo.frameCount * createInfo.maxModelCount, sizeof(uint32_t));
+	modelPool->pDrawInfos = heapAlloc(createInfo.maxModelCount, sizeof(DrawInfo));
+	modelPool->pHiddenDrawInfos = heapAlloc(createInfo.maxModelCount, sizeof(DrawInfo));
+	if (!modelPool->pSlotFlags || !modelPool->pDrawInfoIndices || !modelPool->pCameraFlags || !modelPool->pModelTransforms
+			|| !modelPool->pTextureStates || !modelPool->pAnimations || !modelPool->pBounds || !modelPool->pColors
+			|| !modelPool->pMeshVersions || !modelPool->pFrameMeshVersions || !modelPool->pDrawInfos || !modelPool->pHiddenDrawInfos) {
+		freeModelPool(modelPool);
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: failed to allocate model arrays.");
 		return;
 	}
 	
-	modelPool->pDrawInfos = heapAlloc(createInfo.maxModelCount, sizeof(DrawInfo));
-	if (!modelPool->pDrawInfos) {
-		heapFree(modelPool->pSlotFlags);
-		heapFree(modelPool->pDrawInfoIndices);
-		heapFree(modelPool->pCameraFlags);
-		heapFree(modelPool->pModelTransforms);
-		heapFree(modelPool->pTextureStates);
-		heapFree(modelPool);
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating model pool: failed to allocate draw infos.");
-		return;
+	for (uint32_t i = 0; i < createInfo.frameCount; ++i) {
+		const int32_t subrangeIndex = createInfo.bufferSubrangeIndex + (int32_t)i;
+		
+		bufferBorrowSubrange(createInfo.buffer, subrangeIndex, &modelPool->drawInfoBuffers[i]);
+		modelPool->drawInfoBufferHandles[i] = uploadUniformBuffer2(device, modelPool->drawInfoBuffers[i]);
+		
+		bufferBorrowSubrange(createInfo.animationBuffer, subrangeIndex, &modelPool->animationBuffers[i]);
+		modelPool->animationBufferHandles[i] = uploadStorageBuffer2(device, modelPool->animationBuffers[i]);
+		
+		bufferBorrowSubrange(createInfo.boundsBuffer, subrangeIndex, &modelPool->boundsBuffers[i]);
+		modelPool->boundsBufferHandles[i] = uploadStorageBuffer2(device, modelPool->boundsBuffers[i]);
+		
+		// No model is drawn until the frame's first snapshot is uploaded.
+		const uint32_t drawInfoCount = 0;
+		bufferHostTransfer(modelPool->drawInfoBuffers[i], 0, drawCountSize, &drawInfoCount);
 	}
 	
 	*pOutModelPool = modelPool;
@@ -179,16 +209,13 @@ void createModelPool(const ModelPoolCreateInfo createInfo, ModelPool *const pOut
 
 void deleteModelPool(ModelPool *const pModelPool) {
 	
-	bufferReturnSubrange(&(*pModelPool)->drawInfoBuffer);
-	
-	(*pModelPool)->pSlotFlags = heapFree((*pModelPool)->pSlotFlags);
-	(*pModelPool)->pDrawInfoIndices = heapFree((*pModelPool)->pDrawInfoIndices);
-	(*pModelPool)->pCameraFlags = heapFree((*pModelPool)->pCameraFlags);
-	(*pModelPool)->pModelTransforms = heapFree((*pModelPool)->pModelTransforms);
-	(*pModelPool)->pTextureStates = heapFree((*pModelPool)->pTextureStates);
-	(*pModelPool)->pDrawInfos = heapFree((*pModelPool)->pDrawInfos);
-	(*pModelPool) = heapFree((*pModelPool));
+	for (uint32_t i = 0; i < (*pModelPool)->frameCount; ++i) {
+		bufferReturnSubrange(&(*pModelPool)->drawInfoBuffers[i]);
+		bufferReturnSubrange(&(*pModelPool)->animationBuffers[i]);
+		bufferReturnSubrange(&(*pModelPool)->boundsBuffers[i]);
+	}
 	
+	freeModelPool(*pModelPool);
 	*pModelPool = nullptr;
 }
 
@@ -196,21 +223,150 @@ uint32_t modelPoolGetMaxModelCount(const ModelPool modelPool) {
 	return modelPool->maxModelCount;
 }
 
-VkDescriptorBufferInfo modelPoolGetBufferDescriptorInfo(const ModelPool modelPool) {
-	return makeDescriptorBufferInfo2(modelPool->drawInfoBuffer);
-}
-
 void modelPoolGetDrawCommandArguments(const ModelPool modelPool, uint32_t *const pMaxDrawCount, uint32_t *const pStride) {
 	*pMaxDrawCount = modelPool->maxModelCount;
 	*pStride = sizeof(DrawInfo);
 }
 
-VkDeviceSize modelPoolGetDrawInfoBufferOffset(const ModelPool modelPool) {
-	return modelPool->drawInfoBuffer.offset;
+uint32_t modelPoolGetDrawInfoBufferHandle(const ModelPool modelPool, const uint32_t frameIndex) {
+	return frameIndex < modelPool->frameCount ? modelPool->drawInfoBufferHandles[frameIndex] : DESCRIPTOR_HANDLE_INVALID;
 }
 
-uint32_t modelPoolGetDrawInfoBufferHandle(const ModelPool modelPool) {
-	return modelPool->drawInfoBufferHandle;
+uint32_t modelPoolGetAnimationBufferHandle(const ModelPool modelPool, const uint32_t frameIndex) {
+	return frameIndex < modelPool->frameCount ? modelPool->animationBufferHandles[frameIndex] : DESCRIPTOR_HANDLE_INVALID;
+}
+
+uint32_t modelPoolGetBoundsBufferHandle(const ModelPool modelPool, const uint32_t frameIndex) {
+	return frameIndex < modelPool->frameCount ? modelPool->boundsBufferHandles[frameIndex] : DESCRIPTOR_HANDLE_INVALID;
+}
+
+void setAnimationTime(const uint32_t timeMS) {
+	animationTime = timeMS;
+}
+
+uint32_t getAnimationTime(void) {
+	return animationTime;
+}
+
+// Sets the animation parameters of a model, starting its animation cycle from the given frame.
+static void setModelAnimation(ModelPool modelPool, const uint32_t modelIndex, const TextureState textureState, const uint32_t firstFrame, const bool loop) {
+	ModelAnimation modelAnimation = { };
+	if (textureState.numFrames > 1 && textureState.currentFPS > 0) {
+		const float frameDuration = 1000.0F / (float)textureState.currentFPS;
+		modelAnimation = (ModelAnimation){
+			.startCell = textureState.startCell,
+			.frameCount = textureState.numFrames,
+			.frameDuration = frameDuration,
+			.startTime = animationTime - (uint32_t)((float)firstFrame * frameDuration),
+			.loop = loop ? 1 : 0
+		};
+	}
+	modelPool->pAnimations[modelIndex] = modelAnimation;
+}
+
+// Returns the draw info of a model, whether it is in the array of draw infos or the model is hidden.
+static DrawInfo *getModelDrawInfo(ModelPool modelPool, const uint32_t modelIndex) {
+	const uint32_t drawInfoIndex = modelPool->pDrawInfoIndices[modelIndex];
+	return drawInfoIndex == DRAW_INFO_INDEX_HIDDEN ? &modelPool->pHiddenDrawInfos[modelIndex] : &modelPool->pDrawInfos[drawInfoIndex];
+}
+
+// Updates the image shown by a model when it is not animated.
+static void updateDrawInfo(ModelPool modelPool, const uint32_t modelIndex, const uint32_t imageIndex) {
+	getModelDrawInfo(modelPool, modelIndex)->imageIndex = imageIndex;
+}
+
+// Inserts a draw info into the array of draw infos, in order of depth.
+static void insertDrawInfo(ModelPool modelPool, const DrawInfo drawInfo, const float z) {
+	
+	// Select insertion position depending on depth.
+	uint32_t insertIndex = modelPool->drawInfoCount;
+	for (uint32_t i = 0; i < modelPool->drawInfoCount; ++i) {
+		const float otherZ = modelPool->pModelTransforms[modelPool->pDrawInfos[i].modelIndex].translation.current.z;
+		if (z < otherZ) { // Z-up
+			insertIndex = i;
+			break;
+		}
+	}
+	
+	for (uint32_t i = modelPool->drawInfoCount; i > insertIndex; --i) {
+		modelPool->pDrawInfos[i] = modelPool->pDrawInfos[i - 1];
+		modelPool->pDrawInfoIndices[modelPool->pDrawInfos[i].modelIndex] = i;
+	}
+	
+	modelPool->pDrawInfos[insertIndex] = drawInfo;
+	modelPool->pDrawInfoIndices[drawInfo.modelIndex] = insertIndex;
+	modelPool->drawInfoCount += 1;
+}
+
+// Removes a draw info from the array of draw infos.
+static void removeDrawInfo(ModelPool modelPool, const uint32_t drawInfoIndex) {
+	
+	// Remove the draw data associated with the quad.
+	modelPool->drawInfoCount -= 1;
+	// Move each draw data ahead of the removed draw data forward one place.
+	for (uint32_t i = drawInfoIndex; i < modelPool->drawInfoCount; ++i) {
+		// i = index of the draw data after being moved forward one place.
+		// i + 1 = index of the draw data before being moved forward one place.
+		modelPool->pDrawInfos[i] = modelPool->pDrawInfos[i + 1];	// Copy the next draw data into this place.
+		modelPool->pDrawInfoIndices[modelPool->pDrawInfos[i].modelIndex] = i;
+	}
+}
+
+// The number of vertices in each model's mesh.
+#define MODEL_MESH_VERTEX_COUNT 4
+
+// Builds the mesh of a model from its quadrangle-vertices and color, in the vertex layout of the pool's pipeline.
+static void buildModelMesh(const ModelPool modelPool, const BoxF dimensions, const Vector4F color, float *const pMesh) {
+	static const uint32_t numVerticesPerQuad = MODEL_MESH_VERTEX_COUNT;
+	
+	if (modelPool->graphicsPipeline.vertexAttributePositionOffset >= 0) {
+		uint32_t baseOffset = 0 * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributePositionOffset;
+		pMesh[baseOffset + 0] = dimensions.x1;
+		pMesh[baseOffset + 1] = dimensions.y1;
+		pMesh[baseOffset + 2] = 0.0F;
+		baseOffset = 1 * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributePositionOffset;
+		pMesh[baseOffset + 0] = dimensions.x1;
+		pMesh[baseOffset + 1] = dimensions.y2;
+		pMesh[baseOffset + 2] = 0.0F;
+		baseOffset = 2 * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributePositionOffset;
+		pMesh[baseOffset + 0] = dimensions.x2;
+		pMesh[baseOffset + 1] = dimensions.y2;
+		pMesh[baseOffset + 2] = 0.0F;
+		baseOffset = 3 * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributePositionOffset;
+		pMesh[baseOffset + 0] = dimensions.x2;
+		pMesh[baseOffset + 1] = dimensions.y1;
+		pMesh[baseOffset + 2] = 0.0F;
+	}
+	
+	if (modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset >= 0) {
+		uint32_t baseOffset = 0 * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset;
+		pMesh[baseOffset + 0] = 0.0F;
+		pMesh[baseOffset + 1] = 1.0F;
+		baseOffset = 1 * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset;
+		pMesh[baseOffset + 0] = 0.0F;
+		pMesh[baseOffset + 1] = 0.0F;
+		baseOffset = 2 * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset;
+		pMesh[baseOffset + 0] = 1.0F;
+		pMesh[baseOffset + 1] = 0.0F;
+		baseOffset = 3 * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset;
+		pMesh[baseOffset + 0] = 1.0F;
+		pMesh[baseOffset + 1] = 1.0F;
+	}
+	
+	if (modelPool->graphicsPipeline.vertexAttributeColorOffset >= 0) {
+		for (uint32_t i = 0; i < numVerticesPerQuad; ++i) {
+			uint32_t baseOffset = i * modelPool->graphicsPipeline.vertexInputElementStride + modelPool->graphicsPipeline.vertexAttributeColorOffset;
+			pMesh[baseOffset + 0] = color.x;
+			pMesh[baseOffset + 1] = color.y;
+			pMesh[baseOffset + 2] = color.z;
+		}
+	}
+}
+
+// Uploads the sampled image of a model's texture on the render thread.
+static void uploadModelTexture(void *pData) {
+	const Texture texture = getTexture(*(const int32_t *)pData);
+	uploadSampledImage(device, texture.image);
 }
 
 void loadModel(const ModelLoadInfo loadInfo, int *const pModelHandle) {
@@ -233,117 +389,37 @@ void loadModel(const ModelLoadInfo loadInfo, int *const pModelHandle) {
 	loadInfo.modelPool->pModelTransforms[modelIndex] = makeModelTransform(loadInfo.position, zeroVec4F, zeroVec4F);
 	loadInfo.modelPool->pCameraFlags[modelIndex] = loadInfo.cameraFlag;
 	
-	/* Generate model's mesh and upload to vertex buffer(s) */
-	
-	// Compute size of mesh
-	// Copy attributes into right spots
-	
-	static const VkDeviceSize numVerticesPerQuad = 4;
-	
-	float mesh[numVerticesPerQuad * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride];
-	
-	if (loadInfo.modelPool->graphicsPipeline.vertexAttributePositionOffset >= 0) {
-		uint32_t baseOffset = 0 * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributePositionOffset;
-		mesh[baseOffset + 0] = loadInfo.dimensions.x1;
-		mesh[baseOffset + 1] = loadInfo.dimensions.y1;
-		mesh[baseOffset + 2] = 0.0F;
-		baseOffset = 1 * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributePositionOffset;
-		mesh[baseOffset + 0] = loadInfo.dimensions.x1;
-		mesh[baseOffset + 1] = loadInfo.dimensions.y2;
-		mesh[baseOffset + 2] = 0.0F;
-		baseOffset = 2 * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributePositionOffset;
-		mesh[baseOffset + 0] = loadInfo.dimensions.x2;
-		mesh[baseOffset + 1] = loadInfo.dimensions.y2;
-		mesh[baseOffset + 2] = 0.0F;
-		baseOffset = 3 * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributePositionOffset;
-		mesh[baseOffset + 0] = loadInfo.dimensions.x2;
-		mesh[baseOffset + 1] = loadInfo.dimensions.y1;
-		mesh[baseOffset + 2] = 0.0F;
-	}
-	
-	if (loadInfo.modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset >= 0) {
-		uint32_t baseOffset = 0 * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset;
-		mesh[baseOffset + 0] = 0.0F;
-		mesh[baseOffset + 1] = 1.0F;
-		baseOffset = 1 * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset;
-		mesh[baseOffset + 0] = 0.0F;
-		mesh[baseOffset + 1] = 0.0F;
-		baseOffset = 2 * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset;
-		mesh[baseOffset + 0] = 1.0F;
-		mesh[baseOffset + 1] = 0.0F;
-		baseOffset = 3 * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset;
-		mesh[baseOffset + 0] = 1.0F;
-		mesh[baseOffset + 1] = 1.0F;
-	}
-	
-	if (loadInfo.modelPool->graphicsPipeline.vertexAttributeColorOffset >= 0) {
-		for (uint32_t i = 0; i < numVerticesPerQuad; ++i) {
-			uint32_t baseOffset = i * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride + loadInfo.modelPool->graphicsPipeline.vertexAttributeColorOffset;
-			mesh[baseOffset + 0] = loadInfo.color.x;
-			mesh[baseOffset + 1] = loadInfo.color.y;
-			mesh[baseOffset + 2] = loadInfo.color.z;
-		}
-	}
-	
-	// Upload model's mesh to staging buffer.
-	// The offset of the mesh's vertices in the vertex buffer, in bytes.
-	const VkDeviceSize meshOffset = sizeof(mesh) * modelIndex + loadInfo.modelPool->firstVertex * loadInfo.modelPool->graphicsPipeline.vertexInputElementStride * sizeof(float);	
-	unsigned char *const pMappedMemoryVertices = buffer_partition_map_memory(global_staging_buffer_partition, 0);
-	memcpy(&pMappedMemoryVertices[meshOffset], mesh, sizeof(mesh));
-	buffer_partition_unmap_memory(global_staging_buffer_partition);
+	// The culling pass tests these bounds against the view to skip drawing off-screen models.
+	// The render thread builds the model's mesh from them in each frame's vertex buffer, once the frame draws a snapshot with the new mesh version.
+	loadInfo.modelPool->pBounds[modelIndex] = loadInfo.dimensions;
+	loadInfo.modelPool->pColors[modelIndex] = loadInfo.color;
+	loadInfo.modelPool->pMeshVersions[modelIndex] += 1;
 	
-	VkSemaphore waitSemaphores[NUM_FRAMES_IN_FLIGHT];
-	uint64_t waitSemaphoreValues[NUM_FRAMES_IN_FLIGHT];
-	for (uint32_t i = 0; i < frame_array.num_frames; ++i) {
-		waitSemaphores[i] = frame_array.frames[i].semaphore_buffers_ready.semaphore;
-		waitSemaphoreValues[i] = frame_array.frames[i].semaphore_buffers_ready.wait_counter;
-	}
-	
-	const VkSemaphoreWaitInfo semaphoreWaitInfo = {
-		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
-		.pNext = nullptr,
-		.flags = 0,
-		.semaphoreCount = frame_array.num_frames,
-		.pSemaphores = waitSemaphores,
-		.pValues = waitSemaphoreValues
-	};
-	vkWaitSemaphores(device, &semaphoreWaitInfo, UINT64_MAX);
-	
-	CmdBufArray cmdBufArray = cmdBufAlloc(commandPoolTransfer, NUM_FRAMES_IN_FLIGHT);
-	VkCommandBufferSubmitInfo cmdBufSubmitInfos[NUM_FRAMES_IN_FLIGHT] = { { } };
-	VkSemaphoreSubmitInfo semaphoreWaitSubmitInfos[NUM_FRAMES_IN_FLIGHT] = { { } };
-	VkSemaphoreSubmitInfo semaphoreSignalSubmitInfos[NUM_FRAMES_IN_FLIGHT] = { { } };
-	VkSubmitInfo2 submitInfos[NUM_FRAMES_IN_FLIGHT] = { { } };
-	
-	const VkBufferCopy bufferCopy = {
-		.srcOffset = meshOffset,
-		.dstOffset = meshOffset,
-		.size = sizeof(mesh)
-	};
-	
-	for (uint32_t i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i) {
-		recordCommands(cmdBufArray, i, true, 
-			vkCmdCopyBuffer(cmdBuf, global_staging_buffer_partition.buffer, frame_array.frames[i].vertex_buffer, 1, &bufferCopy);
-		);
+	// Update texture descriptor
+	// True if the model uses a texture, false otherwise.
+	TextureState textureState = { };
+	const bool textureNeeded = loadInfo.modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset >= 0;
+	if (textureNeeded) {
+		if (loadInfo.textureHandle > 0) {
+			textureState = newTextureState2(loadInfo.textureHandle);
+		} else {
+			textureState = newTextureState(loadInfo.textureID);
+		}
+		if (loadInfo.initAnimation < textureState.numAnimations) {
+			textureStateSetAnimation(&textureState, loadInfo.initAnimation);
+		}
 		
-		cmdBufSubmitInfos[i] = make_command_buffer_submit_info(cmdBufArray.pCmdBufs[i]);
-		semaphoreWaitSubmitInfos[i] = make_timeline_semaphore_wait_submit_info(frame_array.frames[i].semaphore_render_finished, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
-		semaphoreSignalSubmitInfos[i] = make_timeline_semaphore_signal_submit_info(frame_array.frames[i].semaphore_buffers_ready, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
-		frame_array.frames[i].semaphore_buffers_ready.wait_counter += 1;
-
-		submitInfos[i] = (VkSubmitInfo2){
-			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-			.pNext = nullptr,
-			.waitSemaphoreInfoCount = 1,
-			.pWaitSemaphoreInfos = &semaphoreWaitSubmitInfos[i],
-			.commandBufferInfoCount = 1,
-			.pCommandBufferInfos = &cmdBufSubmitInfos[i],
-			.signalSemaphoreInfoCount = 1,
-			.pSignalSemaphoreInfos = &semaphoreSignalSubmitInfos[i]
-		};
+		// The render thread uploads the descriptor before drawing the first snapshot that has the model.
+		int32_t *const pTextureHandle = heapAlloc(1, sizeof(int32_t));
+		if (pTextureHandle) {
+			*pTextureHandle = textureState.textureHandle;
+			pushRenderTask(uploadModelTexture, pTextureHandle);
+		} else {
+			logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Loading model: failed to allocate texture upload task.");
+		}
 	}
-	vkQueueSubmit2(queueTransfer, NUM_FRAMES_IN_FLIGHT, submitInfos, VK_NULL_HANDLE);
-	//cmdBufFree(&cmdBufArray); // TODO: clean up command buffers properly.
+	loadInfo.modelPool->pTextureStates[modelIndex] = textureState;
+	setModelAnimation(loadInfo.modelPool, modelIndex, textureState, loadInfo.initFrame, true);
 	
 	/* Create and insert new model's draw info struct */
 	
@@ -354,49 +430,11 @@ void loadModel(const ModelLoadInfo loadInfo, int *const pModelHandle) {
 		.vertexOffset = loadInfo.modelPool->firstVertex + loadInfo.modelPool->vertexCount * modelIndex,
 		.firstInstance = 0,
 		.modelIndex = modelIndex,
-		.imageIndex = loadInfo.imageIndex
+		.imageIndex = textureState.startCell + loadInfo.initFrame,
+		.tilemap.tilesetImageIndex = DESCRIPTOR_HANDLE_INVALID
 	};
 	
-	// Select insertion position depending on depth.
-	uint32_t insertIndex = loadInfo.modelPool->drawInfoCount;
-	for (uint32_t i = 0; i < loadInfo.modelPool->drawInfoCount; ++i) {
-		const float otherZ = loadInfo.modelPool->pModelTransforms[loadInfo.modelPool->pDrawInfos[i].modelIndex].translation.current.z;
-		if (loadInfo.position.z < otherZ) { // Z-up
-			insertIndex = i;
-			break;
-		}
-	}
-	
-	for (uint32_t i = loadInfo.modelPool->drawInfoCount; i > insertIndex; --i) {
-		loadInfo.modelPool->pDrawInfos[i] = loadInfo.modelPool->pDrawInfos[i - 1];
-		loadInfo.modelPool->pDrawInfoIndices[loadInfo.modelPool->pDrawInfos[i].modelIndex] = i;
-	}
-	
-	loadInfo.modelPool->pDrawInfos[insertIndex] = drawInfo;
-	loadInfo.modelPool->pDrawInfoIndices[modelIndex] = insertIndex;
-	loadInfo.modelPool->drawInfoCount += 1;
-	
-	// Upload new draw info array to buffer
-	bufferHostTransfer(loadInfo.modelPool->drawInfoBuffer, 0, drawCountSize, &loadInfo.modelPool->drawInfoCount);
-	bufferHostTransfer(loadInfo.modelPool->drawInfoBuffer, drawCountSize, loadInfo.modelPool->drawInfoCount * sizeof(DrawInfo), loadInfo.modelPool->pDrawInfos);
-	
-	// Update texture descriptor
-	// True if the model uses a texture, false otherwise.
-	loadInfo.modelPool->pTextureStates[modelIndex] = (TextureState){ };
-	const bool textureNeeded = loadInfo.modelPool->graphicsPipeline.vertexAttributeTextureCoordinatesOffset >= 0;
-	if (textureNeeded) {
-		if (loadInfo.textureHandle > 0) {
-			const TextureState textureState = newTextureState2(loadInfo.textureHandle);
-			loadInfo.modelPool->pTextureStates[modelIndex] = textureState;
-			const Texture texture = getTexture(textureState.textureHandle);
-			uploadSampledImage(device, texture.image);
-		} else {
-			const TextureState textureState = newTextureState(loadInfo.textureID);
-			loadInfo.modelPool->pTextureStates[modelIndex] = textureState;
-			const Texture texture = getTexture(textureState.textureHandle);
-			uploadSampledImage(device, texture.image);
-		}
-	}
+	insertDrawInfo(loadInfo.modelPool, drawInfo, loadInfo.position.z);
 	
 	loadInfo.modelPool->pSlotFlags[modelIndex] = true;
 	*pModelHandle = (int)modelIndex;
@@ -410,25 +448,14 @@ void unloadModel(ModelPool modelPool, int *const pModelHandle) {
 	// If any other draw infos are moved around, adjust their models' draw info indices
 	
 	// Get the index of the draw data associated with the quad.
+	// A hidden model's draw info is already out of the array.
 	const uint32_t modelIndex = (uint32_t)*pModelHandle;
 	const uint32_t drawInfoIndex = modelPool->pDrawInfoIndices[modelIndex];
-	if (drawInfoIndex >= modelPool->drawInfoCount) {
-		return;
-	}
-	
-	// Remove the draw data associated with the quad.
-	modelPool->drawInfoCount -= 1;
-	// Move each draw data ahead of the removed draw data forward one place.
-	for (uint32_t i = drawInfoIndex; i < modelPool->drawInfoCount; ++i) {
-		// i = index of the draw data after being moved forward one place.
-		// i + 1 = index of the draw data before being moved forward one place.
-		modelPool->pDrawInfos[i] = modelPool->pDrawInfos[i + 1];	// Copy the next draw data into this place.
-		modelPool->pDrawInfoIndices[modelPool->pDrawInfos[i].modelIndex] = i;
-	}
-	
-	bufferHostTransfer(modelPool->drawInfoBuffer, 0, drawCountSize, &modelPool->drawInfoCount);
-	if (modelPool->drawInfoCount > 0) {
-		bufferHostTransfer(modelPool->drawInfoBuffer, drawCountSize, modelPool->drawInfoCount * sizeof(DrawInfo), modelPool->pDrawInfos);
+	if (drawInfoIndex != DRAW_INFO_INDEX_HIDDEN) {
+		if (drawInfoIndex >= modelPool->drawInfoCount) {
+			return;
+		}
+		removeDrawInfo(modelPool, drawInfoIndex);
 	}
 	
 	modelPool->pSlotFlags[modelIndex] = false;
@@ -454,25 +481,212 @@ void modelSettleTransform(ModelPool modelPool, const int modelHandle) {
 	renderVectorSettle(&modelPool->pModelTransforms[modelHandle].rotation);
 }
 
-TextureState *modelGetTextureState(ModelPool modelPool, const int modelHandle) {
+bool modelSetAnimation(ModelPool modelPool, const int modelHandle, const uint32_t animation, const uint32_t firstFrame, const bool loop) {
+	if (!modelPool) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Setting model animation: model pool is null.");
+		return false;
+	}
+	
+	const uint32_t modelIndex = (uint32_t)modelHandle;
+	TextureState *const pTextureState = &modelPool->pTextureStates[modelIndex];
+	if (!textureStateSetAnimation(pTextureState, animation)) {
+		return false;
+	}
+	
+	setModelAnimation(modelPool, modelIndex, *pTextureState, firstFrame, loop);
+	updateDrawInfo(modelPool, modelIndex, pTextureState->startCell + firstFrame);
+	return true;
+}
+
+uint32_t modelGetAnimation(ModelPool modelPool, const int modelHandle) {
+	if (!modelPool) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Getting model animation: model pool is null.");
+		return 0;
+	}
+	return modelPool->pTextureStates[modelHandle].currentAnimation;
+}
+
+void modelSetImage(ModelPool modelPool, const int modelHandle, const uint32_t imageIndex) {
+	if (!modelPool) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Setting model image: model pool is null.");
+		return;
+	}
+	
+	// A model showing a fixed image is not animated.
+	const uint32_t modelIndex = (uint32_t)modelHandle;
+	setModelAnimation(modelPool, modelIndex, (TextureState){ }, 0, false);
+	updateDrawInfo(modelPool, modelIndex, imageIndex);
+}
+
+void modelSetTilemap(ModelPool modelPool, const int modelHandle, const ModelTilemap tilemap) {
 	if (!modelPool) {
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Getting model texture state: model pool is null.");
-		return nullptr;
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Setting model tilemap: model pool is null.");
+		return;
 	}
-	return &modelPool->pTextureStates[modelHandle];
+	
+	const uint32_t modelIndex = (uint32_t)modelHandle;
+	getModelDrawInfo(modelPool, modelIndex)->tilemap = tilemap;
 }
 
-void updateDrawInfo(ModelPool modelPool, const int modelHandle, const unsigned int imageIndex) {
+void modelSetVisible(ModelPool modelPool, const int modelHandle, const bool visible) {
+	if (!modelPool) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Setting model visibility: model pool is null.");
+		return;
+	}
+	
 	const uint32_t modelIndex = (uint32_t)modelHandle;
 	const uint32_t drawInfoIndex = modelPool->pDrawInfoIndices[modelIndex];
-	modelPool->pDrawInfos[drawInfoIndex].imageIndex = (uint32_t)imageIndex;
-	bufferHostTransfer(modelPool->drawInfoBuffer, drawCountSize + drawInfoIndex * sizeof(DrawInfo), sizeof(DrawInfo), &modelPool->pDrawInfos[drawInfoIndex]);
+	if (visible && drawInfoIndex == DRAW_INFO_INDEX_HIDDEN) {
+		// The model appears where it is now, instead of moving there from where it was hidden.
+		modelSettleTransform(modelPool, modelHandle);
+		insertDrawInfo(modelPool, modelPool->pHiddenDrawInfos[modelIndex], modelPool->pModelTransforms[modelIndex].translation.current.z);
+	} else if (!visible && drawInfoIndex != DRAW_INFO_INDEX_HIDDEN) {
+		modelPool->pHiddenDrawInfos[modelIndex] = modelPool->pDrawInfos[drawInfoIndex];
+		removeDrawInfo(modelPool, drawInfoIndex);
+		modelPool->pDrawInfoIndices[modelIndex] = DRAW_INFO_INDEX_HIDDEN;
+	}
+}
+
+void deleteModelPoolSnapshot(ModelPoolSnapshot *const pSnapshot) {
+	void *const pArrays[] = {
+		pSnapshot->drawInfos,
+		pSnapshot->animations,
+		pSnapshot->bounds,
+		pSnapshot->colors,
+		pSnapshot->meshVersions,
+		pSnapshot->cameraFlags,
+		pSnapshot->transforms
+	};
+	for (size_t i = 0; i < sizeof(pArrays) / sizeof(pArrays[0]); ++i) {
+		if (pArrays[i]) {
+			heapFree(pArrays[i]);
+		}
+	}
+	*pSnapshot = (ModelPoolSnapshot){ };
+}
+
+// Replaces the arrays of a snapshot with arrays that hold at least modelCount models.
+// The snapshot is only written by the simulation thread between publishing snapshots, so no frame reads the old arrays.
+static bool reserveModelPoolSnapshot(ModelPoolSnapshot *const pSnapshot, const uint32_t modelCount) {
+	if (pSnapshot->capacity >= modelCount) {
+		return true;
+	}
+	
+	deleteModelPoolSnapshot(pSnapshot);
+	pSnapshot->drawInfos = heapAlloc(modelCount, sizeof(DrawInfo));
+	pSnapshot->animations = heapAlloc(modelCount, sizeof(ModelAnimation));
+	pSnapshot->bounds = heapAlloc(modelCount, sizeof(BoxF));
+	pSnapshot->colors = heapAlloc(modelCount, sizeof(Vector4F));
+	pSnapshot->meshVersions = heapAlloc(modelCount, sizeof(uint32_t));
+	pSnapshot->cameraFlags = heapAlloc(modelCount, sizeof(uint32_t));
+	pSnapshot->transforms = heapAlloc(modelCount, sizeof(ModelTransform));
+	if (!pSnapshot->drawInfos || !pSnapshot->animations || !pSnapshot->bounds || !pSnapshot->colors
+			|| !pSnapshot->meshVersions || !pSnapshot->cameraFlags || !pSnapshot->transforms) {
+		deleteModelPoolSnapshot(pSnapshot);
+		return false;
+	}
+	pSnapshot->capacity = modelCount;
+	return true;
+}
+
+bool modelPoolTakeSnapshot(const ModelPool modelPool, ModelPoolSnapshot *const pOutSnapshot) {
+	assert(modelPool && pOutSnapshot);
+	
+	if (!reserveModelPoolSnapshot(pOutSnapshot, modelPool->maxModelCount)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Taking model pool snapshot: failed to allocate arrays for %u models.", modelPool->maxModelCount);
+		return false;
+	}
+	
+	const uint32_t modelCount = modelPool->maxModelCount;
+	pOutSnapshot->modelCount = modelCount;
+	pOutSnapshot->drawInfoCount = modelPool->drawInfoCount;
+	memcpy(pOutSnapshot->drawInfos, modelPool->pDrawInfos, modelPool->drawInfoCount * sizeof(DrawInfo));
+	memcpy(pOutSnapshot->animations, modelPool->pAnimations, modelCount * sizeof(ModelAnimation));
+	memcpy(pOutSnapshot->bounds, modelPool->pBounds, modelCount * sizeof(BoxF));
+	memcpy(pOutSnapshot->colors, modelPool->pColors, modelCount * sizeof(Vector4F));
+	memcpy(pOutSnapshot->meshVersions, modelPool->pMeshVersions, modelCount * sizeof(uint32_t));
+	memcpy(pOutSnapshot->cameraFlags, modelPool->pCameraFlags, modelCount * sizeof(uint32_t));
+	memcpy(pOutSnapshot->transforms, modelPool->pModelTransforms, modelCount * sizeof(ModelTransform));
+	return true;
+}
+
+void modelPoolUploadSnapshot(const ModelPool modelPool, const uint32_t frameIndex, const ModelPoolSnapshot *const pSnapshot) {
+	assert(modelPool && pSnapshot);
+	if (frameIndex >= modelPool->frameCount) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Uploading model pool snapshot: frame index (%u) is out of range.", frameIndex);
+		return;
+	}
+	
+	// A snapshot whose arrays could not be allocated holds no models.
+	const uint32_t modelCount = pSnapshot->modelCount < modelPool->maxModelCount ? pSnapshot->modelCount : modelPool->maxModelCount;
+	bufferHostTransfer(modelPool->drawInfoBuffers[frameIndex], 0, drawCountSize, &pSnapshot->drawInfoCount);
+	if (pSnapshot->drawInfoCount > 0) {
+		bufferHostTransfer(modelPool->drawInfoBuffers[frameIndex], drawCountSize, pSnapshot->drawInfoCount * sizeof(DrawInfo), pSnapshot->drawInfos);
+	}
+	bufferHostTransfer(modelPool->animationBuffers[frameIndex], 0, modelCount * sizeof(ModelAnimation), pSnapshot->animations);
+	bufferHostTransfer(modelPool->boundsBuffers[frameIndex], 0, modelCount * sizeof(BoxF), pSnapshot->bounds);
+}
+
+uint32_t cmdUpdateModelMeshes(const VkCommandBuffer cmdBuf, const ModelPool modelPool, const uint32_t frameIndex, const VkBuffer vertexBuffer, const ModelPoolSnapshot *const pSnapshot) {
+	assert(modelPool && pSnapshot);
+	if (frameIndex >= modelPool->frameCount) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Updating model meshes: frame index (%u) is out of range.", frameIndex);
+		return 0;
+	}
+	
+	const uint32_t modelCount = pSnapshot->modelCount < modelPool->maxModelCount ? pSnapshot->modelCount : modelPool->maxModelCount;
+	uint32_t *const pFrameMeshVersions = &modelPool->pFrameMeshVersions[frameIndex * modelPool->maxModelCount];
+	float mesh[MODEL_MESH_VERTEX_COUNT * modelPool->graphicsPipeline.vertexInputElementStride];
+	
+	memset(mesh, 0, sizeof(mesh));
+	
+	uint32_t updateCount = 0;
+	for (uint32_t i = 0; i < modelCount; ++i) {
+		if (pSnapshot->meshVersions[i] == pFrameMeshVersions[i]) {
+			continue;
+		}
+		buildModelMesh(modelPool, pSnapshot->bounds[i], pSnapshot->colors[i], mesh);
+		
+		// The offset of the mesh's vertices in the vertex buffer, in bytes.
+		const VkDeviceSize meshOffset = sizeof(mesh) * i + modelPool->firstVertex * modelPool->graphicsPipeline.vertexInputElementStride * sizeof(float);
+		vkCmdUpdateBuffer(cmdBuf, vertexBuffer, meshOffset, sizeof(mesh), mesh);
+		pFrameMeshVersions[i] = pSnapshot->meshVersions[i];
+		updateCount += 1;
+	}
+	return updateCount;
 }
 
-uint32_t *getModelCameraFlags(const ModelPool modelPool) {
-	return modelPool->pCameraFlags;
+void cmdUpdateModelMeshesBarrier(const VkCommandBuffer cmdBuf) {
+	const VkMemoryBarrier2 memoryBarrier = {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+		.pNext = nullptr,
+		.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+		.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+		.dstStageMask = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT,
+		.dstAccessMask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT
+	};
+	const VkDependencyInfo dependencyInfo = {
+		.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+		.pNext = nullptr,
+		.dependencyFlags = 0,
+		.memoryBarrierCount = 1,
+		.pMemoryBarriers = &memoryBarrier,
+		.bufferMemoryBarrierCount = 0,
+		.pBufferMemoryBarriers = nullptr,
+		.imageMemoryBarrierCount = 0,
+		.pImageMemoryBarriers = nullptr
+	};
+	vkCmdPipelineBarrier2(cmdBuf, &dependencyInfo);
 }
 
-ModelTransform *getModelTransforms(const ModelPool modelPool) {
-	return modelPool->pModelTransforms;
-}
\ No newline at end of file
+void modelPoolSnapshotMarkTilemapsRead(const ModelPoolSnapshot *const pSnapshot, const uint32_t frameIndex, const uint64_t renderFinishedValue) {
+	if (!pSnapshot) {
+		return;
+	}
+	
+	for (uint32_t i = 0; i < pSnapshot->drawInfoCount; ++i) {
+		if (pSnapshot->drawInfos[i].tilemap.tilesetImageIndex != DESCRIPTOR_HANDLE_INVALID) {
+			roomTilemapMarkRead(pSnapshot->drawInfos[i].tilemap, frameIndex, renderFinishedValue);
+		}
+	}
+}
@@ -20,10 +20,24 @@ extern const uint32_t drawCountSize;
 
 extern const uint32_t drawCommandStride;
 
+// Size of each model's animation parameters in a model pool's animation buffer.
+extern const uint32_t modelAnimationStride;
+
+// Size of each model's bounds in a model pool's bounds buffer.
+extern const uint32_t modelBoundsStride;
+
 typedef struct ModelPoolCreateInfo {
 	
+	// The pool has one subrange of each buffer per frame in flight; frame i uses subrange bufferSubrangeIndex + i.
 	Buffer buffer;
 	int32_t bufferSubrangeIndex;
+	uint32_t frameCount;
+	
+	// Host-visible storage buffer for per-model animation parameters; uses the same subrange indices as the draw info buffer.
+	Buffer animationBuffer;
+	
+	// Host-visible storage buffer for per-model bounds, read by the draw culling pass; uses the same subrange indices as the draw info buffer.
+	Buffer boundsBuffer;
 	
 	GraphicsPipeline graphicsPipeline;
 	
@@ -45,16 +59,81 @@ void deleteModelPool(ModelPool *const pModelPool);
 
 uint32_t modelPoolGetMaxModelCount(const ModelPool modelPool);
 
-VkDescriptorBufferInfo modelPoolGetBufferDescriptorInfo(const ModelPool modelPool);
-
 void modelPoolGetDrawCommandArguments(const ModelPool modelPool, uint32_t *const pMaxDrawCount, uint32_t *const pStride);
 
-VkDeviceSize modelPoolGetDrawInfoBufferOffset(const ModelPool modelPool);
+uint32_t modelPoolGetDrawInfoBufferHandle(const ModelPool modelPool, const uint32_t frameIndex);
+
+uint32_t modelPoolGetAnimationBufferHandle(const ModelPool modelPool, const uint32_t frameIndex);
+
+uint32_t modelPoolGetBoundsBufferHandle(const ModelPool modelPool, const uint32_t frameIndex);
 
-uint32_t modelPoolGetDrawInfoBufferHandle(const ModelPool modelPool);
+// Sets the time in milliseconds of the animation clock shared by all models.
+// Animated models select their current image from this time on the GPU.
+void setAnimationTime(const uint32_t timeMS);
 
+uint32_t getAnimationTime(void);
 
 
+
+// Parameters for models that draw a tilemap by reading tiles directly from a tileset, instead of sampling their texture.
+typedef struct ModelTilemap {
+	
+	// Handle to the tileset's storage image; DESCRIPTOR_HANDLE_INVALID if the model is not a tilemap.
+	uint32_t tilesetImageIndex;
+	
+	// Handle to the storage buffer holding the tile indices, and the position of the tilemap's first tile index in it.
+	uint32_t tileDataBufferIndex;
+	uint32_t tileDataOffset;
+	
+	// The extent of the tilemap in tiles; tile indices are stored row by row, starting from the top row.
+	uint32_t width;
+	uint32_t length;
+	
+} ModelTilemap;
+
+typedef struct DrawInfo {
+	
+	/* Indirect draw command parameters */
+	
+	uint32_t indexCount;
+	uint32_t instanceCount;	// Unused
+	uint32_t firstIndex;
+	int32_t vertexOffset;
+	uint32_t firstInstance;	// Unused; the culling pass replaces it with the draw info's index
+	
+	/* Additional draw parameters */
+	
+	// Indexes into a model pool's array of models.
+	int32_t modelIndex;
+	
+	// Indexes into a texture array.
+	uint32_t imageIndex;
+	
+	// Used instead of the texture if the model draws a tilemap.
+	ModelTilemap tilemap;
+	
+} DrawInfo;
+
+// Per-model animation parameters, read by the vertex shader to select the current image of animated models.
+typedef struct ModelAnimation {
+	
+	// The first cell of the animation cycle in the texture.
+	uint32_t startCell;
+	
+	// Number of frames in the animation cycle; models with less than two frames are not animated.
+	uint32_t frameCount;
+	
+	// Duration of each frame in milliseconds; zero if the model is not animated.
+	float frameDuration;
+	
+	// Time point of the animation clock, in milliseconds, at which the animation cycle started.
+	uint32_t startTime;
+	
+	// If nonzero, the animation cycle repeats; otherwise it stops on its last frame.
+	uint32_t loop;
+	
+} ModelAnimation;
+
 typedef struct ModelLoadInfo {
 	
 	// Necessary parameters.
@@ -84,7 +163,9 @@ typedef struct ModelLoadInfo {
 	// The color of the model if there is a color vertex attribute.
 	Vector4F color;
 	
-	uint32_t imageIndex;
+	// The animation cycle of the texture that the model starts in, and the frame of that cycle it starts on.
+	uint32_t initAnimation;
+	uint32_t initFrame;
 	
 } ModelLoadInfo;
 
@@ -103,10 +184,68 @@ void modelSettleTransform(ModelPool modelPool, const int modelHandle);
 
 
 
-// TODO - replace these functions with specific control functions
-TextureState *modelGetTextureState(ModelPool modelPool, const int modelHandle);
-void updateDrawInfo(ModelPool modelPool, const int modelHandle, const unsigned int imageIndex);
-uint32_t *getModelCameraFlags(const ModelPool modelPool);
-ModelTransform *getModelTransforms(const ModelPool modelPool);
+// Starts an animation cycle of the model's texture at the given frame.
+// Returns true if the animation was successfully set, false otherwise.
+bool modelSetAnimation(ModelPool modelPool, const int modelHandle, const uint32_t animation, const uint32_t firstFrame, const bool loop);
+
+// Returns the current animation cycle of the model's texture.
+uint32_t modelGetAnimation(ModelPool modelPool, const int modelHandle);
+
+// Stops animating the model and shows a single image of its texture.
+void modelSetImage(ModelPool modelPool, const int modelHandle, const uint32_t imageIndex);
+
+// Makes the model draw a tilemap instead of its texture.
+void modelSetTilemap(ModelPool modelPool, const int modelHandle, const ModelTilemap tilemap);
+
+// Hides or shows the model; a hidden model is not drawn, but keeps its slot, mesh and texture state, so showing it again costs no reload.
+void modelSetVisible(ModelPool modelPool, const int modelHandle, const bool visible);
+
+// A copy of everything a frame draws from a pool, taken at the end of a game tick,
+// 	so that a frame can be drawn from it while the game changes the pool during the next tick.
+// Model loads and changes only write the pool's CPU-side arrays; the render thread uploads a snapshot into the buffers of the frame that draws it.
+// The arrays are allocated by the first snapshot taken into it, and grown whenever a pool has more models; free them with deleteModelPoolSnapshot.
+typedef struct ModelPoolSnapshot {
+	
+	// The number of models the arrays hold, which is the model count of the pool the snapshot was taken from.
+	uint32_t modelCount;
+	uint32_t capacity;
+	
+	// The draw infos of the pool's visible models, in draw order.
+	uint32_t drawInfoCount;
+	DrawInfo *drawInfos;
+	
+	// The rest is indexed by model index.
+	ModelAnimation *animations;
+	BoxF *bounds;
+	Vector4F *colors;
+	
+	// Increases each time a model is loaded into the slot, so that the render thread rebuilds the slot's mesh in each frame's vertex buffer.
+	uint32_t *meshVersions;
+	
+	uint32_t *cameraFlags;
+	ModelTransform *transforms;
+	
+} ModelPoolSnapshot;
+
+// Copies the state of the pool's models into a snapshot.
+// Returns false if the snapshot's arrays could not be grown to the pool's model count, in which case the snapshot is left empty.
+bool modelPoolTakeSnapshot(const ModelPool modelPool, ModelPoolSnapshot *const pOutSnapshot);
+
+// Frees the arrays of a snapshot; it must no longer be read by the render thread.
+void deleteModelPoolSnapshot(ModelPoolSnapshot *const pSnapshot);
+
+// Uploads the draw infos, animations and bounds of a snapshot into the buffers of a frame.
+// Must only be called on the render thread, once the frame's previous submission has finished executing.
+void modelPoolUploadSnapshot(const ModelPool modelPool, const uint32_t frameIndex, const ModelPoolSnapshot *const pSnapshot);
+
+// Records the rebuilding of every mesh in the frame's vertex buffer whose model was loaded since the frame last drew the pool.
+// Must be recorded outside a rendering scope, followed by cmdUpdateModelMeshesBarrier if any meshes were updated. Returns the number of meshes updated.
+uint32_t cmdUpdateModelMeshes(const VkCommandBuffer cmdBuf, const ModelPool modelPool, const uint32_t frameIndex, const VkBuffer vertexBuffer, const ModelPoolSnapshot *const pSnapshot);
+
+// Makes the updated meshes visible to the vertex input of the draws recorded after it.
+void cmdUpdateModelMeshesBarrier(const VkCommandBuffer cmdBuf);
+
+// Records that a frame reads the room tilemaps of a snapshot's drawn models until its render-finished semaphore reaches renderFinishedValue.
+void modelPoolSnapshotMarkTilemapsRead(const ModelPoolSnapshot *const pSnapshot, const uint32_t frameIndex, const uint64_t renderFinishedValue);
 
 #endif // DRAW_H
\ No newline at end of file
@@ -38,6 +38,10 @@ GraphicsPipeline createGraphicsPipeline(const GraphicsPipelineCreateInfo createI
 
 	VkPipelineShaderStageCreateInfo shaderStateCreateInfos[createInfo.shaderModuleCount];
 	for (uint32_t i = 0; i < createInfo.shaderModuleCount; ++i) {
+		if (createInfo.pShaderModules[i].vkShaderModule == VK_NULL_HANDLE) {
+			logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Graphics pipeline creation failed: shader module %u is invalid.", i);
+			return pipeline;
+		}
 		shaderStateCreateInfos[i] = makeShaderStageCreateInfo(createInfo.pShaderModules[i]);
 	}
 
@@ -48,7 +52,8 @@ GraphicsPipeline createGraphicsPipeline(const GraphicsPipelineCreateInfo createI
 	for (uint32_t i = 0; i < sizeof(createInfo.vertexAttributeFlags) * 8; ++i) {
 		vertexAttributeCount += (createInfo.vertexAttributeFlags >> i) & 1;
 	}
-	VkVertexInputAttributeDescription attributeDescriptions[vertexAttributeCount] = { };
+	// Pipelines that generate their vertices in the shader (e.g. from gl_VertexIndex) have no vertex attributes at all.
+	VkVertexInputAttributeDescription attributeDescriptions[vertexAttributeCount > 0 ? vertexAttributeCount : 1] = { };
 	VkVertexInputBindingDescription bindingDescription = { };
 
 	{	// Generate the vertex attribute descriptions and element offsets as well as the vertex binding description.
@@ -103,7 +108,7 @@ GraphicsPipeline createGraphicsPipeline(const GraphicsPipelineCreateInfo createI
 		.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
 		.pNext = nullptr,
 		.flags = 0,
-		.vertexBindingDescriptionCount = 1,
+		.vertexBindingDescriptionCount = vertexAttributeCount > 0 ? 1 : 0,
 		.pVertexBindingDescriptions = &bindingDescription,
 		.vertexAttributeDescriptionCount = vertexAttributeCount,
 		.pVertexAttributeDescriptions = attributeDescriptions
@@ -153,12 +158,22 @@ GraphicsPipeline createGraphicsPipeline(const GraphicsPipelineCreateInfo createI
 	const VkResult result = vkCreateGraphicsPipelines(createInfo.vkDevice, VK_NULL_HANDLE, 1, &vkGraphicsPipelineCreateInfo, nullptr, &pipeline.vkPipeline);
 	if (result != VK_SUCCESS) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Graphics pipeline creation failed (error code: %i).", result);
+		vkDestroyPipelineLayout(createInfo.vkDevice, pipeline.vkPipelineLayout, nullptr);
+		pipeline.vkPipelineLayout = VK_NULL_HANDLE;
+		pipeline.vkPipeline = VK_NULL_HANDLE;
+		return pipeline;
 	}
 	pipeline.vkDevice = createInfo.vkDevice;
 
 	return pipeline;
 }
 
+bool validateGraphicsPipeline(const GraphicsPipeline pipeline) {
+	return pipeline.vkPipeline != VK_NULL_HANDLE
+		&& pipeline.vkPipelineLayout != VK_NULL_HANDLE
+		&& pipeline.vkDevice != VK_NULL_HANDLE;
+}
+
 void deleteGraphicsPipeline(GraphicsPipeline *const pPipeline) {
 	if (!pPipeline) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error deleting pipeline: pointer to pipeline object is null.");
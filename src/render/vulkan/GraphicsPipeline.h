@@ -69,6 +69,8 @@ typedef struct GraphicsPipelineCreateInfo {
 
 GraphicsPipeline createGraphicsPipeline(const GraphicsPipelineCreateInfo createInfo);
 
+bool validateGraphicsPipeline(const GraphicsPipeline pipeline);
+
 void deleteGraphicsPipeline(GraphicsPipeline *const pPipeline);
 
 #endif	// GRAPHICS_PIPELINE_H
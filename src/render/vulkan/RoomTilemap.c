@@ -0,0 +1,342 @@
+#include "RoomTilemap.h"
+
+#include <stdatomic.h>
+#include <string.h>
+#include "log/Logger.h"
+#include "render/render_config.h"
+#include "render/RenderTaskQueue.h"
+#include "util/Allocation.h"
+#include "Buffer2.h"
+#include "Descriptor.h"
+#include "texture_manager.h"
+#include "VulkanManager.h"
+
+const uint32_t roomTilemapSlotCount = ROOM_TILEMAP_SLOT_COUNT;
+
+typedef struct RoomTilemapSlot {
+
+	// The tileset from which the room's tiles are read.
+	int32_t tilesetTextureHandle;
+	uint32_t tilesetImageIndex;
+
+	Extent roomExtent;
+
+} RoomTilemapSlot;
+
+static VkDevice tilemapDevice = VK_NULL_HANDLE;
+
+// Holds the tile indices of every slot; each slot has its layers stored one after another.
+// The buffer is recreated when it grows, but its descriptor handle stays the same.
+static Buffer bufferTileData = nullptr;
+static BufferSubrange tileData = { };
+static uint32_t tileDataHandle = DESCRIPTOR_HANDLE_INVALID;
+
+// The number of tiles reserved for each layer of a room, and for each slot, as seen by the simulation thread.
+// The simulation thread reserves and fills slots and queues the buffer writes; the buffer itself is only touched by render tasks.
+static uint32_t layerTileCapacity = 0;
+static uint32_t slotTileCapacity = 0;
+
+static RoomTilemapSlot slots[ROOM_TILEMAP_SLOT_COUNT];
+
+// The number of tiles per layer and per slot in the buffer as it currently exists, only used on the render thread.
+static uint32_t bufferLayerTileCapacity = 0;
+static uint32_t bufferSlotTileCapacity = 0;
+
+// When growing the buffer fails, the render thread stores the capacity per layer that it failed to grow to, and the one the buffer kept,
+// 	so that the simulation thread lays its slots out for the buffer that actually exists again.
+static atomic_uint failedLayerTileCapacity = 0;
+static atomic_uint keptLayerTileCapacity = 0;
+
+// For each slot and frame, the value of the frame's render-finished semaphore once it is done reading the slot; only used on the render thread.
+static uint64_t readValues[ROOM_TILEMAP_SLOT_COUNT][MAX_NUM_FRAMES_IN_FLIGHT];
+
+// The storage image descriptor of the most recently used tileset, so that it is only uploaded once per tileset.
+static int32_t lastTilesetTextureHandle = -1;
+static uint32_t lastTilesetImageIndex = DESCRIPTOR_HANDLE_INVALID;
+
+static void clearSlots(void) {
+	for (uint32_t i = 0; i < ROOM_TILEMAP_SLOT_COUNT; ++i) {
+		slots[i] = (RoomTilemapSlot){
+			.tilesetTextureHandle = -1,
+			.tilesetImageIndex = DESCRIPTOR_HANDLE_INVALID,
+			.roomExtent = (Extent){ 0, 0 }
+		};
+	}
+}
+
+// Rolls the slot layout of the simulation thread back to the buffer's if the render thread failed to grow the buffer to the current layout.
+// A failed grow to a smaller capacity than the current one is ignored, since a later grow is still queued.
+static void syncLayerTileCapacity(void) {
+	const uint32_t failedCapacity = atomic_exchange(&failedLayerTileCapacity, 0);
+	if (failedCapacity == 0 || failedCapacity != layerTileCapacity) {
+		return;
+	}
+	
+	layerTileCapacity = atomic_load(&keptLayerTileCapacity);
+	slotTileCapacity = NUM_ROOM_LAYERS * layerTileCapacity;
+	clearSlots();
+	logMsg(loggerVulkan, LOG_LEVEL_WARNING, "Room tilemap slots rolled back to %u tiles per layer, since the tile data buffer could not grow to %u.", layerTileCapacity, failedCapacity);
+}
+
+// Waits until every frame has reached the given values of its render-finished semaphore.
+static void waitForFrameReads(const uint64_t *const pReadValues) {
+	VkSemaphore waitSemaphores[MAX_NUM_FRAMES_IN_FLIGHT];
+	uint64_t waitSemaphoreValues[MAX_NUM_FRAMES_IN_FLIGHT];
+	for (uint32_t i = 0; i < frame_array.num_frames; ++i) {
+		waitSemaphores[i] = frame_array.frames[i].semaphore_render_finished.semaphore;
+		waitSemaphoreValues[i] = pReadValues[i];
+	}
+
+	const VkSemaphoreWaitInfo semaphoreWaitInfo = {
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+		.pNext = nullptr,
+		.flags = 0,
+		.semaphoreCount = frame_array.num_frames,
+		.pSemaphores = waitSemaphores,
+		.pValues = waitSemaphoreValues
+	};
+	vkWaitSemaphores(tilemapDevice, &semaphoreWaitInfo, UINT64_MAX);
+}
+
+// Creates the tile data buffer with room for the given number of tiles per layer, and borrows its only subrange.
+static bool createTileDataBuffer(const uint32_t newLayerTileCapacity) {
+	const BufferCreateInfo bufferCreateInfo = {
+		.physicalDevice = physical_device,
+		.vkDevice = tilemapDevice,
+		.bufferType = BUFFER_TYPE_STREAMING,
+		.memoryTypeIndexSet = memory_type_set,
+		.queueFamilyIndexCount = 0,
+		.pQueueFamilyIndices = nullptr,
+		.subrangeCount = 1,
+		.pSubrangeSizes = (VkDeviceSize[1]){
+			(VkDeviceSize)ROOM_TILEMAP_SLOT_COUNT * NUM_ROOM_LAYERS * newLayerTileCapacity * sizeof(uint32_t)
+		}
+	};
+	createBuffer(bufferCreateInfo, &bufferTileData);
+	if (!bufferTileData) {
+		return false;
+	}
+
+	bufferBorrowSubrange(bufferTileData, 0, &tileData);
+	bufferLayerTileCapacity = newLayerTileCapacity;
+	bufferSlotTileCapacity = NUM_ROOM_LAYERS * newLayerTileCapacity;
+	return true;
+}
+
+void initRoomTilemaps(const VkDevice vkDevice) {
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing room tilemaps...");
+
+	tilemapDevice = vkDevice;
+
+	// The buffer is sized for real rooms by roomTilemapReserve; until then it only holds one tile per layer,
+	// 	so that the descriptor handle exists from the start.
+	if (!createTileDataBuffer(1)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Initializing room tilemaps: failed to create tile data buffer.");
+		return;
+	}
+	tileDataHandle = uploadStorageBuffer2(vkDevice, tileData);
+	layerTileCapacity = bufferLayerTileCapacity;
+	slotTileCapacity = bufferSlotTileCapacity;
+
+	clearSlots();
+	memset(readValues, 0, sizeof(readValues));
+
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initialized room tilemaps.");
+}
+
+void terminateRoomTilemaps(void) {
+	if (bufferTileData) {
+		bufferReturnSubrange(&tileData);
+		deleteBuffer(&bufferTileData);
+	}
+	tileDataHandle = DESCRIPTOR_HANDLE_INVALID;
+	atomic_store(&failedLayerTileCapacity, 0);
+	layerTileCapacity = 0;
+	slotTileCapacity = 0;
+	bufferLayerTileCapacity = 0;
+	bufferSlotTileCapacity = 0;
+	lastTilesetTextureHandle = -1;
+	lastTilesetImageIndex = DESCRIPTOR_HANDLE_INVALID;
+}
+
+// Recreates the tile data buffer on the render thread with room for the given number of tiles per layer.
+static void runGrowTileData(void *pData) {
+	const uint32_t newLayerTileCapacity = *(const uint32_t *)pData;
+	if (newLayerTileCapacity <= bufferLayerTileCapacity) {
+		return;
+	}
+
+	// Every frame in flight may still read any slot, so wait until the last of them is done before replacing the buffer.
+	uint64_t lastReadValues[MAX_NUM_FRAMES_IN_FLIGHT] = { };
+	for (uint32_t i = 0; i < ROOM_TILEMAP_SLOT_COUNT; ++i) {
+		for (uint32_t j = 0; j < frame_array.num_frames; ++j) {
+			if (readValues[i][j] > lastReadValues[j]) {
+				lastReadValues[j] = readValues[i][j];
+			}
+		}
+	}
+	waitForFrameReads(lastReadValues);
+
+	const uint32_t oldLayerTileCapacity = bufferLayerTileCapacity;
+	bufferReturnSubrange(&tileData);
+	deleteBuffer(&bufferTileData);
+	if (!createTileDataBuffer(newLayerTileCapacity) && !createTileDataBuffer(oldLayerTileCapacity)) {
+		logMsg(loggerVulkan, LOG_LEVEL_FATAL, "Growing room tilemap buffer: failed to recreate tile data buffer.");
+		bufferLayerTileCapacity = 0;
+		bufferSlotTileCapacity = 0;
+		atomic_store(&keptLayerTileCapacity, 0);
+		atomic_store(&failedLayerTileCapacity, newLayerTileCapacity);
+		return;
+	}
+	updateStorageBuffer2(tilemapDevice, tileDataHandle, tileData);
+	memset(readValues, 0, sizeof(readValues));
+
+	if (bufferLayerTileCapacity < newLayerTileCapacity) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Growing room tilemap buffer: failed to grow tile data buffer to %u tiles per layer.", newLayerTileCapacity);
+		atomic_store(&keptLayerTileCapacity, bufferLayerTileCapacity);
+		atomic_store(&failedLayerTileCapacity, newLayerTileCapacity);
+		return;
+	}
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Grew room tilemap buffer to %u tiles per layer.", bufferLayerTileCapacity);
+}
+
+bool roomTilemapReserve(const Extent roomExtent) {
+	if (tileDataHandle == DESCRIPTOR_HANDLE_INVALID) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Reserving room tilemaps: tile data buffer does not exist.");
+		return false;
+	}
+	syncLayerTileCapacity();
+
+	const uint64_t roomTileCount = extentArea(roomExtent);
+	if (roomTileCount <= layerTileCapacity) {
+		return true;
+	} else if (roomTileCount > UINT32_MAX / (ROOM_TILEMAP_SLOT_COUNT * NUM_ROOM_LAYERS * sizeof(uint32_t))) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Reserving room tilemaps: room extent (%u, %u) is too large.", roomExtent.width, roomExtent.length);
+		return false;
+	}
+
+	uint32_t *const pNewLayerTileCapacity = heapAlloc(1, sizeof(uint32_t));
+	if (!pNewLayerTileCapacity) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Reserving room tilemaps: failed to allocate grow task.");
+		return false;
+	}
+	*pNewLayerTileCapacity = (uint32_t)roomTileCount;
+	if (!pushRenderTask(runGrowTileData, pNewLayerTileCapacity)) {
+		return false;
+	}
+
+	// The slots are laid out for the new capacity from here on; the buffer follows once the render thread grows it.
+	layerTileCapacity = (uint32_t)roomTileCount;
+	slotTileCapacity = NUM_ROOM_LAYERS * layerTileCapacity;
+	clearSlots();
+	return true;
+}
+
+// The tile indices of a room to write into a slot on the render thread; the layers are stored one after another after the struct.
+typedef struct TilemapWrite {
+	uint32_t slot;
+	
+	// The capacity per layer that the slots were laid out for when the write was queued.
+	uint32_t layerTileCapacity;
+	
+	uint32_t layerTileCount;
+	uint32_t tileIndices[];
+} TilemapWrite;
+
+static void runTilemapWrite(void *pData) {
+	const TilemapWrite *const pWrite = pData;
+	if (pWrite->layerTileCapacity != bufferLayerTileCapacity || !bufferTileData) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Writing room tilemap: slot %u was laid out for %u tiles per layer, but the tile data buffer has %u.", pWrite->slot, pWrite->layerTileCapacity, bufferLayerTileCapacity);
+		return;
+	}
+
+	// The slot may still be read by frames in flight, so wait only for the frames that last drew it.
+	waitForFrameReads(readValues[pWrite->slot]);
+
+	const VkDeviceSize layerSize = pWrite->layerTileCount * sizeof(uint32_t);
+	for (uint32_t layer = 0; layer < NUM_ROOM_LAYERS; ++layer) {
+		const VkDeviceSize layerOffset = ((VkDeviceSize)pWrite->slot * bufferSlotTileCapacity + layer * bufferLayerTileCapacity) * sizeof(uint32_t);
+		bufferHostTransfer(tileData, layerOffset, layerSize, &pWrite->tileIndices[layer * pWrite->layerTileCount]);
+	}
+}
+
+bool roomTilemapUpload(const uint32_t slot, const int32_t tilesetTextureHandle, const Extent roomExtent, uint32_t **ppTileIndices) {
+	syncLayerTileCapacity();
+	if (slot >= ROOM_TILEMAP_SLOT_COUNT) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Uploading room tilemap: slot %u is out of range (must be less than %u).", slot, ROOM_TILEMAP_SLOT_COUNT);
+		return false;
+	} else if (!ppTileIndices) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Uploading room tilemap: pointer to tile index arrays is null.");
+		return false;
+	} else if (extentArea(roomExtent) > layerTileCapacity) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Uploading room tilemap: room extent (%u, %u) has more than the %u tiles reserved per layer.", roomExtent.width, roomExtent.length, layerTileCapacity);
+		return false;
+	} else if (!validateTextureHandle(tilesetTextureHandle)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Uploading room tilemap: tileset texture handle %i is invalid.", tilesetTextureHandle);
+		return false;
+	} else if (tileDataHandle == DESCRIPTOR_HANDLE_INVALID) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Uploading room tilemap: tile data buffer does not exist.");
+		return false;
+	}
+
+	if (tilesetTextureHandle != lastTilesetTextureHandle) {
+		const Texture tilesetTexture = getTexture(tilesetTextureHandle);
+		if (!tilesetTexture.isTilemap) {
+			logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Uploading room tilemap: texture %i is not a tilemap.", tilesetTextureHandle);
+			return false;
+		}
+		lastTilesetImageIndex = uploadStorageImage(tilemapDevice, tilesetTexture.image);
+		lastTilesetTextureHandle = tilesetTextureHandle;
+	}
+
+	// The tile indices are copied, since the write happens on the render thread once the slot is no longer read.
+	const uint32_t layerTileCount = extentArea(roomExtent);
+	TilemapWrite *const pWrite = heapAlloc(1, sizeof(TilemapWrite) + (size_t)NUM_ROOM_LAYERS * layerTileCount * sizeof(uint32_t));
+	if (!pWrite) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Uploading room tilemap: failed to allocate write task.");
+		return false;
+	}
+	pWrite->slot = slot;
+	pWrite->layerTileCapacity = layerTileCapacity;
+	pWrite->layerTileCount = layerTileCount;
+	for (uint32_t layer = 0; layer < NUM_ROOM_LAYERS; ++layer) {
+		memcpy(&pWrite->tileIndices[layer * layerTileCount], ppTileIndices[layer], layerTileCount * sizeof(uint32_t));
+	}
+	if (!pushRenderTask(runTilemapWrite, pWrite)) {
+		return false;
+	}
+
+	slots[slot].tilesetTextureHandle = tilesetTextureHandle;
+	slots[slot].tilesetImageIndex = lastTilesetImageIndex;
+	slots[slot].roomExtent = roomExtent;
+
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Queued room tilemap upload into slot %u (%u tiles per layer).", slot, layerTileCount);
+	return true;
+}
+
+ModelTilemap roomTilemapGetLayer(const uint32_t slot, const uint32_t layer) {
+	syncLayerTileCapacity();
+	if (slot >= ROOM_TILEMAP_SLOT_COUNT || layer >= NUM_ROOM_LAYERS) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Getting room tilemap layer: slot %u or layer %u is out of range.", slot, layer);
+		return (ModelTilemap){ .tilesetImageIndex = DESCRIPTOR_HANDLE_INVALID };
+	}
+
+	return (ModelTilemap){
+		.tilesetImageIndex = slots[slot].tilesetImageIndex,
+		.tileDataBufferIndex = tileDataHandle,
+		.tileDataOffset = slot * slotTileCapacity + layer * layerTileCapacity,
+		.width = slots[slot].roomExtent.width,
+		.length = slots[slot].roomExtent.length
+	};
+}
+
+void roomTilemapMarkRead(const ModelTilemap tilemap, const uint32_t frameIndex, const uint64_t renderFinishedValue) {
+	if (tilemap.tileDataBufferIndex != tileDataHandle || bufferSlotTileCapacity == 0 || frameIndex >= MAX_NUM_FRAMES_IN_FLIGHT) {
+		return;
+	}
+
+	const uint32_t slot = tilemap.tileDataOffset / bufferSlotTileCapacity;
+	if (slot < ROOM_TILEMAP_SLOT_COUNT) {
+		readValues[slot][frameIndex] = renderFinishedValue;
+	}
+}
@@ -0,0 +1,40 @@
+#ifndef ROOM_TILEMAP_H
+#define ROOM_TILEMAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+#include "math/extent.h"
+
+#include "Draw.h"
+
+// The number of rooms whose tile indices can be uploaded at once.
+#define ROOM_TILEMAP_SLOT_COUNT 4
+
+extern const uint32_t roomTilemapSlotCount;
+
+// Creates the buffer that holds the tile indices of each room slot; it starts out empty until rooms are reserved.
+void initRoomTilemaps(const VkDevice vkDevice);
+
+void terminateRoomTilemaps(void);
+
+// Makes room in each slot for rooms of the given extent, queueing the tile data buffer to grow on the render thread if necessary.
+// Growing the buffer waits for frames in flight to finish reading it, and empties every slot.
+// If the render thread fails to grow the buffer, the slots are laid out for the buffer it kept again, and larger rooms fail to upload.
+// Returns true if successful, false otherwise.
+bool roomTilemapReserve(const Extent roomExtent);
+
+// Queues the tile indices of each layer of a room to be written into a slot on the render thread, replacing the room previously in that slot.
+// The write waits for frames in flight to finish reading the slot. Returns true if the upload was queued, false otherwise.
+bool roomTilemapUpload(const uint32_t slot, const int32_t tilesetTextureHandle, const Extent roomExtent, uint32_t **ppTileIndices);
+
+// Returns the parameters with which a model draws one layer of the room in a slot.
+ModelTilemap roomTilemapGetLayer(const uint32_t slot, const uint32_t layer);
+
+// Records on the render thread that a frame reads a tilemap until its render-finished semaphore reaches renderFinishedValue,
+// 	so that the tilemap's slot is not overwritten before then.
+void roomTilemapMarkRead(const ModelTilemap tilemap, const uint32_t frameIndex, const uint64_t renderFinishedValue);
+
+#endif	// ROOM_TILEMAP_H
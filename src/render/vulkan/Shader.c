@@ -1,69 +1,94 @@
 #include "Shader.h"
 
-#include <assert.h>
 #include <stdio.h>
 #include <string.h>
-#include "config.h"
 #include "log/Logger.h"
 #include "util/Allocation.h"
+#include "util/VirtualFileSystem.h"
 
-#define SHADER_DIRECTORY (RESOURCE_PATH "shaders/")
+#define SHADER_DIRECTORY "shaders/"
 
-static const char shaderEntrypoint[] = "main";
+// The first word of every SPIR-V module, and the same word as seen from a host of the other byte order.
+#define SPIRV_MAGIC				0x07230203U
+#define SPIRV_MAGIC_SWAPPED		0x03022307U
 
-typedef struct ShaderBytecode {
-	uint32_t bytecode_size;
-	uint8_t *bytecode;
-} ShaderBytecode;
+// A SPIR-V module starts with a five-word header: magic, version, generator, bound, and schema.
+#define SPIRV_HEADER_WORD_COUNT	5
 
-static const char *shader_directory = SHADER_DIRECTORY;
-static const uint32_t initial_buffer_size = 16384;
+static const char shaderEntrypoint[] = "main";
 
-static ShaderBytecode read_shader_file(const char *const pPath) {
-	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Reading shader file at \"%s\"...", pPath);
+typedef struct ShaderBytecode {
 	
-	ShaderBytecode shader_bytecode = {
-		.bytecode_size = 0,
-		.bytecode = nullptr
-	};
+	// Size of the bytecode in bytes, always a multiple of four.
+	size_t codeSize;
+	const uint32_t *pCode;
 	
-	if (!pPath) {
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reading shader file: pointer to pPath string is null.");
-		return shader_bytecode;
+	// The file that the bytecode was read from.
+	VFSFile file;
+	
+	// A copy of the bytecode converted to host byte order, or null if the file's contents are used directly.
+	uint32_t *pSwappedCode;
+	
+} ShaderBytecode;
+
+// Checks that bytecode is a whole number of words and starts with a SPIR-V header.
+// Returns true if the bytecode is usable, false otherwise.
+static bool validateShaderBytecode(const char *const pName, const size_t codeSize, const uint32_t *const pCode) {
+	if (codeSize % sizeof(uint32_t) != 0 || codeSize < SPIRV_HEADER_WORD_COUNT * sizeof(uint32_t)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Validating shader \"%s\": size (%zu bytes) is not a whole number of words, or is too small for a SPIR-V header.", pName, codeSize);
+		return false;
+	} else if (pCode[0] != SPIRV_MAGIC) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Validating shader \"%s\": bytecode does not start with the SPIR-V magic number (found 0x%08X).", pName, pCode[0]);
+		return false;
 	}
+	return true;
+}
 
-	FILE *file = fopen(pPath, "rb");
-	if (!file) {
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reading shader file: could not open file \"%s\".", pPath);
-		return shader_bytecode;
+static void destroyShaderBytecode(ShaderBytecode *const pShaderBytecode) {
+	vfsCloseFile(&pShaderBytecode->file);
+	if (pShaderBytecode->pSwappedCode) {
+		heapFree(pShaderBytecode->pSwappedCode);
 	}
+	*pShaderBytecode = (ShaderBytecode){ };
+}
+
+// Reads a whole SPIR-V file with a single read, from the resource archive or the shader directory.
+static ShaderBytecode readShaderFile(const char *const pPath) {
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Reading shader file at \"%s\"...", pPath);
 	
-	while (fgetc(file) != EOF) {
-		++shader_bytecode.bytecode_size;
+	ShaderBytecode shaderBytecode = { };
+	if (!vfsReadFile(pPath, &shaderBytecode.file) || !shaderBytecode.file.pData) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reading shader file: could not read \"%s\".", pPath);
+		destroyShaderBytecode(&shaderBytecode);
+		return (ShaderBytecode){ };
 	}
 	
-	shader_bytecode.bytecode = heapAlloc(initial_buffer_size, sizeof(uint8_t));
-	if (!shader_bytecode.bytecode) {
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reading shader file: failed to allocate buffer for shader bytecode.");
-		fclose(file);
-		return shader_bytecode;
+	// Resource files are read into buffers aligned for any type, so the contents can be read as words directly.
+	shaderBytecode.codeSize = shaderBytecode.file.size;
+	shaderBytecode.pCode = shaderBytecode.file.pData;
+	
+	// SPIR-V may be written in either byte order; Vulkan takes it in the host's.
+	if (shaderBytecode.codeSize % sizeof(uint32_t) == 0 && shaderBytecode.codeSize > 0 && shaderBytecode.pCode[0] == SPIRV_MAGIC_SWAPPED) {
+		logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Reading shader file: converting \"%s\" to host byte order.", pPath);
+		const size_t wordCount = shaderBytecode.codeSize / sizeof(uint32_t);
+		shaderBytecode.pSwappedCode = heapAlloc(wordCount, sizeof(uint32_t));
+		if (!shaderBytecode.pSwappedCode) {
+			logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reading shader file: failed to allocate %zu bytes for shader bytecode.", shaderBytecode.codeSize);
+			destroyShaderBytecode(&shaderBytecode);
+			return (ShaderBytecode){ };
+		}
+		for (size_t i = 0; i < wordCount; ++i) {
+			const uint32_t word = shaderBytecode.pCode[i];
+			shaderBytecode.pSwappedCode[i] = (word >> 24) | ((word >> 8) & 0xFF00U) | ((word << 8) & 0xFF0000U) | (word << 24);
+		}
+		shaderBytecode.pCode = shaderBytecode.pSwappedCode;
 	}
 	
-	uint32_t fileSize = 0;
-	rewind(file);
-	int c;
-	while ((c = fgetc(file)) != EOF) {
-		shader_bytecode.bytecode[fileSize++] = (unsigned char)c;
+	if (!validateShaderBytecode(pPath, shaderBytecode.codeSize, shaderBytecode.pCode)) {
+		destroyShaderBytecode(&shaderBytecode);
+		return (ShaderBytecode){ };
 	}
-
-	fclose(file);
-	return shader_bytecode;
-}
-
-static void destroy_shader_bytecode(ShaderBytecode *const pShaderBytecode) {
-	assert(pShaderBytecode);
-	pShaderBytecode->bytecode = heapFree(pShaderBytecode->bytecode);
-	pShaderBytecode->bytecode_size = 0;
+	return shaderBytecode;
 }
 
 ShaderModule createShaderModule(const VkDevice vkDevice, const ShaderStage shaderStage, const char *const pFilename) {
@@ -83,16 +108,14 @@ ShaderModule createShaderModule(const VkDevice vkDevice, const ShaderStage shade
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Loading shader source \"%s\"...", pFilename);
 
 	char path[256];
-	memset(path, '\0', 256);
-
-	// Length does not include null-terminator.
-	const size_t filename_length = strlen(pFilename); // Limit to 64 characters.
-	const size_t shader_directory_length = strlen(SHADER_DIRECTORY); // Limit to 256 - 64 - 1 characters, to make room for pFilename and for null-terminator.
-	strncpy(path, shader_directory, shader_directory_length);
-	strncat(path, pFilename, filename_length);
+	const int pathLength = snprintf(path, sizeof(path), "%s%s", SHADER_DIRECTORY, pFilename);
+	if (pathLength < 0 || (size_t)pathLength >= sizeof(path)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error creating shader module: path to shader \"%s\" is too long.", pFilename);
+		return shaderModule;
+	}
 
-	ShaderBytecode shader_bytecode = read_shader_file(path);
-	if (!shader_bytecode.bytecode) {
+	ShaderBytecode shaderBytecode = readShaderFile(path);
+	if (!shaderBytecode.pCode) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error creating shader module: shader file reading failed.");
 		return shaderModule;
 	}
@@ -101,18 +124,18 @@ ShaderModule createShaderModule(const VkDevice vkDevice, const ShaderStage shade
 		.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
 		.pNext = nullptr,
 		.flags = 0,
-		.codeSize = shader_bytecode.bytecode_size,
-		.pCode = (uint32_t *)shader_bytecode.bytecode
+		.codeSize = shaderBytecode.codeSize,
+		.pCode = shaderBytecode.pCode
 	};
 
 	const VkResult result = vkCreateShaderModule(vkDevice, &create_info, nullptr, &shaderModule.vkShaderModule);
+	destroyShaderBytecode(&shaderBytecode);
 	if (result != VK_SUCCESS) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error creating shader module: shader module creation failed (error code: %i).", result);
 		return shaderModule;
 	}
 	shaderModule.vkDevice = vkDevice;
 
-	destroy_shader_bytecode(&shader_bytecode);
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Created shader module.");
 	return shaderModule;
 }
@@ -26,6 +26,7 @@ typedef struct ShaderModule {
 	
 } ShaderModule;
 
+// Creates a shader module from a SPIR-V file in the shader directory, which is read through the virtual file system.
 ShaderModule createShaderModule(const VkDevice vkDevice, const ShaderStage shaderStage, const char *const pFilename);
 
 bool destroyShaderModule(ShaderModule *const pShaderModule);
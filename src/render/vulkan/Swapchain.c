@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include "log/Logger.h"
+#include "render/render_config.h"
 #include "util/Allocation.h"
 #include "VulkanManager.h"
 
@@ -9,7 +10,7 @@
 
 static VkSurfaceFormatKHR selectSurfaceFormat(const SwapchainSupportDetails swapchainSupportDetails);
 
-static VkPresentModeKHR selectPresentMode(const SwapchainSupportDetails swapchainSupportDetails);
+static VkPresentModeKHR selectPresentMode(const SwapchainSupportDetails swapchainSupportDetails, const PresentMode requestedPresentMode);
 
 static VkExtent2D selectExtent(const SwapchainSupportDetails swapchainSupportDetails, GLFWwindow *const pWindow);
 
@@ -19,11 +20,15 @@ Swapchain createSwapchain(GLFWwindow *const pWindow, const WindowSurface windowS
 	Swapchain swapchain = { };
 
 	VkSurfaceFormatKHR surface_format = selectSurfaceFormat(physicalDevice.swapchainSupportDetails);
-	VkPresentModeKHR present_mode = selectPresentMode(physicalDevice.swapchainSupportDetails);
+	VkPresentModeKHR present_mode = selectPresentMode(physicalDevice.swapchainSupportDetails, getPresentMode());
 	swapchain.imageExtent = selectExtent(physicalDevice.swapchainSupportDetails, pWindow);
 
 	// Requested number of images in swapchain.
+	// At least one image per frame in flight is requested, so that no frame has to wait for another to be presented.
 	uint32_t imageCount = physicalDevice.swapchainSupportDetails.capabilities.minImageCount + 1;
+	if (imageCount < getNumFramesInFlight()) {
+		imageCount = getNumFramesInFlight();
+	}
 	if (physicalDevice.swapchainSupportDetails.capabilities.maxImageCount > 0 && imageCount > physicalDevice.swapchainSupportDetails.capabilities.maxImageCount) {
 		imageCount = physicalDevice.swapchainSupportDetails.capabilities.maxImageCount;
 	}
@@ -185,14 +190,31 @@ static VkSurfaceFormatKHR selectSurfaceFormat(const SwapchainSupportDetails swap
 	};
 }
 
-static VkPresentModeKHR selectPresentMode(const SwapchainSupportDetails swapchainSupportDetails) {
+static VkPresentModeKHR selectPresentMode(const SwapchainSupportDetails swapchainSupportDetails, const PresentMode requestedPresentMode) {
+	
+	static const VkPresentModeKHR vkPresentModes[4] = {
+		[PRESENT_MODE_FIFO] = VK_PRESENT_MODE_FIFO_KHR,
+		[PRESENT_MODE_FIFO_RELAXED] = VK_PRESENT_MODE_FIFO_RELAXED_KHR,
+		[PRESENT_MODE_MAILBOX] = VK_PRESENT_MODE_MAILBOX_KHR,
+		[PRESENT_MODE_IMMEDIATE] = VK_PRESENT_MODE_IMMEDIATE_KHR
+	};
 	
+	if ((uint32_t)requestedPresentMode >= 4) {
+		logMsg(loggerVulkan, LOG_LEVEL_WARNING, "Creating swapchain: invalid present mode %i requested, defaulting to FIFO.", (int)requestedPresentMode);
+		return VK_PRESENT_MODE_FIFO_KHR;
+	}
+	
+	const VkPresentModeKHR requestedVkPresentMode = vkPresentModes[requestedPresentMode];
 	for (size_t i = 0; i < swapchainSupportDetails.num_present_modes; ++i) {
 		VkPresentModeKHR present_mode = swapchainSupportDetails.present_modes[i];
-		if (present_mode == VK_PRESENT_MODE_MAILBOX_KHR)
+		if (present_mode == requestedVkPresentMode) {
+			logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Creating swapchain: using present mode \"%s\".", presentModeName(requestedPresentMode));
 			return present_mode;
+		}
 	}
 
+	// FIFO is guaranteed to be supported.
+	logMsg(loggerVulkan, LOG_LEVEL_WARNING, "Creating swapchain: present mode \"%s\" not supported, defaulting to FIFO.", presentModeName(requestedPresentMode));
 	return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -0,0 +1,392 @@
+#include "TextRenderer.h"
+
+#include <pthread.h>
+#include <string.h>
+#include "log/Logger.h"
+#include "render/render_config.h"
+#include "util/Allocation.h"
+#include "Buffer2.h"
+#include "Descriptor.h"
+#include "GraphicsPipeline.h"
+#include "texture_manager.h"
+#include "VulkanManager.h"
+
+// The distance between the centers of two consecutive glyphs.
+#define GLYPH_ADVANCE 0.5F
+
+// Number of vertices generated by the vertex shader for each glyph quad.
+#define GLYPH_VERTEX_COUNT 6
+
+const int32_t textObjectMaxCount = TEXT_OBJECT_MAX_COUNT;
+
+// Matches the GlyphInstance struct in the text vertex shader (scalar layout).
+typedef struct GlyphInstance {
+	float position[3];
+	uint32_t glyphIndex;
+	Vector4F color;
+} GlyphInstance;
+
+typedef struct TextObject {
+
+	// True if this text object is loaded.
+	bool active;
+
+	Vector4F position;
+	Vector4F color;
+
+	// Image indices into the font texture, one for each character.
+	uint32_t glyphCount;
+	uint32_t glyphCapacity;
+	uint32_t *pGlyphIndices;
+
+} TextObject;
+
+// The range of glyph instances of a single text object inside a frame's glyph buffer.
+typedef struct TextDraw {
+	uint32_t firstGlyph;
+	uint32_t glyphCount;
+} TextDraw;
+
+// Text objects are written by the simulation thread and packed by the render thread; both hold this lock while touching them.
+static pthread_mutex_t textMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static TextObject textObjects[TEXT_OBJECT_MAX_COUNT];
+
+static GraphicsPipeline textPipeline = { };
+
+static uint32_t numFrames = 0;
+
+// One subrange of glyph instances per frame in flight.
+static Buffer bufferGlyphData = nullptr;
+static BufferSubrange glyphBuffers[MAX_NUM_FRAMES_IN_FLIGHT];
+static uint32_t glyphBufferHandles[MAX_NUM_FRAMES_IN_FLIGHT];
+
+// Bit i is set if the glyph buffer of frame i must be repacked before it is drawn.
+static uint32_t staleFrameMask = 0;
+
+// The draw ranges packed into each frame's glyph buffer.
+static uint32_t textDrawCounts[MAX_NUM_FRAMES_IN_FLIGHT];
+static TextDraw textDraws[MAX_NUM_FRAMES_IN_FLIGHT][TEXT_OBJECT_MAX_COUNT];
+
+// The font image that each frame's glyph buffer was packed for, only used on the render thread.
+static uint32_t textFrameImageHandles[MAX_NUM_FRAMES_IN_FLIGHT];
+
+static int32_t fontTextureHandle = 0;
+static uint32_t fontImageHandle = DESCRIPTOR_HANDLE_INVALID;
+static uint32_t fontFirstCell = 0;
+
+static void markAllFramesStale(void) {
+	staleFrameMask = (1U << numFrames) - 1U;
+}
+
+static GraphicsPipeline createTextPipeline(const VkDevice vkDevice, const Swapchain swapchain) {
+	ShaderModule vertexShaderModule = createShaderModule(vkDevice, SHADER_STAGE_VERTEX, "VertexShaderText.spv");
+	ShaderModule fragmentShaderModule = createShaderModule(vkDevice, SHADER_STAGE_FRAGMENT, "FragmentShaderText.spv");
+
+	const GraphicsPipelineCreateInfo pipelineCreateInfo = {
+		.vkDevice = vkDevice,
+		.swapchain = swapchain,
+		.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+		.polygonMode = VK_POLYGON_MODE_FILL,
+		.vertexAttributeFlags = 0,
+		.shaderModuleCount = 2,
+		.pShaderModules = (ShaderModule[2]){ vertexShaderModule, fragmentShaderModule },
+		.pushConstantRangeCount = 1,
+		.pPushConstantRanges = (PushConstantRange[1]){
+			{
+				.shaderStageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+				.size = 3 * sizeof(uint32_t)
+			}
+		}
+	};
+	const GraphicsPipeline pipeline = createGraphicsPipeline(pipelineCreateInfo);
+
+	destroyShaderModule(&vertexShaderModule);
+	destroyShaderModule(&fragmentShaderModule);
+	return pipeline;
+}
+
+void initTextRenderer(const VkDevice vkDevice, const Swapchain swapchain, const uint32_t numFramesInFlight) {
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing text renderer...");
+
+	numFrames = numFramesInFlight;
+
+	textPipeline = createTextPipeline(vkDevice, swapchain);
+
+	VkDeviceSize subrangeSizes[MAX_NUM_FRAMES_IN_FLIGHT];
+	for (uint32_t i = 0; i < numFrames; ++i) {
+		subrangeSizes[i] = TEXT_GLYPH_MAX_COUNT * sizeof(GlyphInstance);
+	}
+
+	const BufferCreateInfo bufferCreateInfo = {
+		.physicalDevice = physical_device,
+		.vkDevice = vkDevice,
+		.bufferType = BUFFER_TYPE_STREAMING,
+		.memoryTypeIndexSet = memory_type_set,
+		.queueFamilyIndexCount = 0,
+		.pQueueFamilyIndices = nullptr,
+		.subrangeCount = numFrames,
+		.pSubrangeSizes = subrangeSizes
+	};
+	createBuffer(bufferCreateInfo, &bufferGlyphData);
+	if (!bufferGlyphData) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Initializing text renderer: failed to create glyph buffer.");
+		return;
+	}
+
+	for (uint32_t i = 0; i < numFrames; ++i) {
+		bufferBorrowSubrange(bufferGlyphData, (int32_t)i, &glyphBuffers[i]);
+		glyphBufferHandles[i] = uploadStorageBuffer2(vkDevice, glyphBuffers[i]);
+		textDrawCounts[i] = 0;
+		textFrameImageHandles[i] = DESCRIPTOR_HANDLE_INVALID;
+	}
+	markAllFramesStale();
+
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initialized text renderer.");
+}
+
+void terminateTextRenderer(void) {
+	for (int32_t i = 0; i < TEXT_OBJECT_MAX_COUNT; ++i) {
+		int32_t handle = i;
+		if (textExists(handle)) {
+			unloadText(&handle);
+		}
+	}
+
+	if (bufferGlyphData) {
+		for (uint32_t i = 0; i < numFrames; ++i) {
+			bufferReturnSubrange(&glyphBuffers[i]);
+		}
+		deleteBuffer(&bufferGlyphData);
+	}
+	deleteGraphicsPipeline(&textPipeline);
+	numFrames = 0;
+}
+
+bool reloadTextRenderer(const VkDevice vkDevice, const Swapchain swapchain) {
+	GraphicsPipeline pipeline = createTextPipeline(vkDevice, swapchain);
+	if (!validateGraphicsPipeline(pipeline)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Reloading text renderer: failed to create pipeline, keeping the previous one.");
+		return false;
+	}
+	deleteGraphicsPipeline(&textPipeline);
+	textPipeline = pipeline;
+	return true;
+}
+
+void textRendererSetFont(const int32_t textureHandle) {
+	if (!validateTextureHandle(textureHandle)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Setting text renderer font: texture handle %i is invalid.", textureHandle);
+		return;
+	}
+
+	const Texture texture = getTexture(textureHandle);
+	const uint32_t imageHandle = uploadSampledImage(device, texture.image);
+	pthread_mutex_lock(&textMutex);
+	fontTextureHandle = textureHandle;
+	fontImageHandle = imageHandle;
+	fontFirstCell = texture.numAnimations > 0 ? texture.animations[0].startCell : 0;
+	markAllFramesStale();
+	pthread_mutex_unlock(&textMutex);
+}
+
+static bool textObjectExists(const int32_t handle) {
+	return handle >= 0 && handle < TEXT_OBJECT_MAX_COUNT && textObjects[handle].active;
+}
+
+static void writeText(const int32_t handle, const uint32_t length, const char *const pText) {
+	if (!textObjectExists(handle)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Writing text: text object %i does not exist.", handle);
+		return;
+	} else if (length > 0 && !pText) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Writing text: text is null.");
+		return;
+	}
+
+	TextObject *const pTextObject = &textObjects[handle];
+	if (length > pTextObject->glyphCapacity) {
+		uint32_t *const pRealloc = heapRealloc(pTextObject->pGlyphIndices, length, sizeof(uint32_t));
+		if (!pRealloc) {
+			logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Writing text: failed to reallocate glyph array.");
+			return;
+		}
+		pTextObject->pGlyphIndices = pRealloc;
+		pTextObject->glyphCapacity = length;
+	}
+
+	// Only repack the glyph buffers if the text actually changed.
+	bool changed = length != pTextObject->glyphCount;
+	for (uint32_t i = 0; i < length; ++i) {
+		const uint32_t glyphIndex = (uint32_t)(unsigned char)pText[i];
+		changed = changed || pTextObject->pGlyphIndices[i] != glyphIndex;
+		pTextObject->pGlyphIndices[i] = glyphIndex;
+	}
+	pTextObject->glyphCount = length;
+
+	if (changed) {
+		markAllFramesStale();
+	}
+}
+
+int32_t loadText(const TextLoadInfo loadInfo) {
+
+	pthread_mutex_lock(&textMutex);
+	int32_t handle = -1;
+	for (int32_t i = 0; i < TEXT_OBJECT_MAX_COUNT; ++i) {
+		if (!textObjects[i].active) {
+			handle = i;
+			break;
+		}
+	}
+	if (handle < 0) {
+		pthread_mutex_unlock(&textMutex);
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Loading text: no text object slots available.");
+		return -1;
+	}
+
+	textObjects[handle] = (TextObject){
+		.active = true,
+		.position = loadInfo.position,
+		.color = loadInfo.color,
+		.glyphCount = 0,
+		.glyphCapacity = 0,
+		.pGlyphIndices = nullptr
+	};
+	writeText(handle, loadInfo.length, loadInfo.pText);
+	pthread_mutex_unlock(&textMutex);
+
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Loaded text object %i.", handle);
+	return handle;
+}
+
+void unloadText(int32_t *const pHandle) {
+	if (!pHandle) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Unloading text: pointer to text handle is null.");
+		return;
+	}
+	
+	pthread_mutex_lock(&textMutex);
+	if (!textObjectExists(*pHandle)) {
+		pthread_mutex_unlock(&textMutex);
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Unloading text: text object %i does not exist.", *pHandle);
+		return;
+	}
+
+	TextObject *const pTextObject = &textObjects[*pHandle];
+	if (pTextObject->pGlyphIndices) {
+		heapFree(pTextObject->pGlyphIndices);
+	}
+	*pTextObject = (TextObject){ };
+	markAllFramesStale();
+	pthread_mutex_unlock(&textMutex);
+
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Unloaded text object %i.", *pHandle);
+	*pHandle = -1;
+}
+
+bool textExists(const int32_t handle) {
+	pthread_mutex_lock(&textMutex);
+	const bool exists = textObjectExists(handle);
+	pthread_mutex_unlock(&textMutex);
+	return exists;
+}
+
+void textWrite(const int32_t handle, const uint32_t length, const char *const pText) {
+	pthread_mutex_lock(&textMutex);
+	writeText(handle, length, pText);
+	pthread_mutex_unlock(&textMutex);
+}
+
+void textRendererUpdateFrame(const uint32_t frameIndex) {
+	if (frameIndex >= numFrames) {
+		return;
+	}
+	
+	pthread_mutex_lock(&textMutex);
+	if (!(staleFrameMask & (1U << frameIndex))) {
+		pthread_mutex_unlock(&textMutex);
+		return;
+	}
+
+	GlyphInstance *const pGlyphs = heapAlloc(TEXT_GLYPH_MAX_COUNT, sizeof(GlyphInstance));
+	if (!pGlyphs) {
+		pthread_mutex_unlock(&textMutex);
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Updating text glyphs: failed to allocate glyph instance array.");
+		return;
+	}
+
+	uint32_t glyphCount = 0;
+	uint32_t drawCount = 0;
+	for (int32_t handle = 0; handle < TEXT_OBJECT_MAX_COUNT; ++handle) {
+		const TextObject textObject = textObjects[handle];
+		if (!textObject.active || textObject.glyphCount == 0) {
+			continue;
+		}
+
+		uint32_t textGlyphCount = textObject.glyphCount;
+		if (glyphCount + textGlyphCount > TEXT_GLYPH_MAX_COUNT) {
+			logMsg(loggerVulkan, LOG_LEVEL_WARNING, "Updating text glyphs: glyph limit (%u) exceeded, truncating text object %i.", TEXT_GLYPH_MAX_COUNT, handle);
+			textGlyphCount = TEXT_GLYPH_MAX_COUNT - glyphCount;
+		}
+
+		for (uint32_t i = 0; i < textGlyphCount; ++i) {
+			pGlyphs[glyphCount + i] = (GlyphInstance){
+				.position = {
+					textObject.position.x + GLYPH_ADVANCE * (float)i,
+					textObject.position.y,
+					textObject.position.z
+				},
+				.glyphIndex = fontFirstCell + textObject.pGlyphIndices[i],
+				.color = textObject.color
+			};
+		}
+
+		textDraws[frameIndex][drawCount++] = (TextDraw){
+			.firstGlyph = glyphCount,
+			.glyphCount = textGlyphCount
+		};
+		glyphCount += textGlyphCount;
+		if (glyphCount >= TEXT_GLYPH_MAX_COUNT) {
+			break;
+		}
+	}
+
+	textDrawCounts[frameIndex] = drawCount;
+	staleFrameMask &= ~(1U << frameIndex);
+	const uint32_t imageHandle = fontImageHandle;
+	pthread_mutex_unlock(&textMutex);
+	
+	// Only this frame reads its glyph buffer, so it is written outside the lock.
+	if (glyphCount > 0) {
+		bufferHostTransfer(glyphBuffers[frameIndex], 0, glyphCount * sizeof(GlyphInstance), pGlyphs);
+	}
+	heapFree(pGlyphs);
+	textFrameImageHandles[frameIndex] = imageHandle;
+}
+
+void textRendererRecordDraws(const VkCommandBuffer cmdBuf, const uint32_t frameIndex, const uint32_t matrixBufferHandle) {
+	if (frameIndex >= numFrames || textDrawCounts[frameIndex] == 0 || textFrameImageHandles[frameIndex] == DESCRIPTOR_HANDLE_INVALID) {
+		return;
+	}
+
+	vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, textPipeline.vkPipeline);
+
+	// The text pipeline has a different push constant layout, so the descriptor set must be rebound with its layout.
+	vkCmdBindDescriptorSets(cmdBuf,
+			VK_PIPELINE_BIND_POINT_GRAPHICS, textPipeline.vkPipelineLayout,
+			0, 1, &globalDescriptorSet, 0, nullptr);
+
+	const uint32_t pushConstants[3] = {
+		textFrameImageHandles[frameIndex],
+		glyphBufferHandles[frameIndex],
+		matrixBufferHandle
+	};
+	vkCmdPushConstants(cmdBuf,
+			textPipeline.vkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+			0, sizeof(pushConstants), pushConstants);
+
+	// One instanced draw per text object; each instance is one glyph.
+	for (uint32_t i = 0; i < textDrawCounts[frameIndex]; ++i) {
+		vkCmdDraw(cmdBuf, GLYPH_VERTEX_COUNT, textDraws[frameIndex][i].glyphCount, 0, textDraws[frameIndex][i].firstGlyph);
+	}
+}
@@ -0,0 +1,63 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+#include "math/Vector.h"
+
+#include "Swapchain.h"
+
+// The maximum number of text objects that can be loaded at once.
+#define TEXT_OBJECT_MAX_COUNT 32
+
+// The maximum number of glyphs that can be drawn each frame, across all text objects.
+#define TEXT_GLYPH_MAX_COUNT 2048
+
+extern const int32_t textObjectMaxCount;
+
+typedef struct TextLoadInfo {
+
+	// The position of the center of the first glyph, in screen space.
+	Vector4F position;
+
+	Vector4F color;
+
+	// The initial text; does not need to be null-terminated.
+	uint32_t length;
+	const char *pText;
+
+} TextLoadInfo;
+
+// Creates the text pipeline and the per-frame glyph instance buffers.
+void initTextRenderer(const VkDevice vkDevice, const Swapchain swapchain, const uint32_t numFramesInFlight);
+
+void terminateTextRenderer(void);
+
+// Recreates the text pipeline from its shader files, keeping the previous pipeline if that fails; the device must be idle.
+// Returns true if successful, false otherwise.
+bool reloadTextRenderer(const VkDevice vkDevice, const Swapchain swapchain);
+
+// Sets the texture used for all glyphs. Each character code indexes a cell of the texture's first animation.
+void textRendererSetFont(const int32_t textureHandle);
+
+// Loads a text object and returns a handle to it, or -1 if it could not be loaded.
+int32_t loadText(const TextLoadInfo loadInfo);
+
+void unloadText(int32_t *const pHandle);
+
+bool textExists(const int32_t handle);
+
+// Replaces the text of a text object; takes effect the next time each frame in flight is drawn.
+void textWrite(const int32_t handle, const uint32_t length, const char *const pText);
+
+// Packs the glyphs of all loaded text objects into the glyph buffer of the given frame, if that buffer is out of date.
+// Must only be called on the render thread, once the frame's previous submission has finished executing.
+void textRendererUpdateFrame(const uint32_t frameIndex);
+
+// Records one instanced draw per text object; must be called inside a rendering scope.
+void textRendererRecordDraws(const VkCommandBuffer cmdBuf, const uint32_t frameIndex, const uint32_t matrixBufferHandle);
+
+#endif	// TEXT_RENDERER_H
@@ -4,7 +4,6 @@
 
 #include "log/Logger.h"
 #include "util/Allocation.h"
-#include "util/Time.h"
 
 #include "texture.h"
 #include "texture_manager.h"
@@ -16,9 +15,7 @@ TextureState nullTextureState(void) {
 		.numAnimations = 0,
 		.currentAnimation = 0,
 		.numFrames = 0,
-		.currentFPS = 0,
-		.currentFrame = 0,
-		.lastFrameTimeMS = 0
+		.currentFPS = 0
 	};
 }
 
@@ -41,7 +38,6 @@ TextureState newTextureState(const String textureID) {
 	textureState.startCell = texture.animations[textureState.currentAnimation].startCell;
 	textureState.numFrames = texture.animations[textureState.currentAnimation].numFrames;
 	textureState.currentFPS = texture.animations[textureState.currentAnimation].framesPerSecond;
-	textureState.lastFrameTimeMS = getMilliseconds();
 	
 	return textureState;
 }
@@ -60,9 +56,7 @@ TextureState newTextureState2(const int32_t textureHandle) {
 		.currentAnimation = 0,
 		.startCell = texture.animations[0].startCell,
 		.numFrames = texture.animations[0].numFrames,
-		.currentFPS = texture.animations[0].framesPerSecond,
-		.currentFrame = 0,
-		.lastFrameTimeMS = getMilliseconds()
+		.currentFPS = texture.animations[0].framesPerSecond
 	};
 }
 
@@ -80,36 +74,6 @@ bool textureStateSetAnimation(TextureState *const pTextureState, const unsigned
 	pTextureState->startCell = textureAnimation.startCell;
 	pTextureState->numFrames = textureAnimation.numFrames;
 	pTextureState->currentFPS = textureAnimation.framesPerSecond;
-	pTextureState->currentFrame = 0;
-	pTextureState->lastFrameTimeMS = getMilliseconds();
 
 	return true;
 }
-
-int textureStateAnimate(TextureState *const pTextureState) {
-	if (!pTextureState) {
-		return 0;
-	}
-	
-	if (pTextureState->currentFPS == 0) {
-		return 1;
-	}
-	
-	// Calculate the time difference between last frame change for this texture and current time, in seconds.
-	const uint64_t currentTimeMS = getMilliseconds();
-	const uint64_t deltaTimeMS = currentTimeMS - pTextureState->lastFrameTimeMS;
-	const double deltaTimeS = (double)deltaTimeMS / 1000.0;
-
-	// Time in seconds * frames per second = number of frames to increment the frame counter by.
-	const unsigned int frames = (unsigned int)(deltaTimeS * (double)pTextureState->currentFPS);
-
-	// Update the current frame and last frame time of this texture.
-	if (frames > 0) {
-		pTextureState->currentFrame += frames;
-		pTextureState->currentFrame %= pTextureState->numFrames;
-		pTextureState->lastFrameTimeMS = currentTimeMS;
-		return 2;
-	}
-
-	return 1;
-}
@@ -24,12 +24,6 @@ typedef struct TextureState {
 	
 	// FPS (Frames-per-second) of the currently selected animation cycle.
 	unsigned int currentFPS;
-	
-	// Current frame in currently selected animation cycle.
-	unsigned int currentFrame;
-	
-	// Time point in milliseconds of last frame update.
-	unsigned long long int lastFrameTimeMS;
 
 } TextureState;
 
@@ -39,11 +33,7 @@ TextureState newTextureState(const String textureID);
 
 TextureState newTextureState2(const int32_t textureHandle);
 
+// Selects an animation cycle; the current frame itself is derived from the animation clock on the GPU.
 bool textureStateSetAnimation(TextureState *const pTextureState, const unsigned int nextAnimation);
 
-// Returns 0 (false) if an error occurred.
-// Returns 1 (true) if function executed successfully with no frame update.
-// Returns 2 if function executed successfully with frame update.
-int textureStateAnimate(TextureState *const pTextureState);
-
 #endif // TEXTURE_STATE_H
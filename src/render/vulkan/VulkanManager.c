@@ -1,5 +1,6 @@
 #include "VulkanManager.h"
 
+#include <assert.h>
 #include <stdalign.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,21 +9,22 @@
 #include "log/Logger.h"
 #include "glfw/GLFWManager.h"
 #include "render/render_config.h"
+#include "render/RenderTaskQueue.h"
+#include "util/Allocation.h"
 #include "CommandBuffer.h"
 #include "descriptor.h"
 #include "GraphicsPipeline.h"
 #include "logical_device.h"
 #include "queue.h"
+#include "RoomTilemap.h"
 #include "Shader.h"
+#include "TextRenderer.h"
 #include "texture_manager.h"
 #include "vertex_input.h"
+#include "compute/ComputeCullDraws.h"
 #include "compute/ComputeMatrices.h"
 #include "compute/ComputeStitchTexture.h"
 
-/* -- Vulkan Module Configuration -- */
-
-const int vkConfMaxNumQuads = VK_CONF_MAX_NUM_QUADS;
-
 /* -- Vulkan Objects -- */
 
 static VulkanInstance vulkan_instance = { };
@@ -70,12 +72,27 @@ BufferPartition global_storage_buffer_partition;
 
 Buffer bufferDrawInfo = nullptr;
 
+// Per-model animation parameters of the main and debug model pools.
+static Buffer bufferModelAnimations = nullptr;
+
+// Per-model bounds of the main and debug model pools, read by the draw culling pass.
+static Buffer bufferModelBounds = nullptr;
+
+// The visible draws of the main and debug model pools, compacted by the draw culling pass for each frame in flight.
+static Buffer bufferDrawCommands = nullptr;
+static BufferSubrange drawCommandsMain[MAX_NUM_FRAMES_IN_FLIGHT] = { };
+static BufferSubrange drawCommandsDebug[MAX_NUM_FRAMES_IN_FLIGHT] = { };
+static uint32_t drawCommandDescriptorsMain[MAX_NUM_FRAMES_IN_FLIGHT] = { };
+static uint32_t drawCommandDescriptorsDebug[MAX_NUM_FRAMES_IN_FLIGHT] = { };
+
 ModelPool modelPoolMain = nullptr;
 
 ModelPool modelPoolDebug = nullptr;
 
-static uint32_t matricesDescriptorMain = DESCRIPTOR_HANDLE_INVALID;
-static uint32_t matricesDescriptorDebug = DESCRIPTOR_HANDLE_INVALID;
+// Each frame in flight has its own pair of matrix buffers, so that computing matrices for one frame
+// 	does not overwrite the matrices still being read by another frame.
+static uint32_t matricesDescriptorsMain[MAX_NUM_FRAMES_IN_FLIGHT] = { };
+static uint32_t matricesDescriptorsDebug[MAX_NUM_FRAMES_IN_FLIGHT] = { };
 static uint32_t transformBufferDescriptorHandle = DESCRIPTOR_HANDLE_INVALID;
 
 // TEST
@@ -125,9 +142,16 @@ static void create_global_uniform_buffer(void) {
 	global_uniform_buffer_partition = create_buffer_partition(buffer_partition_create_info);
 }
 
-static void create_global_storage_buffer(void) {
+static void create_global_storage_buffer(const uint32_t numFramesInFlight) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Creating global storage buffer...");
 
+	// One partition for main matrices and one for debug matrices, per frame in flight.
+	const uint32_t numPartitions = 2 * numFramesInFlight;
+	VkDeviceSize partitionSizes[2 * MAX_NUM_FRAMES_IN_FLIGHT];
+	for (uint32_t i = 0; i < numPartitions; ++i) {
+		partitionSizes[i] = 32832;
+	}
+
 	const BufferPartitionCreateInfo buffer_partition_create_info = {
 		.physical_device = physical_device.vkPhysicalDevice,
 		.device = device,
@@ -135,19 +159,27 @@ static void create_global_storage_buffer(void) {
 		.memory_type_set = memory_type_set,
 		.num_queue_family_indices = 0,
 		.queue_family_indices = nullptr,
-		.num_partition_sizes = 2,
-		.partition_sizes = (VkDeviceSize[2]){
-			32832,
-			32832
-		}
+		.num_partition_sizes = numPartitions,
+		.partition_sizes = partitionSizes
 	};
 	
 	global_storage_buffer_partition = create_buffer_partition(buffer_partition_create_info);
 }
 
-static void create_global_draw_data_buffer(void) {
+static void create_global_draw_data_buffer(const uint32_t numFramesInFlight) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Creating global draw data buffer...");
 	
+	// The main pool's subranges for each frame in flight come first, followed by the debug pool's.
+	const uint32_t modelDataSubrangeCount = 2 * numFramesInFlight;
+	VkDeviceSize drawInfoSubrangeSizes[2 * MAX_NUM_FRAMES_IN_FLIGHT];
+	VkDeviceSize animationSubrangeSizes[2 * MAX_NUM_FRAMES_IN_FLIGHT];
+	VkDeviceSize boundsSubrangeSizes[2 * MAX_NUM_FRAMES_IN_FLIGHT];
+	for (uint32_t i = 0; i < modelDataSubrangeCount; ++i) {
+		drawInfoSubrangeSizes[i] = 4 + COMPUTE_MATRICES_MODEL_COUNT * drawCommandStride;
+		animationSubrangeSizes[i] = COMPUTE_MATRICES_MODEL_COUNT * modelAnimationStride;
+		boundsSubrangeSizes[i] = COMPUTE_MATRICES_MODEL_COUNT * modelBoundsStride;
+	}
+	
 	const BufferCreateInfo bufferCreateInfo = {
 		.physicalDevice = physical_device,
 		.vkDevice = device,
@@ -155,61 +187,62 @@ static void create_global_draw_data_buffer(void) {
 		.memoryTypeIndexSet = memory_type_set,
 		.queueFamilyIndexCount = 0,
 		.pQueueFamilyIndices = nullptr,
-		.subrangeCount = 2,
-		.pSubrangeSizes = (VkDeviceSize[2]){
-			4 + 256 * drawCommandStride,
-			4 + 256 * drawCommandStride
-		}
+		.subrangeCount = modelDataSubrangeCount,
+		.pSubrangeSizes = drawInfoSubrangeSizes
 	};
 	
 	createBuffer(bufferCreateInfo, &bufferDrawInfo);
-}
-
-void initVulkanManager(void) {
-	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing Vulkan...");
-
-	vulkan_instance = create_vulkan_instance();
-
-	if (debug_enabled) {
-		setup_debug_messenger(vulkan_instance.handle, &debug_messenger);
-	}
-
-	windowSurface = createWindowSurface(vulkan_instance);
-
-	physical_device = select_physical_device(vulkan_instance, windowSurface);
-	memory_type_set = select_memory_types(physical_device.vkPhysicalDevice);
-
-	create_device(vulkan_instance, physical_device, &device);
 	
-	initDescriptorManager(device);
-
-	create_global_staging_buffer();
-	create_global_uniform_buffer();
-	create_global_storage_buffer();
-	create_global_draw_data_buffer();
+	const BufferCreateInfo animationBufferCreateInfo = {
+		.physicalDevice = physical_device,
+		.vkDevice = device,
+		.bufferType = BUFFER_TYPE_STREAMING,
+		.memoryTypeIndexSet = memory_type_set,
+		.queueFamilyIndexCount = 0,
+		.pQueueFamilyIndices = nullptr,
+		.subrangeCount = modelDataSubrangeCount,
+		.pSubrangeSizes = animationSubrangeSizes
+	};
 	
-	matricesDescriptorMain = uploadStorageBuffer(device, global_storage_buffer_partition, 0);
-	matricesDescriptorDebug = uploadStorageBuffer(device, global_storage_buffer_partition, 1);
-	transformBufferDescriptorHandle = uploadUniformBuffer(device, global_uniform_buffer_partition, 0);
-
-	vkGetDeviceQueue(device, *physical_device.queueFamilyIndices.graphics_family_ptr, 0, &queueGraphics);
-	vkGetDeviceQueue(device, *physical_device.queueFamilyIndices.present_family_ptr, 0, &queuePresent);
-	vkGetDeviceQueue(device, *physical_device.queueFamilyIndices.transfer_family_ptr, 0, &queueTransfer);
-	vkGetDeviceQueue(device, *physical_device.queueFamilyIndices.compute_family_ptr, 0, &queueCompute);
-
-	commandPoolGraphics = createCommandPool(device, *physical_device.queueFamilyIndices.graphics_family_ptr, false, true);
-	commandPoolTransfer = createCommandPool(device, *physical_device.queueFamilyIndices.transfer_family_ptr, true, true);
-	commandPoolCompute = createCommandPool(device, *physical_device.queueFamilyIndices.compute_family_ptr, true, true);
-
-	swapchain = createSwapchain(getAppWindow(), windowSurface, physical_device, device, VK_NULL_HANDLE);
+	createBuffer(animationBufferCreateInfo, &bufferModelAnimations);
 	
-	samplerDefault = createSampler(device, physical_device);
-	uploadSampler(device, samplerDefault);
+	const BufferCreateInfo boundsBufferCreateInfo = {
+		.physicalDevice = physical_device,
+		.vkDevice = device,
+		.bufferType = BUFFER_TYPE_STREAMING,
+		.memoryTypeIndexSet = memory_type_set,
+		.queueFamilyIndexCount = 0,
+		.pQueueFamilyIndices = nullptr,
+		.subrangeCount = modelDataSubrangeCount,
+		.pSubrangeSizes = boundsSubrangeSizes
+	};
 	
+	createBuffer(boundsBufferCreateInfo, &bufferModelBounds);
+	
+	// One subrange for main draw commands and one for debug draw commands, per frame in flight.
+	const uint32_t drawCommandSubrangeCount = 2 * numFramesInFlight;
+	VkDeviceSize drawCommandSubrangeSizes[2 * MAX_NUM_FRAMES_IN_FLIGHT];
+	for (uint32_t i = 0; i < drawCommandSubrangeCount; ++i) {
+		drawCommandSubrangeSizes[i] = drawCountSize + COMPUTE_MATRICES_MODEL_COUNT * culledDrawCommandStride;
+	}
+	
+	const BufferCreateInfo drawCommandBufferCreateInfo = {
+		.physicalDevice = physical_device,
+		.vkDevice = device,
+		.bufferType = BUFFER_TYPE_INDIRECT,
+		.memoryTypeIndexSet = memory_type_set,
+		.queueFamilyIndexCount = 0,
+		.pQueueFamilyIndices = nullptr,
+		.subrangeCount = drawCommandSubrangeCount,
+		.pSubrangeSizes = drawCommandSubrangeSizes
+	};
+	
+	createBuffer(drawCommandBufferCreateInfo, &bufferDrawCommands);
+}
+
+static GraphicsPipeline createMainPipeline(void) {
 	ShaderModule vertexShaderModule = createShaderModule(device, SHADER_STAGE_VERTEX, "VertexShader.spv");
 	ShaderModule fragmentShaderModule = createShaderModule(device, SHADER_STAGE_FRAGMENT, "FragmentShader.spv");
-	ShaderModule vertexShaderLinesModule = createShaderModule(device, SHADER_STAGE_VERTEX, "VertexShaderLines.spv");
-	ShaderModule fragmentShaderLinesModule = createShaderModule(device, SHADER_STAGE_FRAGMENT, "FragmentShaderLines.spv");
 	
 	const GraphicsPipelineCreateInfo graphicsPipelineCreateInfo = {
 		.vkDevice = device,
@@ -223,11 +256,20 @@ void initVulkanManager(void) {
 		.pPushConstantRanges = (PushConstantRange[1]){
 			{
 				.shaderStageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-				.size = 5 * sizeof(uint32_t)
+				.size = 7 * sizeof(uint32_t)
 			}
 		}
 	};
-	graphicsPipeline = createGraphicsPipeline(graphicsPipelineCreateInfo);
+	const GraphicsPipeline pipeline = createGraphicsPipeline(graphicsPipelineCreateInfo);
+	
+	destroyShaderModule(&vertexShaderModule);
+	destroyShaderModule(&fragmentShaderModule);
+	return pipeline;
+}
+
+static GraphicsPipeline createDebugPipeline(void) {
+	ShaderModule vertexShaderLinesModule = createShaderModule(device, SHADER_STAGE_VERTEX, "VertexShaderLines.spv");
+	ShaderModule fragmentShaderLinesModule = createShaderModule(device, SHADER_STAGE_FRAGMENT, "FragmentShaderLines.spv");
 	
 	const GraphicsPipelineCreateInfo graphicsPipelineDebugCreateInfo = {
 		.vkDevice = device,
@@ -241,45 +283,121 @@ void initVulkanManager(void) {
 		.pPushConstantRanges = (PushConstantRange[1]){
 			{
 				.shaderStageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-				.size = 5 * sizeof(uint32_t)
+				.size = 7 * sizeof(uint32_t)
 			}
 		}
 	};
-	graphicsPipelineDebug = createGraphicsPipeline(graphicsPipelineDebugCreateInfo);
+	const GraphicsPipeline pipeline = createGraphicsPipeline(graphicsPipelineDebugCreateInfo);
 	
-	destroyShaderModule(&vertexShaderModule);
-	destroyShaderModule(&fragmentShaderModule);
 	destroyShaderModule(&vertexShaderLinesModule);
 	destroyShaderModule(&fragmentShaderLinesModule);
+	return pipeline;
+}
+
+// Replaces a graphics pipeline with a newly created one, unless creating it failed.
+static bool replaceGraphicsPipeline(GraphicsPipeline *const pPipeline, GraphicsPipeline newPipeline) {
+	if (!validateGraphicsPipeline(newPipeline)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Reloading graphics pipeline: failed to create pipeline, keeping the previous one.");
+		return false;
+	}
+	deleteGraphicsPipeline(pPipeline);
+	*pPipeline = newPipeline;
+	return true;
+}
+
+void initVulkanManager(void) {
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing Vulkan...");
+	
+	const uint32_t numFramesInFlight = getNumFramesInFlight();
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Using %u frame(s) in flight and requesting present mode \"%s\".", numFramesInFlight, presentModeName(getPresentMode()));
+
+	vulkan_instance = create_vulkan_instance();
+
+	if (debug_enabled) {
+		setup_debug_messenger(vulkan_instance.handle, &debug_messenger);
+	}
+
+	windowSurface = createWindowSurface(vulkan_instance);
+
+	physical_device = select_physical_device(vulkan_instance, windowSurface);
+	memory_type_set = select_memory_types(physical_device.vkPhysicalDevice);
+
+	create_device(vulkan_instance, physical_device, &device);
+	
+	initDescriptorManager(device);
+
+	create_global_staging_buffer();
+	create_global_uniform_buffer();
+	create_global_storage_buffer(numFramesInFlight);
+	create_global_draw_data_buffer(numFramesInFlight);
+	
+	for (uint32_t i = 0; i < MAX_NUM_FRAMES_IN_FLIGHT; ++i) {
+		matricesDescriptorsMain[i] = DESCRIPTOR_HANDLE_INVALID;
+		matricesDescriptorsDebug[i] = DESCRIPTOR_HANDLE_INVALID;
+		drawCommandDescriptorsMain[i] = DESCRIPTOR_HANDLE_INVALID;
+		drawCommandDescriptorsDebug[i] = DESCRIPTOR_HANDLE_INVALID;
+	}
+	for (uint32_t i = 0; i < numFramesInFlight; ++i) {
+		matricesDescriptorsMain[i] = uploadStorageBuffer(device, global_storage_buffer_partition, 2 * i);
+		matricesDescriptorsDebug[i] = uploadStorageBuffer(device, global_storage_buffer_partition, 2 * i + 1);
+		bufferBorrowSubrange(bufferDrawCommands, 2 * i, &drawCommandsMain[i]);
+		bufferBorrowSubrange(bufferDrawCommands, 2 * i + 1, &drawCommandsDebug[i]);
+		drawCommandDescriptorsMain[i] = uploadStorageBuffer2(device, drawCommandsMain[i]);
+		drawCommandDescriptorsDebug[i] = uploadStorageBuffer2(device, drawCommandsDebug[i]);
+	}
+	transformBufferDescriptorHandle = uploadUniformBuffer(device, global_uniform_buffer_partition, 0);
+
+	vkGetDeviceQueue(device, *physical_device.queueFamilyIndices.graphics_family_ptr, 0, &queueGraphics);
+	vkGetDeviceQueue(device, *physical_device.queueFamilyIndices.present_family_ptr, 0, &queuePresent);
+	vkGetDeviceQueue(device, *physical_device.queueFamilyIndices.transfer_family_ptr, 0, &queueTransfer);
+	vkGetDeviceQueue(device, *physical_device.queueFamilyIndices.compute_family_ptr, 0, &queueCompute);
+
+	commandPoolGraphics = createCommandPool(device, *physical_device.queueFamilyIndices.graphics_family_ptr, false, true);
+	commandPoolTransfer = createCommandPool(device, *physical_device.queueFamilyIndices.transfer_family_ptr, true, true);
+	commandPoolCompute = createCommandPool(device, *physical_device.queueFamilyIndices.compute_family_ptr, true, true);
+
+	swapchain = createSwapchain(getAppWindow(), windowSurface, physical_device, device, VK_NULL_HANDLE);
+	
+	samplerDefault = createSampler(device, physical_device);
+	uploadSampler(device, samplerDefault);
+	
+	graphicsPipeline = createMainPipeline();
+	graphicsPipelineDebug = createDebugPipeline();
 	
 	const ModelPoolCreateInfo modelPoolMainCreateInfo = {
 		.buffer = bufferDrawInfo,
 		.bufferSubrangeIndex = 0,
+		.frameCount = numFramesInFlight,
+		.animationBuffer = bufferModelAnimations,
+		.boundsBuffer = bufferModelBounds,
 		.graphicsPipeline = graphicsPipeline,
 		.firstVertex = 0,
 		.vertexCount = 4,
 		.firstIndex = 0,
 		.indexCount = 6,
 		.firstDescriptorIndex = 0,
-		.maxModelCount = 256
+		.maxModelCount = COMPUTE_MATRICES_MODEL_COUNT
 	};
 	createModelPool(modelPoolMainCreateInfo, &modelPoolMain);
 	
 	const ModelPoolCreateInfo modelPoolDebugCreateInfo = {
 		.buffer = bufferDrawInfo,
-		.bufferSubrangeIndex = 1,
+		.bufferSubrangeIndex = (int32_t)numFramesInFlight,
+		.frameCount = numFramesInFlight,
+		.animationBuffer = bufferModelAnimations,
+		.boundsBuffer = bufferModelBounds,
 		.graphicsPipeline = graphicsPipelineDebug,
-		.firstVertex = 256 * 4,
+		.firstVertex = COMPUTE_MATRICES_MODEL_COUNT * 4,
 		.vertexCount = 4,
 		.firstIndex = 6,
 		.indexCount = 8,
-		.firstDescriptorIndex = 256,
-		.maxModelCount = 256
+		.firstDescriptorIndex = COMPUTE_MATRICES_MODEL_COUNT,
+		.maxModelCount = COMPUTE_MATRICES_MODEL_COUNT
 	};
 	createModelPool(modelPoolDebugCreateInfo, &modelPoolDebug);
 	
 	const FrameArrayCreateInfo frameArrayCreateInfo = {
-		.num_frames = 2,
+		.num_frames = numFramesInFlight,
 		.physical_device = physical_device,
 		.vkDevice = device,
 		.commandPool = commandPoolGraphics
@@ -287,7 +405,10 @@ void initVulkanManager(void) {
 	frame_array = createFrameArray(frameArrayCreateInfo);
 	
 	initComputeMatrices(device);
+	initComputeCullDraws(device);
 	initComputeStitchTexture(device);
+	initTextRenderer(device, swapchain, numFramesInFlight);
+	initRoomTilemaps(device);
 	
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initialized Vulkan.");
 }
@@ -298,7 +419,10 @@ void terminateVulkanManager(void) {
 	vkDeviceWaitIdle(device);
 
 	terminateComputeMatrices();
+	terminateComputeCullDraws();
 	terminateComputeStitchTexture();
+	terminateTextRenderer();
+	terminateRoomTilemaps();
 	terminateTextureManager();
 
 	deleteModelPool(&modelPoolDebug);
@@ -318,6 +442,13 @@ void terminateVulkanManager(void) {
 	deleteCommandPool(&commandPoolCompute);
 
 	deleteBuffer(&bufferDrawInfo);
+	deleteBuffer(&bufferModelAnimations);
+	deleteBuffer(&bufferModelBounds);
+	for (uint32_t i = 0; i < getNumFramesInFlight(); ++i) {
+		bufferReturnSubrange(&drawCommandsMain[i]);
+		bufferReturnSubrange(&drawCommandsDebug[i]);
+	}
+	deleteBuffer(&bufferDrawCommands);
 
 	destroy_buffer_partition(&global_staging_buffer_partition);
 	destroy_buffer_partition(&global_uniform_buffer_partition);
@@ -337,26 +468,132 @@ void terminateVulkanManager(void) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Terminated Vulkan.");
 }
 
-void drawFrame(const float deltaTime, const Vector4F cameraPosition, const ProjectionBounds projectionBounds) {
+// The pipelines that can be rebuilt from a shader file.
+typedef enum ShaderPipeline {
+	SHADER_PIPELINE_MAIN,
+	SHADER_PIPELINE_DEBUG,
+	SHADER_PIPELINE_TEXT,
+	SHADER_PIPELINE_COMPUTE_MATRICES,
+	SHADER_PIPELINE_CULL_DRAWS,
+	SHADER_PIPELINE_ROOM_TEXTURE
+} ShaderPipeline;
+
+// Recreates a pipeline on the render thread, once no frame in flight uses it.
+static void runShaderReload(void *pData) {
+	const ShaderPipeline shaderPipeline = *(const ShaderPipeline *)pData;
+	vkDeviceWaitIdle(device);
+	
+	bool result = false;
+	switch (shaderPipeline) {
+		case SHADER_PIPELINE_MAIN: result = replaceGraphicsPipeline(&graphicsPipeline, createMainPipeline()); break;
+		case SHADER_PIPELINE_DEBUG: result = replaceGraphicsPipeline(&graphicsPipelineDebug, createDebugPipeline()); break;
+		case SHADER_PIPELINE_TEXT: result = reloadTextRenderer(device, swapchain); break;
+		case SHADER_PIPELINE_COMPUTE_MATRICES: result = reloadComputeMatrices(device); break;
+		case SHADER_PIPELINE_CULL_DRAWS: result = reloadComputeCullDraws(device); break;
+		case SHADER_PIPELINE_ROOM_TEXTURE: result = reloadComputeStitchTexture(device); break;
+	}
+	if (!result) {
+		logMsg(loggerVulkan, LOG_LEVEL_WARNING, "Reloading shader: pipeline was not recreated.");
+	}
+}
+
+bool reloadShader(const char *const pFilename) {
+	if (!pFilename) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reloading shader: pFilename is null.");
+		return false;
+	}
+	
+	ShaderPipeline shaderPipeline = SHADER_PIPELINE_MAIN;
+	if (strcmp(pFilename, "VertexShader.spv") == 0 || strcmp(pFilename, "FragmentShader.spv") == 0) {
+		shaderPipeline = SHADER_PIPELINE_MAIN;
+	} else if (strcmp(pFilename, "VertexShaderLines.spv") == 0 || strcmp(pFilename, "FragmentShaderLines.spv") == 0) {
+		shaderPipeline = SHADER_PIPELINE_DEBUG;
+	} else if (strcmp(pFilename, "VertexShaderText.spv") == 0 || strcmp(pFilename, "FragmentShaderText.spv") == 0) {
+		shaderPipeline = SHADER_PIPELINE_TEXT;
+	} else if (strcmp(pFilename, "ComputeMatrices.spv") == 0) {
+		shaderPipeline = SHADER_PIPELINE_COMPUTE_MATRICES;
+	} else if (strcmp(pFilename, "ComputeCullDraws.spv") == 0) {
+		shaderPipeline = SHADER_PIPELINE_CULL_DRAWS;
+	} else if (strcmp(pFilename, "RoomTexture.spv") == 0) {
+		shaderPipeline = SHADER_PIPELINE_ROOM_TEXTURE;
+	} else {
+		logMsg(loggerVulkan, LOG_LEVEL_WARNING, "Reloading shader: no pipeline is built from shader \"%s\".", pFilename);
+		return false;
+	}
+	logMsg(loggerVulkan, LOG_LEVEL_INFO, "Reloading shader \"%s\"...", pFilename);
+	
+	// Only the pipelines built from the shader are recreated, by the render thread before it draws the next snapshot.
+	ShaderPipeline *const pShaderPipeline = heapAlloc(1, sizeof(ShaderPipeline));
+	if (!pShaderPipeline) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reloading shader: failed to allocate reload task.");
+		return false;
+	}
+	*pShaderPipeline = shaderPipeline;
+	return pushRenderTask(runShaderReload, pShaderPipeline);
+}
+
+bool acquireFrame(uint32_t *const pImageIndex) {
+	assert(pImageIndex);
 
 	vkWaitForFences(device, 1, &frame_array.frames[frame_array.current_frame].fence_frame_ready, VK_TRUE, UINT64_MAX);
-	vkResetFences(device, 1, &frame_array.frames[frame_array.current_frame].fence_frame_ready);
 
-	uint32_t imageIndex = 0;
-	const VkResult result = vkAcquireNextImageKHR(device, swapchain.vkSwapchain, UINT64_MAX, frame_array.frames[frame_array.current_frame].semaphore_image_available.semaphore, VK_NULL_HANDLE, &imageIndex);
+	const VkResult result = vkAcquireNextImageKHR(device, swapchain.vkSwapchain, UINT64_MAX, frame_array.frames[frame_array.current_frame].semaphore_image_available.semaphore, VK_NULL_HANDLE, pImageIndex);
 	if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-		return;
+		return false;
 	}
 	else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
 		// TODO - error handling
 	}
 
+	// The fence is only reset once the frame is sure to be submitted, so that a skipped frame does not leave it unsignaled.
+	vkResetFences(device, 1, &frame_array.frames[frame_array.current_frame].fence_frame_ready);
+	return true;
+}
+
+void drawFrame(const uint32_t imageIndex, const float deltaTime, const Vector4F cameraPosition, const ProjectionBounds projectionBounds, 
+		const ModelPoolSnapshot *const pMainSnapshot, const ModelPoolSnapshot *const pDebugSnapshot) {
+	assert(pMainSnapshot && pDebugSnapshot);
+
+	const uint32_t matricesDescriptorMain = matricesDescriptorsMain[frame_array.current_frame];
+	const uint32_t matricesDescriptorDebug = matricesDescriptorsDebug[frame_array.current_frame];
+	
+	// The frame's previous submission is done, so its glyph, draw info, animation and bounds buffers can be safely rewritten.
+	textRendererUpdateFrame(frame_array.current_frame);
+	modelPoolUploadSnapshot(modelPoolMain, frame_array.current_frame, pMainSnapshot);
+	modelPoolUploadSnapshot(modelPoolDebug, frame_array.current_frame, pDebugSnapshot);
+
 	// Signal a semaphore when the entire batch in the compute queue is done being executed.
-	computeMatrices(transformBufferDescriptorHandle, matricesDescriptorMain, deltaTime, projectionBounds, cameraPosition, getModelCameraFlags(modelPoolMain), getModelTransforms(modelPoolMain));
-	computeMatrices(transformBufferDescriptorHandle, matricesDescriptorDebug, deltaTime, projectionBounds, cameraPosition, getModelCameraFlags(modelPoolDebug), getModelTransforms(modelPoolDebug));
+	computeMatrices(transformBufferDescriptorHandle, matricesDescriptorMain, deltaTime, projectionBounds, cameraPosition, pMainSnapshot->modelCount, pMainSnapshot->cameraFlags, pMainSnapshot->transforms);
+	computeMatrices(transformBufferDescriptorHandle, matricesDescriptorDebug, deltaTime, projectionBounds, cameraPosition, pDebugSnapshot->modelCount, pDebugSnapshot->cameraFlags, pDebugSnapshot->transforms);
+
+	const BufferSubrange drawCommandsMainFrame = drawCommandsMain[frame_array.current_frame];
+	const BufferSubrange drawCommandsDebugFrame = drawCommandsDebug[frame_array.current_frame];
 
 	recordCommands(frame_array.cmdBufArray, frame_array.current_frame, false, 
 		
+		// Rebuild the meshes of models loaded since this frame was last drawn; only this frame reads its vertex buffer.
+		const VkBuffer vertexBuffer = frame_array.frames[frame_array.current_frame].vertex_buffer;
+		const uint32_t meshUpdateCount = cmdUpdateModelMeshes(cmdBuf, modelPoolMain, frame_array.current_frame, vertexBuffer, pMainSnapshot)
+				+ cmdUpdateModelMeshes(cmdBuf, modelPoolDebug, frame_array.current_frame, vertexBuffer, pDebugSnapshot);
+		if (meshUpdateCount > 0) {
+			cmdUpdateModelMeshesBarrier(cmdBuf);
+		}
+		
+		// Compact the draws of models that are inside the view, so that off-screen models are never rasterized.
+		cmdCullDraws(cmdBuf, (CullDrawsInfo){
+			.drawInfoBufferHandle = modelPoolGetDrawInfoBufferHandle(modelPoolMain, frame_array.current_frame),
+			.boundsBufferHandle = modelPoolGetBoundsBufferHandle(modelPoolMain, frame_array.current_frame),
+			.matrixBufferHandle = matricesDescriptorMain,
+			.drawCommandBufferHandle = drawCommandDescriptorsMain[frame_array.current_frame]
+		});
+		cmdCullDraws(cmdBuf, (CullDrawsInfo){
+			.drawInfoBufferHandle = modelPoolGetDrawInfoBufferHandle(modelPoolDebug, frame_array.current_frame),
+			.boundsBufferHandle = modelPoolGetBoundsBufferHandle(modelPoolDebug, frame_array.current_frame),
+			.matrixBufferHandle = matricesDescriptorDebug,
+			.drawCommandBufferHandle = drawCommandDescriptorsDebug[frame_array.current_frame]
+		});
+		cmdCullDrawsBarrier(cmdBuf);
+		
 		static const ImageSubresourceRange imageSubresourceRange = {
 			.imageAspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
 			.baseArrayLayer = 0,
@@ -415,46 +652,52 @@ void drawFrame(const float deltaTime, const Vector4F cameraPosition, const Proje
 		vkCmdBindVertexBuffers(cmdBuf, 0, 1, &frame_array.frames[frame_array.current_frame].vertex_buffer, offsets);
 		vkCmdBindIndexBuffer(cmdBuf, frame_array.frames[frame_array.current_frame].index_buffer, 0, VK_INDEX_TYPE_UINT16);
 		
-		const uint32_t pushConstantsMain[5] = { 
+		const uint32_t pushConstantsMain[7] = { 
 			0, 
 			0, 
 			0, 
-			modelPoolGetDrawInfoBufferHandle(modelPoolMain), 
-			matricesDescriptorMain
+			modelPoolGetDrawInfoBufferHandle(modelPoolMain, frame_array.current_frame), 
+			matricesDescriptorMain,
+			modelPoolGetAnimationBufferHandle(modelPoolMain, frame_array.current_frame),
+			getAnimationTime()
 		};
 		vkCmdPushConstants(cmdBuf, 
 				graphicsPipelineDebug.vkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 				0, sizeof(pushConstantsMain), pushConstantsMain);
 		
-		const uint32_t drawOffset = drawCountSize;
-		const VkBuffer bufferDrawInfoHandle = bufferGetVkBuffer(bufferDrawInfo);
+		const VkBuffer bufferDrawCommandsHandle = bufferGetVkBuffer(bufferDrawCommands);
 		const uint32_t maxDrawCount = modelPoolGetMaxModelCount(modelPoolMain);
 		vkCmdDrawIndexedIndirectCount(cmdBuf, 
-				bufferDrawInfoHandle, drawOffset, 
-				bufferDrawInfoHandle, 0, 
-				maxDrawCount, drawCommandStride);
+				bufferDrawCommandsHandle, drawCommandsMainFrame.offset + drawCountSize, 
+				bufferDrawCommandsHandle, drawCommandsMainFrame.offset, 
+				maxDrawCount, culledDrawCommandStride);
 		
 		// Debug drawing
 		
 		vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelineDebug.vkPipeline);
 		
-		const uint32_t pushConstantsDebug[5] = { 
+		const uint32_t pushConstantsDebug[7] = { 
 			0, 
 			0, 
 			0, 
-			modelPoolGetDrawInfoBufferHandle(modelPoolDebug), 
-			matricesDescriptorDebug
+			modelPoolGetDrawInfoBufferHandle(modelPoolDebug, frame_array.current_frame), 
+			matricesDescriptorDebug,
+			modelPoolGetAnimationBufferHandle(modelPoolDebug, frame_array.current_frame),
+			getAnimationTime()
 		};
 		vkCmdPushConstants(cmdBuf, 
 				graphicsPipelineDebug.vkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 				0, sizeof(pushConstantsDebug), pushConstantsDebug);
 		
-		const uint32_t debugDrawOffset = modelPoolGetDrawInfoBufferOffset(modelPoolDebug);
 		const uint32_t debugMaxDrawCount = modelPoolGetMaxModelCount(modelPoolDebug);
 		vkCmdDrawIndexedIndirectCount(cmdBuf, 
-				bufferDrawInfoHandle, debugDrawOffset + drawCountSize, 
-				bufferDrawInfoHandle, debugDrawOffset, 
-				debugMaxDrawCount, drawCommandStride);
+				bufferDrawCommandsHandle, drawCommandsDebugFrame.offset + drawCountSize, 
+				bufferDrawCommandsHandle, drawCommandsDebugFrame.offset, 
+				debugMaxDrawCount, culledDrawCommandStride);
+		
+		// Text drawing
+		
+		textRendererRecordDraws(cmdBuf, frame_array.current_frame, matricesDescriptorMain);
 		
 		vkCmdEndRendering(cmdBuf);
 		
@@ -480,9 +723,8 @@ void drawFrame(const float deltaTime, const Vector4F cameraPosition, const Proje
 		.deviceMask = 0
 	};
 
-	VkSemaphoreSubmitInfo wait_semaphore_submit_infos[3] = { { } };
-	wait_semaphore_submit_infos[1] = make_timeline_semaphore_wait_submit_info(frame_array.frames[frame_array.current_frame].semaphore_buffers_ready, VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT);
-	wait_semaphore_submit_infos[2] = make_timeline_semaphore_wait_submit_info(computeMatricesSemaphore, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT);
+	VkSemaphoreSubmitInfo wait_semaphore_submit_infos[2] = { { } };
+	wait_semaphore_submit_infos[1] = make_timeline_semaphore_wait_submit_info(computeMatricesSemaphore, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT);
 
 	wait_semaphore_submit_infos[0].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
 	wait_semaphore_submit_infos[0].pNext = nullptr;
@@ -499,7 +741,7 @@ void drawFrame(const float deltaTime, const Vector4F cameraPosition, const Proje
 		.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
 		.pNext = nullptr,
 		.flags = 0,
-		.waitSemaphoreInfoCount = 3,
+		.waitSemaphoreInfoCount = 2,
 		.pWaitSemaphoreInfos = wait_semaphore_submit_infos,
 		.commandBufferInfoCount = 1,
 		.pCommandBufferInfos = &command_buffer_submit_info,
@@ -509,6 +751,9 @@ void drawFrame(const float deltaTime, const Vector4F cameraPosition, const Proje
 
 	vkQueueSubmit2(queueGraphics, 1, &submit_info, frame_array.frames[frame_array.current_frame].fence_frame_ready);
 
+	// Room tilemap slots drawn by this frame must not be overwritten until it finishes.
+	modelPoolSnapshotMarkTilemapsRead(pMainSnapshot, frame_array.current_frame, frame_array.frames[frame_array.current_frame].semaphore_render_finished.wait_counter);
+
 
 
 	const VkPresentInfoKHR present_info = {
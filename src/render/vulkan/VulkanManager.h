@@ -15,12 +15,6 @@
 #include "math/projection.h"
 #include "render/render_config.h"
 
-/* -- Vulkan Module Configuration -- */
-
-#define VK_CONF_MAX_NUM_QUADS (NUM_RENDER_OBJECT_SLOTS * MAX_NUM_RENDER_OBJECT_QUADS)
-
-extern const int vkConfMaxNumQuads;
-
 /* -- Core State -- */
 
 extern PhysicalDevice physical_device;
@@ -63,6 +57,17 @@ void initVulkanManager(void);
 // Destroys the Vulkan objects created for the rendering system.
 void terminateVulkanManager(void);
 
-void drawFrame(const float deltaTime, const Vector4F cameraPosition, const ProjectionBounds projectionBounds);
+// Queues the pipelines built from a shader file in the shader directory, e.g. "VertexShader.spv", to be recreated on the render thread after waiting for the device.
+// A pipeline whose shader fails to load is kept as it is.
+// Returns true if the reload was queued, false if no pipeline is built from the shader or the reload could not be queued.
+bool reloadShader(const char *const pFilename);
+
+// Waits until the next frame in flight is free, then acquires the swapchain image to draw it into.
+// Returns true if an image was acquired, false if the frame should be skipped.
+bool acquireFrame(uint32_t *const pImageIndex);
+
+// Draws the frame into the acquired image, computing model matrices from snapshots of the model pools.
+void drawFrame(const uint32_t imageIndex, const float deltaTime, const Vector4F cameraPosition, const ProjectionBounds projectionBounds, 
+		const ModelPoolSnapshot *const pMainSnapshot, const ModelPoolSnapshot *const pDebugSnapshot);
 
 #endif	// VULKAN_MANAGER_H
@@ -61,6 +61,12 @@ BufferPartition create_buffer_partition(const BufferPartitionCreateInfo buffer_p
 		case BUFFER_TYPE_DRAW_DATA:
 			offset_alignment = physical_device_properties.properties.limits.minUniformBufferOffsetAlignment;
 			break;
+		case BUFFER_TYPE_STREAMING:
+			offset_alignment = physical_device_properties.properties.limits.minStorageBufferOffsetAlignment;
+			break;
+		case BUFFER_TYPE_INDIRECT:
+			offset_alignment = physical_device_properties.properties.limits.minStorageBufferOffsetAlignment;
+			break;
 	}
 
 	for (uint32_t i = 0; i < buffer_partition.num_ranges; ++i) {
@@ -84,6 +90,12 @@ BufferPartition create_buffer_partition(const BufferPartitionCreateInfo buffer_p
 		case BUFFER_TYPE_DRAW_DATA:
 			buffer_usage_flags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
 			break;
+		case BUFFER_TYPE_STREAMING:
+			buffer_usage_flags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+			break;
+		case BUFFER_TYPE_INDIRECT:
+			buffer_usage_flags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+			break;
 	}
 
 	VkBufferCreateInfo buffer_create_info = {
@@ -145,6 +157,12 @@ BufferPartition create_buffer_partition(const BufferPartitionCreateInfo buffer_p
 		case BUFFER_TYPE_DRAW_DATA:
 			memory_type_index = buffer_partition_create_info.memory_type_set.uniform_data;
 			break;
+		case BUFFER_TYPE_STREAMING:
+			memory_type_index = buffer_partition_create_info.memory_type_set.uniform_data;
+			break;
+		case BUFFER_TYPE_INDIRECT:
+			memory_type_index = buffer_partition_create_info.memory_type_set.graphics_resources;
+			break;
 	}
 
 	const VkMemoryAllocateInfo memory_allocate_info = {
@@ -11,7 +11,9 @@ typedef enum BufferType {
 	BUFFER_TYPE_STAGING,
 	BUFFER_TYPE_UNIFORM,
 	BUFFER_TYPE_STORAGE,
-	BUFFER_TYPE_DRAW_DATA
+	BUFFER_TYPE_DRAW_DATA,
+	BUFFER_TYPE_STREAMING,	// Host-visible storage data, rewritten by the CPU every frame.
+	BUFFER_TYPE_INDIRECT	// Device-local storage data written by compute shaders and read as indirect draw parameters.
 } BufferType;
 
 typedef struct BufferPartitionCreateInfo {
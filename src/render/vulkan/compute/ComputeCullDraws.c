@@ -0,0 +1,91 @@
+#include "ComputeCullDraws.h"
+
+#include "log/Logger.h"
+#include "../ComputePipeline.h"
+#include "../Descriptor.h"
+
+const uint32_t culledDrawCommandStride = sizeof(VkDrawIndexedIndirectCommand);
+
+static Pipeline cullDrawsPipeline = { };
+
+static Pipeline createCullDrawsPipeline(const VkDevice vkDevice) {
+	const ComputePipelineCreateInfo pipelineCreateInfo = {
+		.vkDevice = vkDevice,
+		.shaderFilename = makeStaticString("ComputeCullDraws.spv"),
+		.pushConstantRangeCount = 1,
+		.pPushConstantRanges = (PushConstantRange[1]){
+			{
+				.shaderStageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+				.size = 4 * sizeof(uint32_t)
+			}
+		}
+	};
+	return createComputePipeline(pipelineCreateInfo);
+}
+
+bool initComputeCullDraws(const VkDevice vkDevice) {
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing draw culling pipeline...");
+	
+	cullDrawsPipeline = createCullDrawsPipeline(vkDevice);
+	if (!validatePipeline(cullDrawsPipeline)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Initializing draw culling pipeline: failed to create pipeline.");
+		return false;
+	}
+	
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initialized draw culling pipeline.");
+	return true;
+}
+
+void terminateComputeCullDraws(void) {
+	deletePipeline(&cullDrawsPipeline);
+}
+
+bool reloadComputeCullDraws(const VkDevice vkDevice) {
+	const Pipeline pipeline = createCullDrawsPipeline(vkDevice);
+	if (!validatePipeline(pipeline)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Reloading draw culling pipeline: failed to create pipeline, keeping the previous one.");
+		return false;
+	}
+	deletePipeline(&cullDrawsPipeline);
+	cullDrawsPipeline = pipeline;
+	return true;
+}
+
+void cmdCullDraws(const VkCommandBuffer cmdBuf, const CullDrawsInfo cullDrawsInfo) {
+	vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, cullDrawsPipeline.vkPipeline);
+	vkCmdBindDescriptorSets(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, cullDrawsPipeline.vkPipelineLayout, 0, 1, &globalDescriptorSet, 0, nullptr);
+	
+	const uint32_t pushConstants[4] = {
+		cullDrawsInfo.drawInfoBufferHandle,
+		cullDrawsInfo.boundsBufferHandle,
+		cullDrawsInfo.matrixBufferHandle,
+		cullDrawsInfo.drawCommandBufferHandle
+	};
+	vkCmdPushConstants(cmdBuf, cullDrawsPipeline.vkPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), pushConstants);
+	
+	// A single work group compacts every draw of the pool, so that the draws keep their depth order.
+	vkCmdDispatch(cmdBuf, 1, 1, 1);
+}
+
+void cmdCullDrawsBarrier(const VkCommandBuffer cmdBuf) {
+	const VkMemoryBarrier2 memoryBarrier = {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+		.pNext = nullptr,
+		.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+		.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+		.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT
+	};
+	const VkDependencyInfo dependencyInfo = {
+		.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+		.pNext = nullptr,
+		.dependencyFlags = 0,
+		.memoryBarrierCount = 1,
+		.pMemoryBarriers = &memoryBarrier,
+		.bufferMemoryBarrierCount = 0,
+		.pBufferMemoryBarriers = nullptr,
+		.imageMemoryBarrierCount = 0,
+		.pImageMemoryBarriers = nullptr
+	};
+	vkCmdPipelineBarrier2(cmdBuf, &dependencyInfo);
+}
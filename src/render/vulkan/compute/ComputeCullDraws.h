@@ -0,0 +1,39 @@
+#ifndef COMPUTE_CULL_DRAWS_H
+#define COMPUTE_CULL_DRAWS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <vulkan/vulkan.h>
+
+// Size of each draw command compacted by the culling pass; the draw count precedes the draw commands.
+extern const uint32_t culledDrawCommandStride;
+
+typedef struct CullDrawsInfo {
+	
+	// Handles to a model pool's draw infos, model bounds, and the matrices computed for it this frame.
+	uint32_t drawInfoBufferHandle;
+	uint32_t boundsBufferHandle;
+	uint32_t matrixBufferHandle;
+	
+	// Handle to the storage buffer into which the draw count and the visible draw commands are written.
+	uint32_t drawCommandBufferHandle;
+	
+} CullDrawsInfo;
+
+bool initComputeCullDraws(const VkDevice vkDevice);
+
+void terminateComputeCullDraws(void);
+
+// Recreates the pipeline from its shader file, keeping the previous pipeline if that fails; the device must be idle.
+// Returns true if successful, false otherwise.
+bool reloadComputeCullDraws(const VkDevice vkDevice);
+
+// Records a dispatch that tests each draw of a model pool against the view and compacts the visible draws,
+// 	in their original order, into a draw command buffer for use with an indirect count draw call.
+void cmdCullDraws(const VkCommandBuffer cmdBuf, const CullDrawsInfo cullDrawsInfo);
+
+// Records a barrier that makes the draw commands written by culling dispatches visible to indirect draw calls.
+void cmdCullDrawsBarrier(const VkCommandBuffer cmdBuf);
+
+#endif	// COMPUTE_CULL_DRAWS_H
@@ -19,15 +19,14 @@ TimelineSemaphore computeMatricesSemaphore = { };
 static VkFence computeMatricesFence = VK_NULL_HANDLE;
 
 // One camera matrix, one projection matrix, and one matrix for each render object slot.
-static const VkDeviceSize matrixCount = 256 + 2;
+static const VkDeviceSize matrixCount = COMPUTE_MATRICES_MODEL_COUNT + 2;
 
 // Size in bytes of a 4x4 matrix of single-precision floating point numbers.
 static const VkDeviceSize matrixSize = 4 * 4 * sizeof(float);
 
 const VkDeviceSize matrixDataSize = matrixCount * matrixSize;
 
-bool initComputeMatrices(const VkDevice vkDevice) {
-	
+static Pipeline createComputeMatricesPipeline(const VkDevice vkDevice) {
 	const ComputePipelineCreateInfo pipelineCreateInfo = {
 		.vkDevice = vkDevice,
 		.shaderFilename = makeStaticString("ComputeMatrices.spv"),
@@ -39,7 +38,12 @@ bool initComputeMatrices(const VkDevice vkDevice) {
 			}
 		}
 	};
-	computeMatricesPipeline = createComputePipeline(pipelineCreateInfo);
+	return createComputePipeline(pipelineCreateInfo);
+}
+
+bool initComputeMatrices(const VkDevice vkDevice) {
+	
+	computeMatricesPipeline = createComputeMatricesPipeline(vkDevice);
 	computeMatricesSemaphore = create_timeline_semaphore(vkDevice);
 	computeMatricesCmdBufArray = cmdBufAlloc(commandPoolCompute, 1);
 
@@ -67,8 +71,25 @@ void terminateComputeMatrices(void) {
 	deletePipeline(&computeMatricesPipeline);
 }
 
-void computeMatrices(const uint32_t transformBufferDescriptorHandle, const uint32_t matrixBufferDescriptorHandle, const float deltaTime, const ProjectionBounds projectionBounds, const Vector4F cameraPosition, const uint32_t *const pCameraFlags, const ModelTransform *const transforms) {
-	assert(pCameraFlags && transforms);
+bool reloadComputeMatrices(const VkDevice vkDevice) {
+	const Pipeline pipeline = createComputeMatricesPipeline(vkDevice);
+	if (!validatePipeline(pipeline)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Reloading compute matrices pipeline: failed to create pipeline, keeping the previous one.");
+		return false;
+	}
+	deletePipeline(&computeMatricesPipeline);
+	computeMatricesPipeline = pipeline;
+	return true;
+}
+
+void computeMatrices(const uint32_t transformBufferDescriptorHandle, const uint32_t matrixBufferDescriptorHandle, const float deltaTime, const ProjectionBounds projectionBounds, const Vector4F cameraPosition, const uint32_t modelCount, const uint32_t *const pCameraFlags, const ModelTransform *const transforms) {
+	assert(modelCount == 0 || (pCameraFlags && transforms));
+
+	uint32_t copiedModelCount = modelCount;
+	if (modelCount > COMPUTE_MATRICES_MODEL_COUNT) {
+		logMsg(loggerVulkan, LOG_LEVEL_WARNING, "Computing matrices: model count (%u) exceeds the maximum (%u).", modelCount, COMPUTE_MATRICES_MODEL_COUNT);
+		copiedModelCount = COMPUTE_MATRICES_MODEL_COUNT;
+	}
 
 	vkWaitForFences(computeMatricesPipeline.vkDevice, 1, &computeMatricesFence, VK_TRUE, UINT64_MAX);
 	vkResetFences(computeMatricesPipeline.vkDevice, 1, &computeMatricesFence);
@@ -81,8 +102,17 @@ void computeMatrices(const uint32_t transformBufferDescriptorHandle, const uint3
 	memcpy(mapped_memory, &projectionBounds, sizeof projectionBounds);
 	memcpy(mapped_memory + 24, &deltaTime, sizeof deltaTime);
 	memcpy(mapped_memory + 28, &cameraPosition, sizeof cameraPosition);
-	memcpy(mapped_memory + 44, pCameraFlags, 256 * sizeof(*pCameraFlags));
-	memcpy(mapped_memory + 44 + 256 * sizeof(*pCameraFlags), transforms, 256 * sizeof(*transforms));
+
+	// Slots past the model count are zeroed, so that the shader never reads a previous pool's transforms.
+	uint8_t *const pMappedCameraFlags = mapped_memory + 44;
+	uint8_t *const pMappedTransforms = pMappedCameraFlags + COMPUTE_MATRICES_MODEL_COUNT * sizeof(*pCameraFlags);
+	const uint32_t unusedModelCount = COMPUTE_MATRICES_MODEL_COUNT - copiedModelCount;
+	if (copiedModelCount > 0) {
+		memcpy(pMappedCameraFlags, pCameraFlags, copiedModelCount * sizeof(*pCameraFlags));
+		memcpy(pMappedTransforms, transforms, copiedModelCount * sizeof(*transforms));
+	}
+	memset(pMappedCameraFlags + copiedModelCount * sizeof(*pCameraFlags), 0, unusedModelCount * sizeof(*pCameraFlags));
+	memset(pMappedTransforms + copiedModelCount * sizeof(*transforms), 0, unusedModelCount * sizeof(*transforms));
 	buffer_partition_unmap_memory(global_uniform_buffer_partition);
 
 	recordCommands(computeMatricesCmdBufArray, 0, false, 
@@ -13,11 +13,18 @@ extern TimelineSemaphore computeMatricesSemaphore;
 
 extern const VkDeviceSize matrix_data_size;
 
+// The number of model transforms the compute matrices shader reads, and so the most models a pool it computes matrices for can have.
+#define COMPUTE_MATRICES_MODEL_COUNT 256
+
 bool initComputeMatrices(const VkDevice vkDevice);
 void terminateComputeMatrices(void);
 
+// Recreates the pipeline from its shader file, keeping the previous pipeline if that fails; the device must be idle.
+bool reloadComputeMatrices(const VkDevice vkDevice);
+
+// Computes the matrices of modelCount models; models past COMPUTE_MATRICES_MODEL_COUNT are left out.
 void computeMatrices(const uint32_t transformBufferDescriptorHandle, const uint32_t matrixBufferDescriptorHandle, 
 		const float deltaTime, const ProjectionBounds projectionBounds, const Vector4F cameraPosition, 
-		const uint32_t *const pCameraFlags, const ModelTransform *const transforms);
+		const uint32_t modelCount, const uint32_t *const pCameraFlags, const ModelTransform *const transforms);
 
 #endif	// COMPUTE_MATRICES_H
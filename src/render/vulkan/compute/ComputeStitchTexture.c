@@ -5,6 +5,7 @@
 #include <string.h>
 #include "log/Logger.h"
 #include "render/render_config.h"
+#include "render/RenderTaskQueue.h"
 #include "util/Allocation.h"
 #include "../CommandBuffer.h"
 #include "../ComputePipeline.h"
@@ -137,9 +138,7 @@ static void createTransferImage(const VkDevice vkDevice) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Created texture stitching transfer image.");
 }
 
-void initComputeStitchTexture(const VkDevice vkDevice) {
-	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing texture stitcher...");
-	
+static Pipeline createRoomTexturePipeline(const VkDevice vkDevice) {
 	const ComputePipelineCreateInfo pipelineCreateInfo = {
 		.vkDevice = vkDevice,
 		.shaderFilename = makeStaticString("RoomTexture.spv"),
@@ -151,7 +150,13 @@ void initComputeStitchTexture(const VkDevice vkDevice) {
 			}
 		}
 	};
-	computeRoomTexturePipeline = createComputePipeline(pipelineCreateInfo);
+	return createComputePipeline(pipelineCreateInfo);
+}
+
+void initComputeStitchTexture(const VkDevice vkDevice) {
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing texture stitcher...");
+	
+	computeRoomTexturePipeline = createRoomTexturePipeline(vkDevice);
 	
 	createTransferImage(vkDevice);
 	
@@ -182,22 +187,47 @@ void terminateComputeStitchTexture(void) {
 	deletePipeline(&computeRoomTexturePipeline);
 }
 
-void computeStitchTexture(const int tilemapTextureHandle, const int destinationTextureHandle, const ImageSubresourceRange destinationRange, const Extent tileExtent, uint32_t **tileIndices) {
+bool reloadComputeStitchTexture(const VkDevice vkDevice) {
+	const Pipeline pipeline = createRoomTexturePipeline(vkDevice);
+	if (!validatePipeline(pipeline)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Reloading texture stitcher: failed to create pipeline, keeping the previous one.");
+		return false;
+	}
+	deletePipeline(&computeRoomTexturePipeline);
+	computeRoomTexturePipeline = pipeline;
+	return true;
+}
+
+// A texture to stitch on the render thread; the tile indices of each layer are stored one after another after the struct.
+typedef struct StitchTexture {
+	int tilemapTextureHandle;
+	int destinationTextureHandle;
+	ImageSubresourceRange destinationRange;
+	Extent tileExtent;
+	uint32_t tileIndices[];
+} StitchTexture;
+
+static void runStitchTexture(void *pData) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Stitching texture...");
 	
-	const Texture tilemapTexture = getTexture(tilemapTextureHandle);
-	Texture *const pRoomTexture = getTextureP(destinationTextureHandle);
-	if (!pRoomTexture) {
+	const StitchTexture *const pStitch = pData;
+	const ImageSubresourceRange destinationRange = pStitch->destinationRange;
+	const Extent tileExtent = pStitch->tileExtent;
+	if (!validateTextureHandle(pStitch->destinationTextureHandle)) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Stitching texture: could not get room texture.");
 		return;
 	}
+	const Texture tilemapTexture = getTexture(pStitch->tilemapTextureHandle);
+	
+	// The room image is transitioned through a copy, and its final usage is stored back into the texture once recorded.
+	Image roomImage = getTexture(pStitch->destinationTextureHandle).image;
 	
 	uint8_t *mappedMemory = buffer_partition_map_memory(global_uniform_buffer_partition, 1); {
 		const uint32_t numTileIndices = extentArea(tileExtent);
-		const uint32_t layerSize = numTileIndices * sizeof(**tileIndices);
-		const uint32_t fullLayerSize = 640 * sizeof(**tileIndices);
+		const uint32_t layerSize = numTileIndices * sizeof(*pStitch->tileIndices);
+		const uint32_t fullLayerSize = 640 * sizeof(*pStitch->tileIndices);
 		for (uint32_t i = 0; i < destinationRange.arrayLayerCount; ++i) {
-			memcpy(&mappedMemory[fullLayerSize * i], tileIndices[i], layerSize);
+			memcpy(&mappedMemory[fullLayerSize * i], &pStitch->tileIndices[numTileIndices * i], layerSize);
 		}
 	} buffer_partition_unmap_memory(global_uniform_buffer_partition);
 	
@@ -245,7 +275,7 @@ void computeStitchTexture(const int tilemapTextureHandle, const int destinationT
 		// Transition the compute texture to transfer source and the destination texture to transfer destination.
 		const VkImageMemoryBarrier2 imageMemoryBarriers1[2] = {
 			[0] = makeImageTransitionBarrier(transferImage, imageSubresourceRange, imageUsageTransferSource),
-			[1] = makeImageTransitionBarrier(pRoomTexture->image, imageSubresourceRange, imageUsageTransferDestination)
+			[1] = makeImageTransitionBarrier(roomImage, imageSubresourceRange, imageUsageTransferDestination)
 		};
 		const VkDependencyInfo dependencyInfo1 = {
 			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
@@ -260,7 +290,7 @@ void computeStitchTexture(const int tilemapTextureHandle, const int destinationT
 		};
 		vkCmdPipelineBarrier2(cmdBuf, &dependencyInfo1);
 		transferImage.usage = imageUsageTransferSource;
-		pRoomTexture->image.usage = imageUsageTransferDestination;
+		roomImage.usage = imageUsageTransferDestination;
 	
 		const ImageSubresourceRange sourceRange = {
 			.imageAspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -275,8 +305,8 @@ void computeStitchTexture(const int tilemapTextureHandle, const int destinationT
 			.dstSubresource = makeImageSubresourceLayers(destinationRange),
 			.dstOffset = (VkOffset3D){ 0, 0, 0 },
 			.extent = (VkExtent3D){
-				.width = pRoomTexture->image.extent.width,
-				.height = pRoomTexture->image.extent.length,
+				.width = roomImage.extent.width,
+				.height = roomImage.extent.length,
 				.depth = 1
 			}
 		};
@@ -285,8 +315,8 @@ void computeStitchTexture(const int tilemapTextureHandle, const int destinationT
 			.pNext = nullptr,
 			.srcImage = transferImage.vkImage,
 			.srcImageLayout = transferImage.usage.imageLayout,
-			.dstImage = pRoomTexture->image.vkImage,
-			.dstImageLayout = pRoomTexture->image.usage.imageLayout,
+			.dstImage = roomImage.vkImage,
+			.dstImageLayout = roomImage.usage.imageLayout,
 			.regionCount = 1,
 			.pRegions = &imageCopyRegion
 		};
@@ -295,7 +325,7 @@ void computeStitchTexture(const int tilemapTextureHandle, const int destinationT
 		// Transition the compute texture to general and the destination texture to sampled.
 		const VkImageMemoryBarrier2 imageMemoryBarriers2[2] = {
 			[0] = makeImageTransitionBarrier(transferImage, imageSubresourceRange, imageUsageComputeWrite),
-			[1] = makeImageTransitionBarrier(pRoomTexture->image, imageSubresourceRange, imageUsageSampled)
+			[1] = makeImageTransitionBarrier(roomImage, imageSubresourceRange, imageUsageSampled)
 		};
 		const VkDependencyInfo dependencyInfo2 = {
 			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
@@ -310,7 +340,7 @@ void computeStitchTexture(const int tilemapTextureHandle, const int destinationT
 		};
 		vkCmdPipelineBarrier2(cmdBuf, &dependencyInfo2);
 		transferImage.usage = imageUsageComputeWrite;
-		pRoomTexture->image.usage = imageUsageSampled;
+		roomImage.usage = imageUsageSampled;
 	);
 	
 	const VkCommandBufferSubmitInfo transferImageCmdBufSubmitInfo = {
@@ -331,6 +361,24 @@ void computeStitchTexture(const int tilemapTextureHandle, const int destinationT
 	};
 	vkQueueSubmit2(queueGraphics, 1, &transferImageSubmitInfo, transferImageFence);
 	vkQueueWaitIdle(queueGraphics);
+	textureSetImageUsage(pStitch->destinationTextureHandle, roomImage.usage);
 
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Done stitching texture.");
 }
+
+void computeStitchTexture(const int tilemapTextureHandle, const int destinationTextureHandle, const ImageSubresourceRange destinationRange, const Extent tileExtent, uint32_t **tileIndices) {
+	const uint32_t numTileIndices = extentArea(tileExtent);
+	StitchTexture *const pStitch = heapAlloc(1, sizeof(StitchTexture) + (size_t)destinationRange.arrayLayerCount * numTileIndices * sizeof(uint32_t));
+	if (!pStitch) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Stitching texture: failed to allocate stitch task.");
+		return;
+	}
+	pStitch->tilemapTextureHandle = tilemapTextureHandle;
+	pStitch->destinationTextureHandle = destinationTextureHandle;
+	pStitch->destinationRange = destinationRange;
+	pStitch->tileExtent = tileExtent;
+	for (uint32_t i = 0; i < destinationRange.arrayLayerCount; ++i) {
+		memcpy(&pStitch->tileIndices[numTileIndices * i], tileIndices[i], numTileIndices * sizeof(uint32_t));
+	}
+	pushRenderTask(runStitchTexture, pStitch);
+}
@@ -12,6 +12,10 @@ void initComputeStitchTexture(const VkDevice vkDevice);
 
 void terminateComputeStitchTexture(void);
 
+// Recreates the pipeline from its shader file, keeping the previous pipeline if that fails; the device must be idle.
+bool reloadComputeStitchTexture(const VkDevice vkDevice);
+
+// Queues the destination texture to be stitched from the tilemap texture on the render thread; the tile indices are copied.
 void computeStitchTexture(const int tilemapTextureHandle, const int destinationTextureHandle, const ImageSubresourceRange destinationRange, const Extent tileExtent, uint32_t **tileIndices);
 
 #endif	// COMPUTE_ROOM_TEXTURE_H
@@ -15,7 +15,6 @@ static Frame createFrame(PhysicalDevice physicalDevice, VkDevice vkDevice) {
 		.semaphore_present_ready = (BinarySemaphore){ },
 		.semaphore_render_finished = (TimelineSemaphore){ },
 		.fence_frame_ready = VK_NULL_HANDLE,
-		.semaphore_buffers_ready = (TimelineSemaphore){ },
 		.vertex_buffer = VK_NULL_HANDLE,
 		.index_buffer = VK_NULL_HANDLE
 	};
@@ -29,7 +28,6 @@ static Frame createFrame(PhysicalDevice physicalDevice, VkDevice vkDevice) {
 	frame.semaphore_image_available = create_binary_semaphore(vkDevice);
 	frame.semaphore_present_ready = create_binary_semaphore(vkDevice);
 	frame.semaphore_render_finished = create_timeline_semaphore(vkDevice);
-	frame.semaphore_buffers_ready = create_timeline_semaphore(vkDevice);
 
 	uint32_t queue_family_indices[2] = {
 		*physicalDevice.queueFamilyIndices.graphics_family_ptr,
@@ -68,7 +66,6 @@ static void destroy_frame(VkDevice vkDevice, Frame frame) {
 	destroy_binary_semaphore(&frame.semaphore_image_available);
 	destroy_binary_semaphore(&frame.semaphore_present_ready);
 	destroy_timeline_semaphore(&frame.semaphore_render_finished);
-	destroy_timeline_semaphore(&frame.semaphore_buffers_ready);
 	vkDestroyFence(vkDevice, frame.fence_frame_ready, nullptr);
 	vkDestroyBuffer(vkDevice, frame.vertex_buffer, nullptr);
 	vkDestroyBuffer(vkDevice, frame.index_buffer, nullptr);
@@ -76,7 +73,7 @@ static void destroy_frame(VkDevice vkDevice, Frame frame) {
 
 FrameArray createFrameArray(const FrameArrayCreateInfo frameArrayCreateInfo) {
 
-	static const uint32_t max_num_frames = 3;
+	static const uint32_t max_num_frames = MAX_NUM_FRAMES_IN_FLIGHT;
 
 	FrameArray frameArray = { 
 		.current_frame = 0,
@@ -102,8 +99,8 @@ FrameArray createFrameArray(const FrameArrayCreateInfo frameArrayCreateInfo) {
 		return (FrameArray){ };
 	}
 	
-	MemoryRange vertex_buffer_memory_ranges[3];
-	MemoryRange index_buffer_memory_ranges[3];
+	MemoryRange vertex_buffer_memory_ranges[MAX_NUM_FRAMES_IN_FLIGHT];
+	MemoryRange index_buffer_memory_ranges[MAX_NUM_FRAMES_IN_FLIGHT];
 	VkDeviceSize total_vertex_memory_size = 0;
 	VkDeviceSize total_index_memory_size = 0;
 
@@ -179,7 +176,7 @@ FrameArray createFrameArray(const FrameArrayCreateInfo frameArrayCreateInfo) {
 	vkQueueSubmit2(queueGraphics, 1, &submitInfo, VK_NULL_HANDLE);
 	vkQueueWaitIdle(queueGraphics);
 	
-	frameArray.cmdBufArray = cmdBufAlloc(frameArrayCreateInfo.commandPool, frameArrayCreateInfo.num_frames);
+	frameArray.cmdBufArray = cmdBufAlloc(frameArrayCreateInfo.commandPool, frameArray.num_frames);
 
 	return frameArray;
 }
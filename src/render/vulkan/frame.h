@@ -26,12 +26,6 @@ typedef struct Frame {
 	// Signaled when this frame is done being presented.
 	VkFence fence_frame_ready;
 
-	// Signaled when the buffers are fully updated after a transfer operation.
-	// Unsignaled when there is a pending transfer operation;
-	// 	this can be either when a request is put in to update the buffer data, 
-	// 	OR when the request is being currently fulfilled.
-	TimelineSemaphore semaphore_buffers_ready;
-
 	VkBuffer vertex_buffer;
 	VkBuffer index_buffer;
 
@@ -96,6 +96,7 @@ void create_device(VulkanInstance vulkan_instance, PhysicalDevice physical_devic
 		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
 		.pNext = &features11,
 		.features = (VkPhysicalDeviceFeatures){ 
+			.drawIndirectFirstInstance = VK_TRUE,
 			.samplerAnisotropy = VK_TRUE
 		}
 	};
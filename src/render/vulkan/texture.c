@@ -148,10 +148,17 @@ static VkImageUsageFlags getTextureImageUsage(const TextureCreateInfo textureCre
 
 static VkImage createTextureImage(const VkDevice vkDevice, const uint32_t arrayLayerCount, const TextureCreateInfo textureCreateInfo) {
 
-	uint32_t queueFamilyIndices[2];
+	uint32_t queueFamilyIndices[3];
+	uint32_t queueFamilyIndexCount = 2;
 	if (textureCreateInfo.isTilemap) {
 		queueFamilyIndices[0] = *physical_device.queueFamilyIndices.transfer_family_ptr;
 		queueFamilyIndices[1] = *physical_device.queueFamilyIndices.compute_family_ptr;
+		
+		// Tilemaps are also read by the graphics pipeline when rooms are drawn directly from their tileset.
+		const uint32_t graphicsFamilyIndex = *physical_device.queueFamilyIndices.graphics_family_ptr;
+		if (graphicsFamilyIndex != queueFamilyIndices[0] && graphicsFamilyIndex != queueFamilyIndices[1]) {
+			queueFamilyIndices[queueFamilyIndexCount++] = graphicsFamilyIndex;
+		}
 	} else {
 		queueFamilyIndices[0] = *physical_device.queueFamilyIndices.graphics_family_ptr;
 		queueFamilyIndices[1] = *physical_device.queueFamilyIndices.transfer_family_ptr;
@@ -172,7 +179,7 @@ static VkImage createTextureImage(const VkDevice vkDevice, const uint32_t arrayL
 		.tiling = VK_IMAGE_TILING_OPTIMAL,
 		.usage = getTextureImageUsage(textureCreateInfo),
 		.sharingMode = VK_SHARING_MODE_CONCURRENT,
-		.queueFamilyIndexCount = 2,
+		.queueFamilyIndexCount = queueFamilyIndexCount,
 		.pQueueFamilyIndices = queueFamilyIndices,
 		.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
 	};
@@ -288,6 +295,22 @@ Texture createTexture(const TextureCreateInfo textureCreateInfo) {
 	return texture;
 }
 
+Texture createHeadlessTexture(const TextureCreateInfo textureCreateInfo) {
+	Texture texture = nullTexture;
+	texture.numAnimations = textureCreateInfo.numAnimations;
+	texture.isLoaded = textureCreateInfo.isLoaded;
+	texture.isTilemap = textureCreateInfo.isTilemap;
+	texture.animations = heapAlloc(texture.numAnimations, sizeof(TextureAnimation));
+	if (!texture.animations) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Creating headless texture: failed to allocate animations array.");
+		return nullTexture;
+	}
+	memcpy(texture.animations, textureCreateInfo.animations, textureCreateInfo.numAnimations * sizeof(TextureAnimation));
+	texture.image.arrayLayerCount = textureCreateInfo.numCells.width * textureCreateInfo.numCells.length;
+	texture.image.extent = textureCreateInfo.cellExtent;
+	return texture;
+}
+
 bool deleteTexture(Texture *const pTexture) {
 	if (!pTexture) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error deleting texture: pointer to texture object is null.");
@@ -128,6 +128,10 @@ bool textureIsNull(const Texture texture);
 // Creates and returns a blank texture with undefined layout.
 Texture createTexture(const TextureCreateInfo textureCreateInfo);
 
+// Creates a texture with the animations and cell layout of the create info, but no image, for rendering headless.
+// The texture is still null; only its animations have to be freed.
+Texture createHeadlessTexture(const TextureCreateInfo textureCreateInfo);
+
 // Frees the memory (both CPU and GPU) used by the texture and resets the texture to null state.
 // Returns true if executed successfully, false otherwise.
 bool deleteTexture(Texture *const pTexture);
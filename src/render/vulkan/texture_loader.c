@@ -3,7 +3,6 @@
 #include <stdint.h>
 #include <string.h>
 #include <vulkan/vulkan.h>
-#include "config.h"
 #include "log/Logger.h"
 #include "render/stb/ImageData.h"
 #include "util/Allocation.h"
@@ -11,7 +10,16 @@
 #include "CommandBuffer.h"
 #include "VulkanManager.h"
 
-#define TEXTURE_PATH (RESOURCE_PATH "assets/textures/")
+#define TEXTURE_PATH "assets/textures/"
+
+static const VkDeviceSize numImageChannels = 4;
+
+// Subresource range used in all image views and layout transitions.
+static const ImageSubresourceRange imageSubresourceRange = {
+	.imageAspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+	.baseArrayLayer = 0,
+	.arrayLayerCount = VK_REMAINING_ARRAY_LAYERS
+};
 
 static String textureIDToPath(const String textureID) {
 	
@@ -29,11 +37,85 @@ static String textureIDToPath(const String textureID) {
 	return path;
 }
 
+// Records a copy of each cell of the atlas in the image staging buffer into its own array layer of the image.
+// Returns true if successful, false otherwise.
+static bool cmdCopyCells(const VkCommandBuffer cmdBuf, const Image image, const Extent numCells, const Extent cellExtent) {
+
+	const uint32_t numBufImgCopies = image.arrayLayerCount;
+	VkBufferImageCopy2 *bufImgCopies = heapAlloc(numBufImgCopies, sizeof(VkBufferImageCopy2));
+	if (!bufImgCopies) {
+		return false;
+	}
+
+	const uint32_t atlasExtentWidth = numCells.width * cellExtent.width;
+	const uint32_t atlasExtentLength = numCells.length * cellExtent.length;
+	const VkDeviceSize buffer_partition_offset = global_staging_buffer_partition.ranges[2].offset;
+	for (uint32_t i = 0; i < numBufImgCopies; ++i) {
+		bufImgCopies[i].sType = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2;
+		bufImgCopies[i].pNext = nullptr;
+
+		const uint32_t cell_offset = i;
+		const uint32_t cell_offset_x = cell_offset % numCells.width;
+		const uint32_t cell_offset_y = cell_offset / numCells.width;
+
+		const uint32_t texel_offset_x = cell_offset_x * cellExtent.width;
+		const uint32_t texel_offset_y = cell_offset_y * cellExtent.length;
+		const uint32_t texel_offset = texel_offset_y * atlasExtentWidth + texel_offset_x;
+
+		bufImgCopies[i].bufferOffset = buffer_partition_offset + (VkDeviceSize)texel_offset * numImageChannels;
+		bufImgCopies[i].bufferRowLength = atlasExtentWidth;
+		bufImgCopies[i].bufferImageHeight = atlasExtentLength;
+
+		bufImgCopies[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		bufImgCopies[i].imageSubresource.mipLevel = 0;
+		bufImgCopies[i].imageSubresource.baseArrayLayer = i;
+		bufImgCopies[i].imageSubresource.layerCount = 1;
+
+		bufImgCopies[i].imageOffset.x = 0;
+		bufImgCopies[i].imageOffset.y = 0;
+		bufImgCopies[i].imageOffset.z = 0;
+
+		bufImgCopies[i].imageExtent.width = cellExtent.width;
+		bufImgCopies[i].imageExtent.height = cellExtent.length;
+		bufImgCopies[i].imageExtent.depth = 1;
+	}
+
+	const VkCopyBufferToImageInfo2 copy_info = {
+		.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2,
+		.pNext = nullptr,
+		.srcBuffer = global_staging_buffer_partition.buffer,
+		.dstImage = image.vkImage,
+		.dstImageLayout = image.usage.imageLayout,
+		.regionCount = numBufImgCopies,
+		.pRegions = bufImgCopies
+	};
+
+	vkCmdCopyBufferToImage2(cmdBuf, &copy_info);
+
+	bufImgCopies = heapFree(bufImgCopies);
+	return true;
+}
+
+static void cmdTransitionImage(const VkCommandBuffer cmdBuf, Image *const pImage, const ImageUsage newUsage) {
+	const VkImageMemoryBarrier2 imageMemoryBarrier = makeImageTransitionBarrier(*pImage, imageSubresourceRange, newUsage);
+	const VkDependencyInfo dependencyInfo = {
+		.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+		.pNext = nullptr,
+		.dependencyFlags = 0,
+		.memoryBarrierCount = 0,
+		.pMemoryBarriers = nullptr,
+		.bufferMemoryBarrierCount = 0,
+		.pBufferMemoryBarriers = nullptr,
+		.imageMemoryBarrierCount = 1,
+		.pImageMemoryBarriers = &imageMemoryBarrier
+	};
+	vkCmdPipelineBarrier2(cmdBuf, &dependencyInfo);
+	pImage->usage = newUsage;
+}
+
 // Loaded textures are required to have animation create infos all with the same extent.
 Texture loadTexture(const TextureCreateInfo textureCreateInfo) {
 
-	static const VkDeviceSize numImageChannels = 4;
-
 	// TODO: modify this to use semaphores between image transitions and data transfer operations.
 
 	if (stringIsNull(textureCreateInfo.textureID)) {
@@ -78,72 +160,12 @@ Texture loadTexture(const TextureCreateInfo textureCreateInfo) {
 	deleteImageData(&base_image_data);
 	buffer_partition_unmap_memory(global_staging_buffer_partition);
 	
-	// Subresource range used in all image views and layout transitions.	
-	static const ImageSubresourceRange imageSubresourceRange = {
-		.imageAspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-		.baseArrayLayer = 0,
-		.arrayLayerCount = VK_REMAINING_ARRAY_LAYERS
-	};
-
 	// Transfer image data to texture images.
 	CmdBufArray transferCmdBufs = cmdBufAlloc(commandPoolTransfer, 1);
 	recordCommands(transferCmdBufs, 0, true,
-		
-		const uint32_t numBufImgCopies = texture.image.arrayLayerCount;
-		VkBufferImageCopy2 *bufImgCopies = heapAlloc(numBufImgCopies, sizeof(VkBufferImageCopy2));
-		if (!bufImgCopies) {
+		if (!cmdCopyCells(cmdBuf, texture.image, textureCreateInfo.numCells, textureCreateInfo.cellExtent)) {
 			logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error loading texture: failed to allocate copy region pointer-array.");
-			// TODO - do proper cleanup here.
-			return texture;
 		}
-
-		const VkDeviceSize buffer_partition_offset = global_staging_buffer_partition.ranges[2].offset;
-		for (uint32_t i = 0; i < numBufImgCopies; ++i) {
-			bufImgCopies[i].sType = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2;
-			bufImgCopies[i].pNext = nullptr;
-
-			const uint32_t atlasExtentWidth = textureCreateInfo.numCells.width * textureCreateInfo.cellExtent.width;
-			const uint32_t atlasExtentLength = textureCreateInfo.numCells.length * textureCreateInfo.cellExtent.length;
-
-			const uint32_t cell_offset = i;
-			const uint32_t cell_offset_x = cell_offset % textureCreateInfo.numCells.width;
-			const uint32_t cell_offset_y = cell_offset / textureCreateInfo.numCells.width;
-
-			const uint32_t texel_offset_x = cell_offset_x * textureCreateInfo.cellExtent.width;
-			const uint32_t texel_offset_y = cell_offset_y * textureCreateInfo.cellExtent.length;
-			const uint32_t texel_offset = texel_offset_y * atlasExtentWidth + texel_offset_x;
-
-			bufImgCopies[i].bufferOffset = buffer_partition_offset + (VkDeviceSize)texel_offset * numImageChannels;
-			bufImgCopies[i].bufferRowLength = atlasExtentWidth;
-			bufImgCopies[i].bufferImageHeight = atlasExtentLength;
-
-			bufImgCopies[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			bufImgCopies[i].imageSubresource.mipLevel = 0;
-			bufImgCopies[i].imageSubresource.baseArrayLayer = i;
-			bufImgCopies[i].imageSubresource.layerCount = 1;
-
-			bufImgCopies[i].imageOffset.x = 0;
-			bufImgCopies[i].imageOffset.y = 0;
-			bufImgCopies[i].imageOffset.z = 0;
-
-			bufImgCopies[i].imageExtent.width = textureCreateInfo.cellExtent.width;
-			bufImgCopies[i].imageExtent.height = textureCreateInfo.cellExtent.length;
-			bufImgCopies[i].imageExtent.depth = 1;
-		}
-
-		const VkCopyBufferToImageInfo2 copy_info = {
-			.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2,
-			.pNext = nullptr,
-			.srcBuffer = global_staging_buffer_partition.buffer,
-			.dstImage = texture.image.vkImage,
-			.dstImageLayout = texture.image.usage.imageLayout,
-			.regionCount = numBufImgCopies,
-			.pRegions = bufImgCopies
-		};
-
-		vkCmdCopyBufferToImage2(cmdBuf, &copy_info);
-
-		bufImgCopies = heapFree(bufImgCopies);
 	);
 
 	{	// Second submit // TODO: use vkQueueSubmit2
@@ -164,21 +186,7 @@ Texture loadTexture(const TextureCreateInfo textureCreateInfo) {
 	// Command buffer for second image layout transition (transfer destination to sampled).
 	CmdBufArray transitionCmdBufs = cmdBufAlloc(commandPoolGraphics, 1);
 	recordCommands(transitionCmdBufs, 0, true,
-		const ImageUsage imageUsage = textureCreateInfo.isTilemap ? imageUsageComputeRead : imageUsageSampled;
-		const VkImageMemoryBarrier2 imageMemoryBarrier = makeImageTransitionBarrier(texture.image, imageSubresourceRange, imageUsage);
-		const VkDependencyInfo dependencyInfo = {
-			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-			.pNext = nullptr,
-			.dependencyFlags = 0,
-			.memoryBarrierCount = 0,
-			.pMemoryBarriers = nullptr,
-			.bufferMemoryBarrierCount = 0,
-			.pBufferMemoryBarriers = nullptr,
-			.imageMemoryBarrierCount = 1,
-			.pImageMemoryBarriers = &imageMemoryBarrier
-		};
-		vkCmdPipelineBarrier2(cmdBuf, &dependencyInfo);
-		texture.image.usage = imageUsage;
+		cmdTransitionImage(cmdBuf, &texture.image, textureCreateInfo.isTilemap ? imageUsageComputeRead : imageUsageSampled);
 	);
 
 	VkPipelineStageFlags transition_1_stage_flags[1] = { VK_PIPELINE_STAGE_TRANSFER_BIT };
@@ -207,3 +215,64 @@ Texture loadTexture(const TextureCreateInfo textureCreateInfo) {
 
 	return texture;
 }
+
+bool reloadTexture(const String textureID, Texture *const pTexture) {
+	if (!pTexture || !pTexture->isLoaded || !validateImage(pTexture->image)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reloading texture: texture is not a loaded texture.");
+		return false;
+	}
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Reloading texture \"%s\"...", textureID.pBuffer);
+
+	String path = textureIDToPath(textureID);
+	ImageData imageData = loadImageData(path.pBuffer, numImageChannels);
+	deleteString(&path);
+	if (!imageData.pPixels) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reloading texture: failed to load image data.");
+		return false;
+	}
+
+	// The image is reused as it is, so the new atlas must still hold a cell of the old extent for each array layer.
+	const Extent cellExtent = pTexture->image.extent;
+	const Extent numCells = {
+		.width = (uint32_t)(imageData.width / cellExtent.width),
+		.length = (uint32_t)(imageData.height / cellExtent.length)
+	};
+	const VkDeviceSize imageSize = (VkDeviceSize)imageData.width * imageData.height * numImageChannels;
+	if (imageData.width % cellExtent.width != 0 || imageData.height % cellExtent.length != 0
+			|| (uint64_t)numCells.width * numCells.length < pTexture->image.arrayLayerCount) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reloading texture: image size (%zu, %zu) does not fit the texture's cells; restart to load it.", imageData.width, imageData.height);
+		deleteImageData(&imageData);
+		return false;
+	} else if (imageSize > global_staging_buffer_partition.ranges[2].size) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reloading texture: image data (%llu bytes) does not fit in the staging buffer.", (unsigned long long)imageSize);
+		deleteImageData(&imageData);
+		return false;
+	}
+
+	uint8_t *const pMappedMemory = buffer_partition_map_memory(global_staging_buffer_partition, 2);
+	memcpy(pMappedMemory, imageData.pPixels, imageSize);
+	buffer_partition_unmap_memory(global_staging_buffer_partition);
+	deleteImageData(&imageData);
+
+	// The image may be in use by frames in flight, so the copy waits for the device, 
+	// 	and then runs on the graphics queue between a transition into and out of the transfer layout.
+	vkDeviceWaitIdle(device);
+	const ImageUsage previousUsage = pTexture->image.usage;
+	bool copyRecorded = false;
+	CmdBufArray cmdBufArray = cmdBufAlloc(commandPoolGraphics, 1);
+	recordCommands(cmdBufArray, 0, true,
+		cmdTransitionImage(cmdBuf, &pTexture->image, imageUsageTransferDestination);
+		copyRecorded = cmdCopyCells(cmdBuf, pTexture->image, numCells, cellExtent);
+		cmdTransitionImage(cmdBuf, &pTexture->image, previousUsage);
+	);
+	submit_command_buffers_async(queueGraphics, 1, &cmdBufArray.pCmdBufs[0]);
+	vkQueueWaitIdle(queueGraphics);
+	cmdBufFree(&cmdBufArray);
+
+	if (!copyRecorded) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reloading texture: failed to allocate copy region pointer-array.");
+		return false;
+	}
+	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Reloaded texture \"%s\".", textureID.pBuffer);
+	return true;
+}
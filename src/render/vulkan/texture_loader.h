@@ -10,4 +10,9 @@ void destroy_image_staging_buffer(void);
 
 Texture loadTexture(const TextureCreateInfo texture_create_info);
 
+// Loads the image of a loaded texture again and uploads its cells into the texture's existing array layers.
+// The image must still have the texture's cell extent and at least as many cells as the texture has layers.
+// Returns true if successful, false otherwise.
+bool reloadTexture(const String textureID, Texture *const pTexture);
+
 #endif	// VK_TEXTURE_LOADER_H
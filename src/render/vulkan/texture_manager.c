@@ -1,5 +1,6 @@
 #include "texture_manager.h"
 
+#include <pthread.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -8,7 +9,11 @@
 #include <vulkan/vulkan.h>
 #include "config.h"
 #include "log/Logger.h"
+#include "render/render_config.h"
+#include "render/RenderTaskQueue.h"
 #include "util/Allocation.h"
+#include "util/HashMap.h"
+#include "util/StringTable.h"
 #include "buffer.h"
 #include "CommandBuffer.h"
 #include "texture.h"
@@ -18,26 +23,33 @@
 
 #define TEXTURE_PATH (RESOURCE_PATH "assets/textures/")
 
-#define NUM_TEXTURES 67
+#define INITIAL_TEXTURE_CAPACITY 64
 
-typedef struct TextureRecord {
-	String textureID;
-	int textureHandle;
-} TextureRecord;
+// Textures are indexed by handle; the array grows as textures are loaded.
+static int numTexturesLoaded = 0;
+static int textureCapacity = 0;
+static Texture *pTextures = nullptr;
 
-const int numTextures = NUM_TEXTURES;
-int numTexturesLoaded = 0;
+// The render thread changes the usage of texture images while the simulation thread reads textures, so copies and usage changes hold this lock.
+static pthread_mutex_t textureMutex = PTHREAD_MUTEX_INITIALIZER;
 
-static Texture textures[NUM_TEXTURES];
-static TextureRecord textureRecords[NUM_TEXTURES];
+// Maps interned texture IDs to texture handles.
+static HashMap textureRecords = { };
 
 static bool textureManagerInitialized = false;
 
 const int textureHandleMissing = 0;
 
+// Makes room for at least textureCount textures.
+static bool reserveTextures(const int textureCount);
+
 // Creates a texture record and hashes it.
 static void registerTexture(const int textureHandle, const TextureCreateInfo textureCreateInfo);
 
+// Finds the handle of a registered texture without logging if there is none.
+// Returns true if the texture was found, false otherwise.
+static bool lookupTexture(const StringID textureID, int *const pTextureHandle);
+
 void initTextureManager(void) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing texture manager...");
 	
@@ -46,16 +58,12 @@ void initTextureManager(void) {
 		return;
 	}
 
-	// Nullify each texture first.
-	for (int i = 0; i < numTextures; ++i) {
-		textures[i] = nullTexture;
-	}
-	
-	// Nullify texture records FIRST, hash-collision-resolution relies on records being null to begin with.
-	for (int i = 0; i < numTextures; ++i) {
-		textureRecords[i].textureID = (String){ };
-		textureRecords[i].textureHandle = textureHandleMissing;
+	numTexturesLoaded = 0;
+	if (!reserveTextures(INITIAL_TEXTURE_CAPACITY)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error initializing texture manager: failed to allocate texture array.");
+		return;
 	}
+	textureRecords = newHashMap(sizeof(int), getStringIDHash);
 	
 	TextureCreateInfo missingTextureCreateInfo = (TextureCreateInfo){
 		.textureID = (String){
@@ -86,11 +94,19 @@ void initTextureManager(void) {
 
 void terminateTextureManager(void) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Terminating texture manager....");
-	for (int i = 0; i < numTextures; ++i) {
-		if (!textureIsNull(textures[i])) {
-			deleteTexture(&textures[i]);
+	for (int i = 0; i < numTexturesLoaded; ++i) {
+		if (!textureIsNull(pTextures[i])) {
+			deleteTexture(&pTextures[i]);
+		} else if (pTextures[i].animations) {
+			pTextures[i].animations = heapFree(pTextures[i].animations);
 		}
 	}
+	if (pTextures) {
+		pTextures = heapFree(pTextures);
+	}
+	numTexturesLoaded = 0;
+	textureCapacity = 0;
+	deleteHashMap(&textureRecords);
 	textureManagerInitialized = false;
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Terminated texture manager.");
 }
@@ -112,9 +128,9 @@ bool textureManagerLoadTexturePack(const TexturePack texturePack) {
 		return false;
 	}
 	
-	const int textureSlotsRemaining = numTextures - numTexturesLoaded;
-	if (textureSlotsRemaining < (int)texturePack.numTextures) {
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error loading texture pack: not enough available texture slots (%i) for texture pack.", textureSlotsRemaining);
+	const int textureCount = numTexturesLoaded + (int)texturePack.numTextures;
+	if (!reserveTextures(textureCount) || !hashMapReserve(&textureRecords, (uint32_t)textureCount)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error loading texture pack: failed to make room for %u textures.", texturePack.numTextures);
 		return false;
 	}
 	
@@ -129,32 +145,32 @@ bool textureManagerLoadTexturePack(const TexturePack texturePack) {
 void textureManagerLoadTexture(const TextureCreateInfo textureCreateInfo) {
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Initializing texture \"%s\"...", textureCreateInfo.textureID.pBuffer);
 	
-	const int textureHandle = numTexturesLoaded++;
-	if (!validateTextureHandle(textureHandle)) {
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error initializing texture: invalid texture handle (%i).", textureHandle);
-		return;
-	}
-	
-	if (!textureIsNull(textures[textureHandle])) {
-		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error initializing texture: texture %i already initialized.", textureHandle);
+	if (!reserveTextures(numTexturesLoaded + 1)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error initializing texture: failed to grow texture array.");
 		return;
 	}
+	const int textureHandle = numTexturesLoaded++;
 	
+	// Headless textures keep their animations for the simulation, but have no image to draw or load.
 	Texture texture = nullTexture;
-	if (textureCreateInfo.isLoaded) {
+	if (isRenderHeadless()) {
+		texture = createHeadlessTexture(textureCreateInfo);
+	} else if (textureCreateInfo.isLoaded) {
 		texture = loadTexture(textureCreateInfo);
 	} else {
 		texture = createTexture(textureCreateInfo);
 	}
 	
-	textures[textureHandle] = texture;
+	pthread_mutex_lock(&textureMutex);
+	pTextures[textureHandle] = texture;
+	pthread_mutex_unlock(&textureMutex);
 	registerTexture(textureHandle, textureCreateInfo);
 	
 	logMsg(loggerVulkan, LOG_LEVEL_VERBOSE, "Done initializing texture \"%s\".", textureCreateInfo.textureID.pBuffer);
 }
 
 bool validateTextureHandle(const int textureHandle) {
-	return textureHandle >= 0 && textureHandle < numTextures;
+	return textureHandle >= 0 && textureHandle < numTexturesLoaded;
 }
 
 int findTexture(const String textureID) {
@@ -163,50 +179,156 @@ int findTexture(const String textureID) {
 		return textureHandleMissing;
 	}
 	
-	size_t hashIndex = stringHash(textureID, (size_t)numTextures);
-	for (size_t i = 0; i < (size_t)numTextures; ++i) {
-		if (stringCompare(textureID, textureRecords[hashIndex].textureID)) {
-			return textureRecords[hashIndex].textureHandle;
-		} else {
-			hashIndex += 1;
-			hashIndex %= (size_t)numTextures;
-		}
+	// Every registered texture ID is interned, so a string that was never interned cannot name a texture.
+	int textureHandle = textureHandleMissing;
+	if (!lookupTexture(findStringID(textureID), &textureHandle)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error finding loaded texture: could not find texture \"%s\".", textureID.pBuffer);
 	}
+	return textureHandle;
+}
+
+int findTextureByID(const StringID textureID) {
+	if (textureID == stringIDNull) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error finding loaded texture: given texture ID is null.");
+		return textureHandleMissing;
+	}
+	
+	int textureHandle = textureHandleMissing;
+	if (!lookupTexture(textureID, &textureHandle)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error finding loaded texture: could not find texture \"%s\".", getInternedString(textureID).pBuffer);
+	}
+	return textureHandle;
+}
+
+// A texture to reload on the render thread; the texture ID is stored after the struct.
+typedef struct TextureReload {
+	int textureHandle;
+	size_t textureIDLength;
+	char textureID[];
+} TextureReload;
+
+static void runTextureReload(void *pData) {
+	const TextureReload *const pReload = pData;
+	const String textureID = {
+		.length = pReload->textureIDLength,
+		.capacity = pReload->textureIDLength + 1,
+		.pBuffer = (char *)pReload->textureID
+	};
 	
-	logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error finding loaded texture: could not find texture \"%s\".", textureID.pBuffer);
-	return textureHandleMissing;
+	// Reloading leaves the image in the usage it had, so a copy of the texture is reloaded, and the texture itself is never written.
+	Texture texture = getTexture(pReload->textureHandle);
+	if (reloadTexture(textureID, &texture)) {
+		logMsg(loggerVulkan, LOG_LEVEL_INFO, "Reloaded texture \"%s\".", textureID.pBuffer);
+	} else {
+		logMsg(loggerVulkan, LOG_LEVEL_WARNING, "Texture \"%s\" was not reloaded.", textureID.pBuffer);
+	}
+}
+
+bool textureManagerReloadTexture(const String textureID, int *const pTextureHandle) {
+	int textureHandle = textureHandleMissing;
+	if (stringIsNull(textureID) || !lookupTexture(findStringID(textureID), &textureHandle)) {
+		return false;
+	}
+	
+	TextureReload *const pReload = heapAlloc(1, sizeof(TextureReload) + textureID.length + 1);
+	if (!pReload) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error reloading texture: failed to allocate reload task.");
+		return false;
+	}
+	pReload->textureHandle = textureHandle;
+	pReload->textureIDLength = textureID.length;
+	memcpy(pReload->textureID, textureID.pBuffer, textureID.length);
+	
+	if (pTextureHandle) {
+		*pTextureHandle = textureHandle;
+	}
+	return pushRenderTask(runTextureReload, pReload);
 }
 
 Texture getTexture(const int textureHandle) {
 	if (!validateTextureHandle(textureHandle)) {
 		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error getting loaded texture: texture handle (%u) is invalid.", textureHandle);
-		return textures[textureHandleMissing];
+		if (numTexturesLoaded == 0) {
+			return nullTexture;
+		}
+		pthread_mutex_lock(&textureMutex);
+		const Texture texture = pTextures[textureHandleMissing];
+		pthread_mutex_unlock(&textureMutex);
+		return texture;
+	}
+	pthread_mutex_lock(&textureMutex);
+	const Texture texture = pTextures[textureHandle];
+	pthread_mutex_unlock(&textureMutex);
+	return texture;
+}
+
+void textureSetImageUsage(const int textureHandle, const ImageUsage usage) {
+	if (!validateTextureHandle(textureHandle)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error setting texture image usage: texture handle (%u) is invalid.", textureHandle);
+		return;
 	}
-	return textures[textureHandle];
+	pthread_mutex_lock(&textureMutex);
+	pTextures[textureHandle].image.usage = usage;
+	pthread_mutex_unlock(&textureMutex);
 }
 
 Texture *getTextureP(const int textureHandle) {
 	if (!validateTextureHandle(textureHandle)) {
-		return &textures[textureHandleMissing];
+		return &pTextures[textureHandleMissing];
+	}
+	return &pTextures[textureHandle];
+}
+
+static bool reserveTextures(const int textureCount) {
+	if (textureCount <= textureCapacity) {
+		return true;
+	}
+	
+	int newCapacity = textureCapacity > 0 ? textureCapacity : INITIAL_TEXTURE_CAPACITY;
+	while (newCapacity < textureCount) {
+		newCapacity *= 2;
+	}
+	
+	Texture *const pNewTextures = heapAlloc((size_t)newCapacity, sizeof(Texture));
+	if (!pNewTextures) {
+		return false;
+	}
+	for (int i = 0; i < newCapacity; ++i) {
+		pNewTextures[i] = i < numTexturesLoaded ? pTextures[i] : nullTexture;
+	}
+	pthread_mutex_lock(&textureMutex);
+	Texture *const pOldTextures = pTextures;
+	pTextures = pNewTextures;
+	textureCapacity = newCapacity;
+	pthread_mutex_unlock(&textureMutex);
+	if (pOldTextures) {
+		heapFree(pOldTextures);
 	}
-	return &textures[textureHandle];
+	return true;
 }
 
 static void registerTexture(const int textureHandle, const TextureCreateInfo textureCreateInfo) {
+	// Textures without an ID (e.g. room textures) are only used through their handles.
+	if (stringIsNull(textureCreateInfo.textureID)) {
+		return;
+	}
 	
-	const TextureRecord textureRecord = {
-		.textureID = deepCopyString(textureCreateInfo.textureID),
-		.textureHandle = textureHandle
-	};
+	const StringID textureID = internString(textureCreateInfo.textureID);
+	if (textureID == stringIDNull) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error registering texture %i: failed to intern texture ID.", textureHandle);
+		return;
+	}
 	
-	size_t hashIndex = stringHash(textureRecord.textureID, (size_t)numTextures);
-	for (size_t i = 0; i < (size_t)numTextures; ++i) {
-		if (stringIsNull(textureRecords[hashIndex].textureID)) {
-			textureRecords[hashIndex] = textureRecord;
-			break;
-		} else {
-			hashIndex += 1;
-			hashIndex %= (size_t)numTextures;
-		}
+	if (!hashMapInsert(&textureRecords, textureID, &textureHandle)) {
+		logMsg(loggerVulkan, LOG_LEVEL_ERROR, "Error registering texture %i: failed to insert texture record.", textureHandle);
+	}
+}
+
+static bool lookupTexture(const StringID textureID, int *const pTextureHandle) {
+	const int *const pTextureHandleFound = hashMapFind(&textureRecords, textureID);
+	if (!pTextureHandleFound) {
+		return false;
 	}
+	*pTextureHandle = *pTextureHandleFound;
+	return true;
 }
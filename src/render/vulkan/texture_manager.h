@@ -7,10 +7,10 @@
 #include "game/area/room.h"
 #include "render/texture_pack.h"
 #include "util/String.h"
+#include "util/StringTable.h"
 
 #include "texture.h"
 
-extern const int numTextures;
 extern const int textureHandleMissing;
 
 void initTextureManager(void);
@@ -23,16 +23,27 @@ bool textureManagerLoadTexturePack(const TexturePack texturePack);
 // Creates a texture and loads it into the texture manager.
 void textureManagerLoadTexture(const TextureCreateInfo textureCreateInfo);
 
+// Queues the image of a loaded texture to be reloaded in place on the render thread, keeping its handle; pTextureHandle receives the handle if it is not null.
+// Returns false if no loaded texture has the given texture ID or if the reload could not be queued, true otherwise; a failed reload is only logged.
+bool textureManagerReloadTexture(const String textureID, int *const pTextureHandle);
+
 // Returns true if the texture handle is a valid texture handle, false otherwise.
 bool validateTextureHandle(const int textureHandle);
 
 // Finds a texture with the given texture ID and returns a handle to it.
 int findTexture(const String textureID);
 
+// Finds a texture with the given interned texture ID and returns a handle to it.
+int findTextureByID(const StringID textureID);
+
 // Returns a texture from the array of loaded texture directly from the texture handle.
 Texture getTexture(const int textureHandle);
 
+// Sets the usage of a texture's image after the render thread transitions it; only call on the render thread.
+void textureSetImageUsage(const int textureHandle, const ImageUsage usage);
+
 // Returns the pointer to a texture from the array of loaded texture directly from the texture handle.
+// The pointer is invalidated when another texture is loaded.
 Texture *getTextureP(const int textureHandle);
 
 #endif	// TEXTURE_MANAGER_H
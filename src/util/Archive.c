@@ -0,0 +1,268 @@
+#include "Archive.h"
+
+#include <string.h>
+#include "log/Logger.h"
+#include "util/Allocation.h"
+#include "util/BinaryReader.h"
+#include "util/FileIO.h"
+#include "util/LZ4.h"
+
+// Orders entries by name hash, and then by name for the rare names with the same hash.
+static int compareEntryKeys(const uint64_t hashA, const char *const pNameA, const uint64_t hashB, const char *const pNameB) {
+	if (hashA != hashB) {
+		return hashA < hashB ? -1 : 1;
+	}
+	return strcmp(pNameA, pNameB);
+}
+
+// Reads bytes at an offset in the archive file.
+// Returns true if every byte was read, false otherwise.
+static bool readArchiveBytes(Archive *const pArchive, const uint64_t offset, const size_t size, void *const pOutput) {
+	pthread_mutex_lock(&pArchive->streamMutex);
+	const bool result = fseek(pArchive->pStream, (long int)offset, SEEK_SET) == 0
+			&& fread(pOutput, 1, size, pArchive->pStream) == size;
+	pthread_mutex_unlock(&pArchive->streamMutex);
+	return result;
+}
+
+// Frees what an archive has opened or allocated so far; used both when opening fails and when closing.
+static void releaseArchive(Archive *const pArchive) {
+	if (pArchive->pEntries) {
+		heapFree(pArchive->pEntries);
+	}
+	if (pArchive->pIndexData) {
+		heapFree(pArchive->pIndexData);
+	}
+	if (pArchive->pStream) {
+		fclose(pArchive->pStream);
+		pthread_mutex_destroy(&pArchive->streamMutex);
+	}
+	if (pArchive->pPath) {
+		heapFree(pArchive->pPath);
+	}
+	*pArchive = (Archive){ };
+}
+
+bool openArchive(const char *const pPath, Archive *const pOutArchive) {
+	if (!pPath || !pOutArchive) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: path or pointer to output archive is null.");
+		return false;
+	}
+	*pOutArchive = (Archive){ };
+
+	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Opening archive \"%s\"...", pPath);
+
+	Archive archive = { };
+	const size_t pathLength = strlen(pPath);
+	archive.pPath = heapAlloc(pathLength + 1, sizeof(char));
+	if (!archive.pPath) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: failed to allocate copy of path \"%s\".", pPath);
+		return false;
+	}
+	memcpy(archive.pPath, pPath, pathLength + 1);
+
+	File file = openFile(pPath, FMODE_READ, FMODE_NO_UPDATE, FMODE_BINARY);
+	if (!file.pStream) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: failed to open file \"%s\".", pPath);
+		releaseArchive(&archive);
+		return false;
+	}
+	archive.pStream = file.pStream;
+	pthread_mutex_init(&archive.streamMutex, nullptr);
+
+	long int fileSize = -1;
+	if (fseek(archive.pStream, 0, SEEK_END) == 0) {
+		fileSize = ftell(archive.pStream);
+	}
+	if (fileSize < 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: failed to get size of file \"%s\".", pPath);
+		releaseArchive(&archive);
+		return false;
+	}
+	archive.fileSize = (uint64_t)fileSize;
+
+	uint8_t header[ARCHIVE_HEADER_SIZE] = { };
+	if (archive.fileSize < ARCHIVE_HEADER_SIZE || !readArchiveBytes(&archive, 0, sizeof(header), header)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: failed to read header of \"%s\".", pPath);
+		releaseArchive(&archive);
+		return false;
+	}
+	BinaryReader headerReader = makeBinaryReader(header, sizeof(header));
+	const uint32_t magic = binaryReadU32(&headerReader);
+	const uint32_t version = binaryReadU32(&headerReader);
+	const uint32_t entryCount = binaryReadU32(&headerReader);
+	const uint32_t nameTableSize = binaryReadU32(&headerReader);
+	if (headerReader.failed || magic != ARCHIVE_MAGIC || version != ARCHIVE_VERSION) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: \"%s\" is not a version %u archive.", pPath, ARCHIVE_VERSION);
+		releaseArchive(&archive);
+		return false;
+	}
+
+	// Only the index and name table are loaded; they sit between the header and the first entry's data.
+	const uint64_t indexSize = (uint64_t)entryCount * ARCHIVE_INDEX_ENTRY_SIZE;
+	const uint64_t indexDataSize = indexSize + nameTableSize;
+	if (indexDataSize > archive.fileSize - ARCHIVE_HEADER_SIZE) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: index of \"%s\" runs past the end of the file.", pPath);
+		releaseArchive(&archive);
+		return false;
+	}
+	archive.pIndexData = heapAlloc(indexDataSize > 0 ? (size_t)indexDataSize : 1, sizeof(uint8_t));
+	if (!archive.pIndexData) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: failed to allocate %llu bytes for index of \"%s\".", (unsigned long long)indexDataSize, pPath);
+		releaseArchive(&archive);
+		return false;
+	} else if (indexDataSize > 0 && !readArchiveBytes(&archive, ARCHIVE_HEADER_SIZE, (size_t)indexDataSize, archive.pIndexData)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: failed to read index of \"%s\".", pPath);
+		releaseArchive(&archive);
+		return false;
+	}
+
+	if (nameTableSize > 0 && archive.pIndexData[indexDataSize - 1] != '\0') {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: name table of \"%s\" is not null-terminated.", pPath);
+		releaseArchive(&archive);
+		return false;
+	}
+	const char *const pNameTable = (const char *)&archive.pIndexData[indexSize];
+
+	if (entryCount > 0) {
+		archive.pEntries = heapAlloc(entryCount, sizeof(ArchiveEntry));
+		if (!archive.pEntries) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: failed to allocate index of %u entries.", entryCount);
+			releaseArchive(&archive);
+			return false;
+		}
+	}
+
+	// Every entry is checked once here, so that lookups can trust the index.
+	BinaryReader indexReader = makeBinaryReader(archive.pIndexData, (size_t)indexSize);
+	for (uint32_t i = 0; i < entryCount; ++i) {
+		const uint64_t nameHash = binaryReadU64(&indexReader);
+		const uint64_t dataOffset = binaryReadU64(&indexReader);
+		const uint64_t storedSize = binaryReadU64(&indexReader);
+		const uint64_t size = binaryReadU64(&indexReader);
+		const uint32_t nameOffset = binaryReadU32(&indexReader);
+		const uint32_t compression = binaryReadU32(&indexReader);
+
+		const bool nameValid = nameOffset < nameTableSize && archiveHashName(&pNameTable[nameOffset]) == nameHash;
+		const bool dataValid = dataOffset % ARCHIVE_ENTRY_ALIGNMENT == 0 && dataOffset <= archive.fileSize && storedSize <= archive.fileSize - dataOffset;
+		const bool compressionValid = compression == ARCHIVE_COMPRESSION_LZ4 || (compression == ARCHIVE_COMPRESSION_NONE && storedSize == size);
+		if (indexReader.failed || !nameValid || !dataValid || !compressionValid) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: entry %u of \"%s\" is invalid.", i, pPath);
+			releaseArchive(&archive);
+			return false;
+		}
+
+		archive.pEntries[i] = (ArchiveEntry){
+			.nameHash = nameHash,
+			.pName = &pNameTable[nameOffset],
+			.dataOffset = dataOffset,
+			.storedSize = (size_t)storedSize,
+			.size = (size_t)size,
+			.compression = (ArchiveCompression)compression
+		};
+
+		if (i > 0 && compareEntryKeys(archive.pEntries[i - 1].nameHash, archive.pEntries[i - 1].pName, nameHash, archive.pEntries[i].pName) >= 0) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive: index of \"%s\" is not sorted, or has duplicate entries.", pPath);
+			releaseArchive(&archive);
+			return false;
+		}
+	}
+	archive.entryCount = entryCount;
+
+	*pOutArchive = archive;
+	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Opened archive \"%s\" with %u entries.", pPath, entryCount);
+	return true;
+}
+
+void closeArchive(Archive *const pArchive) {
+	if (!pArchive) {
+		return;
+	}
+	releaseArchive(pArchive);
+}
+
+bool archiveFindEntry(const Archive *const pArchive, const char *const pName, ArchiveEntry *const pOutEntry) {
+	if (!pArchive || !pName) {
+		return false;
+	}
+
+	const uint64_t nameHash = archiveHashName(pName);
+	uint32_t low = 0;
+	uint32_t high = pArchive->entryCount;
+	while (low < high) {
+		const uint32_t middle = low + (high - low) / 2;
+		const ArchiveEntry *const pEntry = &pArchive->pEntries[middle];
+		const int comparison = compareEntryKeys(pEntry->nameHash, pEntry->pName, nameHash, pName);
+		if (comparison == 0) {
+			if (pOutEntry) {
+				*pOutEntry = *pEntry;
+			}
+			return true;
+		} else if (comparison < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return false;
+}
+
+bool archiveReadEntry(Archive *const pArchive, const ArchiveEntry entry, void *const pOutput) {
+	if (!pArchive || !pArchive->pStream) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading archive entry: archive is null or not open.");
+		return false;
+	} else if (!pOutput && entry.size > 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading archive entry: pointer to output buffer is null.");
+		return false;
+	}
+
+	switch (entry.compression) {
+		case ARCHIVE_COMPRESSION_NONE:
+			if (entry.size > 0 && !readArchiveBytes(pArchive, entry.dataOffset, entry.size, pOutput)) {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading archive entry: failed to read \"%s\".", entry.pName);
+				return false;
+			}
+			return true;
+		case ARCHIVE_COMPRESSION_LZ4: {
+			// The block is read whole and then decompressed, since LZ4 blocks cannot be decompressed piece by piece.
+			void *const pStoredData = heapAlloc(entry.storedSize > 0 ? entry.storedSize : 1, sizeof(uint8_t));
+			if (!pStoredData) {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading archive entry: failed to allocate %zu bytes for \"%s\".", entry.storedSize, entry.pName);
+				return false;
+			} else if (!readArchiveBytes(pArchive, entry.dataOffset, entry.storedSize, pStoredData)) {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading archive entry: failed to read \"%s\".", entry.pName);
+				heapFree(pStoredData);
+				return false;
+			}
+			const bool decompressed = lz4DecompressBlock(pStoredData, entry.storedSize, pOutput, entry.size);
+			heapFree(pStoredData);
+			if (!decompressed) {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading archive entry: LZ4 block of \"%s\" is corrupt.", entry.pName);
+				return false;
+			}
+			return true;
+		}
+	}
+	logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading archive entry: unknown compression (%i) for \"%s\".", (int)entry.compression, entry.pName);
+	return false;
+}
+
+FILE *archiveOpenEntryStream(const Archive *const pArchive, const ArchiveEntry entry) {
+	if (!pArchive || !pArchive->pPath) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive entry stream: archive is null or not open.");
+		return nullptr;
+	} else if (entry.compression != ARCHIVE_COMPRESSION_NONE) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive entry stream: \"%s\" is compressed.", entry.pName);
+		return nullptr;
+	}
+
+	File file = openFile(pArchive->pPath, FMODE_READ, FMODE_NO_UPDATE, FMODE_BINARY);
+	if (!file.pStream) {
+		return nullptr;
+	} else if (fseek(file.pStream, (long int)entry.dataOffset, SEEK_SET) != 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening archive entry stream: failed to seek to \"%s\".", entry.pName);
+		closeFile(&file);
+		return nullptr;
+	}
+	return file.pStream;
+}
@@ -0,0 +1,93 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Packed archive file layout, all little-endian:
+// 	Header (16 bytes): magic "PPAK", version, entry count, size of the name table in bytes.
+// 	Index (40 bytes per entry), sorted by name hash and then by name:
+// 		name hash (u64), data offset (u64), stored size (u64), size (u64), offset of the name in the name table (u32), compression (u32).
+// 	Name table: the null-terminated names of the entries.
+// 	Data: the stored contents of the entries, each starting at a multiple of ARCHIVE_ENTRY_ALIGNMENT from the start of the file.
+#define ARCHIVE_MAGIC				0x4B415050U	// "PPAK"
+#define ARCHIVE_VERSION				2
+#define ARCHIVE_HEADER_SIZE			16
+#define ARCHIVE_INDEX_ENTRY_SIZE	40
+#define ARCHIVE_ENTRY_ALIGNMENT		4096
+
+typedef enum ArchiveCompression {
+	ARCHIVE_COMPRESSION_NONE = 0,
+	
+	// The entry is stored as one LZ4 block.
+	ARCHIVE_COMPRESSION_LZ4 = 1
+} ArchiveCompression;
+
+typedef struct ArchiveEntry {
+
+	uint64_t nameHash;
+	const char *pName;
+
+	// Where the stored contents of the entry start in the archive file, and their size.
+	uint64_t dataOffset;
+	size_t storedSize;
+
+	// The size of the entry once decompressed.
+	size_t size;
+
+	ArchiveCompression compression;
+
+} ArchiveEntry;
+
+// A read-only archive of files packed together.
+// Only the header, index and name table are loaded into memory; entries are read from the file when they are needed.
+typedef struct Archive {
+
+	char *pPath;
+
+	// The archive file, which stays open while the archive is; the mutex guards its position.
+	FILE *pStream;
+	pthread_mutex_t streamMutex;
+	uint64_t fileSize;
+
+	// Holds the index and name table, which entry names point into.
+	uint8_t *pIndexData;
+
+	uint32_t entryCount;
+	ArchiveEntry *pEntries;
+
+} Archive;
+
+// Hashes an entry name with 64-bit FNV-1a.
+static inline uint64_t archiveHashName(const char *const pName) {
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (const char *pCharacter = pName; *pCharacter != '\0'; ++pCharacter) {
+		hash ^= (uint8_t)*pCharacter;
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+// Opens an archive and loads and checks its index.
+// Returns true if successful, false otherwise.
+bool openArchive(const char *const pPath, Archive *const pOutArchive);
+
+void closeArchive(Archive *const pArchive);
+
+// Finds an entry by name with a binary search of the index.
+// Returns true if the entry was found, false otherwise.
+bool archiveFindEntry(const Archive *const pArchive, const char *const pName, ArchiveEntry *const pOutEntry);
+
+// Reads an entry, decompressing it if necessary, into a buffer of at least entry.size bytes.
+// Returns true if successful, false otherwise.
+bool archiveReadEntry(Archive *const pArchive, const ArchiveEntry entry, void *const pOutput);
+
+// Opens a stream of its own over the archive file, positioned at the start of a stored entry, so that the entry
+// 	can be read piece by piece without loading it whole and without sharing a file position with other readers.
+// Returns the stream, or null if the entry is compressed or the file could not be opened.
+FILE *archiveOpenEntryStream(const Archive *const pArchive, const ArchiveEntry entry);
+
+#endif	// ARCHIVE_H
@@ -0,0 +1,256 @@
+#include "BinaryReader.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "log/Logger.h"
+#include "util/Allocation.h"
+#include "util/FileIO.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define HOST_IS_LITTLE_ENDIAN 1
+#else
+#define HOST_IS_LITTLE_ENDIAN 0
+#endif
+
+bool openBinaryReader(const char *const pPath, BinaryReader *const pOutReader) {
+	if (!pPath || !pOutReader) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening binary reader: path or pointer to output reader is null.");
+		return false;
+	}
+	*pOutReader = (BinaryReader){ .failed = true };
+
+	File file = openFile(pPath, FMODE_READ, FMODE_NO_UPDATE, FMODE_BINARY);
+	if (!file.pStream) {
+		return false;
+	}
+
+	long int fileSize = -1;
+	if (fseek(file.pStream, 0, SEEK_END) == 0) {
+		fileSize = ftell(file.pStream);
+	}
+	if (fileSize < 0 || fseek(file.pStream, 0, SEEK_SET) != 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening binary reader: failed to get size of file \"%s\".", pPath);
+		closeFile(&file);
+		return false;
+	}
+
+	uint8_t *pData = nullptr;
+	if (fileSize > 0) {
+		pData = heapAlloc((size_t)fileSize, sizeof(uint8_t));
+		if (!pData) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening binary reader: failed to allocate %li bytes for file \"%s\".", fileSize, pPath);
+			closeFile(&file);
+			return false;
+		}
+
+		// The whole file is read with a single call.
+		if (fread(pData, 1, (size_t)fileSize, file.pStream) != (size_t)fileSize) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening binary reader: failed to read file \"%s\".", pPath);
+			heapFree(pData);
+			closeFile(&file);
+			return false;
+		}
+	}
+	closeFile(&file);
+
+	*pOutReader = (BinaryReader){
+		.pData = pData,
+		.size = (size_t)fileSize,
+		.position = 0,
+		.failed = false,
+		.ownsData = pData != nullptr
+	};
+	return true;
+}
+
+BinaryReader makeBinaryReader(const void *const pData, const size_t size) {
+	return (BinaryReader){
+		.pData = pData,
+		.size = pData ? size : 0,
+		.position = 0,
+		.failed = false,
+		.ownsData = false
+	};
+}
+
+void closeBinaryReader(BinaryReader *const pReader) {
+	if (!pReader) {
+		return;
+	}
+	if (pReader->ownsData) {
+		heapFree((void *)pReader->pData);
+	}
+	*pReader = (BinaryReader){ };
+}
+
+size_t binaryReaderRemaining(const BinaryReader *const pReader) {
+	return pReader && !pReader->failed ? pReader->size - pReader->position : 0;
+}
+
+// Returns a pointer to the next size bytes and moves past them, or marks the reader as failed if there are not enough bytes left.
+static const uint8_t *binaryTake(BinaryReader *const pReader, const size_t size) {
+	if (!pReader || pReader->failed) {
+		return nullptr;
+	}
+	if (size > pReader->size - pReader->position) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading binary data: read of %zu bytes at offset %zu runs past the end of the data (%zu bytes).",
+				size, pReader->position, pReader->size);
+		pReader->failed = true;
+		return nullptr;
+	}
+	const uint8_t *const pBytes = &pReader->pData[pReader->position];
+	pReader->position += size;
+	return pBytes;
+}
+
+bool binaryReadBytes(BinaryReader *const pReader, const size_t size, void *const pOut) {
+	const uint8_t *const pBytes = binaryTake(pReader, size);
+	if (!pBytes) {
+		return false;
+	}
+	if (pOut && size > 0) {
+		memcpy(pOut, pBytes, size);
+	}
+	return true;
+}
+
+bool binarySkip(BinaryReader *const pReader, const size_t size) {
+	return binaryTake(pReader, size) != nullptr;
+}
+
+static inline uint32_t decodeU32(const uint8_t *const pBytes) {
+	return (uint32_t)pBytes[0] | ((uint32_t)pBytes[1] << 8) | ((uint32_t)pBytes[2] << 16) | ((uint32_t)pBytes[3] << 24);
+}
+
+static inline uint64_t decodeU64(const uint8_t *const pBytes) {
+	return (uint64_t)decodeU32(pBytes) | ((uint64_t)decodeU32(&pBytes[4]) << 32);
+}
+
+uint8_t binaryReadU8(BinaryReader *const pReader) {
+	const uint8_t *const pBytes = binaryTake(pReader, 1);
+	return pBytes ? pBytes[0] : 0;
+}
+
+uint16_t binaryReadU16(BinaryReader *const pReader) {
+	const uint8_t *const pBytes = binaryTake(pReader, 2);
+	return pBytes ? (uint16_t)(pBytes[0] | (pBytes[1] << 8)) : 0;
+}
+
+uint32_t binaryReadU32(BinaryReader *const pReader) {
+	const uint8_t *const pBytes = binaryTake(pReader, 4);
+	return pBytes ? decodeU32(pBytes) : 0;
+}
+
+uint64_t binaryReadU64(BinaryReader *const pReader) {
+	const uint8_t *const pBytes = binaryTake(pReader, 8);
+	return pBytes ? decodeU64(pBytes) : 0;
+}
+
+int32_t binaryReadI32(BinaryReader *const pReader) {
+	return (int32_t)binaryReadU32(pReader);
+}
+
+float binaryReadF32(BinaryReader *const pReader) {
+	const uint32_t bits = binaryReadU32(pReader);
+	float value = 0.0F;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+double binaryReadF64(BinaryReader *const pReader) {
+	const uint64_t bits = binaryReadU64(pReader);
+	double value = 0.0;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// Copies an array of 4- or 8-byte values, converting each from little-endian only if the host is not little-endian.
+static bool binaryReadArray(BinaryReader *const pReader, const size_t count, const size_t elementSize, void *const pOut) {
+	if (count > 0 && elementSize > SIZE_MAX / count) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading binary data: array of %zu elements is too large.", count);
+		if (pReader) {
+			pReader->failed = true;
+		}
+		return false;
+	}
+
+	const uint8_t *const pBytes = binaryTake(pReader, count * elementSize);
+	if (!pBytes || !pOut) {
+		return pBytes != nullptr;
+	}
+
+#if HOST_IS_LITTLE_ENDIAN
+	memcpy(pOut, pBytes, count * elementSize);
+#else
+	for (size_t i = 0; i < count; ++i) {
+		if (elementSize == 4) {
+			const uint32_t value = decodeU32(&pBytes[4 * i]);
+			memcpy((uint8_t *)pOut + 4 * i, &value, 4);
+		} else {
+			const uint64_t value = decodeU64(&pBytes[8 * i]);
+			memcpy((uint8_t *)pOut + 8 * i, &value, 8);
+		}
+	}
+#endif
+	return true;
+}
+
+bool binaryReadU32Array(BinaryReader *const pReader, const size_t count, uint32_t *const pOut) {
+	return binaryReadArray(pReader, count, sizeof(uint32_t), pOut);
+}
+
+bool binaryReadF32Array(BinaryReader *const pReader, const size_t count, float *const pOut) {
+	return binaryReadArray(pReader, count, sizeof(float), pOut);
+}
+
+bool binaryReadF64Array(BinaryReader *const pReader, const size_t count, double *const pOut) {
+	return binaryReadArray(pReader, count, sizeof(double), pOut);
+}
+
+static String binaryMakeString(const uint8_t *const pCharacters, const size_t length) {
+	String string = newStringEmpty(length + 1);
+	if (stringIsNull(string)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading binary data: failed to allocate string.");
+		return (String){ };
+	}
+	memcpy(string.pBuffer, pCharacters, length);
+	string.pBuffer[length] = '\0';
+	string.length = length;
+	return string;
+}
+
+String binaryReadString(BinaryReader *const pReader, const size_t maxLength) {
+	if (!pReader || pReader->failed) {
+		return (String){ };
+	}
+
+	// Find the null-terminator in one pass over the buffer, instead of reading the string twice.
+	const size_t remaining = pReader->size - pReader->position;
+	const size_t searchLength = remaining < maxLength + 1 ? remaining : maxLength + 1;
+	const uint8_t *const pStart = &pReader->pData[pReader->position];
+	const uint8_t *const pTerminator = memchr(pStart, '\0', searchLength);
+	if (!pTerminator) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading binary data: string at offset %zu is not terminated within %zu characters.", pReader->position, maxLength);
+		pReader->failed = true;
+		return (String){ };
+	}
+
+	const size_t length = (size_t)(pTerminator - pStart);
+	pReader->position += length + 1;
+	return binaryMakeString(pStart, length);
+}
+
+String binaryReadPrefixedString(BinaryReader *const pReader, const size_t maxLength) {
+	const size_t offset = pReader ? pReader->position : 0;
+	const uint32_t length = binaryReadU32(pReader);
+	if (pReader && !pReader->failed && length > maxLength) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading binary data: string at offset %zu is %u characters long (at most %zu allowed).", offset, length, maxLength);
+		pReader->failed = true;
+	}
+
+	const uint8_t *const pCharacters = binaryTake(pReader, length);
+	if (!pCharacters) {
+		return (String){ };
+	}
+	return binaryMakeString(pCharacters, length);
+}
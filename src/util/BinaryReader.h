@@ -0,0 +1,63 @@
+#ifndef BINARY_READER_H
+#define BINARY_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/String.h"
+
+// Reads little-endian binary data from a buffer that holds a whole file.
+// Every read is bounds-checked; the first read that fails marks the reader as failed,
+// 	and every read after that also fails and returns zero, so a loader can check for errors once at the end.
+typedef struct BinaryReader {
+
+	const uint8_t *pData;
+	size_t size;
+	size_t position;
+
+	bool failed;
+
+	// True if the reader allocated the buffer itself, and frees it when closed.
+	bool ownsData;
+
+} BinaryReader;
+
+// Loads the whole file into memory to read from.
+// Returns true if successful, false otherwise.
+bool openBinaryReader(const char *const pPath, BinaryReader *const pOutReader);
+
+// Reads from a buffer in memory; the buffer is not copied and must outlive the reader.
+BinaryReader makeBinaryReader(const void *const pData, const size_t size);
+
+void closeBinaryReader(BinaryReader *const pReader);
+
+// Returns the number of bytes left to read.
+size_t binaryReaderRemaining(const BinaryReader *const pReader);
+
+bool binaryReadBytes(BinaryReader *const pReader, const size_t size, void *const pOut);
+
+// Moves the reader forward without reading.
+bool binarySkip(BinaryReader *const pReader, const size_t size);
+
+uint8_t binaryReadU8(BinaryReader *const pReader);
+uint16_t binaryReadU16(BinaryReader *const pReader);
+uint32_t binaryReadU32(BinaryReader *const pReader);
+uint64_t binaryReadU64(BinaryReader *const pReader);
+int32_t binaryReadI32(BinaryReader *const pReader);
+float binaryReadF32(BinaryReader *const pReader);
+double binaryReadF64(BinaryReader *const pReader);
+
+bool binaryReadU32Array(BinaryReader *const pReader, const size_t count, uint32_t *const pOut);
+bool binaryReadF32Array(BinaryReader *const pReader, const size_t count, float *const pOut);
+bool binaryReadF64Array(BinaryReader *const pReader, const size_t count, double *const pOut);
+
+// Reads a null-terminated string of at most maxLength characters, not counting the null-terminator.
+// Returns a null string if the read fails.
+String binaryReadString(BinaryReader *const pReader, const size_t maxLength);
+
+// Reads a string stored as a 32-bit length followed by that many characters, of at most maxLength characters.
+// Returns a null string if the read fails.
+String binaryReadPrefixedString(BinaryReader *const pReader, const size_t maxLength);
+
+#endif	// BINARY_READER_H
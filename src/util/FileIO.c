@@ -48,9 +48,12 @@ File openFile(const char path[], const FileMode mode, const bool update, const b
 		.binary = binary
 	};
 	
-	const errno_t result = fopen_s(&file.pStream, path, modeString);
-	if (result != 0) {
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening file: failed to open file \"%s\" (error code = \"%s\").", path, strerror(result));
+	modeString[modeStringPos] = '\0';
+	
+	file.pStream = fopen(path, modeString);
+	if (!file.pStream) {
+		const int error = errno;
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening file: failed to open file \"%s\" (error code = \"%s\").", path, strerror(error));
 		return (File){ };
 	}
 	
@@ -65,78 +68,3 @@ void closeFile(File *const pFile) {
 	}
 	*pFile = (File){ };
 }
-
-void fileReadData(const File file, const size_t objectCount, const size_t objectSize, void *const pBuffer) {
-	if (!file.pStream) {
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading data from file: file stream is null.");
-		return;
-	}
-	
-	if (objectCount == 0 || objectSize == 0) {
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading data from file: invalid data size requested (object count: %llu, object size: %llu).", objectCount, objectSize);
-		return;
-	}
-	
-	if (!pBuffer) {
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading data from file: destination buffer is null.");
-		return;
-	}
-	
-	const size_t objectsRead = fread(pBuffer, objectSize, objectCount, file.pStream);
-	if (objectsRead != objectCount) {
-		if (feof(file.pStream) != 0) {
-			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading data from file: end-of-file reached.");
-		} else if (ferror(file.pStream) != 0) {
-			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading data from file: error occurred during reading operation.");
-		} else {
-			logMsg(loggerSystem, LOG_LEVEL_WARNING, "Reading data from file: did not read requested number of objects (requested: %llu, actually read: %llu).", objectCount, objectsRead);
-		}
-	}
-}
-
-String fileReadString(const File file, const size_t maxCapacity) {
-	if (!file.pStream) {
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading string from file: file stream is null.");
-		return (String){ };
-	}
-	
-	const long int currentPosition = ftell(file.pStream);
-	if (currentPosition < 0) {
-		const errno_t error = errno;
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading string from file: failed to get file position (error code = \"%s\").", strerror(error));
-		return (String){ };
-	}
-	
-	// First pass: get total length of string in file.
-	size_t stringLength = 0;
-	int ch = fgetc(file.pStream);
-	while (ch != '\0' && ch != EOF && stringLength < maxCapacity) {
-		stringLength += 1;
-		ch = fgetc(file.pStream);
-	}
-	size_t stringCapacity = stringLength + 1;
-	
-	// Seek back to initial position.
-	const int seekResult = fseek(file.pStream, currentPosition, SEEK_SET);
-	if (seekResult != 0) {
-		const errno_t error = errno;
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading string from file: failed to seek to start of string (error code = \"%s\").", strerror(error));
-		return (String){ };
-	}
-	
-	// Second pass: read characters from file into string buffer.
-	String string = newStringEmpty(stringCapacity);
-	if (stringIsNull(string)) {
-		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading string from file: failed to allocate string.");
-		return (String){ };
-	}
-	size_t counter = 0;
-	ch = fgetc(file.pStream);
-	while (ch != '\0' && ch != EOF && counter < stringCapacity) {
-		string.pBuffer[counter++] = (char)ch;
-		ch = fgetc(file.pStream);
-	}
-	string.pBuffer[counter] = '\0';
-	string.length = stringLength;
-	return string;
-}
\ No newline at end of file
@@ -27,8 +27,4 @@ File openFile(const char path[], const FileMode mode, const bool update, const b
 
 void closeFile(File *const pFile);
 
-void fileReadData(const File file, const size_t objectCount, const size_t objectSize, void *const pBuffer);
-
-String fileReadString(const File file, const size_t maxCapacity);
-
 #endif	// FILE_IO_H
\ No newline at end of file
@@ -0,0 +1,237 @@
+// Needed for d_type and lstat with -std=c2x.
+#define _DEFAULT_SOURCE
+
+#include "FileWatcher.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "log/Logger.h"
+
+#define FILE_WATCHER_PATH_MAX_LENGTH 256
+
+#ifdef __linux__
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdalign.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Files are reported once they are closed after writing, or moved into place as editors do when saving,
+// 	so that a file is never reloaded while it is only partly written.
+#define FILE_WATCHER_FILE_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO)
+
+// Directories created in a watched directory are watched too.
+#define FILE_WATCHER_EVENTS (FILE_WATCHER_FILE_EVENTS | IN_CREATE)
+
+typedef struct WatchedDirectory {
+	int watchDescriptor;
+
+	// Relative to the resource directory, without a trailing slash.
+	char path[FILE_WATCHER_PATH_MAX_LENGTH];
+} WatchedDirectory;
+
+static int inotifyDescriptor = -1;
+
+static uint32_t watchedDirectoryCount = 0;
+static WatchedDirectory watchedDirectories[FILE_WATCHER_MAX_DIRECTORIES];
+
+static bool isDirectory(const char *const pFullPath) {
+	struct stat status;
+	return lstat(pFullPath, &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+// Watches a directory and, recursively, the directories inside it.
+static void watchDirectory(const char *const pPath) {
+	if (watchedDirectoryCount >= FILE_WATCHER_MAX_DIRECTORIES) {
+		logMsg(loggerSystem, LOG_LEVEL_WARNING, "Watching files: not watching \"%s\", already at the limit of %u directories.", pPath, FILE_WATCHER_MAX_DIRECTORIES);
+		return;
+	}
+
+	char fullPath[FILE_WATCHER_PATH_MAX_LENGTH];
+	const int fullPathLength = snprintf(fullPath, sizeof(fullPath), "%s%s", RESOURCE_PATH, pPath);
+	if (fullPathLength < 0 || (size_t)fullPathLength >= sizeof(fullPath) || strlen(pPath) >= FILE_WATCHER_PATH_MAX_LENGTH) {
+		logMsg(loggerSystem, LOG_LEVEL_WARNING, "Watching files: path to \"%s\" is too long.", pPath);
+		return;
+	}
+
+	const int watchDescriptor = inotify_add_watch(inotifyDescriptor, fullPath, FILE_WATCHER_EVENTS | IN_ONLYDIR);
+	if (watchDescriptor < 0) {
+		logMsg(loggerSystem, LOG_LEVEL_WARNING, "Watching files: failed to watch \"%s\" (error code: %i).", fullPath, errno);
+		return;
+	}
+
+	// Adding a watch twice for the same directory returns the same descriptor.
+	for (uint32_t i = 0; i < watchedDirectoryCount; ++i) {
+		if (watchedDirectories[i].watchDescriptor == watchDescriptor) {
+			return;
+		}
+	}
+	watchedDirectories[watchedDirectoryCount].watchDescriptor = watchDescriptor;
+	strcpy(watchedDirectories[watchedDirectoryCount].path, pPath);
+	watchedDirectoryCount += 1;
+
+	DIR *const pDirectory = opendir(fullPath);
+	if (!pDirectory) {
+		return;
+	}
+
+	struct dirent *pEntry = nullptr;
+	while ((pEntry = readdir(pDirectory)) != nullptr) {
+		if (strcmp(pEntry->d_name, ".") == 0 || strcmp(pEntry->d_name, "..") == 0) {
+			continue;
+		}
+
+		char childPath[FILE_WATCHER_PATH_MAX_LENGTH];
+		const int childPathLength = snprintf(childPath, sizeof(childPath), "%s/%s", pPath, pEntry->d_name);
+		if (childPathLength < 0 || (size_t)childPathLength >= sizeof(childPath)) {
+			continue;
+		}
+
+		char childFullPath[FILE_WATCHER_PATH_MAX_LENGTH];
+		const int childFullPathLength = snprintf(childFullPath, sizeof(childFullPath), "%s%s", RESOURCE_PATH, childPath);
+		if (childFullPathLength < 0 || (size_t)childFullPathLength >= sizeof(childFullPath)) {
+			continue;
+		}
+
+		const bool childIsDirectory = pEntry->d_type == DT_DIR || (pEntry->d_type == DT_UNKNOWN && isDirectory(childFullPath));
+		if (childIsDirectory) {
+			watchDirectory(childPath);
+		}
+	}
+	closedir(pDirectory);
+}
+
+static const WatchedDirectory *findWatchedDirectory(const int watchDescriptor) {
+	for (uint32_t i = 0; i < watchedDirectoryCount; ++i) {
+		if (watchedDirectories[i].watchDescriptor == watchDescriptor) {
+			return &watchedDirectories[i];
+		}
+	}
+	return nullptr;
+}
+
+bool initFileWatcher(const uint32_t directoryCount, const char *const pDirectories[static const directoryCount]) {
+	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Initializing file watcher...");
+
+	if (inotifyDescriptor >= 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error initializing file watcher: file watcher already initialized.");
+		return false;
+	}
+
+	inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyDescriptor < 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error initializing file watcher: failed to initialize inotify (error code: %i).", errno);
+		return false;
+	}
+
+	for (uint32_t i = 0; i < directoryCount; ++i) {
+		watchDirectory(pDirectories[i]);
+	}
+
+	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Initialized file watcher, watching %u directories.", watchedDirectoryCount);
+	return true;
+}
+
+void terminateFileWatcher(void) {
+	if (inotifyDescriptor < 0) {
+		return;
+	}
+	// Closing the descriptor removes all of its watches.
+	close(inotifyDescriptor);
+	inotifyDescriptor = -1;
+	watchedDirectoryCount = 0;
+}
+
+void pollFileWatcher(const FileChangedCallback pfnCallback) {
+	if (inotifyDescriptor < 0 || !pfnCallback) {
+		return;
+	}
+
+	// Saving a file often produces several events for it, so each changed file is only reported once per poll.
+	uint32_t changedFileCount = 0;
+	static char changedFiles[FILE_WATCHER_MAX_CHANGES][FILE_WATCHER_PATH_MAX_LENGTH];
+
+	alignas(struct inotify_event) char buffer[4096];
+	bool changesDropped = false;
+	while (true) {
+		const ssize_t readSize = read(inotifyDescriptor, buffer, sizeof(buffer));
+		if (readSize <= 0) {
+			if (readSize < 0 && errno != EAGAIN) {
+				logMsg(loggerSystem, LOG_LEVEL_ERROR, "Polling file watcher: failed to read events (error code: %i).", errno);
+			}
+			break;
+		}
+
+		// Each event is followed by its padded name, which keeps the next event aligned.
+		for (size_t offset = 0; offset + sizeof(struct inotify_event) <= (size_t)readSize; ) {
+			const struct inotify_event *const pEvent = (const void *)&buffer[offset];
+			offset += sizeof(struct inotify_event) + pEvent->len;
+
+			if (pEvent->mask & IN_Q_OVERFLOW) {
+				logMsg(loggerSystem, LOG_LEVEL_WARNING, "Polling file watcher: event queue overflowed, some changes were missed.");
+				continue;
+			}
+
+			const WatchedDirectory *const pDirectory = findWatchedDirectory(pEvent->wd);
+			if (!pDirectory || pEvent->len == 0) {
+				continue;
+			}
+
+			char path[FILE_WATCHER_PATH_MAX_LENGTH];
+			const int pathLength = snprintf(path, sizeof(path), "%s/%s", pDirectory->path, pEvent->name);
+			if (pathLength < 0 || (size_t)pathLength >= sizeof(path)) {
+				continue;
+			}
+
+			if (pEvent->mask & IN_ISDIR) {
+				if (pEvent->mask & (IN_CREATE | IN_MOVED_TO)) {
+					watchDirectory(path);
+				}
+				continue;
+			} else if (!(pEvent->mask & FILE_WATCHER_FILE_EVENTS)) {
+				continue;
+			}
+
+			bool alreadyChanged = false;
+			for (uint32_t i = 0; i < changedFileCount && !alreadyChanged; ++i) {
+				alreadyChanged = strcmp(changedFiles[i], path) == 0;
+			}
+			if (alreadyChanged) {
+				continue;
+			} else if (changedFileCount >= FILE_WATCHER_MAX_CHANGES) {
+				changesDropped = true;
+				continue;
+			}
+			strcpy(changedFiles[changedFileCount++], path);
+		}
+	}
+
+	if (changesDropped) {
+		logMsg(loggerSystem, LOG_LEVEL_WARNING, "Polling file watcher: more than %u files changed at once, some changes were missed.", FILE_WATCHER_MAX_CHANGES);
+	}
+
+	for (uint32_t i = 0; i < changedFileCount; ++i) {
+		pfnCallback(changedFiles[i]);
+	}
+}
+
+#else	// __linux__
+
+bool initFileWatcher(const uint32_t directoryCount, const char *const pDirectories[static const directoryCount]) {
+	(void)pDirectories;
+	logMsg(loggerSystem, LOG_LEVEL_WARNING, "Initializing file watcher: watching files is only supported on Linux; changes to %u directories will not be reported.", directoryCount);
+	return true;
+}
+
+void terminateFileWatcher(void) {
+
+}
+
+void pollFileWatcher(const FileChangedCallback pfnCallback) {
+	(void)pfnCallback;
+}
+
+#endif	// __linux__
@@ -0,0 +1,28 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Watches directories under the resource directory for files that are written, using inotify on Linux.
+// Changed files are reported by their path relative to the resource directory, as used by the virtual file system.
+// On other platforms the watcher starts, but never reports a change.
+
+#define FILE_WATCHER_MAX_DIRECTORIES 64
+
+// The most changed files reported by one poll; changes to further files are missed.
+#define FILE_WATCHER_MAX_CHANGES 32
+
+typedef void (*FileChangedCallback)(const char *const pPath);
+
+// Starts watching each directory, e.g. "shaders", and the directories inside it.
+// Returns true if successful, false otherwise.
+bool initFileWatcher(const uint32_t directoryCount, const char *const pDirectories[static const directoryCount]);
+
+void terminateFileWatcher(void);
+
+// Calls pfnCallback once for each file that was written or moved into a watched directory since the last poll.
+// Does not block if no file has changed.
+void pollFileWatcher(const FileChangedCallback pfnCallback);
+
+#endif	// FILE_WATCHER_H
@@ -0,0 +1,114 @@
+#include "GameClock.h"
+
+#include "log/Logger.h"
+#include "Time.h"
+
+#define NS_PER_MS 1'000'000LLU
+
+const uint32_t gameTickRate = GAME_TICK_RATE;
+const uint64_t gameTickDurationMS = GAME_TICK_DURATION_MS;
+
+static const uint64_t tickDurationNS = GAME_TICK_DURATION_MS * NS_PER_MS;
+static const uint64_t maxFrameNS = GAME_CLOCK_MAX_FRAME_MS * NS_PER_MS;
+
+// The monotonic clock reading at the start of the last frame.
+static uint64_t lastSampleNS = 0;
+
+// Scaled real time that has not yet been consumed by ticks.
+static uint64_t accumulatedNS = 0;
+
+static uint64_t tickCount = 0;
+static uint64_t tickTimeNS = 0;
+static uint64_t frameTimeNS = 0;
+
+static bool clockPaused = false;
+static double clockTimeScale = 1.0;
+
+void initGameClock(void) {
+	lastSampleNS = getNanoseconds();
+	accumulatedNS = 0;
+	tickCount = 0;
+	tickTimeNS = 0;
+	frameTimeNS = 0;
+	clockPaused = false;
+}
+
+void gameClockBeginFrame(void) {
+	const uint64_t sampleNS = getNanoseconds();
+	uint64_t elapsedNS = sampleNS > lastSampleNS ? sampleNS - lastSampleNS : 0;
+	lastSampleNS = sampleNS;
+	
+	if (elapsedNS > maxFrameNS) {
+		elapsedNS = maxFrameNS;
+	}
+	
+	const uint64_t scaledNS = (uint64_t)((double)elapsedNS * clockTimeScale);
+	accumulatedNS += scaledNS;
+	if (!clockPaused) {
+		frameTimeNS += scaledNS;
+	}
+}
+
+void gameClockStep(void) {
+	accumulatedNS += tickDurationNS;
+	if (!clockPaused) {
+		frameTimeNS += tickDurationNS;
+	}
+}
+
+bool gameClockNextTick(void) {
+	if (accumulatedNS < tickDurationNS) {
+		return false;
+	}
+	
+	accumulatedNS -= tickDurationNS;
+	tickCount += 1;
+	if (!clockPaused) {
+		tickTimeNS += tickDurationNS;
+	}
+	return true;
+}
+
+uint64_t gameClockGetTickCount(void) {
+	return tickCount;
+}
+
+uint64_t gameClockGetTickTimeMS(void) {
+	return tickTimeNS / NS_PER_MS;
+}
+
+uint64_t gameClockGetFrameTimeMS(void) {
+	return frameTimeNS / NS_PER_MS;
+}
+
+float gameClockGetAlpha(void) {
+	return (float)((double)accumulatedNS / (double)tickDurationNS);
+}
+
+uint64_t gameClockGetTimeUntilNextTickNS(void) {
+	if (accumulatedNS >= tickDurationNS) {
+		return 0;
+	}
+	return (uint64_t)((double)(tickDurationNS - accumulatedNS) / clockTimeScale);
+}
+
+void gameClockSetPaused(const bool paused) {
+	clockPaused = paused;
+}
+
+bool gameClockIsPaused(void) {
+	return clockPaused;
+}
+
+bool gameClockSetTimeScale(const double timeScale) {
+	if (!(timeScale > 0.0 && timeScale <= MAX_GAME_TIME_SCALE)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Setting game time scale: %f is out of range (must be greater than 0 and at most %f).", timeScale, MAX_GAME_TIME_SCALE);
+		return false;
+	}
+	clockTimeScale = timeScale;
+	return true;
+}
+
+double gameClockGetTimeScale(void) {
+	return clockTimeScale;
+}
@@ -0,0 +1,64 @@
+#ifndef GAME_CLOCK_H
+#define GAME_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The number of game ticks per second of game time.
+#define GAME_TICK_RATE 20
+extern const uint32_t gameTickRate;
+
+// The length of one game tick in game time.
+#define GAME_TICK_DURATION_MS (1000 / GAME_TICK_RATE)
+extern const uint64_t gameTickDurationMS;
+
+// The most real time that one frame can add to the clock; longer stalls (e.g. dragging the window) are dropped, 
+// 	so that the game does not run a long burst of ticks to catch up afterwards.
+#define GAME_CLOCK_MAX_FRAME_MS 250
+
+#define MAX_GAME_TIME_SCALE 16.0
+
+// The game clock samples the monotonic clock once per frame, and advances game time in fixed ticks.
+// Game logic reads tick time, which only depends on the number of ticks run, so a simulation plays out the same regardless of frame timing.
+// Rendering reads frame time, which advances smoothly between ticks.
+
+void initGameClock(void);
+
+// Samples the monotonic clock for a new frame. Call once at the start of each frame.
+void gameClockBeginFrame(void);
+
+// Advances the clock by exactly one tick's worth of time, instead of sampling the monotonic clock.
+// Used in place of gameClockBeginFrame to run ticks back to back, e.g. when replaying recorded input.
+void gameClockStep(void);
+
+// Advances the clock by one tick if one is due. Call in a loop after gameClockBeginFrame, running a game tick each time this returns true.
+// Ticks stay due while the clock is paused, so that the game can still respond to input; only game time stops.
+bool gameClockNextTick(void);
+
+// Returns the number of ticks run since the clock was initialized, including ticks run while paused.
+uint64_t gameClockGetTickCount(void);
+
+// Returns the game time of the current tick, in milliseconds.
+uint64_t gameClockGetTickTimeMS(void);
+
+// Returns the game time of the current frame, in milliseconds.
+uint64_t gameClockGetFrameTimeMS(void);
+
+// Returns how far the current frame is between the last tick and the next, from 0.0 to 1.0.
+float gameClockGetAlpha(void);
+
+// Returns how much real time is left until the next tick is due, in nanoseconds, or 0 if one is already due.
+uint64_t gameClockGetTimeUntilNextTickNS(void);
+
+// Stops or resumes game time; ticks keep running while paused.
+void gameClockSetPaused(const bool paused);
+
+bool gameClockIsPaused(void);
+
+// Sets how fast game time runs compared to real time; e.g. 0.5 runs the game at half speed.
+// Returns true if the setting was accepted, false otherwise.
+bool gameClockSetTimeScale(const double timeScale);
+
+double gameClockGetTimeScale(void);
+
+#endif	// GAME_CLOCK_H
@@ -0,0 +1,213 @@
+#include "HashMap.h"
+
+#include <string.h>
+#include "log/Logger.h"
+#include "Allocation.h"
+
+#define HASH_MAP_MIN_CAPACITY 16
+
+// The map is resized once more than three quarters of its slots are used.
+#define HASH_MAP_MAX_LOAD_NUMERATOR 3
+#define HASH_MAP_MAX_LOAD_DENOMINATOR 4
+
+static void *valueAt(const HashMap *const pMap, const uint32_t index) {
+	return (char *)pMap->pValues + (size_t)index * pMap->valueSize;
+}
+
+static uint32_t hashKey(const HashMap *const pMap, const uint32_t key) {
+	return pMap->hashFunctor ? pMap->hashFunctor(key) : key;
+}
+
+// Returns the slot index of the key, or the capacity if the map does not have the key.
+static uint32_t findSlot(const HashMap *const pMap, const uint32_t key) {
+	if (pMap->count == 0) {
+		return pMap->capacity;
+	}
+
+	const uint32_t hash = hashKey(pMap, key);
+	const uint32_t mask = pMap->capacity - 1;
+	uint32_t index = hash & mask;
+
+	// An entry is never further from its home slot than the entries it passed, so the search stops at the first entry closer to home.
+	for (uint32_t probeLength = 1; probeLength <= pMap->pSlots[index].probeLength; ++probeLength) {
+		if (pMap->pSlots[index].hash == hash && pMap->pSlots[index].key == key) {
+			return index;
+		}
+		index = (index + 1) & mask;
+	}
+	return pMap->capacity;
+}
+
+// Inserts an entry whose value is in the first scratch value, assuming there is room for it.
+static void insertEntry(HashMap *const pMap, uint32_t key, uint32_t hash) {
+	void *const pCarriedValue = valueAt(pMap, pMap->capacity);
+	void *const pSwapValue = valueAt(pMap, pMap->capacity + 1);
+
+	const uint32_t mask = pMap->capacity - 1;
+	uint32_t index = hash & mask;
+	uint32_t probeLength = 1;
+	bool displaced = false;	// Whether the entry being carried is one that was already in the map.
+	while (true) {
+		HashMapSlot *const pSlot = &pMap->pSlots[index];
+		if (pSlot->probeLength == 0) {
+			*pSlot = (HashMapSlot){ .key = key, .hash = hash, .probeLength = probeLength };
+			memcpy(valueAt(pMap, index), pCarriedValue, pMap->valueSize);
+			pMap->count += 1;
+			return;
+		}
+
+		if (!displaced && pSlot->hash == hash && pSlot->key == key) {
+			memcpy(valueAt(pMap, index), pCarriedValue, pMap->valueSize);
+			return;
+		}
+
+		// Take the slot from an entry closer to its home slot, and carry that entry on instead.
+		if (pSlot->probeLength < probeLength) {
+			const HashMapSlot swapSlot = *pSlot;
+			*pSlot = (HashMapSlot){ .key = key, .hash = hash, .probeLength = probeLength };
+			key = swapSlot.key;
+			hash = swapSlot.hash;
+			probeLength = swapSlot.probeLength;
+
+			memcpy(pSwapValue, valueAt(pMap, index), pMap->valueSize);
+			memcpy(valueAt(pMap, index), pCarriedValue, pMap->valueSize);
+			memcpy(pCarriedValue, pSwapValue, pMap->valueSize);
+			displaced = true;
+		}
+
+		index = (index + 1) & mask;
+		probeLength += 1;
+	}
+}
+
+static bool resizeHashMap(HashMap *const pMap, const uint32_t newCapacity) {
+	HashMapSlot *const pNewSlots = heapAlloc(newCapacity, sizeof(HashMapSlot));
+	if (!pNewSlots) {
+		return false;
+	}
+	void *const pNewValues = heapAlloc((size_t)newCapacity + 2, pMap->valueSize);
+	if (!pNewValues) {
+		heapFree(pNewSlots);
+		return false;
+	}
+
+	HashMap oldMap = *pMap;
+	pMap->capacity = newCapacity;
+	pMap->count = 0;
+	pMap->pSlots = pNewSlots;
+	pMap->pValues = pNewValues;
+
+	// Hashes are stored with the keys, so they are not recomputed.
+	for (uint32_t i = 0; i < oldMap.capacity; ++i) {
+		if (oldMap.pSlots[i].probeLength != 0) {
+			memcpy(valueAt(pMap, pMap->capacity), valueAt(&oldMap, i), pMap->valueSize);
+			insertEntry(pMap, oldMap.pSlots[i].key, oldMap.pSlots[i].hash);
+		}
+	}
+
+	if (oldMap.pSlots) {
+		oldMap.pSlots = heapFree(oldMap.pSlots);
+	}
+	if (oldMap.pValues) {
+		oldMap.pValues = heapFree(oldMap.pValues);
+	}
+	return true;
+}
+
+HashMap newHashMap(const size_t valueSize, const HashFunctor hashFunctor) {
+	return (HashMap){
+		.capacity = 0,
+		.count = 0,
+		.valueSize = valueSize,
+		.hashFunctor = hashFunctor,
+		.pSlots = nullptr,
+		.pValues = nullptr
+	};
+}
+
+void deleteHashMap(HashMap *const pMap) {
+	if (!pMap) {
+		return;
+	}
+	if (pMap->pSlots) {
+		pMap->pSlots = heapFree(pMap->pSlots);
+	}
+	if (pMap->pValues) {
+		pMap->pValues = heapFree(pMap->pValues);
+	}
+	pMap->capacity = 0;
+	pMap->count = 0;
+}
+
+bool hashMapReserve(HashMap *const pMap, const uint32_t entryCount) {
+	if (!pMap || pMap->valueSize == 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reserving hash map: map is null or has no value size.");
+		return false;
+	}
+
+	uint32_t newCapacity = pMap->capacity > 0 ? pMap->capacity : HASH_MAP_MIN_CAPACITY;
+	while ((uint64_t)entryCount * HASH_MAP_MAX_LOAD_DENOMINATOR > (uint64_t)newCapacity * HASH_MAP_MAX_LOAD_NUMERATOR) {
+		if (newCapacity > UINT32_MAX / 2) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reserving hash map: %u entries is too many.", entryCount);
+			return false;
+		}
+		newCapacity *= 2;
+	}
+
+	if (newCapacity == pMap->capacity) {
+		return true;
+	} else if (!resizeHashMap(pMap, newCapacity)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reserving hash map: failed to resize map to %u slots.", newCapacity);
+		return false;
+	}
+	return true;
+}
+
+bool hashMapInsert(HashMap *const pMap, const uint32_t key, const void *const pValue) {
+	if (!pMap || !pValue) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error inserting into hash map: map or value is null.");
+		return false;
+	}
+
+	if (!hashMapReserve(pMap, pMap->count + 1)) {
+		return false;
+	}
+
+	memcpy(valueAt(pMap, pMap->capacity), pValue, pMap->valueSize);
+	insertEntry(pMap, key, hashKey(pMap, key));
+	return true;
+}
+
+void *hashMapFind(const HashMap *const pMap, const uint32_t key) {
+	if (!pMap) {
+		return nullptr;
+	}
+
+	const uint32_t index = findSlot(pMap, key);
+	return index < pMap->capacity ? valueAt(pMap, index) : nullptr;
+}
+
+bool hashMapRemove(HashMap *const pMap, const uint32_t key) {
+	if (!pMap) {
+		return false;
+	}
+
+	uint32_t index = findSlot(pMap, key);
+	if (index >= pMap->capacity) {
+		return false;
+	}
+
+	// Shift each following entry that is not in its home slot back by one, so that no probe sequence passes an empty slot.
+	const uint32_t mask = pMap->capacity - 1;
+	uint32_t nextIndex = (index + 1) & mask;
+	while (pMap->pSlots[nextIndex].probeLength > 1) {
+		pMap->pSlots[index] = pMap->pSlots[nextIndex];
+		pMap->pSlots[index].probeLength -= 1;
+		memcpy(valueAt(pMap, index), valueAt(pMap, nextIndex), pMap->valueSize);
+		index = nextIndex;
+		nextIndex = (nextIndex + 1) & mask;
+	}
+	pMap->pSlots[index] = (HashMapSlot){ };
+	pMap->count -= 1;
+	return true;
+}
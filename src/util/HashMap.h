@@ -0,0 +1,61 @@
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Maps 32-bit keys (e.g. interned string IDs) to values of a fixed size, stored in the map.
+// Uses open addressing with Robin Hood probing: an entry being inserted takes the slot of any entry closer to its home slot,
+// 	which keeps probe sequences short and even, so a lookup stays O(1) as the map grows.
+// Removal shifts the following entries back instead of leaving tombstones.
+
+// Returns the hash of a key; if a map has no hash functor, keys are used as their own hash.
+typedef uint32_t (*HashFunctor)(const uint32_t key);
+
+typedef struct HashMapSlot {
+	uint32_t key;
+	uint32_t hash;
+
+	// One more than the distance from the entry's home slot, or zero if the slot is empty.
+	uint32_t probeLength;
+} HashMapSlot;
+
+typedef struct HashMap {
+
+	// Always zero or a power of two.
+	uint32_t capacity;
+	uint32_t count;
+
+	size_t valueSize;
+	HashFunctor hashFunctor;
+
+	HashMapSlot *pSlots;
+
+	// One value for each slot, followed by scratch space for two values used while inserting.
+	void *pValues;
+
+} HashMap;
+
+// Returns an empty map; no memory is allocated until the first insertion.
+HashMap newHashMap(const size_t valueSize, const HashFunctor hashFunctor);
+
+void deleteHashMap(HashMap *const pMap);
+
+// Makes room for at least entryCount entries without resizing again.
+// Returns true if successful, false otherwise.
+bool hashMapReserve(HashMap *const pMap, const uint32_t entryCount);
+
+// Inserts a value under the key, replacing the value already under it if there is one.
+// Returns true if successful, false otherwise.
+bool hashMapInsert(HashMap *const pMap, const uint32_t key, const void *const pValue);
+
+// Returns a pointer to the value under the key, or null if there is none.
+// The pointer is invalidated by the next insertion or removal.
+void *hashMapFind(const HashMap *const pMap, const uint32_t key);
+
+// Removes the value under the key.
+// Returns true if there was one, false otherwise.
+bool hashMapRemove(HashMap *const pMap, const uint32_t key);
+
+#endif	// HASH_MAP_H
@@ -0,0 +1,187 @@
+#include "LZ4.h"
+
+#include <string.h>
+
+#define LZ4_MIN_MATCH			4
+#define LZ4_MAX_OFFSET			65535
+
+// The format requires the last five bytes of a block to be literals, and the last match to start at least twelve bytes before the end.
+#define LZ4_LAST_LITERALS		5
+#define LZ4_MATCH_FIND_LIMIT	12
+
+#define LZ4_HASH_BITS			12
+
+static inline uint32_t readU32(const uint8_t *const pBytes) {
+	uint32_t value = 0;
+	memcpy(&value, pBytes, sizeof(value));
+	return value;
+}
+
+static inline uint32_t hashSequence(const uint32_t sequence) {
+	return (sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+size_t lz4CompressBound(const size_t inputSize) {
+	return inputSize + inputSize / 255 + 16;
+}
+
+// Writes the rest of a length that did not fit in its four bits of the token.
+static bool writeLengthExtension(size_t length, uint8_t *const pOutput, const size_t outputCapacity, size_t *const pOutputPosition) {
+	for (; length >= 255; length -= 255) {
+		if (*pOutputPosition >= outputCapacity) {
+			return false;
+		}
+		pOutput[(*pOutputPosition)++] = 255;
+	}
+	if (*pOutputPosition >= outputCapacity) {
+		return false;
+	}
+	pOutput[(*pOutputPosition)++] = (uint8_t)length;
+	return true;
+}
+
+// Writes one sequence: a run of literals, followed by a match unless this is the last sequence of the block.
+static bool writeSequence(const uint8_t *const pLiterals, const size_t literalLength, const size_t offset, const size_t matchLength,
+		uint8_t *const pOutput, const size_t outputCapacity, size_t *const pOutputPosition) {
+
+	if (*pOutputPosition >= outputCapacity) {
+		return false;
+	}
+	const size_t matchCode = matchLength > 0 ? matchLength - LZ4_MIN_MATCH : 0;
+	const uint8_t token = (uint8_t)(((literalLength >= 15 ? 15 : literalLength) << 4) | (matchCode >= 15 ? 15 : matchCode));
+	pOutput[(*pOutputPosition)++] = token;
+
+	if (literalLength >= 15 && !writeLengthExtension(literalLength - 15, pOutput, outputCapacity, pOutputPosition)) {
+		return false;
+	}
+	if (literalLength > outputCapacity - *pOutputPosition) {
+		return false;
+	}
+	memcpy(&pOutput[*pOutputPosition], pLiterals, literalLength);
+	*pOutputPosition += literalLength;
+
+	if (matchLength == 0) {
+		return true;
+	}
+	if (outputCapacity - *pOutputPosition < 2) {
+		return false;
+	}
+	pOutput[(*pOutputPosition)++] = (uint8_t)offset;
+	pOutput[(*pOutputPosition)++] = (uint8_t)(offset >> 8);
+	return matchCode < 15 || writeLengthExtension(matchCode - 15, pOutput, outputCapacity, pOutputPosition);
+}
+
+size_t lz4CompressBlock(const uint8_t *const pInput, const size_t inputSize, uint8_t *const pOutput, const size_t outputCapacity) {
+	if ((!pInput && inputSize > 0) || !pOutput) {
+		return 0;
+	}
+
+	// Positions are stored plus one, so that zero marks an empty slot.
+	uint32_t hashTable[1 << LZ4_HASH_BITS] = { };
+	size_t outputPosition = 0;
+	size_t anchor = 0;
+	size_t position = 0;
+
+	if (inputSize > LZ4_MATCH_FIND_LIMIT) {
+		const size_t matchFindLimit = inputSize - LZ4_MATCH_FIND_LIMIT;
+		const size_t matchEndLimit = inputSize - LZ4_LAST_LITERALS;
+		while (position < matchFindLimit) {
+			const uint32_t sequence = readU32(&pInput[position]);
+			const uint32_t hash = hashSequence(sequence);
+			const size_t candidate = hashTable[hash];
+			hashTable[hash] = (uint32_t)position + 1;
+
+			if (candidate == 0 || position - (candidate - 1) > LZ4_MAX_OFFSET || readU32(&pInput[candidate - 1]) != sequence) {
+				position += 1;
+				continue;
+			}
+
+			const size_t matchStart = candidate - 1;
+			size_t matchLength = LZ4_MIN_MATCH;
+			while (position + matchLength < matchEndLimit && pInput[matchStart + matchLength] == pInput[position + matchLength]) {
+				matchLength += 1;
+			}
+
+			if (!writeSequence(&pInput[anchor], position - anchor, position - matchStart, matchLength, pOutput, outputCapacity, &outputPosition)) {
+				return 0;
+			}
+			position += matchLength;
+			anchor = position;
+		}
+	}
+
+	if (!writeSequence(&pInput[anchor], inputSize - anchor, 0, 0, pOutput, outputCapacity, &outputPosition)) {
+		return 0;
+	}
+	return outputPosition;
+}
+
+// Reads the rest of a length that did not fit in its four bits of the token.
+static bool readLengthExtension(const uint8_t *const pInput, const size_t inputSize, size_t *const pInputPosition, size_t *const pLength) {
+	uint8_t byte = 255;
+	while (byte == 255) {
+		if (*pInputPosition >= inputSize) {
+			return false;
+		}
+		byte = pInput[(*pInputPosition)++];
+		*pLength += byte;
+	}
+	return true;
+}
+
+bool lz4DecompressBlock(const uint8_t *const pInput, const size_t inputSize, uint8_t *const pOutput, const size_t outputSize) {
+	if ((!pInput && inputSize > 0) || (!pOutput && outputSize > 0)) {
+		return false;
+	}
+
+	size_t inputPosition = 0;
+	size_t outputPosition = 0;
+	while (inputPosition < inputSize) {
+		const uint8_t token = pInput[inputPosition++];
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !readLengthExtension(pInput, inputSize, &inputPosition, &literalLength)) {
+			return false;
+		}
+		if (literalLength > inputSize - inputPosition || literalLength > outputSize - outputPosition) {
+			return false;
+		}
+		if (literalLength > 0) {
+			memcpy(&pOutput[outputPosition], &pInput[inputPosition], literalLength);
+		}
+		inputPosition += literalLength;
+		outputPosition += literalLength;
+
+		// The last sequence has literals only.
+		if (inputPosition == inputSize) {
+			break;
+		}
+
+		if (inputSize - inputPosition < 2) {
+			return false;
+		}
+		const size_t offset = (size_t)pInput[inputPosition] | ((size_t)pInput[inputPosition + 1] << 8);
+		inputPosition += 2;
+		if (offset == 0 || offset > outputPosition) {
+			return false;
+		}
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLengthExtension(pInput, inputSize, &inputPosition, &matchLength)) {
+			return false;
+		}
+		matchLength += LZ4_MIN_MATCH;
+		if (matchLength > outputSize - outputPosition) {
+			return false;
+		}
+
+		// Matches may overlap the bytes they produce, so they are copied forward one byte at a time.
+		const uint8_t *pMatch = &pOutput[outputPosition - offset];
+		for (size_t i = 0; i < matchLength; ++i) {
+			pOutput[outputPosition + i] = pMatch[i];
+		}
+		outputPosition += matchLength;
+	}
+
+	return outputPosition == outputSize;
+}
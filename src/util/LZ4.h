@@ -0,0 +1,22 @@
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Compression and decompression of single blocks in the LZ4 block format, without the LZ4 frame format around them.
+
+// Returns the largest size that a block of inputSize bytes can compress to.
+size_t lz4CompressBound(const size_t inputSize);
+
+// Compresses a block with a fast greedy match search.
+// Returns the compressed size, or zero if the compressed block would not fit in outputCapacity bytes.
+size_t lz4CompressBlock(const uint8_t *const pInput, const size_t inputSize, uint8_t *const pOutput, const size_t outputCapacity);
+
+// Decompresses a block whose decompressed size is known.
+// Every length and offset is checked, so a corrupt block fails instead of reading or writing out of bounds.
+// Returns true if the block decompressed to exactly outputSize bytes, false otherwise.
+bool lz4DecompressBlock(const uint8_t *const pInput, const size_t inputSize, uint8_t *const pOutput, const size_t outputSize);
+
+#endif	// LZ4_H
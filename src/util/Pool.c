@@ -0,0 +1,133 @@
+#include "Pool.h"
+
+#include <string.h>
+#include "log/Logger.h"
+#include "Allocation.h"
+
+#define POOL_MIN_CAPACITY 16
+
+static bool growPool(Pool *const pPool, const uint32_t newCapacity) {
+	PoolSlot *const pNewSlots = heapAlloc(newCapacity, sizeof(PoolSlot));
+	if (!pNewSlots) {
+		return false;
+	}
+	void *const pNewValues = heapAlloc(newCapacity, pPool->valueSize);
+	if (!pNewValues) {
+		heapFree(pNewSlots);
+		return false;
+	}
+
+	if (pPool->pSlots) {
+		memcpy(pNewSlots, pPool->pSlots, pPool->capacity * sizeof(PoolSlot));
+		pPool->pSlots = heapFree(pPool->pSlots);
+	}
+	if (pPool->pValues) {
+		memcpy(pNewValues, pPool->pValues, (size_t)pPool->capacity * pPool->valueSize);
+		pPool->pValues = heapFree(pPool->pValues);
+	}
+
+	// The new slots are pushed onto the free list last to first, so that they are allocated in order.
+	for (uint32_t index = newCapacity; index > pPool->capacity; --index) {
+		pNewSlots[index - 1].nextFree = pPool->firstFree;
+		pPool->firstFree = index - 1;
+	}
+
+	pPool->capacity = newCapacity;
+	pPool->pSlots = pNewSlots;
+	pPool->pValues = pNewValues;
+	return true;
+}
+
+Pool newPool(const size_t valueSize) {
+	return (Pool){
+		.capacity = 0,
+		.count = 0,
+		.valueSize = valueSize,
+		.firstFree = POOL_INDEX_NONE,
+		.pSlots = nullptr,
+		.pValues = nullptr
+	};
+}
+
+void deletePool(Pool *const pPool) {
+	if (!pPool) {
+		return;
+	}
+	if (pPool->pSlots) {
+		pPool->pSlots = heapFree(pPool->pSlots);
+	}
+	if (pPool->pValues) {
+		pPool->pValues = heapFree(pPool->pValues);
+	}
+	pPool->capacity = 0;
+	pPool->count = 0;
+	pPool->firstFree = POOL_INDEX_NONE;
+}
+
+bool poolReserve(Pool *const pPool, const uint32_t capacity) {
+	if (!pPool || pPool->valueSize == 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reserving pool: pool is null or has no value size.");
+		return false;
+	}
+
+	uint32_t newCapacity = pPool->capacity > 0 ? pPool->capacity : POOL_MIN_CAPACITY;
+	while (newCapacity < capacity) {
+		if (newCapacity > UINT32_MAX / 4) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reserving pool: %u values is too many.", capacity);
+			return false;
+		}
+		newCapacity *= 2;
+	}
+
+	if (newCapacity == pPool->capacity) {
+		return true;
+	} else if (!growPool(pPool, newCapacity)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error reserving pool: failed to grow pool to %u slots.", newCapacity);
+		return false;
+	}
+	return true;
+}
+
+uint32_t poolAlloc(Pool *const pPool) {
+	if (!pPool) {
+		return POOL_INDEX_NONE;
+	}
+
+	if (pPool->firstFree == POOL_INDEX_NONE && !poolReserve(pPool, pPool->capacity + 1)) {
+		return POOL_INDEX_NONE;
+	}
+
+	const uint32_t index = pPool->firstFree;
+	pPool->firstFree = pPool->pSlots[index].nextFree;
+	pPool->pSlots[index].nextFree = POOL_INDEX_NONE;
+	pPool->pSlots[index].used = true;
+	pPool->count += 1;
+	return index;
+}
+
+void poolFree(Pool *const pPool, const uint32_t index) {
+	if (!poolIsUsed(pPool, index)) {
+		return;
+	}
+
+	pPool->pSlots[index].used = false;
+	pPool->pSlots[index].generation += 1;
+	pPool->pSlots[index].nextFree = pPool->firstFree;
+	pPool->firstFree = index;
+	pPool->count -= 1;
+}
+
+bool poolIsUsed(const Pool *const pPool, const uint32_t index) {
+	return pPool && index < pPool->capacity && pPool->pSlots[index].used;
+}
+
+uint32_t poolGetGeneration(const Pool *const pPool, const uint32_t index) {
+	return pPool && index < pPool->capacity ? pPool->pSlots[index].generation : 0;
+}
+
+void *poolGet(const Pool *const pPool, const uint32_t index) {
+	if (!pPool || index >= pPool->capacity) {
+		return nullptr;
+	}
+	return (char *)pPool->pValues + (size_t)index * pPool->valueSize;
+}
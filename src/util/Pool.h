@@ -0,0 +1,68 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Stores values of a fixed size in one contiguous, growable array of slots.
+// Free slots are kept in a free list, so that allocating and freeing a slot are O(1) until the pool has to grow.
+// Each slot has a generation, incremented each time the slot is freed, so that a handle made from a slot index
+// 	and its generation can be told apart from a handle to a later value in the same slot.
+// A freed slot's value is kept as it is, so that memory owned by the value can be reused by the next value in the slot.
+
+#define POOL_INDEX_NONE UINT32_MAX
+
+typedef struct PoolSlot {
+	uint32_t generation;
+
+	// Index of the next free slot, or POOL_INDEX_NONE; only meaningful while the slot is free.
+	uint32_t nextFree;
+
+	bool used;
+} PoolSlot;
+
+typedef struct Pool {
+
+	uint32_t capacity;
+	uint32_t count;
+
+	size_t valueSize;
+
+	// Index of the first free slot, or POOL_INDEX_NONE if every slot is used.
+	uint32_t firstFree;
+
+	PoolSlot *pSlots;
+
+	// One value for each slot; values in slots that were never used are zeroed.
+	void *pValues;
+
+} Pool;
+
+// Returns an empty pool; no memory is allocated until the first allocation.
+Pool newPool(const size_t valueSize);
+
+// Frees the pool's slots; memory owned by the values must be freed by the user beforehand.
+void deletePool(Pool *const pPool);
+
+// Makes room for at least capacity values without growing again.
+// Returns true if successful, false otherwise.
+bool poolReserve(Pool *const pPool, const uint32_t capacity);
+
+// Allocates a slot, growing the pool if every slot is used.
+// Returns the index of the slot, or POOL_INDEX_NONE if the pool could not grow.
+uint32_t poolAlloc(Pool *const pPool);
+
+// Frees a slot and increments its generation.
+void poolFree(Pool *const pPool, const uint32_t index);
+
+// Returns true if the slot is allocated, false otherwise.
+bool poolIsUsed(const Pool *const pPool, const uint32_t index);
+
+uint32_t poolGetGeneration(const Pool *const pPool, const uint32_t index);
+
+// Returns a pointer to the value in a slot, or null if the index is out of range.
+// The pointer is invalidated when the pool grows.
+void *poolGet(const Pool *const pPool, const uint32_t index);
+
+#endif	// POOL_H
@@ -1,14 +1,150 @@
 #include "Random.h"
 
-#include <stdlib.h>
 #include <time.h>
 
-void initRandom(void) {
-	srand(time(nullptr));
+static uint64_t randomSeed = 0;
+
+static RandomState streams[RANDOM_STREAM_COUNT];
+
+static inline uint64_t rotateLeft(const uint64_t x, const int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t splitMix64(uint64_t *const pX) {
+	uint64_t z = (*pX += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
 }
 
-#define X(typename, functionName) typename functionName(const typename minimum, const typename maximum) { \
-			return rand() % (maximum + 1 - minimum) + minimum; \
+// xoshiro256** by David Blackman and Sebastiano Vigna.
+static inline uint64_t xoshiro256StarStar(RandomState *const pState) {
+	uint64_t *const s = pState->s;
+	const uint64_t result = rotateLeft(s[1] * 5, 7) * 9;
+	const uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotateLeft(s[3], 45);
+	return result;
+}
+
+// Maps 64 random bits onto [0, span), or onto every 64-bit number if span is zero.
+// Spans that fit in 32 bits use a multiply instead of a division; the bias of either method is negligible for the spans the game uses.
+static inline uint64_t reduceToSpan(const uint64_t x, const uint64_t span) {
+	if (span == 0) {
+		return x;
+	} else if (span <= UINT32_MAX) {
+		return ((x >> 32) * span) >> 32;
+	}
+	return x % span;
+}
+
+// Takes the top 24 bits, which fill a float's mantissa exactly.
+static inline float toUnitFloat(const uint64_t x) {
+	return (float)(x >> 40) * 0x1.0p-24F;
+}
+
+void randomStateSeed(RandomState *const pState, const uint64_t seed) {
+	if (!pState) {
+		return;
+	}
+	uint64_t x = seed;
+	for (int i = 0; i < 4; ++i) {
+		pState->s[i] = splitMix64(&x);
+	}
+}
+
+uint64_t randomStateNext(RandomState *const pState) {
+	return xoshiro256StarStar(pState);
+}
+
+void randomStateJump(RandomState *const pState) {
+	static const uint64_t jump[4] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+
+	uint64_t s[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < 4; ++i) {
+		for (int b = 0; b < 64; ++b) {
+			if (jump[i] & (1ULL << b)) {
+				s[0] ^= pState->s[0];
+				s[1] ^= pState->s[1];
+				s[2] ^= pState->s[2];
+				s[3] ^= pState->s[3];
+			}
+			xoshiro256StarStar(pState);
+		}
+	}
+
+	for (int i = 0; i < 4; ++i) {
+		pState->s[i] = s[i];
+	}
+}
+
+#define X(typename, functionName) typename functionName(const RandomStream stream, const typename minimum, const typename maximum) { \
+			const uint64_t span = (unsigned long long)maximum - (unsigned long long)minimum + 1ULL; \
+			const uint64_t offset = reduceToSpan(xoshiro256StarStar(&streams[stream]), span); \
+			return (typename)((unsigned long long)minimum + offset); \
 		}
 LIST_OF_RANDOM_FUNCTIONS
-#undef X
\ No newline at end of file
+#undef X
+
+float randomFloat(const RandomStream stream) {
+	return toUnitFloat(xoshiro256StarStar(&streams[stream]));
+}
+
+// The fill functions work on a local copy of the stream's state, so that it stays in registers for the whole loop.
+
+void randomFillU64(const RandomStream stream, const size_t count, uint64_t *const pOut) {
+	if (!pOut) {
+		return;
+	}
+	RandomState state = streams[stream];
+	for (size_t i = 0; i < count; ++i) {
+		pOut[i] = xoshiro256StarStar(&state);
+	}
+	streams[stream] = state;
+}
+
+void randomFillRangeU32(const RandomStream stream, const uint32_t minimum, const uint32_t maximum, const size_t count, uint32_t *const pOut) {
+	if (!pOut) {
+		return;
+	}
+	const uint64_t span = (uint64_t)maximum - (uint64_t)minimum + 1ULL;
+	RandomState state = streams[stream];
+	for (size_t i = 0; i < count; ++i) {
+		pOut[i] = minimum + (uint32_t)(((xoshiro256StarStar(&state) >> 32) * span) >> 32);
+	}
+	streams[stream] = state;
+}
+
+void randomFillFloat(const RandomStream stream, const size_t count, float *const pOut) {
+	if (!pOut) {
+		return;
+	}
+	RandomState state = streams[stream];
+	for (size_t i = 0; i < count; ++i) {
+		pOut[i] = toUnitFloat(xoshiro256StarStar(&state));
+	}
+	streams[stream] = state;
+}
+
+void initRandom(void) {
+	initRandomSeed((uint64_t)time(nullptr));
+}
+
+void initRandomSeed(const uint64_t seed) {
+	randomSeed = seed;
+
+	// Each stream starts one jump after the previous one, so that no two streams ever overlap.
+	randomStateSeed(&streams[0], seed);
+	for (int i = 1; i < RANDOM_STREAM_COUNT; ++i) {
+		streams[i] = streams[i - 1];
+		randomStateJump(&streams[i]);
+	}
+}
+
+uint64_t getRandomSeed(void) {
+	return randomSeed;
+}
@@ -1,6 +1,33 @@
 #ifndef RANDOM_H
 #define RANDOM_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+// Each system draws random numbers from its own stream, so that one system using more or fewer numbers
+// 	does not change the numbers that another system gets.
+// All streams are derived from a single seed, so saving the seed is enough to repeat a run.
+typedef enum RandomStream {
+	RANDOM_STREAM_AI,
+	RANDOM_STREAM_SPAWNING,
+	RANDOM_STREAM_EFFECTS,
+	RANDOM_STREAM_COUNT
+} RandomStream;
+
+// The state of a xoshiro256** generator. Must not be all zeros; seed it with randomStateSeed.
+typedef struct RandomState {
+	uint64_t s[4];
+} RandomState;
+
+// Seeds a generator, expanding the seed into the full state with SplitMix64.
+void randomStateSeed(RandomState *const pState, const uint64_t seed);
+
+// Returns the next 64 random bits from a generator.
+uint64_t randomStateNext(RandomState *const pState);
+
+// Advances a generator by 2^128 numbers, giving a sequence that does not overlap with the one it would have produced.
+void randomStateJump(RandomState *const pState);
+
 // TODO: generate template function name automatically.
 
 #define LIST_OF_RANDOM_FUNCTIONS \
@@ -12,12 +39,13 @@
 		X(unsigned int, randomU) \
 		X(unsigned long, randomUL) \
 		X(unsigned long long, randomULL)
-		
-#define X(typename, functionName) typename functionName(const typename minimum, const typename maximum);
+
+// Each returns a random number in the inclusive range [minimum, maximum] from a stream.
+#define X(typename, functionName) typename functionName(const RandomStream stream, const typename minimum, const typename maximum);
 LIST_OF_RANDOM_FUNCTIONS
 #undef X
 
-#define random(minimum, maximum) _Generic((minimum), \
+#define random(stream, minimum, maximum) _Generic((minimum), \
 			short: randomS, \
 			int: randomI, \
 			long: randomL, \
@@ -26,8 +54,28 @@ LIST_OF_RANDOM_FUNCTIONS
 			unsigned int: randomU, \
 			unsigned long: randomUL, \
 			unsigned long long: randomULL \
-		)(minimum, maximum)
+		)(stream, minimum, maximum)
 
+// Returns a random float in the range [0, 1) from a stream.
+float randomFloat(const RandomStream stream);
+
+// Fills an array with random 64-bit numbers from a stream.
+void randomFillU64(const RandomStream stream, const size_t count, uint64_t *const pOut);
+
+// Fills an array with random numbers in the inclusive range [minimum, maximum] from a stream.
+void randomFillRangeU32(const RandomStream stream, const uint32_t minimum, const uint32_t maximum, const size_t count, uint32_t *const pOut);
+
+// Fills an array with random floats in the range [0, 1) from a stream.
+void randomFillFloat(const RandomStream stream, const size_t count, float *const pOut);
+
+// Seeds the random number generator from the current time.
 void initRandom(void);
 
-#endif	// RANDOM_H
\ No newline at end of file
+// Seeds the random number generator with a given seed, e.g. to repeat the random choices of a recorded session.
+// Resets every stream.
+void initRandomSeed(const uint64_t seed);
+
+// Returns the seed that the random number generator was last seeded with.
+uint64_t getRandomSeed(void);
+
+#endif	// RANDOM_H
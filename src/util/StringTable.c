@@ -0,0 +1,200 @@
+#include "StringTable.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "log/Logger.h"
+#include "Allocation.h"
+
+// Must be powers of two.
+#define STRING_TABLE_INITIAL_ENTRY_CAPACITY 64
+#define STRING_TABLE_INITIAL_SLOT_COUNT 128
+
+typedef struct InternedString {
+	String string;
+	uint32_t hash;
+} InternedString;
+
+const StringID stringIDNull = 0;
+
+// Indexed by string ID; the first entry is reserved for the null string.
+static uint32_t entryCount = 0;
+static uint32_t entryCapacity = 0;
+static InternedString *pEntries = nullptr;
+
+// Open-addressed hash table of string IDs, probed linearly; empty slots hold stringIDNull.
+// The slot count is kept at least twice the entry count, so probe sequences stay short.
+static uint32_t slotCount = 0;
+static StringID *pSlots = nullptr;
+
+static bool stringTableInitialized = false;
+
+// 32-bit FNV-1a.
+static uint32_t hashString(const String string) {
+	uint32_t hash = 2166136261U;
+	for (size_t i = 0; i < string.length; ++i) {
+		hash ^= (uint8_t)string.pBuffer[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+static bool stringsEqual(const InternedString entry, const uint32_t hash, const String string) {
+	return entry.hash == hash && entry.string.length == string.length && memcmp(entry.string.pBuffer, string.pBuffer, string.length) == 0;
+}
+
+// Returns the slot holding the string, or the empty slot where it would be inserted.
+static uint32_t probeSlot(const uint32_t hash, const String string) {
+	const uint32_t mask = slotCount - 1;
+	uint32_t slotIndex = hash & mask;
+	while (pSlots[slotIndex] != stringIDNull && !stringsEqual(pEntries[pSlots[slotIndex]], hash, string)) {
+		slotIndex = (slotIndex + 1) & mask;
+	}
+	return slotIndex;
+}
+
+// Doubles the number of slots and reinserts every interned string.
+static bool growSlots(void) {
+	const uint32_t newSlotCount = slotCount * 2;
+	StringID *const pNewSlots = heapAlloc(newSlotCount, sizeof(StringID));
+	if (!pNewSlots) {
+		return false;
+	}
+
+	pSlots = heapFree(pSlots);
+	pSlots = pNewSlots;
+	slotCount = newSlotCount;
+	for (StringID stringID = 1; stringID < entryCount; ++stringID) {
+		pSlots[probeSlot(pEntries[stringID].hash, pEntries[stringID].string)] = stringID;
+	}
+	return true;
+}
+
+static bool growEntries(void) {
+	const uint32_t newEntryCapacity = entryCapacity * 2;
+	InternedString *const pNewEntries = heapAlloc(newEntryCapacity, sizeof(InternedString));
+	if (!pNewEntries) {
+		return false;
+	}
+
+	memcpy(pNewEntries, pEntries, entryCount * sizeof(InternedString));
+	pEntries = heapFree(pEntries);
+	pEntries = pNewEntries;
+	entryCapacity = newEntryCapacity;
+	return true;
+}
+
+void initStringTable(void) {
+	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Initializing string table...");
+
+	if (stringTableInitialized) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error initializing string table: string table already initialized.");
+		return;
+	}
+
+	pEntries = heapAlloc(STRING_TABLE_INITIAL_ENTRY_CAPACITY, sizeof(InternedString));
+	pSlots = heapAlloc(STRING_TABLE_INITIAL_SLOT_COUNT, sizeof(StringID));
+	if (!pEntries || !pSlots) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error initializing string table: failed to allocate table.");
+		if (pEntries) {
+			pEntries = heapFree(pEntries);
+		}
+		if (pSlots) {
+			pSlots = heapFree(pSlots);
+		}
+		return;
+	}
+
+	entryCapacity = STRING_TABLE_INITIAL_ENTRY_CAPACITY;
+	entryCount = 1;	// Reserve the null string ID.
+	pEntries[stringIDNull] = (InternedString){ };
+	slotCount = STRING_TABLE_INITIAL_SLOT_COUNT;
+
+	stringTableInitialized = true;
+	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Done initializing string table.");
+}
+
+void terminateStringTable(void) {
+	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Terminating string table...");
+
+	if (!stringTableInitialized) {
+		return;
+	}
+
+	for (StringID stringID = 1; stringID < entryCount; ++stringID) {
+		deleteString(&pEntries[stringID].string);
+	}
+	pEntries = heapFree(pEntries);
+	pSlots = heapFree(pSlots);
+	entryCount = 0;
+	entryCapacity = 0;
+	slotCount = 0;
+
+	stringTableInitialized = false;
+	logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "Done terminating string table.");
+}
+
+StringID internString(const String string) {
+	if (!stringTableInitialized) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error interning string: string table is not initialized.");
+		return stringIDNull;
+	} else if (stringIsNull(string)) {
+		return stringIDNull;
+	}
+
+	const uint32_t hash = hashString(string);
+	uint32_t slotIndex = probeSlot(hash, string);
+	if (pSlots[slotIndex] != stringIDNull) {
+		return pSlots[slotIndex];
+	}
+
+	if (entryCount == entryCapacity && !growEntries()) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error interning string \"%s\": failed to grow string table.", string.pBuffer);
+		return stringIDNull;
+	}
+	if ((entryCount + 1) * 2 > slotCount) {
+		if (!growSlots()) {
+			logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error interning string \"%s\": failed to grow string table.", string.pBuffer);
+			return stringIDNull;
+		}
+		slotIndex = probeSlot(hash, string);
+	}
+
+	// The copy is made from the string's length, since its buffer may be larger than its contents.
+	String copy = newStringEmpty(string.length + 1);
+	if (stringIsNull(copy)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Error interning string \"%s\": failed to copy string.", string.pBuffer);
+		return stringIDNull;
+	}
+	memcpy(copy.pBuffer, string.pBuffer, string.length);
+	copy.pBuffer[string.length] = '\0';
+	copy.length = string.length;
+
+	const StringID stringID = entryCount++;
+	pEntries[stringID] = (InternedString){
+		.string = copy,
+		.hash = hash
+	};
+	pSlots[slotIndex] = stringID;
+	return stringID;
+}
+
+StringID findStringID(const String string) {
+	if (!stringTableInitialized || stringIsNull(string)) {
+		return stringIDNull;
+	}
+	return pSlots[probeSlot(hashString(string), string)];
+}
+
+String getInternedString(const StringID stringID) {
+	if (!stringTableInitialized || stringID == stringIDNull || stringID >= entryCount) {
+		return (String){ };
+	}
+	return pEntries[stringID].string;
+}
+
+uint32_t getStringIDHash(const StringID stringID) {
+	if (!stringTableInitialized || stringID >= entryCount) {
+		return 0;
+	}
+	return pEntries[stringID].hash;
+}
@@ -0,0 +1,35 @@
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "String.h"
+
+// Interns identifier strings (e.g. entity and texture IDs), giving each distinct string a stable 32-bit ID.
+// Registries are keyed by these IDs, so that finding a record is an integer hash probe instead of hashing and comparing strings;
+// 	strings are interned once when they are read or first used, and their IDs are kept thereafter.
+
+typedef uint32_t StringID;
+
+// The ID of the null string; no interned string has this ID.
+extern const StringID stringIDNull;
+
+void initStringTable(void);
+
+void terminateStringTable(void);
+
+// Returns the ID of the string, interning a copy of it if it was not interned yet.
+// Returns stringIDNull if the string is null or could not be interned.
+StringID internString(const String string);
+
+// Returns the ID of the string if it was interned, stringIDNull otherwise; never interns the string.
+StringID findStringID(const String string);
+
+// Returns the interned string with the given ID, or a null string if there is none.
+// The string is owned by the table and must not be deleted.
+String getInternedString(const StringID stringID);
+
+// Returns the hash of the interned string with the given ID, computed once when it was interned.
+uint32_t getStringIDHash(const StringID stringID);
+
+#endif	// STRING_TABLE_H
@@ -5,12 +5,26 @@
 #include <time.h>
 #include "log/Logger.h"
 
-uint64_t getMilliseconds(void) {
+uint64_t getNanoseconds(void) {
 	struct timespec ts = { };
-	if (clock_gettime(CLOCK_REALTIME, &ts) == 0) {
-		return (uint64_t)ts.tv_sec * 1000LLU + (uint64_t)ts.tv_nsec / 1'000'000LLU;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+		return (uint64_t)ts.tv_sec * 1'000'000'000LLU + (uint64_t)ts.tv_nsec;
 	}
 	const errno_t error = errno;
-	logMsg(loggerSystem, LOG_LEVEL_ERROR, "Getting milliseconds: error occurred getting clock time (error code = \"%s\").", strerror(error));
+	logMsg(loggerSystem, LOG_LEVEL_ERROR, "Getting nanoseconds: error occurred getting clock time (error code = \"%s\").", strerror(error));
 	return 0;
 }
+
+uint64_t getMilliseconds(void) {
+	return getNanoseconds() / 1'000'000LLU;
+}
+
+void sleepNanoseconds(const uint64_t nanoseconds) {
+	struct timespec remaining = {
+		.tv_sec = (time_t)(nanoseconds / 1'000'000'000LLU),
+		.tv_nsec = (long int)(nanoseconds % 1'000'000'000LLU)
+	};
+	
+	// Sleep again for the rest of the time if a signal interrupts the sleep.
+	while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR) {}
+}
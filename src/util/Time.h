@@ -3,6 +3,14 @@
 
 #include <stdint.h>
 
+// Returns the time of a monotonic clock in nanoseconds, which is unaffected by changes to the system time.
+// Only differences between two readings are meaningful.
+uint64_t getNanoseconds(void);
+
+// Returns the time of the monotonic clock in milliseconds.
 uint64_t getMilliseconds(void);
 
+// Suspends the calling thread for at least the given number of nanoseconds.
+void sleepNanoseconds(const uint64_t nanoseconds);
+
 #endif	// TIME_H
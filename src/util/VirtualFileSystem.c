@@ -0,0 +1,256 @@
+#include "VirtualFileSystem.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "log/Logger.h"
+#include "util/Allocation.h"
+#include "util/Archive.h"
+#include "util/FileIO.h"
+
+#define VFS_DEFAULT_ARCHIVE_PATH (RESOURCE_PATH "resources.ppak")
+
+#define VFS_PATH_MAX_LENGTH 256
+
+static uint32_t mountedArchiveCount = 0;
+static Archive mountedArchives[VFS_MAX_MOUNTED_ARCHIVES];
+
+bool vfsMountArchive(const char *const pPath) {
+	if (!pPath) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Mounting archive: path is null.");
+		return false;
+	} else if (mountedArchiveCount >= VFS_MAX_MOUNTED_ARCHIVES) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Mounting archive: cannot mount \"%s\", already at the limit of %u archives.", pPath, VFS_MAX_MOUNTED_ARCHIVES);
+		return false;
+	}
+	
+	if (!openArchive(pPath, &mountedArchives[mountedArchiveCount])) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Mounting archive: failed to open \"%s\".", pPath);
+		return false;
+	}
+	mountedArchiveCount += 1;
+	logMsg(loggerSystem, LOG_LEVEL_INFO, "Mounted archive \"%s\".", pPath);
+	return true;
+}
+
+void vfsMountDefaultArchive(void) {
+	// Probe for the archive first, since running from loose files is not an error.
+	FILE *const pStream = fopen(VFS_DEFAULT_ARCHIVE_PATH, "rb");
+	if (!pStream) {
+		logMsg(loggerSystem, LOG_LEVEL_VERBOSE, "No resource archive found; reading loose resource files.");
+		return;
+	}
+	fclose(pStream);
+	vfsMountArchive(VFS_DEFAULT_ARCHIVE_PATH);
+}
+
+void vfsUnmountArchives(void) {
+	for (uint32_t i = 0; i < mountedArchiveCount; ++i) {
+		closeArchive(&mountedArchives[i]);
+	}
+	mountedArchiveCount = 0;
+}
+
+// Finds a file in the mounted archives, searching the most recently mounted archive first.
+// Returns the archive that has the file, or null if none of them do.
+static Archive *findArchivedFile(const char *const pPath, ArchiveEntry *const pOutEntry) {
+	for (uint32_t i = mountedArchiveCount; i > 0; --i) {
+		if (archiveFindEntry(&mountedArchives[i - 1], pPath, pOutEntry)) {
+			return &mountedArchives[i - 1];
+		}
+	}
+	return nullptr;
+}
+
+// Reads a file whole from the first archive that has it.
+// Returns true if an archive had the file, even if it could not be read; pOutFile is left empty if reading failed.
+static bool readArchivedFile(const char *const pPath, VFSFile *const pOutFile) {
+	ArchiveEntry entry = { };
+	Archive *const pArchive = findArchivedFile(pPath, &entry);
+	if (!pArchive) {
+		return false;
+	}
+	
+	void *const pData = heapAlloc(entry.size > 0 ? entry.size : 1, sizeof(uint8_t));
+	if (!pData) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading file \"%s\": failed to allocate %zu bytes to read into.", pPath, entry.size);
+		return true;
+	} else if (!archiveReadEntry(pArchive, entry, pData)) {
+		heapFree(pData);
+		return true;
+	}
+	
+	*pOutFile = (VFSFile){
+		.pData = pData,
+		.size = entry.size,
+		.pOwnedData = pData
+	};
+	return true;
+}
+
+// Writes the full path of a loose resource file into pFullPath.
+// Returns true if successful, false if the path is too long.
+static bool makeLoosePath(const char *const pPath, char pFullPath[static VFS_PATH_MAX_LENGTH]) {
+	const int pathLength = snprintf(pFullPath, VFS_PATH_MAX_LENGTH, "%s%s", RESOURCE_PATH, pPath);
+	return pathLength >= 0 && pathLength < VFS_PATH_MAX_LENGTH;
+}
+
+bool vfsIsArchived(const char *const pPath) {
+	if (!pPath) {
+		return false;
+	}
+	ArchiveEntry entry = { };
+	for (uint32_t i = 0; i < mountedArchiveCount; ++i) {
+		if (archiveFindEntry(&mountedArchives[i], pPath, &entry)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool vfsReadFile(const char *const pPath, VFSFile *const pOutFile) {
+	if (!pPath || !pOutFile) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading file: path or pointer to output file is null.");
+		return false;
+	}
+	*pOutFile = (VFSFile){ };
+	
+	if (readArchivedFile(pPath, pOutFile)) {
+		return pOutFile->pData != nullptr;
+	}
+	
+	char fullPath[VFS_PATH_MAX_LENGTH];
+	if (!makeLoosePath(pPath, fullPath)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading file \"%s\": path is too long.", pPath);
+		return false;
+	}
+	
+	// The loose file is read whole with the binary reader, which then hands over its buffer.
+	BinaryReader reader = { };
+	if (!openBinaryReader(fullPath, &reader)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Reading file \"%s\": not found in any archive or in the resource directory.", pPath);
+		return false;
+	}
+	void *const pData = (void *)reader.pData;
+	*pOutFile = (VFSFile){
+		.pData = pData,
+		.size = reader.size,
+		.pOwnedData = pData
+	};
+	return true;
+}
+
+void vfsCloseFile(VFSFile *const pFile) {
+	if (!pFile) {
+		return;
+	}
+	if (pFile->pOwnedData) {
+		heapFree(pFile->pOwnedData);
+	}
+	*pFile = (VFSFile){ };
+}
+
+bool vfsOpenStream(const char *const pPath, VFSStream *const pOutStream) {
+	if (!pPath || !pOutStream) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening stream: path or pointer to output stream is null.");
+		return false;
+	}
+	*pOutStream = (VFSStream){ };
+	
+	ArchiveEntry entry = { };
+	const Archive *const pArchive = findArchivedFile(pPath, &entry);
+	if (pArchive && entry.compression != ARCHIVE_COMPRESSION_NONE) {
+		if (!readArchivedFile(pPath, &pOutStream->file) || !pOutStream->file.pData) {
+			return false;
+		}
+		pOutStream->size = pOutStream->file.size;
+		return true;
+	} else if (pArchive) {
+		pOutStream->pStream = archiveOpenEntryStream(pArchive, entry);
+		pOutStream->baseOffset = entry.dataOffset;
+		pOutStream->size = entry.size;
+		return pOutStream->pStream != nullptr;
+	}
+	
+	char fullPath[VFS_PATH_MAX_LENGTH];
+	if (!makeLoosePath(pPath, fullPath)) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening stream \"%s\": path is too long.", pPath);
+		return false;
+	}
+	
+	File file = openFile(fullPath, FMODE_READ, FMODE_NO_UPDATE, FMODE_BINARY);
+	if (!file.pStream) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening stream \"%s\": not found in any archive or in the resource directory.", pPath);
+		return false;
+	}
+	
+	long int fileSize = -1;
+	if (fseek(file.pStream, 0, SEEK_END) == 0) {
+		fileSize = ftell(file.pStream);
+	}
+	if (fileSize < 0 || fseek(file.pStream, 0, SEEK_SET) != 0) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening stream \"%s\": failed to get size of file.", pPath);
+		closeFile(&file);
+		return false;
+	}
+	
+	pOutStream->pStream = file.pStream;
+	pOutStream->size = (size_t)fileSize;
+	return true;
+}
+
+void vfsCloseStream(VFSStream *const pStream) {
+	if (!pStream) {
+		return;
+	}
+	if (pStream->pStream) {
+		fclose(pStream->pStream);
+	}
+	vfsCloseFile(&pStream->file);
+	*pStream = (VFSStream){ };
+}
+
+size_t vfsStreamRead(VFSStream *const pStream, void *const pOutput, const size_t size) {
+	if (!pStream || !pOutput || pStream->position >= pStream->size) {
+		return 0;
+	}
+	
+	const size_t remainingSize = pStream->size - pStream->position;
+	const size_t readSize = size < remainingSize ? size : remainingSize;
+	size_t bytesRead = 0;
+	if (pStream->pStream) {
+		bytesRead = fread(pOutput, 1, readSize, pStream->pStream);
+	} else if (pStream->file.pData) {
+		memcpy(pOutput, (const uint8_t *)pStream->file.pData + pStream->position, readSize);
+		bytesRead = readSize;
+	}
+	pStream->position += bytesRead;
+	return bytesRead;
+}
+
+bool vfsStreamSeek(VFSStream *const pStream, const size_t position) {
+	if (!pStream || position > pStream->size) {
+		return false;
+	} else if (pStream->pStream && fseek(pStream->pStream, (long int)(pStream->baseOffset + position), SEEK_SET) != 0) {
+		return false;
+	}
+	pStream->position = position;
+	return true;
+}
+
+bool vfsOpenBinaryReader(const char *const pPath, BinaryReader *const pOutReader) {
+	if (!pOutReader) {
+		logMsg(loggerSystem, LOG_LEVEL_ERROR, "Opening binary reader: pointer to output reader is null.");
+		return false;
+	}
+	*pOutReader = (BinaryReader){ .failed = true };
+	
+	VFSFile file = { };
+	if (!vfsReadFile(pPath, &file)) {
+		return false;
+	}
+	
+	*pOutReader = makeBinaryReader(file.pData, file.size);
+	pOutReader->ownsData = file.pOwnedData != nullptr;
+	return true;
+}
@@ -0,0 +1,81 @@
+#ifndef VIRTUAL_FILE_SYSTEM_H
+#define VIRTUAL_FILE_SYSTEM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "util/BinaryReader.h"
+
+// Resource files are named by their path relative to the resource directory, e.g. "data/textures.fgt".
+// A file is looked up in the mounted archives first, most recently mounted first,
+// 	and is read from the resource directory if no archive has it, so loose files can be used during development.
+
+#define VFS_MAX_MOUNTED_ARCHIVES 4
+
+// The contents of a resource file.
+typedef struct VFSFile {
+
+	const void *pData;
+	size_t size;
+
+	// The buffer that holds the contents, which is freed when the file is closed.
+	void *pOwnedData;
+
+} VFSFile;
+
+// Mounts an archive, so that the files in it are read from it instead of the resource directory.
+// Returns true if successful, false otherwise.
+bool vfsMountArchive(const char *const pPath);
+
+// Mounts "resources.ppak" in the resource directory if there is one.
+void vfsMountDefaultArchive(void);
+
+void vfsUnmountArchives(void);
+
+// Returns true if a mounted archive has the file, in which case the loose file in the resource directory is not read.
+bool vfsIsArchived(const char *const pPath);
+
+// Reads a whole resource file.
+// Returns true if successful, false otherwise.
+bool vfsReadFile(const char *const pPath, VFSFile *const pOutFile);
+
+void vfsCloseFile(VFSFile *const pFile);
+
+// A resource file that is read piece by piece instead of whole, e.g. music that is decoded while it plays.
+typedef struct VFSStream {
+
+	// The loose file, or a stream of its own over the archive that has the file.
+	FILE *pStream;
+
+	// Where the contents start in pStream.
+	uint64_t baseOffset;
+
+	size_t size;
+	size_t position;
+
+	// Compressed archive entries cannot be read piece by piece, so they are read whole into this instead.
+	VFSFile file;
+
+} VFSStream;
+
+// Opens a stream over a resource file; loose files and stored archive entries are read from disk as the stream is read.
+// Returns true if successful, false otherwise.
+bool vfsOpenStream(const char *const pPath, VFSStream *const pOutStream);
+
+void vfsCloseStream(VFSStream *const pStream);
+
+// Reads up to size bytes from the stream's position.
+// Returns the number of bytes read, which is less than size only at the end of the file or if reading failed.
+size_t vfsStreamRead(VFSStream *const pStream, void *const pOutput, const size_t size);
+
+// Moves the stream to a position from the start of the file.
+// Returns true if successful, false otherwise.
+bool vfsStreamSeek(VFSStream *const pStream, const size_t position);
+
+// Opens a binary reader over a whole resource file; the reader owns the contents if they were copied.
+// Returns true if successful, false otherwise.
+bool vfsOpenBinaryReader(const char *const pPath, BinaryReader *const pOutReader);
+
+#endif	// VIRTUAL_FILE_SYSTEM_H
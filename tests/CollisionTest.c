@@ -0,0 +1,122 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "game/entity/Collision.h"
+#include "util/Random.h"
+
+// Checks that resolveWallCollisions, which tests two walls at a time when SSE2 is available,
+// 	gives exactly the same positions as resolveWallCollisionsReference for randomized hitboxes, walls and steps.
+
+#define CASE_COUNT 200000
+
+// Enough walls to cover empty rooms, single walls, and both even and odd wall counts for the paired walls.
+#define MAX_WALL_COUNT 9
+
+static RandomState randomState;
+
+// Returns a random double in the range [minimum, maximum).
+static double randomDouble(const double minimum, const double maximum) {
+	return minimum + (maximum - minimum) * (double)(randomStateNext(&randomState) >> 11) * 0x1.0p-53;
+}
+
+// Returns a random integer in the inclusive range [minimum, maximum].
+static int randomInt(const int minimum, const int maximum) {
+	return minimum + (int)(randomStateNext(&randomState) % (uint64_t)(maximum - minimum + 1));
+}
+
+// Returns a step component, which is zero a quarter of the time, so that purely horizontal, purely vertical, and zero steps are all covered.
+static double randomStepComponent(void) {
+	return randomInt(0, 3) == 0 ? 0.0 : randomDouble(-1.0, 1.0);
+}
+
+// Walls are mostly whole tiles, as they are in rooms, with some arbitrary boxes.
+static BoxD randomWall(void) {
+	if (randomInt(0, 3) == 0) {
+		const double x = randomDouble(-4.0, 4.0);
+		const double y = randomDouble(-4.0, 4.0);
+		return (BoxD){ x, y, x + randomDouble(0.125, 3.0), y + randomDouble(0.125, 3.0) };
+	}
+	const int x = randomInt(-4, 4);
+	const int y = randomInt(-4, 4);
+	return (BoxD){ x, y, x + randomInt(1, 3), y + randomInt(1, 3) };
+}
+
+static BoxD randomHitbox(void) {
+	if (randomInt(0, 1) == 0) {
+		return (BoxD){ -0.5, -0.5, 0.5, 0.5 };
+	}
+	return (BoxD){ -randomDouble(0.125, 1.0), -randomDouble(0.125, 1.0), randomDouble(0.125, 1.0), randomDouble(0.125, 1.0) };
+}
+
+// Places the hitbox so that one of its edges exactly touches one of the edges of the wall.
+static Vector3D touchingPosition(const BoxD hitbox, const BoxD wall) {
+	Vector3D position = { randomDouble(wall.x1 - 1.0, wall.x2 + 1.0), randomDouble(wall.y1 - 1.0, wall.y2 + 1.0), 1.0 };
+	switch (randomInt(0, 3)) {
+		case 0: position.x = wall.x1 - hitbox.x2; break;
+		case 1: position.x = wall.x2 - hitbox.x1; break;
+		case 2: position.y = wall.y1 - hitbox.y2; break;
+		case 3: position.y = wall.y2 - hitbox.y1; break;
+	}
+	return position;
+}
+
+int main(void) {
+	randomStateSeed(&randomState, 0x50494E4B50454152);
+
+	BoxD walls[MAX_WALL_COUNT];
+	double x1[MAX_WALL_COUNT], y1[MAX_WALL_COUNT], x2[MAX_WALL_COUNT], y2[MAX_WALL_COUNT];
+	uint32_t collisionCount = 0;
+	uint32_t failureCount = 0;
+	for (uint32_t i = 0; i < CASE_COUNT; ++i) {
+		const unsigned int wallCount = (unsigned int)randomInt(0, MAX_WALL_COUNT);
+		for (unsigned int j = 0; j < wallCount; ++j) {
+			walls[j] = randomWall();
+			x1[j] = walls[j].x1;
+			y1[j] = walls[j].y1;
+			x2[j] = walls[j].x2;
+			y2[j] = walls[j].y2;
+		}
+		const CollisionWalls collisionWalls = {
+			.count = wallCount,
+			.pX1 = x1,
+			.pY1 = y1,
+			.pX2 = x2,
+			.pY2 = y2
+		};
+
+		const BoxD hitbox = randomHitbox();
+		const bool touching = wallCount > 0 && randomInt(0, 2) == 0;
+		const Vector3D previousPosition = touching ? touchingPosition(hitbox, walls[randomInt(0, (int)wallCount - 1)])
+				: (Vector3D){ randomDouble(-5.0, 5.0), randomDouble(-5.0, 5.0), 1.0 };
+		const Vector3D positionStep = { randomStepComponent(), randomStepComponent(), 0.0 };
+
+		const Vector3D resolvedPosition = resolveWallCollisions(collisionWalls, hitbox, previousPosition, positionStep);
+		const Vector3D referencePosition = resolveWallCollisionsReference(collisionWalls, hitbox, previousPosition, positionStep);
+		const Vector3D unresolvedPosition = addVec(previousPosition, positionStep);
+		if (referencePosition.x != unresolvedPosition.x || referencePosition.y != unresolvedPosition.y) {
+			collisionCount += 1;
+		}
+
+		if (resolvedPosition.x == referencePosition.x && resolvedPosition.y == referencePosition.y && resolvedPosition.z == referencePosition.z) {
+			continue;
+		}
+
+		failureCount += 1;
+		if (failureCount <= 10) {
+			fprintf(stderr, "Case %u: result (%a, %a, %a) differs from reference result (%a, %a, %a).\n", i,
+					resolvedPosition.x, resolvedPosition.y, resolvedPosition.z, referencePosition.x, referencePosition.y, referencePosition.z);
+			fprintf(stderr, "\thitbox (%a, %a, %a, %a), previous position (%a, %a), step (%a, %a), %u walls:\n",
+					hitbox.x1, hitbox.y1, hitbox.x2, hitbox.y2, previousPosition.x, previousPosition.y, positionStep.x, positionStep.y, wallCount);
+			for (unsigned int j = 0; j < wallCount; ++j) {
+				fprintf(stderr, "\t\t(%a, %a, %a, %a)\n", walls[j].x1, walls[j].y1, walls[j].x2, walls[j].y2);
+			}
+		}
+	}
+
+	if (failureCount > 0) {
+		fprintf(stderr, "%u of %u cases differ from the reference.\n", failureCount, CASE_COUNT);
+		return EXIT_FAILURE;
+	}
+	printf("All %u cases match the reference (%u of them collided with a wall).\n", CASE_COUNT, collisionCount);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,278 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "game/area/room.h"
+#include "util/Random.h"
+
+// Checks the walls prepared for a room against brute force over randomized rooms:
+// 	merged walls must cover exactly the tiles that the original walls covered,
+// 	BVH queries must find the same walls as testing every wall,
+// 	BVH raycasts must hit the nearest wall found by testing every wall,
+// 	and collisions resolved against the nearby walls must match resolving against every wall.
+
+#define ROOM_COUNT 400
+#define QUERY_COUNT 200
+
+// Rooms are at most the largest room size, in tiles.
+#define MAX_ROOM_WIDTH 32
+#define MAX_ROOM_LENGTH 20
+#define MAX_WALL_COUNT (MAX_ROOM_WIDTH * MAX_ROOM_LENGTH)
+
+static RandomState randomState;
+
+static uint32_t failureCount = 0;
+
+// Returns a random double in the range [minimum, maximum).
+static double randomDouble(const double minimum, const double maximum) {
+	return minimum + (maximum - minimum) * (double)(randomStateNext(&randomState) >> 11) * 0x1.0p-53;
+}
+
+// Returns a random integer in the inclusive range [minimum, maximum].
+static int randomInt(const int minimum, const int maximum) {
+	return minimum + (int)(randomStateNext(&randomState) % (uint64_t)(maximum - minimum + 1));
+}
+
+static void fail(const uint32_t roomIndex, const char *const pMessage) {
+	failureCount += 1;
+	if (failureCount <= 20) {
+		fprintf(stderr, "Room %u: %s\n", roomIndex, pMessage);
+	}
+}
+
+static bool boxesTouch(const BoxD a, const BoxD b) {
+	return a.x1 <= b.x2 && a.x2 >= b.x1 && a.y1 <= b.y2 && a.y2 >= b.y1;
+}
+
+static bool boxContainsPoint(const BoxD box, const double x, const double y) {
+	return x > box.x1 && x < box.x2 && y > box.y1 && y < box.y2;
+}
+
+// Same as the slab test of the wall BVH: the distance to where the ray enters the box, or INFINITY if it misses.
+static double raycastBox(const BoxD box, const Vector3D origin, const double inverseDirectionX, const double inverseDirectionY, const double maxDistance) {
+	double entry = 0.0;
+	double exit = maxDistance;
+	if (isinf(inverseDirectionX)) {
+		if (origin.x < box.x1 || origin.x > box.x2) {
+			return INFINITY;
+		}
+	} else {
+		const double t1 = (box.x1 - origin.x) * inverseDirectionX;
+		const double t2 = (box.x2 - origin.x) * inverseDirectionX;
+		entry = fmax(entry, fmin(t1, t2));
+		exit = fmin(exit, fmax(t1, t2));
+	}
+	if (isinf(inverseDirectionY)) {
+		if (origin.y < box.y1 || origin.y > box.y2) {
+			return INFINITY;
+		}
+	} else {
+		const double t1 = (box.y1 - origin.y) * inverseDirectionY;
+		const double t2 = (box.y2 - origin.y) * inverseDirectionY;
+		entry = fmax(entry, fmin(t1, t2));
+		exit = fmin(exit, fmax(t1, t2));
+	}
+	return entry <= exit ? entry : INFINITY;
+}
+
+// Fills the room with walls: single tiles, in a random order, and sometimes larger rectangles that may overlap them.
+// Marks every tile covered by a wall.
+static uint32_t makeRoomWalls(const int width, const int length, const bool rectangles, BoxD *const pWalls, bool pSolid[MAX_ROOM_LENGTH][MAX_ROOM_WIDTH]) {
+	const int solidChance = randomInt(5, 70);
+	uint32_t wallCount = 0;
+	for (int y = 0; y < length; ++y) {
+		for (int x = 0; x < width; ++x) {
+			pSolid[y][x] = false;
+		}
+	}
+	for (int y = 0; y < length; ++y) {
+		for (int x = 0; x < width; ++x) {
+			if (randomInt(0, 99) >= solidChance) {
+				continue;
+			}
+			BoxD wall = { x, y, x + 1, y + 1 };
+			if (rectangles && randomInt(0, 7) == 0) {
+				wall.x2 = fmin(width, x + randomInt(1, 4));
+				wall.y2 = fmin(length, y + randomInt(1, 3));
+			}
+			for (int tileY = y; tileY < (int)wall.y2; ++tileY) {
+				for (int tileX = x; tileX < (int)wall.x2; ++tileX) {
+					pSolid[tileY][tileX] = true;
+				}
+			}
+			pWalls[wallCount++] = wall;
+		}
+	}
+	for (uint32_t i = wallCount; i > 1; --i) {
+		const uint32_t j = (uint32_t)randomInt(0, (int)i - 1);
+		const BoxD wall = pWalls[i - 1];
+		pWalls[i - 1] = pWalls[j];
+		pWalls[j] = wall;
+	}
+	return wallCount;
+}
+
+static void checkMergedWalls(const uint32_t roomIndex, const Room room, const uint32_t originalWallCount, const bool rectangles,
+		const int width, const int length, bool pSolid[MAX_ROOM_LENGTH][MAX_ROOM_WIDTH]) {
+	if (room.wallCount > originalWallCount) {
+		fail(roomIndex, "merging walls made more walls.");
+	}
+	for (uint32_t i = 0; i < room.wallCount; ++i) {
+		const BoxD wall = room.pWalls[i];
+		if (!(wall.x1 < wall.x2 && wall.y1 < wall.y2)) {
+			fail(roomIndex, "a merged wall is empty.");
+		}
+		// Merged tiles never overlap, since the tiles do not; rectangles may overlap tiles, and so the walls merged from them.
+		for (uint32_t j = i + 1; j < room.wallCount && !rectangles; ++j) {
+			const BoxD other = room.pWalls[j];
+			if (wall.x1 < other.x2 && wall.x2 > other.x1 && wall.y1 < other.y2 && wall.y2 > other.y1) {
+				fail(roomIndex, "two merged walls overlap.");
+			}
+		}
+	}
+
+	// Every tile must be covered by a merged wall exactly when it was covered by an original wall.
+	for (int y = 0; y < length; ++y) {
+		for (int x = 0; x < width; ++x) {
+			bool covered = false;
+			for (uint32_t i = 0; i < room.wallCount && !covered; ++i) {
+				covered = boxContainsPoint(room.pWalls[i], x + 0.5, y + 0.5);
+			}
+			if (covered != pSolid[y][x]) {
+				fail(roomIndex, covered ? "merged walls cover a tile that no wall covered." : "merged walls miss a tile that a wall covered.");
+			}
+		}
+	}
+}
+
+static void checkQueries(const uint32_t roomIndex, const Room room, const int width, const int length) {
+	uint32_t wallIndices[MAX_WALL_COUNT];
+	uint32_t scanIndices[MAX_WALL_COUNT];
+	for (uint32_t i = 0; i < QUERY_COUNT; ++i) {
+		const double x = randomDouble(-2.0, width + 2.0);
+		const double y = randomDouble(-2.0, length + 2.0);
+
+		// Boxes with whole-tile edges touch walls exactly, which counts as finding them.
+		BoxD bounds = { x, y, x + randomDouble(0.0, 6.0), y + randomDouble(0.0, 6.0) };
+		if (randomInt(0, 3) == 0) {
+			bounds = (BoxD){ floor(bounds.x1), floor(bounds.y1), ceil(bounds.x2), ceil(bounds.y2) };
+		}
+
+		uint32_t scanCount = 0;
+		for (uint32_t j = 0; j < room.wallCount; ++j) {
+			if (boxesTouch(room.pWalls[j], bounds)) {
+				scanIndices[scanCount++] = j;
+			}
+		}
+
+		// A query that finds more walls than it can write still counts them all, and writes a sorted subset of them.
+		const uint32_t maxWallCount = randomInt(0, 3) == 0 ? (uint32_t)randomInt(0, 4) : MAX_WALL_COUNT;
+		const uint32_t foundCount = roomQueryWalls(&room, bounds, maxWallCount, wallIndices);
+		if (foundCount != scanCount) {
+			fail(roomIndex, "a BVH query found a different number of walls than testing every wall.");
+			continue;
+		}
+		const uint32_t writtenCount = foundCount < maxWallCount ? foundCount : maxWallCount;
+		for (uint32_t j = 0, k = 0; j < writtenCount; ++j) {
+			if (j > 0 && wallIndices[j] <= wallIndices[j - 1]) {
+				fail(roomIndex, "a BVH query wrote its walls out of order.");
+				break;
+			}
+			while (k < scanCount && scanIndices[k] < wallIndices[j]) {
+				k += 1;
+			}
+			if (k == scanCount || scanIndices[k] != wallIndices[j]) {
+				fail(roomIndex, "a BVH query wrote a wall that testing every wall did not find.");
+				break;
+			}
+		}
+	}
+}
+
+static void checkRaycasts(const uint32_t roomIndex, const Room room, const int width, const int length) {
+	for (uint32_t i = 0; i < QUERY_COUNT; ++i) {
+		const Vector3D origin = { randomDouble(-2.0, width + 2.0), randomDouble(-2.0, length + 2.0), 1.0 };
+
+		// Axis-aligned rays are common, and test the slabs that the ray runs parallel to.
+		Vector3D direction = { randomDouble(-1.0, 1.0), randomDouble(-1.0, 1.0), 0.0 };
+		switch (randomInt(0, 5)) {
+			case 0: direction.x = 0.0; break;
+			case 1: direction.y = 0.0; break;
+		}
+		if (direction.x == 0.0 && direction.y == 0.0) {
+			continue;
+		}
+		const double maxDistance = randomInt(0, 3) == 0 ? INFINITY : randomDouble(0.0, 20.0);
+
+		const double directionLength = sqrt(direction.x * direction.x + direction.y * direction.y);
+		const double inverseDirectionX = directionLength / direction.x;
+		const double inverseDirectionY = directionLength / direction.y;
+		double nearestDistance = INFINITY;
+		for (uint32_t j = 0; j < room.wallCount; ++j) {
+			nearestDistance = fmin(nearestDistance, raycastBox(room.pWalls[j], origin, inverseDirectionX, inverseDirectionY, maxDistance));
+		}
+
+		WallRaycastHit hit = { };
+		const bool hitWall = roomRaycastWalls(&room, origin, direction, maxDistance, &hit);
+		if (hitWall != !isinf(nearestDistance)) {
+			fail(roomIndex, hitWall ? "a BVH raycast hit a wall that testing every wall missed." : "a BVH raycast missed a wall that testing every wall hit.");
+		} else if (hitWall && (hit.distance != nearestDistance || hit.wallIndex >= room.wallCount
+				|| raycastBox(room.pWalls[hit.wallIndex], origin, inverseDirectionX, inverseDirectionY, maxDistance) != nearestDistance)) {
+			// Walls at the same distance are all nearest, so the hit may be any of them.
+			fail(roomIndex, "a BVH raycast did not hit the nearest wall.");
+		}
+	}
+}
+
+static void checkCollisions(const uint32_t roomIndex, const Room room, const int width, const int length) {
+	for (uint32_t i = 0; i < QUERY_COUNT; ++i) {
+		const double extent = randomDouble(0.125, 0.5);
+		const BoxD hitbox = { -extent, -extent, extent, extent };
+		const Vector3D previousPosition = { randomDouble(0.0, width), randomDouble(0.0, length), 1.0 };
+		const Vector3D positionStep = { randomInt(0, 3) == 0 ? 0.0 : randomDouble(-1.0, 1.0), randomInt(0, 3) == 0 ? 0.0 : randomDouble(-1.0, 1.0), 0.0 };
+
+		const Vector3D resolvedPosition = roomResolveWallCollisions(&room, hitbox, previousPosition, positionStep);
+		const Vector3D referencePosition = resolveWallCollisionsReference(room.collisionWalls, hitbox, previousPosition, positionStep);
+		if (resolvedPosition.x != referencePosition.x || resolvedPosition.y != referencePosition.y || resolvedPosition.z != referencePosition.z) {
+			fail(roomIndex, "resolving collisions against the nearby walls differs from resolving against every wall.");
+		}
+	}
+}
+
+int main(void) {
+	randomStateSeed(&randomState, 0x524F4F4D57414C4C);
+
+	static BoxD walls[MAX_WALL_COUNT];
+	static bool solid[MAX_ROOM_LENGTH][MAX_ROOM_WIDTH];
+	for (uint32_t i = 0; i < ROOM_COUNT; ++i) {
+		const int width = randomInt(1, MAX_ROOM_WIDTH);
+		const int length = randomInt(1, MAX_ROOM_LENGTH);
+		const bool rectangles = randomInt(0, 2) == 0;
+		const uint32_t wallCount = makeRoomWalls(width, length, rectangles, walls, solid);
+
+		Room room = {
+			.id = (int)i,
+			.wallCount = wallCount,
+			.pWalls = walls
+		};
+		if (!roomPrepareWalls(&room)) {
+			fail(i, "failed to prepare walls.");
+			continue;
+		}
+
+		checkMergedWalls(i, room, wallCount, rectangles, width, length, solid);
+		checkQueries(i, room, width, length);
+		checkRaycasts(i, room, width, length);
+		checkCollisions(i, room, width, length);
+
+		deleteCollisionWalls(&room.collisionWalls);
+		deleteWallBVH(&room.wallBVH);
+	}
+
+	if (failureCount > 0) {
+		fprintf(stderr, "%u checks failed.\n", failureCount);
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed for %u rooms.\n", ROOM_COUNT);
+	return EXIT_SUCCESS;
+}
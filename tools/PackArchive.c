@@ -0,0 +1,218 @@
+// Packs files into an archive that util/Archive.h can read.
+// Usage: PackArchive [--no-compress] <output archive> <base directory> <file>...
+// Each file is read from the base directory and stored under its name as given, e.g.:
+// 	PackArchive resources.ppak resources shaders/VertexShader.spv data/textures.fgt
+// Each file is compressed with LZ4 unless that saves less than an eighth of its size,
+// 	which leaves already-compressed formats such as PNG stored as they are.
+// WAV files are always stored as they are, so that the game can stream them from the archive instead of reading them whole.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "util/Archive.h"
+#include "util/LZ4.h"
+
+typedef struct PackEntry {
+	const char *pName;
+	uint64_t nameHash;
+	uint32_t nameOffset;
+	uint64_t dataOffset;
+	uint64_t size;
+	uint8_t *pData;
+	ArchiveCompression compression;
+	uint64_t storedSize;
+	uint8_t *pStoredData;
+} PackEntry;
+
+static int comparePackEntries(const void *pA, const void *pB) {
+	const PackEntry *const a = pA;
+	const PackEntry *const b = pB;
+	if (a->nameHash != b->nameHash) {
+		return a->nameHash < b->nameHash ? -1 : 1;
+	}
+	return strcmp(a->pName, b->pName);
+}
+
+static bool readWholeFile(const char *const pPath, uint8_t **const ppData, uint64_t *const pSize) {
+	FILE *const pFile = fopen(pPath, "rb");
+	if (!pFile) {
+		fprintf(stderr, "PackArchive: could not open \"%s\".\n", pPath);
+		return false;
+	}
+
+	long int fileSize = -1;
+	if (fseek(pFile, 0, SEEK_END) == 0) {
+		fileSize = ftell(pFile);
+	}
+	if (fileSize < 0 || fseek(pFile, 0, SEEK_SET) != 0) {
+		fprintf(stderr, "PackArchive: could not get size of \"%s\".\n", pPath);
+		fclose(pFile);
+		return false;
+	}
+
+	uint8_t *const pData = malloc(fileSize > 0 ? (size_t)fileSize : 1);
+	if (!pData || fread(pData, 1, (size_t)fileSize, pFile) != (size_t)fileSize) {
+		fprintf(stderr, "PackArchive: could not read \"%s\".\n", pPath);
+		free(pData);
+		fclose(pFile);
+		return false;
+	}
+	fclose(pFile);
+
+	*ppData = pData;
+	*pSize = (uint64_t)fileSize;
+	return true;
+}
+
+static bool isStreamedEntry(const char *const pName) {
+	const size_t nameLength = strlen(pName);
+	return nameLength >= 4 && strcmp(&pName[nameLength - 4], ".wav") == 0;
+}
+
+// Compresses an entry if that saves enough space, and otherwise stores it as it is.
+static bool compressEntry(PackEntry *const pEntry, const bool compress) {
+	pEntry->compression = ARCHIVE_COMPRESSION_NONE;
+	pEntry->storedSize = pEntry->size;
+	pEntry->pStoredData = pEntry->pData;
+	if (!compress || pEntry->size == 0 || isStreamedEntry(pEntry->pName)) {
+		return true;
+	}
+
+	const size_t compressedCapacity = lz4CompressBound((size_t)pEntry->size);
+	uint8_t *const pCompressed = malloc(compressedCapacity);
+	if (!pCompressed) {
+		fprintf(stderr, "PackArchive: failed to allocate compression buffer for \"%s\".\n", pEntry->pName);
+		return false;
+	}
+
+	const size_t compressedSize = lz4CompressBlock(pEntry->pData, (size_t)pEntry->size, pCompressed, compressedCapacity);
+	if (compressedSize == 0 || compressedSize > pEntry->size - pEntry->size / 8) {
+		free(pCompressed);
+		return true;
+	}
+
+	pEntry->compression = ARCHIVE_COMPRESSION_LZ4;
+	pEntry->storedSize = compressedSize;
+	pEntry->pStoredData = pCompressed;
+	return true;
+}
+
+static void writeU32(FILE *const pFile, const uint32_t value) {
+	const uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+	fwrite(bytes, 1, sizeof(bytes), pFile);
+}
+
+static void writeU64(FILE *const pFile, const uint64_t value) {
+	writeU32(pFile, (uint32_t)value);
+	writeU32(pFile, (uint32_t)(value >> 32));
+}
+
+static void writePadding(FILE *const pFile, uint64_t size) {
+	for (; size > 0; --size) {
+		fputc(0, pFile);
+	}
+}
+
+static uint64_t alignOffset(const uint64_t offset) {
+	return (offset + ARCHIVE_ENTRY_ALIGNMENT - 1) / ARCHIVE_ENTRY_ALIGNMENT * ARCHIVE_ENTRY_ALIGNMENT;
+}
+
+int main(int argc, char *argv[]) {
+	const bool compress = argc < 2 || strcmp(argv[1], "--no-compress") != 0;
+	const int firstArgument = compress ? 1 : 2;
+	if (argc < firstArgument + 3) {
+		fprintf(stderr, "Usage: %s [--no-compress] <output archive> <base directory> <file>...\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const pOutputPath = argv[firstArgument];
+	const char *const pBaseDirectory = argv[firstArgument + 1];
+	const uint32_t entryCount = (uint32_t)(argc - firstArgument - 2);
+
+	PackEntry *const pEntries = calloc(entryCount, sizeof(PackEntry));
+	if (!pEntries) {
+		fprintf(stderr, "PackArchive: failed to allocate %u entries.\n", entryCount);
+		return EXIT_FAILURE;
+	}
+
+	uint64_t nameTableSize = 0;
+	for (uint32_t i = 0; i < entryCount; ++i) {
+		const char *const pName = argv[firstArgument + 2 + i];
+		char path[1024];
+		const int pathLength = snprintf(path, sizeof(path), "%s/%s", pBaseDirectory, pName);
+		if (pathLength < 0 || (size_t)pathLength >= sizeof(path)) {
+			fprintf(stderr, "PackArchive: path to \"%s\" is too long.\n", pName);
+			return EXIT_FAILURE;
+		}
+
+		pEntries[i].pName = pName;
+		pEntries[i].nameHash = archiveHashName(pName);
+		if (!readWholeFile(path, &pEntries[i].pData, &pEntries[i].size) || !compressEntry(&pEntries[i], compress)) {
+			return EXIT_FAILURE;
+		}
+		nameTableSize += strlen(pName) + 1;
+	}
+
+	qsort(pEntries, entryCount, sizeof(PackEntry), comparePackEntries);
+
+	const uint64_t nameTableOffset = ARCHIVE_HEADER_SIZE + (uint64_t)entryCount * ARCHIVE_INDEX_ENTRY_SIZE;
+	uint64_t nameOffset = 0;
+	uint64_t dataOffset = alignOffset(nameTableOffset + nameTableSize);
+	for (uint32_t i = 0; i < entryCount; ++i) {
+		if (i > 0 && comparePackEntries(&pEntries[i - 1], &pEntries[i]) == 0) {
+			fprintf(stderr, "PackArchive: \"%s\" is listed more than once.\n", pEntries[i].pName);
+			return EXIT_FAILURE;
+		}
+		pEntries[i].nameOffset = (uint32_t)nameOffset;
+		nameOffset += strlen(pEntries[i].pName) + 1;
+		pEntries[i].dataOffset = dataOffset;
+		dataOffset = alignOffset(dataOffset + pEntries[i].storedSize);
+	}
+
+	FILE *const pFile = fopen(pOutputPath, "wb");
+	if (!pFile) {
+		fprintf(stderr, "PackArchive: could not create \"%s\".\n", pOutputPath);
+		return EXIT_FAILURE;
+	}
+
+	writeU32(pFile, ARCHIVE_MAGIC);
+	writeU32(pFile, ARCHIVE_VERSION);
+	writeU32(pFile, entryCount);
+	writeU32(pFile, (uint32_t)nameTableSize);
+
+	for (uint32_t i = 0; i < entryCount; ++i) {
+		writeU64(pFile, pEntries[i].nameHash);
+		writeU64(pFile, pEntries[i].dataOffset);
+		writeU64(pFile, pEntries[i].storedSize);
+		writeU64(pFile, pEntries[i].size);
+		writeU32(pFile, pEntries[i].nameOffset);
+		writeU32(pFile, (uint32_t)pEntries[i].compression);
+	}
+
+	for (uint32_t i = 0; i < entryCount; ++i) {
+		fwrite(pEntries[i].pName, 1, strlen(pEntries[i].pName) + 1, pFile);
+	}
+
+	uint64_t position = nameTableOffset + nameTableSize;
+	uint64_t totalSize = 0;
+	for (uint32_t i = 0; i < entryCount; ++i) {
+		writePadding(pFile, pEntries[i].dataOffset - position);
+		fwrite(pEntries[i].pStoredData, 1, (size_t)pEntries[i].storedSize, pFile);
+		position = pEntries[i].dataOffset + pEntries[i].storedSize;
+		totalSize += pEntries[i].size;
+		if (pEntries[i].pStoredData != pEntries[i].pData) {
+			free(pEntries[i].pStoredData);
+		}
+		free(pEntries[i].pData);
+	}
+	free(pEntries);
+
+	if (ferror(pFile) || fclose(pFile) != 0) {
+		fprintf(stderr, "PackArchive: failed to write \"%s\".\n", pOutputPath);
+		return EXIT_FAILURE;
+	}
+
+	printf("PackArchive: packed %u files (%llu bytes) into \"%s\" (%llu bytes).\n", entryCount, (unsigned long long)totalSize, pOutputPath, (unsigned long long)position);
+	return EXIT_SUCCESS;
+}